@@ -28,6 +28,49 @@ function(GET_SHADERS_RECURSIVE RESULT GLSL_FOLDER)
     set(${RESULT} ${ALL_SOURCES} PARENT_SCOPE)
 endfunction(GET_SHADERS_RECURSIVE)
 
+# build-time reflection of a SPIR-V file via SPIRV_REFLECT_TOOL (optional).
+# appends constexpr tables to OUTPUT_SOURCE and an initializer for a vierkant::shader_reflection_t to list ENTRIES
+function(APPEND_SHADER_REFLECTION SPIRV DIR_NAME NAME OUTPUT_SOURCE ENTRIES)
+    set(entries ${${ENTRIES}})
+
+    if (SPIRV_REFLECT_TOOL)
+        execute_process(
+                COMMAND ${SPIRV_REFLECT_TOOL} ${SPIRV} ${NAME}
+                OUTPUT_VARIABLE reflection
+                ERROR_VARIABLE reflection_std_err
+                RESULT_VARIABLE ret
+        )
+
+        if ("${ret}" STREQUAL "0")
+            file(APPEND ${OUTPUT_SOURCE} "${reflection}")
+            list(APPEND entries "{${DIR_NAME}::${NAME}.data(), ${DIR_NAME}::${NAME}.size(), ${DIR_NAME}::${NAME}_entry_points}")
+        else ()
+            # runtime-reflection is used as fallback
+            message(WARNING "Failed to reflect shader: ${reflection_std_err}")
+        endif ()
+    endif ()
+    set(${ENTRIES} ${entries} PARENT_SCOPE)
+endfunction(APPEND_SHADER_REFLECTION)
+
+# declare/define the array of all reflected shaders, expected inside the top-level namespace
+function(WRITE_SHADER_REFLECTION_TABLE OUTPUT_HEADER OUTPUT_SOURCE ENTRIES)
+    list(LENGTH ENTRIES num_entries)
+    string(REPLACE ";" ",\n        " entries_str "${ENTRIES}")
+
+    if (num_entries)
+        set(initializer "{{\n        ${entries_str}}}")
+    else ()
+        set(initializer "{}")
+    endif ()
+
+    file(APPEND ${OUTPUT_HEADER}
+            "\n//! build-time reflection-data for all shaders\n"
+            "extern const std::span<const vierkant::shader_reflection_t> reflections;\n")
+    file(APPEND ${OUTPUT_SOURCE}
+            "\nstatic const std::array<vierkant::shader_reflection_t, ${num_entries}> reflection_array = ${initializer};\n"
+            "const std::span<const vierkant::shader_reflection_t> reflections = reflection_array;\n")
+endfunction(WRITE_SHADER_REFLECTION_TABLE)
+
 # --- slang helpers -------------------------------------------------------
 # recursive collection of `.slang` source files mirroring GET_SHADERS_RECURSIVE
 function(GET_SLANG_RECURSIVE RESULT SLANG_FOLDER)
@@ -76,7 +119,9 @@ function(STRINGIFY_SLANG_SHADERS SLANG_FOLDER TARGET_NAME SLANG_COMPILER SPIRV_O
     file(WRITE ${OUTPUT_HEADER}
             "/* Generated file, do not edit! */\n\n"
             "#pragma once\n\n"
-            "#include <array>\n\n"
+            "#include <array>\n"
+            "#include <span>\n"
+            "#include <vierkant/shader_reflection.hpp>\n\n"
             "namespace ${TOP_NAMESPACE}\n{\n\n")
     file(WRITE ${OUTPUT_SOURCE}
             "/* Generated file, do not edit! */\n\n"
@@ -130,6 +175,7 @@ function(STRINGIFY_SLANG_SHADERS SLANG_FOLDER TARGET_NAME SLANG_COMPILER SPIRV_O
                 string(REPLACE ";" ", 0x" hex_values "${hex_values}")
 
                 file(APPEND ${OUTPUT_SOURCE} "0x${hex_values}};\n")
+                append_shader_reflection(${SPIRV} ${DIR_NAME} ${NAME} ${OUTPUT_SOURCE} REFLECTION_ENTRIES)
             else()
                 message(STATUS "skipping slang source without spirv output: ${SLANG}")
             endif()
@@ -141,6 +187,7 @@ function(STRINGIFY_SLANG_SHADERS SLANG_FOLDER TARGET_NAME SLANG_COMPILER SPIRV_O
         endif()
     endforeach()
 
+    write_shader_reflection_table(${OUTPUT_HEADER} ${OUTPUT_SOURCE} "${REFLECTION_ENTRIES}")
     file(APPEND ${OUTPUT_HEADER} "\n}// namespace ${TOP_NAMESPACE}\n")
     file(APPEND ${OUTPUT_SOURCE} "\n}// namespace ${TOP_NAMESPACE}\n")
 endfunction(STRINGIFY_SLANG_SHADERS)
@@ -200,7 +247,9 @@ function(STRINGIFY_SHADERS GLSL_FOLDER TARGET_NAME SHADER_COMPILER SPIRV_OUT_DIR
     file(WRITE ${OUTPUT_HEADER}
             "/* Generated file, do not edit! */\n\n"
             "#pragma once\n\n"
-            "#include <array>\n\n"
+            "#include <array>\n"
+            "#include <span>\n"
+            "#include <vierkant/shader_reflection.hpp>\n\n"
             "namespace ${TOP_NAMESPACE}\n{\n\n")
     file(WRITE ${OUTPUT_SOURCE}
             "/* Generated file, do not edit! */\n\n"
@@ -262,6 +311,7 @@ function(STRINGIFY_SHADERS GLSL_FOLDER TARGET_NAME SHADER_COMPILER SPIRV_OUT_DIR
             string(REPLACE ";" ", 0x" hex_values "${hex_values}")
 
             file(APPEND ${OUTPUT_SOURCE} "0x${hex_values}};\n")
+            append_shader_reflection(${SPIRV} ${DIR_NAME} ${NAME} ${OUTPUT_SOURCE} REFLECTION_ENTRIES)
         endforeach (GLSL)
 
         if (GLSL_FOLDER_FILES)
@@ -272,6 +322,8 @@ function(STRINGIFY_SHADERS GLSL_FOLDER TARGET_NAME SHADER_COMPILER SPIRV_OUT_DIR
 
     endforeach (SUBDIR)
 
+    write_shader_reflection_table(${OUTPUT_HEADER} ${OUTPUT_SOURCE} "${REFLECTION_ENTRIES}")
+
     # close namespace
     file(APPEND ${OUTPUT_HEADER} "\n}// namespace ${TOP_NAMESPACE}\n")
     file(APPEND ${OUTPUT_SOURCE} "\n}// namespace ${TOP_NAMESPACE}\n")
@@ -0,0 +1,207 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+#include <vierkant/AssetProvider.hpp>
+#include <vierkant/intersection.hpp>
+
+namespace vierkant
+{
+
+DEFINE_CLASS_PTR(AssetStreamer)
+
+//! handle identifying a streaming-request
+using stream_handle_t = uint64_t;
+
+//! enumeration of streaming-states
+enum class StreamState
+{
+    Invalid,
+    Queued,
+    Loading,
+    Uploading,
+    Done,
+    Failed
+};
+
+/**
+ * @brief   stream_priority returns a priority for streaming an object, approximating its projected screen-size.
+ *
+ * @param   eye         camera-position in world-space
+ * @param   bounds      world-space bounding-sphere of the object
+ * @param   fovy        the camera's vertical field-of-view in radians
+ * @return  the ratio of projected radius and half the viewport-height. objects containing the eye return +inf.
+ */
+float stream_priority(const glm::vec3 &eye, const vierkant::Sphere &bounds, float fovy);
+
+/**
+ * @brief   AssetStreamer loads models incrementally, scheduling asset-work (parse → compress → upload)
+ *          as prioritized jobs on a threadpool and publishing meshes and textures to an AssetProvider,
+ *          as soon as they become available.
+ *
+ *  - meshes are published first (with materials and lights), textures follow individually.
+ *  - job-priorities are taken from requests and can be changed at any time, e.g. using 'stream_priority'.
+ *  - a cpu-budget limits the amount of parsed, not yet uploaded asset-data. parsing is paused when exceeded.
+ *  - a gpu-budget limits the amount of uploaded data. uploads are deferred when exceeded,
+ *    until requests are released.
+ *
+ * GPU-uploads and publishing happen in 'update', which is expected to be called on the render-thread,
+ * at the same sync-point used for AssetProvider-mutations.
+ * if 'load_params.upload_queue' is set, uploads are batched onto the transfer-queue without blocking
+ * and the render-loop needs to call UploadQueue::acquire before using published assets.
+ */
+class AssetStreamer
+{
+public:
+    //! callback invoked from 'update' after a mesh (including materials and lights) was published
+    using mesh_fn_t = std::function<void(stream_handle_t, const model::load_mesh_result_t &)>;
+
+    struct create_info_t
+    {
+        //! the AssetProvider receiving loaded assets
+        vierkant::AssetProviderPtr asset_provider;
+
+        //! parameters for gpu-uploads (device, queue, buffer-params)
+        model::load_mesh_params_t load_params = {};
+
+        //! optional threadpool for parse- and compress-jobs. if null, jobs are run from 'update'
+        crocore::ThreadPoolClassic *pool = nullptr;
+
+        //! max number of concurrently running jobs, 0: use number of pool-threads
+        uint32_t max_jobs_in_flight = 0;
+
+        //! budget for parsed, not yet uploaded asset-data in bytes
+        size_t cpu_budget = size_t(1) << 30;
+
+        //! budget for uploaded asset-data in bytes
+        size_t gpu_budget = size_t(2) << 30;
+
+        //! max number of bytes uploaded during a single call to 'update'
+        size_t max_upload_bytes = size_t(64) << 20;
+
+        //! flag indicating if textures should be compressed (BC5/BC7) before upload
+        bool compress_textures = true;
+
+        //! optional directory for a model-cache (see model_cache.hpp)
+        std::filesystem::path cache_dir;
+
+        //! optional callback for published meshes
+        mesh_fn_t mesh_fn;
+    };
+
+    //! statistics for streaming-requests, jobs and memory-budgets
+    struct stats_t
+    {
+        size_t cpu_bytes = 0;
+        size_t gpu_bytes = 0;
+        uint32_t num_requests = 0;
+        uint32_t num_jobs_queued = 0;
+        uint32_t num_jobs_in_flight = 0;
+    };
+
+    static AssetStreamerPtr create(create_info_t create_info);
+
+    AssetStreamer(const AssetStreamer &) = delete;
+
+    AssetStreamer(AssetStreamer &&) = delete;
+
+    AssetStreamer &operator=(AssetStreamer other) = delete;
+
+    ~AssetStreamer();
+
+    /**
+     * @brief   request loading of a model-file.
+     *
+     * @param   path        path to a supported model-file.
+     * @param   priority    initial priority, higher values are processed first
+     * @param   id_seed     optional stable string seeding deterministic asset-ids (default: path)
+     * @return  a handle identifying the request
+     */
+    stream_handle_t request(const std::filesystem::path &path, float priority = 0.f, const std::string &id_seed = {});
+
+    /**
+     * @brief   request streaming of already loaded model-assets, e.g. procedurally generated ones.
+     *
+     * @param   mesh_assets model-assets to stream
+     * @param   priority    initial priority, higher values are processed first
+     * @return  a handle identifying the request
+     */
+    stream_handle_t request(model::model_assets_t mesh_assets, float priority = 0.f);
+
+    //! update the priority for a request
+    void set_priority(stream_handle_t handle, float priority);
+
+    //! returns the current state of a request
+    [[nodiscard]] StreamState state(stream_handle_t handle) const;
+
+    /**
+     * @brief   release a request. pending work is cancelled and its data is removed from memory-budgets.
+     *          published assets are not removed from the AssetProvider (see AssetProvider::prune).
+     */
+    void release(stream_handle_t handle);
+
+    /**
+     * @brief   update dispatches jobs, uploads finished assets and publishes them to the AssetProvider.
+     *          expected to be called on the render-thread.
+     */
+    void update();
+
+    //! returns true, if no request has outstanding work
+    [[nodiscard]] bool idle() const;
+
+    //! returns current statistics
+    [[nodiscard]] stats_t stats() const;
+
+private:
+    struct request_t;
+    using RequestPtr = std::shared_ptr<request_t>;
+
+    struct job_t
+    {
+        RequestPtr request;
+        std::function<void()> fn;
+        bool parse = false;
+    };
+
+    explicit AssetStreamer(create_info_t create_info);
+
+    stream_handle_t add_request(RequestPtr request);
+
+    void parse(const RequestPtr &request);
+
+    void parsed(const RequestPtr &request, std::optional<model::model_assets_t> mesh_assets);
+
+    void compress(const RequestPtr &request, const vierkant::TextureId &texture_id);
+
+    std::optional<job_t> next_job();
+
+    void dispatch_jobs(std::unique_lock<std::mutex> &lock);
+
+    void run_job(job_t job);
+
+    void upload_mesh(const RequestPtr &request);
+
+    void upload_texture(const RequestPtr &request, const vierkant::TextureId &texture_id);
+
+    create_info_t m_create_info;
+
+    std::unordered_map<stream_handle_t, RequestPtr> m_requests;
+
+    std::deque<job_t> m_jobs;
+
+    stream_handle_t m_next_handle = 1;
+
+    uint32_t m_num_jobs_in_flight = 0;
+
+    size_t m_cpu_bytes = 0, m_gpu_bytes = 0;
+
+    bool m_shutdown = false;
+
+    mutable std::mutex m_mutex;
+
+    std::condition_variable m_condition;
+};
+
+}// namespace vierkant
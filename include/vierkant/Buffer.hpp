@@ -40,6 +40,9 @@ public:
         VmaMemoryUsage mem_usage = VMA_MEMORY_USAGE_UNKNOWN;
         VmaPoolPtr pool;
         std::string name;
+
+        //! category used for memory-accounting, derived from usage-flags if undefined
+        MemoryCategory memory_category = MemoryCategory::UNDEFINED;
     };
 
     /**
@@ -158,8 +161,13 @@ public:
     [[nodiscard]] vierkant::DevicePtr device() const { return m_device; }
 
 private:
+    friend class Defragmenter;
+
     explicit Buffer(const create_info_t &create_info);
 
+    //! usage-flags passed to vkCreateBuffer
+    [[nodiscard]] VkBufferUsageFlags create_usage_flags() const;
+
     DevicePtr m_device;
 
     VkBuffer m_buffer = VK_NULL_HANDLE;
@@ -183,6 +191,8 @@ private:
     VmaPoolPtr m_pool = nullptr;
 
     std::string m_name;
+
+    MemoryCategory m_memory_category = MemoryCategory::OTHER;
 };
 
 }// namespace vierkant
\ No newline at end of file
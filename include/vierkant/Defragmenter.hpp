@@ -0,0 +1,138 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+
+#include <vierkant/Buffer.hpp>
+
+namespace vierkant
+{
+
+DEFINE_CLASS_PTR(Defragmenter)
+
+/**
+ * @brief   Defragmenter incrementally compacts device-memory, using VMA's defragmentation-API.
+ *
+ *  - visits VMA's default pools and all dedicated memory-pools of a Device (see Device::memory_pool) in turn.
+ *  - 'update' runs defragmentation-passes until a time-budget is spent. each pass copies a limited amount of
+ *    allocations into new locations, using a blocking submission.
+ *  - relocated buffers are patched in place (VkBuffer-handle and VkDeviceAddress),
+ *    'relocation_delegate' is invoked for each relocation.
+ *
+ *  only device-local buffers are moved. images (clones share VkImage-handles and -views), host-visible buffers
+ *  (persistently mapped pointers) and acceleration-structure storage are left in place.
+ *
+ *  descriptor-sets are rewritten with current handles whenever they are retrieved (see find_or_create_descriptor_set),
+ *  pre-recorded command-buffers or device-addresses stored in GPU-memory need to be patched by the caller,
+ *  using 'relocation_delegate'.
+ *
+ *  'update' should be called on the render-thread, between frames, while no other thread modifies buffers.
+ *  copies are ordered after all prior work on the queue selected by 'queue_type',
+ *  other queues using relocated buffers need to be idle.
+ */
+class Defragmenter
+{
+public:
+    //! relocation of a buffer, reported after its contents were moved
+    struct relocation_t
+    {
+        vierkant::Buffer *buffer = nullptr;
+        VkBuffer old_handle = VK_NULL_HANDLE;
+        VkBuffer new_handle = VK_NULL_HANDLE;
+        VkDeviceAddress old_device_address = 0;
+        VkDeviceAddress new_device_address = 0;
+    };
+
+    using relocation_fn_t = std::function<void(const relocation_t &relocation)>;
+
+    struct create_info_t
+    {
+        vierkant::DevicePtr device;
+
+        //! type of queue used for copies, also determines the queue-family of the internal command-pool
+        vierkant::Device::Queue queue_type = vierkant::Device::Queue::GRAPHICS;
+
+        //! include VMA's default pools, in addition to dedicated memory-pools
+        bool default_pools = true;
+
+        //! defragmentation-algorithm
+        VmaDefragmentationFlags flags = VMA_DEFRAGMENTATION_FLAG_ALGORITHM_BALANCED_BIT;
+
+        //! limits for a single pass, 0: no limit
+        VkDeviceSize max_bytes_per_pass = 1UL << 26;
+        uint32_t max_allocations_per_pass = 256;
+    };
+
+    //! accumulated statistics
+    struct stats_t
+    {
+        VkDeviceSize num_bytes_moved = 0;
+        VkDeviceSize num_bytes_freed = 0;
+        uint32_t num_allocations_moved = 0;
+        uint32_t num_allocations_ignored = 0;
+        uint32_t num_device_memory_blocks_freed = 0;
+        uint32_t num_passes = 0;
+    };
+
+    /**
+     * @brief   Create a new Defragmenter.
+     *
+     * @param   create_info a create_info_t struct
+     * @return  a DefragmenterPtr.
+     */
+    static DefragmenterPtr create(const create_info_t &create_info);
+
+    Defragmenter(const Defragmenter &) = delete;
+
+    Defragmenter &operator=(const Defragmenter &) = delete;
+
+    ~Defragmenter();
+
+    /**
+     * @brief   update runs defragmentation-passes until 'time_budget' is spent,
+     *          or all pools were visited without pending moves.
+     *
+     * @param   time_budget maximum duration to spend, the last pass might exceed it
+     * @return  number of relocated buffers.
+     */
+    uint32_t update(std::chrono::nanoseconds time_budget);
+
+    /**
+     * @return  accumulated statistics for all passes so far.
+     */
+    [[nodiscard]] const stats_t &stats() const { return m_stats; }
+
+    //! invoked for each relocated buffer, after its contents were copied
+    relocation_fn_t relocation_delegate;
+
+private:
+    explicit Defragmenter(const create_info_t &create_info);
+
+    //! begin defragmentation of the next pool, round-robin
+    void begin_next_pool();
+
+    //! end defragmentation of the current pool, accumulate stats
+    void end_pool();
+
+    //! run a single pass, returns false if the current pool is complete
+    bool run_pass(uint32_t &num_relocations);
+
+    vierkant::DevicePtr m_device;
+
+    create_info_t m_create_info;
+
+    VkQueue m_queue = VK_NULL_HANDLE;
+
+    vierkant::CommandPoolPtr m_command_pool;
+
+    //! current defragmentation-context and pool (VK_NULL_HANDLE: default pools)
+    VmaDefragmentationContext m_context = VK_NULL_HANDLE;
+    VmaPool m_pool = VK_NULL_HANDLE;
+
+    //! round-robin index over all pools
+    uint32_t m_pool_index = 0;
+
+    stats_t m_stats;
+};
+
+}// namespace vierkant
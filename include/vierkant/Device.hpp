@@ -5,7 +5,9 @@
 #pragma once
 
 #include <map>
+#include <mutex>
 #include <vierkant/Instance.hpp>
+#include <vierkant/MemoryTracker.hpp>
 #include <vierkant/debug_label.hpp>
 #include <vierkant/math.hpp>
 #include <vk_mem_alloc.h>
@@ -93,6 +95,9 @@ public:
 
         //! optional pointer that will be passed as 'pNext' during device-creation.
         void *create_device_pNext = nullptr;
+
+        //! block-sizes for dedicated memory-pools per MemoryCategory. categories without entry use VMA's default pools
+        std::map<vierkant::MemoryCategory, VkDeviceSize> memory_pool_block_sizes;
     };
 
     static DevicePtr create(const create_info_t &create_info);
@@ -166,6 +171,25 @@ public:
      */
     [[nodiscard]] VmaAllocator vk_mem_allocator() const { return m_vk_mem_allocator; };
 
+    /**
+     * @return  a MemoryTracker, accounting live allocations per category and heap.
+     */
+    [[nodiscard]] vierkant::MemoryTracker &memory_tracker() const { return *m_memory_tracker; }
+
+    /**
+     * @brief   memory_pool returns a dedicated memory-pool for a MemoryCategory and memory-type, created on demand.
+     *
+     * @param   category            a MemoryCategory
+     * @param   memory_type_index   index of a memory-type
+     * @return  a VmaPool or VK_NULL_HANDLE, if no block-size was configured for the category.
+     */
+    [[nodiscard]] VmaPool memory_pool(vierkant::MemoryCategory category, uint32_t memory_type_index) const;
+
+    /**
+     * @return  all dedicated memory-pools created so far.
+     */
+    [[nodiscard]] std::vector<VmaPool> memory_pools() const;
+
     /**
      * @brief   set_object_name can be used to set a name for an object.
      *
@@ -190,6 +214,14 @@ private:
     // an instance of a VmaAllocator for this device
     VmaAllocator m_vk_mem_allocator = VK_NULL_HANDLE;
 
+    // per-category accounting and memory-budgets
+    std::unique_ptr<vierkant::MemoryTracker> m_memory_tracker;
+
+    // block-sizes and lazily created memory-pools, per category and memory-type
+    std::map<vierkant::MemoryCategory, VkDeviceSize> m_memory_pool_block_sizes;
+    mutable std::map<std::pair<vierkant::MemoryCategory, uint32_t>, VmaPoolPtr> m_memory_pools;
+    mutable std::mutex m_memory_pool_mutex;
+
     VkSampleCountFlagBits m_max_usable_samples = VK_SAMPLE_COUNT_1_BIT;
 
     // a map holding all queues for logical device
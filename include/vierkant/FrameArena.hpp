@@ -0,0 +1,120 @@
+#pragma once
+
+#include <memory_resource>
+#include <vector>
+
+#include <crocore/crocore.hpp>
+
+namespace vierkant
+{
+
+DEFINE_CLASS_PTR(FrameArena)
+
+/**
+ * @brief   FrameArena is a linear allocator for transient, frame-scoped data.
+ *
+ *  - allocations are bump-allocated from a single block, deallocation is a no-op.
+ *  - 'reset' releases all allocations in O(1), memory is reused by the next frame.
+ *  - if a frame exceeds the capacity, additional blocks are requested from an upstream-resource.
+ *    those are coalesced into a single, larger block on the next 'reset', so steady-state frames
+ *    do not allocate from upstream.
+ *
+ *  FrameArena derives from std::pmr::memory_resource and can be used with std::pmr containers:
+ *  - std::pmr::vector<uint32_t> indices(frame_arena.get());
+ *
+ *  containers using a FrameArena must not outlive the next call to 'reset'.
+ *  FrameArena is not thread-safe.
+ */
+class FrameArena : public std::pmr::memory_resource
+{
+public:
+    struct create_info_t
+    {
+        //! initial capacity in bytes
+        size_t num_bytes = 1UL << 20;
+
+        //! resource used to allocate blocks
+        std::pmr::memory_resource *upstream = std::pmr::new_delete_resource();
+    };
+
+    //! allocation-counters for a frame
+    struct stats_t
+    {
+        //! total number of bytes allocated, including alignment-padding
+        size_t num_bytes = 0;
+
+        //! number of allocations
+        size_t num_allocations = 0;
+
+        //! number of blocks allocated from upstream-resource
+        size_t num_upstream_allocations = 0;
+    };
+
+    /**
+     * @brief   Create a new FrameArena.
+     *
+     * @param   create_info a create_info_t struct
+     * @return  a FrameArenaPtr.
+     */
+    static FrameArenaPtr create(const create_info_t &create_info);
+
+    FrameArena(const FrameArena &) = delete;
+
+    FrameArena &operator=(const FrameArena &) = delete;
+
+    ~FrameArena() override;
+
+    /**
+     * @brief   reset releases all allocations and starts a new frame.
+     *          counters of the current frame are available via 'last_frame_stats'.
+     */
+    void reset();
+
+    /**
+     * @return  total capacity in bytes, across all blocks.
+     */
+    [[nodiscard]] size_t capacity() const;
+
+    /**
+     * @return  allocation-counters for the current frame.
+     */
+    [[nodiscard]] const stats_t &stats() const { return m_stats; }
+
+    /**
+     * @return  allocation-counters for the previous frame.
+     */
+    [[nodiscard]] const stats_t &last_frame_stats() const { return m_last_frame_stats; }
+
+private:
+    struct block_t
+    {
+        uint8_t *data = nullptr;
+        size_t num_bytes = 0;
+    };
+
+    explicit FrameArena(const create_info_t &create_info);
+
+    void *do_allocate(size_t num_bytes, size_t alignment) override;
+
+    void do_deallocate(void * /*p*/, size_t /*num_bytes*/, size_t /*alignment*/) override {}
+
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+    {
+        return this == &other;
+    }
+
+    //! allocate a new block from upstream and make it current
+    void add_block(size_t num_bytes);
+
+    std::pmr::memory_resource *m_upstream = nullptr;
+
+    //! all blocks, the last one is used for allocations
+    std::vector<block_t> m_blocks;
+
+    //! offset into the current block
+    size_t m_offset = 0;
+
+    stats_t m_stats, m_last_frame_stats;
+};
+
+}// namespace vierkant
@@ -62,6 +62,9 @@ public:
         VkCommandBuffer initial_cmd_buffer = VK_NULL_HANDLE;
         std::string name;
 
+        //! category used for memory-accounting, derived from usage-flags if undefined
+        MemoryCategory memory_category = MemoryCategory::UNDEFINED;
+
         bool operator==(const Format &other) const;
 
         bool operator!=(const Format &other) const { return !(*this == other); };
@@ -194,10 +197,12 @@ public:
                            VkDependencyFlags dependency_flags = 0, bool force = false);
 
     /**
-     * @brief  more explicit alternative to 'transition_layout'
+     * @brief  more explicit alternative to 'transition_layout', optionally transferring queue-family ownership
      */
     void barrier(VkImageLayout new_layout, VkCommandBuffer command_buffer, VkPipelineStageFlags2 src_stage,
-                 VkAccessFlags2 src_access, VkPipelineStageFlags2 dst_stage, VkAccessFlags2 dst_access);
+                 VkAccessFlags2 src_access, VkPipelineStageFlags2 dst_stage, VkAccessFlags2 dst_access,
+                 uint32_t src_queue_family = VK_QUEUE_FAMILY_IGNORED,
+                 uint32_t dst_queue_family = VK_QUEUE_FAMILY_IGNORED);
 
     /**
      * @brief   generate a mipmap-chain by performing linear-filtered blits.
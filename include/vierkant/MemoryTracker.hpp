@@ -0,0 +1,151 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <vector>
+
+#include <volk.h>
+#include <vk_mem_alloc.h>
+
+namespace vierkant
+{
+
+//! categories used to account for device-memory
+enum class MemoryCategory : uint32_t
+{
+    //! derive category from usage-flags
+    UNDEFINED = 0,
+    OTHER,
+    MESH,
+    TEXTURE,
+    RENDER_TARGET,
+    ACCELERATION_STRUCTURE,
+    STAGING,
+    MAX_ENUM
+};
+
+/**
+ * @brief   memory_category_from_usage derives a category from buffer-usage flags.
+ *
+ * @param   usage       buffer-usage flags
+ * @param   mem_usage   intended memory-usage
+ * @return  a MemoryCategory.
+ */
+MemoryCategory memory_category_from_usage(VkBufferUsageFlags usage, VmaMemoryUsage mem_usage);
+
+/**
+ * @brief   memory_category_from_usage derives a category from image-usage flags.
+ *
+ * @param   usage       image-usage flags
+ * @return  a MemoryCategory.
+ */
+MemoryCategory memory_category_from_usage(VkImageUsageFlags usage);
+
+/**
+ * @brief   MemoryTracker aggregates live allocations per MemoryCategory and memory-heap,
+ *          and compares heap-usage against budgets reported by VMA (VK_EXT_memory_budget, if available).
+ *
+ *  - Buffers and Images register their allocations on creation and unregister on destruction.
+ *  - 'update' should be called once per frame. it advances VMA's frame-index, which refreshes cached budgets,
+ *    and invokes 'budget_exceeded_delegate' for all heaps exceeding the budget-threshold.
+ *
+ *  tracking is thread-safe, 'budget_exceeded_delegate' and 'budget_threshold' should be set upfront.
+ */
+class MemoryTracker
+{
+public:
+    //! usage and budget for a memory-heap
+    struct heap_stats_t
+    {
+        uint32_t heap_index = 0;
+        VkMemoryHeapFlags flags = 0;
+
+        //! total size of the heap in bytes
+        VkDeviceSize size = 0;
+
+        //! current usage and budget, including other processes
+        VkDeviceSize usage = 0;
+        VkDeviceSize budget = 0;
+
+        //! number of bytes allocated in VkDeviceMemory-blocks by this process
+        VkDeviceSize block_bytes = 0;
+
+        //! number of bytes in tracked allocations, per MemoryCategory
+        std::array<VkDeviceSize, static_cast<uint32_t>(MemoryCategory::MAX_ENUM)> category_bytes = {};
+    };
+
+    //! live allocations for a MemoryCategory
+    struct category_stats_t
+    {
+        VkDeviceSize num_bytes = 0;
+        uint64_t num_allocations = 0;
+    };
+
+    using budget_exceeded_fn_t = std::function<void(const heap_stats_t &heap_stats)>;
+
+    explicit MemoryTracker(VmaAllocator allocator);
+
+    MemoryTracker(const MemoryTracker &) = delete;
+
+    MemoryTracker &operator=(const MemoryTracker &) = delete;
+
+    /**
+     * @brief   add registers a live allocation.
+     *
+     * @param   category    the MemoryCategory to account the allocation for
+     * @param   allocation  a valid VmaAllocation
+     */
+    void add(MemoryCategory category, VmaAllocation allocation);
+
+    /**
+     * @brief   remove unregisters an allocation, before it is freed.
+     *
+     * @param   category    the MemoryCategory used to register the allocation
+     * @param   allocation  a valid VmaAllocation
+     */
+    void remove(MemoryCategory category, VmaAllocation allocation);
+
+    /**
+     * @return  live allocations for a MemoryCategory, across all heaps.
+     */
+    [[nodiscard]] category_stats_t stats(MemoryCategory category) const;
+
+    /**
+     * @return  number of live bytes for a MemoryCategory in a memory-heap.
+     */
+    [[nodiscard]] VkDeviceSize num_bytes(MemoryCategory category, uint32_t heap_index) const;
+
+    /**
+     * @return  usage and budget for all memory-heaps.
+     */
+    [[nodiscard]] std::vector<heap_stats_t> heap_stats() const;
+
+    /**
+     * @brief   update refreshes budgets and invokes 'budget_exceeded_delegate' for heaps exceeding the threshold.
+     */
+    void update();
+
+    //! invoked during 'update' for each heap with usage > budget_threshold * budget
+    budget_exceeded_fn_t budget_exceeded_delegate;
+
+    //! fraction of a heap's budget considered exceeded
+    float budget_threshold = 0.9f;
+
+private:
+    static constexpr uint32_t num_categories = static_cast<uint32_t>(MemoryCategory::MAX_ENUM);
+
+    VmaAllocator m_allocator = VK_NULL_HANDLE;
+
+    //! memory-types and -heaps
+    VkPhysicalDeviceMemoryProperties m_memory_properties = {};
+
+    //! live bytes per category and heap
+    std::array<std::array<std::atomic<VkDeviceSize>, VK_MAX_MEMORY_HEAPS>, num_categories> m_num_bytes = {};
+
+    std::array<std::atomic<uint64_t>, num_categories> m_num_allocations = {};
+
+    std::atomic<uint32_t> m_frame_index = 0;
+};
+
+}// namespace vierkant
@@ -8,6 +8,7 @@
 #include "vierkant/Device.hpp"
 #include "vierkant/Geometry.hpp"
 #include "vierkant/Material.hpp"
+#include "vierkant/UploadQueue.hpp"
 #include <vierkant/intersection.hpp>
 #include <vierkant/transform.hpp>
 #include <vierkant/vertex_attrib.hpp>
@@ -83,6 +84,13 @@ struct mesh_buffer_params_t
     //! cone-weight used during meshlet-generation. useful for cluster-culling
     float meshlet_cone_weight = 0.5f;
 
+    //! flag indicating if a hierarchical cluster-lod (DAG of meshlet-groups) shall be generated.
+    //! requires 'generate_meshlets'
+    bool generate_cluster_lods = false;
+
+    //! number of neighboring meshlets grouped and simplified together during cluster-lod generation
+    uint32_t cluster_lod_group_size = 8;
+
     bool operator==(const mesh_buffer_params_t &other) const = default;
 };
 
@@ -118,6 +126,9 @@ public:
         vierkant::BufferPtr staging_buffer = nullptr;
         VkBufferUsageFlags buffer_usage_flags = 0;
         mesh_buffer_params_t mesh_buffer_params = {};
+
+        //! optional UploadQueue. if provided, uploads are scheduled asynchronously and 'command_buffer' is unused
+        vierkant::UploadQueuePtr upload_queue = nullptr;
     };
 
     struct entry_create_info_t
@@ -152,6 +163,10 @@ public:
 
         std::vector<lod_t> lods;
 
+        //! optional range of meshlets forming a hierarchical cluster-lod, see Mesh::meshlet_lods
+        uint32_t base_cluster_meshlet = 0;
+        uint32_t num_cluster_meshlets = 0;
+
         uint32_t material_index = 0;
         VkPrimitiveTopology primitive_type = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
         uint32_t morph_vertex_offset = 0;
@@ -178,6 +193,21 @@ public:
         vierkant::Sphere bounding_sphere;
     };
 
+    //! lod-information for a meshlet, parallel to meshlets. allows selecting a cut through a cluster-lod DAG
+    struct alignas(16) meshlet_lod_t
+    {
+        //! bounds of the group this meshlet was generated from and of the group consuming it
+        vierkant::Sphere bounds;
+        vierkant::Sphere parent_bounds;
+
+        //! simplification-errors for bounds (0 for leaves) and parent_bounds (max-error for roots)
+        float error = 0.f;
+        float parent_error = std::numeric_limits<float>::max();
+
+        //! DAG-level, 0 for full-resolution meshlets
+        uint32_t level = 0;
+    };
+
     static MeshPtr create();
 
     /**
@@ -269,6 +299,9 @@ public:
     //! micro-indices into meshlet_vertices
     vierkant::BufferPtr meshlet_triangles;
 
+    //! optional lod-information for meshlets (meshlet_lod_t)
+    vierkant::BufferPtr meshlet_lods;
+
 private:
     Mesh() = default;
 };
@@ -309,6 +342,9 @@ struct mesh_buffer_bundle_t
 
     //! micro-indices into meshlet_vertices, referenced by meshlets
     std::vector<uint8_t> meshlet_triangles;
+
+    //! optional lod-information for meshlets, parallel to meshlets
+    std::vector<Mesh::meshlet_lod_t> meshlet_lods;
 };
 
 /**
@@ -64,6 +64,11 @@ public:
      */
     [[nodiscard]] VkPipelineLayout layout() const{ return m_pipeline_layout; }
 
+    /**
+     * @return  creation-feedback reported by the driver, e.g. indicating a VkPipelineCache-hit
+     */
+    [[nodiscard]] const VkPipelineCreationFeedback &creation_feedback() const{ return m_creation_feedback; }
+
 private:
 
     Pipeline(DevicePtr device, VkPipelineLayout pipeline_layout, VkPipelineBindPoint bind_point, VkPipeline pipeline);
@@ -75,6 +80,8 @@ private:
     VkPipelineBindPoint m_bind_point = VK_PIPELINE_BIND_POINT_MAX_ENUM;
 
     VkPipeline m_pipeline = VK_NULL_HANDLE;
+
+    VkPipelineCreationFeedback m_creation_feedback = {};
 };
 
 }//namespace vierkant
\ No newline at end of file
@@ -4,9 +4,15 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <filesystem>
 #include <shared_mutex>
 #include <unordered_map>
+#include <crocore/ThreadPoolClassic.hpp>
 #include "vierkant/Pipeline.hpp"
+#include "vierkant/pipeline_manifest.hpp"
 
 namespace vierkant
 {
@@ -20,17 +26,43 @@ class PipelineCache
 {
 public:
 
+    //! statistics for pipeline-lookups and -creation
+    struct stats_t
+    {
+        //! number of lookups served by already created pipelines
+        uint64_t num_hits = 0;
+
+        //! number of lookups requiring a pipeline-creation
+        uint64_t num_misses = 0;
+
+        //! number of created pipelines the driver reported as VkPipelineCache-hits
+        uint64_t num_vk_cache_hits = 0;
+
+        //! accumulated duration of pipeline-creation
+        std::chrono::nanoseconds creation_duration = {};
+
+        //! size of initial VkPipelineCache-data, loaded from file
+        size_t num_loaded_bytes = 0;
+
+        //! number of pipelines created by 'precompile'
+        uint64_t num_precompiled = 0;
+    };
+
     /**
      * @brief   Create a shared PipelineCache
      *
-     * @param   device  handle for the vierkant::Device to create the pipelines with
+     * @param   device      handle for the vierkant::Device to create the pipelines with
+     * @param   cache_path  optional path to a file used to initialize the VkPipelineCache and to store it on shutdown.
+     *                      data from other devices or drivers is rejected.
      * @return  the newly created PipelineCachePtr
      */
-    static PipelineCachePtr create(vierkant::DevicePtr device)
+    static PipelineCachePtr create(vierkant::DevicePtr device, std::filesystem::path cache_path = {})
     {
-        return PipelineCachePtr(new PipelineCache(std::move(device)));
+        return PipelineCachePtr(new PipelineCache(std::move(device), std::move(cache_path)));
     };
 
+    ~PipelineCache();
+
     PipelineCache(const PipelineCache &) = delete;
 
     PipelineCache(PipelineCache &&) = delete;
@@ -122,6 +154,51 @@ public:
         return shader_stage_it->second;
     }
 
+    /**
+     * @brief   save stores the VkPipelineCache into a file. the file is written to a temporary location and renamed,
+     *          so concurrent readers never observe partial files. failures are logged, no exceptions are thrown.
+     *
+     * @param   path    optional output-path, defaults to the path provided on construction
+     * @return  true, if the file was written successfully
+     */
+    bool save(const std::filesystem::path &path = {}) const;
+
+    /**
+     * @brief   merge combines the VkPipelineCache of another PipelineCache into this one,
+     *          e.g. from caches used by other threads or renderers.
+     *
+     * @param   other   another PipelineCache created for the same device
+     */
+    void merge(const PipelineCachePtr &other);
+
+    /**
+     * @brief   manifest returns a record of all pipeline-keys created by this cache so far.
+     *          keys referencing unknown descriptor-set-layouts or base-pipelines are not recorded.
+     *
+     * @return  a pipeline_manifest_t, e.g. to be stored via 'save_pipeline_manifest'
+     */
+    [[nodiscard]] pipeline_manifest_t manifest() const;
+
+    /**
+     * @brief   precompile creates all pipelines recorded in a manifest, which are not already contained.
+     *          subsequent lookups with keys sharing shader-code and set-layout definitions will not compile.
+     *
+     * @param   manifest    a pipeline_manifest_t
+     * @param   pool        optional threadpool used for parallel pipeline-creation
+     * @return  number of created pipelines
+     */
+    size_t precompile(const pipeline_manifest_t &manifest, crocore::ThreadPoolClassic *pool = nullptr);
+
+    /**
+     * @return  the managed VkPipelineCache
+     */
+    [[nodiscard]] VkPipelineCache handle() const { return m_pipeline_cache; }
+
+    /**
+     * @return  statistics for pipeline-lookups and -creation
+     */
+    [[nodiscard]] stats_t stats() const;
+
     void clear()
     {
         {
@@ -140,7 +217,26 @@ public:
 
 private:
 
-    explicit PipelineCache(vierkant::DevicePtr device) : m_device(std::move(device)){}
+    PipelineCache(vierkant::DevicePtr device, std::filesystem::path cache_path);
+
+    template<typename FMT_T>
+    inline PipelinePtr create_pipeline(FMT_T format)
+    {
+        format.pipeline_cache = m_pipeline_cache;
+
+        auto start_time = std::chrono::steady_clock::now();
+        auto new_pipeline = Pipeline::create(m_device, std::move(format));
+        m_creation_duration += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                       std::chrono::steady_clock::now() - start_time)
+                                       .count();
+
+        if(new_pipeline && (new_pipeline->creation_feedback().flags &
+                            VK_PIPELINE_CREATION_FEEDBACK_APPLICATION_PIPELINE_CACHE_HIT_BIT))
+        {
+            m_num_vk_cache_hits++;
+        }
+        return new_pipeline;
+    }
 
     template<typename FMT_T>
     inline const PipelinePtr &retrieve_pipeline(const FMT_T &format,
@@ -153,21 +249,57 @@ private:
             auto it = map.find(format);
 
             // found
-            if(it != map.end()){ return it->second; }
+            if(it != map.end())
+            {
+                m_num_hits++;
+                return it->second;
+            }
         }
 
-        auto modified_format = format;
-        modified_format.pipeline_cache = m_pipeline_cache;
+        // keys sharing shader-code and set-layout definitions map to the same pipeline, e.g. a precompiled one
+        auto key = format;
+        bool recordable = canonicalize(key);
+        {
+            std::unique_lock lock(mutex);
+            if(auto it = map.find(key); it != map.end())
+            {
+                m_num_hits++;
+                auto pipeline = it->second;
+                return map.insert(std::make_pair(format, std::move(pipeline))).first->second;
+            }
+        }
 
         // not found -> create pipeline
-        auto new_pipeline = Pipeline::create(m_device, std::move(modified_format));
+        auto new_pipeline = create_pipeline(key);
+        m_num_misses++;
+        if(recordable) { record(key); }
 
         // write-locked for insertion
         std::unique_lock write_lock(mutex);
+        map.insert(std::make_pair(std::move(key), new_pipeline));
         auto pipe_it = map.insert(std::make_pair(format, std::move(new_pipeline))).first;
         return pipe_it->second;
     }
 
+    //! replace shader-code and set-layouts by canonical instances, returns true if the key can be recorded
+    bool canonicalize(graphics_pipeline_info_t &format);
+    bool canonicalize(raytracing_pipeline_info_t &format);
+    bool canonicalize(compute_pipeline_info_t &format);
+
+    const uint32_t *canonical_code(const uint32_t *code, size_t num_bytes);
+    bool canonical_set_layouts(std::vector<VkDescriptorSetLayout> &set_layouts);
+    VkDescriptorSetLayout canonical_set_layout(const descriptor_set_layout_desc_t &desc);
+
+    //! add canonical keys to the manifest
+    void record(const graphics_pipeline_info_t &format);
+    void record(const raytracing_pipeline_info_t &format);
+    void record(const compute_pipeline_info_t &format);
+    pipeline_manifest_t::pipeline_t record_common(VkPipelineBindPoint bind_point,
+                                                  const std::vector<VkDescriptorSetLayout> &set_layouts,
+                                                  const std::vector<VkPushConstantRange> &push_constant_ranges,
+                                                  const std::optional<pipeline_specialization> &specialization);
+    pipeline_manifest_t::shader_t record_shader(VkShaderStageFlagBits stage, const shader_module_t &shader_module);
+
     template<typename FMT_T>
     inline bool has(const std::unordered_map<FMT_T, PipelinePtr> &map,
                     std::shared_mutex &mutex,
@@ -193,5 +325,25 @@ private:
     std::unordered_map<vierkant::ShaderType, vierkant::shader_stage_map_t> m_shader_stages;
 
     VkPipelineCache m_pipeline_cache = VK_NULL_HANDLE;
+
+    std::filesystem::path m_cache_path;
+
+    size_t m_num_loaded_bytes = 0;
+
+    std::atomic<uint64_t> m_num_hits = 0, m_num_misses = 0, m_num_vk_cache_hits = 0, m_creation_duration = 0;
+    std::atomic<uint64_t> m_num_precompiled = 0;
+
+    //! canonical shader-code and set-layouts, keyed by content
+    mutable std::shared_mutex m_canonical_mutex;
+    std::unordered_multimap<uint64_t, std::pair<const uint32_t *, size_t>> m_code_hashes;
+    std::deque<std::vector<uint32_t>> m_owned_codes;
+    std::unordered_map<descriptor_set_layout_desc_t, DescriptorSetLayoutPtr> m_canonical_set_layouts;
+    std::deque<std::vector<VkFormat>> m_owned_attachment_formats;
+
+    //! recorded pipeline-keys
+    mutable std::mutex m_manifest_mutex;
+    pipeline_manifest_t m_manifest;
+    std::unordered_map<const uint32_t *, uint32_t> m_manifest_codes;
+    std::unordered_map<descriptor_set_layout_desc_t, uint32_t> m_manifest_set_layouts;
 };
 }
\ No newline at end of file
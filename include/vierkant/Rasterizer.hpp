@@ -4,9 +4,11 @@
 
 #pragma once
 
+#include <atomic>
 #include <mutex>
 
 #include "vierkant/Camera.hpp"
+#include "vierkant/FrameArena.hpp"
 #include "vierkant/Framebuffer.hpp"
 #include "vierkant/Material.hpp"
 #include "vierkant/Mesh.hpp"
@@ -29,7 +31,9 @@ using double_millisecond_t = std::chrono::duration<double, std::milli>;
  *  Required resources like descriptor-sets and uniform-buffers will be created
  *  and kept alive, depending on the requested number of in-flight (pending) frames.
  *
- *  Renderer is NOT thread-safe, with the exception of stage_drawables(...).
+ *  Renderer is NOT thread-safe, with the exception of stage_drawable(s)(...).
+ *  Staging is lock-free: each call pushes a batch of drawables, which are collected by the next call to render.
+ *  Batches are ordered by an optional order-key, ties keep their staging-order.
  */
 class Rasterizer
 {
@@ -142,6 +146,23 @@ public:
         vierkant::BufferPtr draw_command_indices;
     };
 
+    //! statistics for draw-batching of a frame
+    struct batch_stats_t
+    {
+        //! duration for computing sort-keys and sorting
+        double_millisecond_t sort_time = {};
+
+        //! number of drawables and resulting draw-batches
+        uint32_t num_drawables = 0;
+        uint32_t num_batches = 0;
+
+        //! recorded draw-calls and binds
+        uint32_t num_draw_calls = 0;
+        uint32_t num_pipeline_binds = 0;
+        uint32_t num_descriptor_binds = 0;
+        uint32_t num_mesh_binds = 0;
+    };
+
     //! define syntax for a culling-delegate
     using indirect_draw_delegate_t = std::function<void(indirect_draw_bundle_t &)>;
 
@@ -153,6 +174,7 @@ public:
         VkSampleCountFlagBits sample_count = VK_SAMPLE_COUNT_1_BIT;
         bool indirect_draw = false;
         bool enable_mesh_shader = false;
+        bool use_bindless = false;
         vierkant::PipelineCachePtr pipeline_cache = nullptr;
         vierkant::CommandPoolPtr command_pool = nullptr;
         vierkant::DescriptorPoolPtr descriptor_pool = nullptr;
@@ -201,6 +223,11 @@ public:
     //! option to use a meshlet-based pipeline
     bool use_mesh_shader = false;
 
+    //! option to bind descriptors once per batch of merged draws (requires indirect_draw).
+    //! unique descriptor-sets of a frame are packed into a descriptor-buffer (VK_EXT_descriptor_buffer),
+    //! bound once per frame. falls back to descriptor-indexing. no persistent, id-indexed descriptor-heaps.
+    bool use_bindless = false;
+
     //! option to write gpu-timestamps
     bool use_gpu_timestamps = true;
 
@@ -228,19 +255,26 @@ public:
 
     Rasterizer &operator=(Rasterizer other);
 
+    ~Rasterizer();
+
     /**
      * @brief   Stage a drawable to be rendered.
      *
      * @param   drawable    a drawable_t object.
+     * @param   order_key   optional key, used to order staged drawables
      */
-    void stage_drawable(drawable_t drawable);
+    void stage_drawable(drawable_t drawable, uint64_t order_key = 0);
 
     /**
      * @brief   Stage an ordered sequence of drawables to be rendered.
      *
-     * @param   drawables    a sequence of drawable_t objects.
+     *          concurrent producers should pass distinct order-keys (e.g. a job-index),
+     *          to achieve a reproducible order of drawables.
+     *
+     * @param   drawables   a sequence of drawable_t objects.
+     * @param   order_key   optional key, used to order staged drawables
      */
-    void stage_drawables(const std::span<drawable_t> &drawables);
+    void stage_drawables(const std::span<drawable_t> &drawables, uint64_t order_key = 0);
 
     /**
      * @brief   Records drawing-commands for all staged drawables into a secondary VkCommandBuffer.
@@ -282,6 +316,14 @@ public:
      */
     [[nodiscard]] double_millisecond_t last_frame_ms() const { return m_frame_assets[m_current_index].frame_time; }
 
+    /**
+     * @return  draw-batching statistics for the last rendered frame.
+     */
+    [[nodiscard]] const batch_stats_t &batch_stats() const
+    {
+        return m_frame_assets[(m_current_index + m_frame_assets.size() - 1) % m_frame_assets.size()].batch_stats;
+    }
+
     /**
      * @brief   Release all cached rendering assets.
      */
@@ -289,6 +331,11 @@ public:
 
     [[nodiscard]] const vierkant::DevicePtr &device() const { return m_device; }
 
+    /**
+     * @return  the arena used for transient allocations while recording a frame.
+     */
+    [[nodiscard]] const vierkant::FrameArenaPtr &frame_arena() const { return m_frame_arena; }
+
     friend void swap(Rasterizer &lhs, Rasterizer &rhs) noexcept;
 
 private:
@@ -318,6 +365,10 @@ private:
         std::unordered_map<descriptor_map_t, DescriptorSetLayoutPtr> descriptor_set_layouts;
         descriptor_set_map_t descriptor_sets;
 
+        // bindless: set-layouts and host-visible descriptor-buffer (VK_EXT_descriptor_buffer)
+        std::unordered_map<descriptor_map_t, DescriptorSetLayoutPtr> descriptor_buffer_set_layouts;
+        vierkant::BufferPtr descriptor_buffer;
+
         // SSBOs containing everything (using gpu-mem iff a queue was provided)
         vierkant::BufferPtr vertex_buffer_refs;
         vierkant::BufferPtr mesh_draw_buffer;
@@ -340,6 +391,8 @@ private:
         vierkant::QueryPoolPtr query_pool;
         bool acquire_timestamps = false;
         double_millisecond_t frame_time;
+
+        batch_stats_t batch_stats;
     };
 
     //! internal rendering-workhorse, creating assets and recording drawing-commands
@@ -364,11 +417,25 @@ private:
 
     vierkant::DescriptorPoolPtr m_descriptor_pool;
 
-    std::vector<std::vector<drawable_t>> m_staged_drawables;
+    //! node in an intrusive list of staged drawables
+    struct staging_batch_t
+    {
+        //! single drawables are stored inline, avoiding another allocation
+        std::optional<drawable_t> drawable;
+        std::vector<drawable_t> drawables;
+        uint64_t order_key = 0;
+        staging_batch_t *next = nullptr;
+    };
 
-    std::vector<frame_assets_t> m_frame_assets;
+    //! push a batch onto the staging-list (multi-producer, lock-free)
+    void stage_batch(staging_batch_t *batch);
+
+    //! take all staged batches, in staging-order
+    std::vector<std::unique_ptr<staging_batch_t>> collect_batches();
 
-    std::mutex m_staging_mutex;
+    std::atomic<staging_batch_t *> m_staging_head = nullptr;
+
+    std::vector<frame_assets_t> m_frame_assets;
 
     uint32_t m_current_index = 0;
 
@@ -379,6 +446,9 @@ private:
     std::default_random_engine m_random_engine;
 
     uint32_t m_mesh_task_count = 0;
+
+    //! transient allocations while recording a frame, reset for each frame
+    vierkant::FrameArenaPtr m_frame_arena;
 };
 
 }//namespace vierkant
\ No newline at end of file
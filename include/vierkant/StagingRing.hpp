@@ -0,0 +1,172 @@
+#pragma once
+
+#include <deque>
+#include <mutex>
+
+#include <vierkant/Buffer.hpp>
+#include <vierkant/Image.hpp>
+#include <vierkant/Semaphore.hpp>
+
+namespace vierkant
+{
+
+DEFINE_CLASS_PTR(StagingRing)
+
+/**
+ * @brief   StagingRing is a persistently mapped, host-visible ring-buffer used to stage uploads.
+ *
+ *  Sub-allocations are handed out linearly and reclaimed in order, once the GPU has signaled
+ *  an internal timeline-semaphore. Uploads are only recorded into provided command-buffers,
+ *  neither allocations nor waits are performed per upload.
+ *
+ *  usage per submission:
+ *  - record copies via 'upload' (or use 'allocate' and record copies manually)
+ *  - call 'retire' and pass the returned semaphore_submit_info_t to the submission using the copies
+ *
+ *  StagingRing is meant to be used by a single producer: while individual calls are internally synchronized,
+ *  'retire' covers all allocations since the previous call, regardless of the allocating thread.
+ *  multiple threads need to serialize their allocate/retire-sequences (see UploadQueue) or use separate rings.
+ */
+class StagingRing
+{
+public:
+    //! least common multiple of all texel-/block-sizes (1, 2, 3, 4, 6, 8, 12, 16), valid for buffer->image copies
+    static constexpr size_t image_copy_alignment = 48;
+
+    struct create_info_t
+    {
+        vierkant::DevicePtr device;
+
+        //! total capacity in bytes
+        size_t num_bytes = 1UL << 26;
+
+        //! optional debug-name for the underlying buffer
+        std::string name = "StagingRing";
+    };
+
+    //! a sub-allocation inside the ring
+    struct allocation_t
+    {
+        //! the ring's staging-buffer
+        vierkant::BufferPtr buffer;
+
+        //! offset in bytes into 'buffer'
+        VkDeviceSize offset = 0;
+
+        //! mapped host-memory at 'offset'
+        void *data = nullptr;
+
+        VkDeviceSize num_bytes = 0;
+
+        inline explicit operator bool() const { return data; }
+    };
+
+    /**
+     * @brief   Create a new StagingRing.
+     *
+     * @param   create_info a create_info_t struct
+     * @return  a StagingRingPtr, nullptr if no host-visible memory could be allocated.
+     */
+    static StagingRingPtr create(const create_info_t &create_info);
+
+    StagingRing(const StagingRing &) = delete;
+
+    StagingRing &operator=(const StagingRing &) = delete;
+
+    /**
+     * @brief   allocate sub-allocates a range of the staging-buffer.
+     *          ranges retired earlier are reclaimed if the GPU has signaled their completion (non-blocking).
+     *
+     * @param   num_bytes   number of bytes to allocate
+     * @param   alignment   required alignment of the returned offset, not required to be a power of two
+     * @return  an allocation_t, evaluating to false if not enough space was available.
+     */
+    allocation_t allocate(size_t num_bytes, size_t alignment = 16);
+
+    /**
+     * @brief   upload stages data and records a copy into a buffer. the destination is not resized.
+     *
+     * @param   command_buffer  a command-buffer in recording state
+     * @param   data            pointer to data to upload
+     * @param   num_bytes       number of bytes to upload
+     * @param   dst             destination-buffer, holding at least 'dst_offset + num_bytes' bytes
+     * @param   dst_offset      offset in bytes into the destination-buffer
+     * @return  true, if the copy was recorded. false, if the ring did not have enough space or dst is too small.
+     */
+    bool upload(VkCommandBuffer command_buffer, const void *data, size_t num_bytes, const vierkant::BufferPtr &dst,
+                size_t dst_offset = 0);
+
+    /**
+     * @brief   upload stages data and records a copy into an image.
+     *
+     * @param   command_buffer  a command-buffer in recording state
+     * @param   data            pointer to data to upload
+     * @param   num_bytes       number of bytes to upload
+     * @param   dst             destination-image
+     * @param   img_offset      the image-offset used for the copy operation
+     * @param   extent          the extent of the region to copy, defaults to the (mip-level's) image-extent
+     * @param   layer           the target layer in the image
+     * @param   level           the target mip-level in the image
+     * @return  true, if the copy was recorded. false, if the ring did not have enough space.
+     */
+    bool upload(VkCommandBuffer command_buffer, const void *data, size_t num_bytes, const vierkant::ImagePtr &dst,
+                VkOffset3D img_offset = {0, 0, 0}, VkExtent3D extent = {0, 0, 0}, uint32_t layer = 0,
+                uint32_t level = 0);
+
+    /**
+     * @brief   retire marks all allocations since the last call as in-flight, including those made by other threads.
+     *          the returned semaphore-info needs to be passed to the submission consuming those allocations.
+     *
+     * @param   signal_stage    pipeline-stage to signal the timeline-semaphore from.
+     * @return  a semaphore_submit_info_t, signaling completion of retired allocations.
+     */
+    vierkant::semaphore_submit_info_t
+    retire(VkPipelineStageFlags2 signal_stage = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT);
+
+    /**
+     * @return  total capacity in bytes.
+     */
+    [[nodiscard]] size_t num_bytes() const { return m_num_bytes; }
+
+    /**
+     * @return  number of bytes currently allocated or in-flight.
+     */
+    [[nodiscard]] size_t num_bytes_used() const;
+
+    /**
+     * @return  the timeline-semaphore used for reclamation.
+     */
+    [[nodiscard]] const vierkant::Semaphore &semaphore() const { return m_semaphore; }
+
+private:
+    explicit StagingRing(const create_info_t &create_info);
+
+    //! release all ranges with signaled timeline-values. requires a locked mutex
+    void reclaim();
+
+    //! monotonic end-position of a retired range, paired with the timeline-value signaling its completion
+    struct retired_range_t
+    {
+        uint64_t end = 0;
+        uint64_t timeline_value = 0;
+    };
+
+    vierkant::BufferPtr m_buffer;
+
+    uint8_t *m_data = nullptr;
+
+    size_t m_num_bytes = 0;
+
+    //! monotonic positions for next allocation and oldest range still in use
+    uint64_t m_head = 0, m_tail = 0;
+
+    vierkant::Semaphore m_semaphore;
+
+    uint64_t m_timeline_value = 0;
+
+    std::deque<retired_range_t> m_retired_ranges;
+
+    mutable std::mutex m_mutex;
+};
+
+}// namespace vierkant
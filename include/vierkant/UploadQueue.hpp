@@ -0,0 +1,215 @@
+#pragma once
+
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <vierkant/CommandBuffer.hpp>
+#include <vierkant/StagingRing.hpp>
+
+namespace vierkant
+{
+
+DEFINE_CLASS_PTR(UploadQueue)
+
+/**
+ * @brief   UploadQueue batches buffer- and image-uploads onto the dedicated transfer-queue.
+ *
+ *  - uploads are staged from a StagingRing and recorded into an open batch, nothing is submitted per upload.
+ *  - 'flush' submits the open batch to the transfer-queue, signaling a timeline-semaphore.
+ *  - queue-family ownership is released on the transfer-queue and acquired by the consumer via 'acquire',
+ *    which also generates pending mipmap-chains (blits are not available on transfer-queues).
+ *  - each upload returns a handle, referring to the timeline-value signaled by its batch.
+ *
+ *  destination-resources are expected to be freshly created: buffers without pending GPU-work,
+ *  images with an undefined layout (Image::Format::initial_layout_transition = false).
+ *  all levels and layers of an image should be uploaded before calling 'flush'.
+ *
+ *  typical usage per frame on the render-thread:
+ *  - auto wait_info = upload_queue->acquire(command_buffer);
+ *  - pass 'wait_info' to the submission of 'command_buffer'
+ *
+ *  UploadQueue is thread-safe. loader-threads only block if the staging-ring is exhausted.
+ */
+class UploadQueue
+{
+public:
+    struct create_info_t
+    {
+        vierkant::DevicePtr device;
+
+        //! capacity in bytes for the internal staging-ring
+        size_t staging_num_bytes = 1UL << 26;
+
+        //! queue-type consuming uploaded resources (and calling 'acquire')
+        vierkant::Device::Queue dst_queue_type = vierkant::Device::Queue::GRAPHICS;
+    };
+
+    //! completion-handle for an upload, refers to a timeline-value of the UploadQueue's semaphore
+    struct handle_t
+    {
+        uint64_t value = 0;
+
+        inline explicit operator bool() const { return value; }
+    };
+
+    /**
+     * @brief   Create a new UploadQueue.
+     *
+     * @param   create_info a create_info_t struct
+     * @return  an UploadQueuePtr, nullptr if no staging-memory could be allocated.
+     */
+    static UploadQueuePtr create(const create_info_t &create_info);
+
+    UploadQueue(const UploadQueue &) = delete;
+
+    UploadQueue &operator=(const UploadQueue &) = delete;
+
+    ~UploadQueue();
+
+    /**
+     * @brief   upload schedules a copy into a buffer. the destination is not resized.
+     *
+     * @param   dst         destination-buffer, requires VK_BUFFER_USAGE_TRANSFER_DST_BIT
+     *                      and at least 'dst_offset + num_bytes' bytes
+     * @param   data        pointer to data to upload, copied before returning
+     * @param   num_bytes   number of bytes to upload
+     * @param   dst_offset  offset in bytes into the destination-buffer
+     * @return  a handle for the upload, or an invalid handle if the destination is too small.
+     */
+    handle_t upload(const vierkant::BufferPtr &dst, const void *data, size_t num_bytes, size_t dst_offset = 0);
+
+    /**
+     * @brief   upload schedules a copy into an image-level.
+     *          if the image uses autogenerated mipmaps, the chain is generated from level 0 during 'acquire'.
+     *
+     * @param   dst             destination-image, requires VK_IMAGE_USAGE_TRANSFER_DST_BIT
+     * @param   data            pointer to data to upload, copied before returning
+     * @param   num_bytes       number of bytes to upload, must not exceed the target layer/level
+     * @param   layer           the target layer in the image
+     * @param   level           the target mip-level in the image
+     * @param   final_layout    layout for the image, once the upload has completed
+     * @return  a handle for the upload, or an invalid handle if the target-subresource is exceeded.
+     */
+    handle_t upload(const vierkant::ImagePtr &dst, const void *data, size_t num_bytes, uint32_t layer = 0,
+                    uint32_t level = 0, VkImageLayout final_layout = VK_IMAGE_LAYOUT_READ_ONLY_OPTIMAL);
+
+    /**
+     * @brief   flush submits the open batch to the transfer-queue (non-blocking).
+     *
+     * @return  a handle for the submitted batch, or for the most recent one if no uploads were pending.
+     */
+    handle_t flush();
+
+    /**
+     * @brief   acquire records ownership-acquisition and pending mipmap-generation
+     *          for all batches submitted since the last call.
+     *
+     * @param   command_buffer  a command-buffer in recording state, submitted to a queue of type 'dst_queue_type'
+     * @param   dst_stage       pipeline-stages consuming uploaded resources
+     * @return  a semaphore_submit_info_t, to be waited on by the submission of 'command_buffer'.
+     *          contains a null-semaphore if no batches were submitted since the last call.
+     */
+    vierkant::semaphore_submit_info_t acquire(VkCommandBuffer command_buffer,
+                                              VkPipelineStageFlags2 dst_stage = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT);
+
+    /**
+     * @return  true, if the transfer-batch containing the upload has completed.
+     */
+    [[nodiscard]] bool complete(handle_t handle) const;
+
+    /**
+     * @brief   wait performs a blocking wait for an upload, flushing its batch if necessary.
+     *          not intended to be used from the render-thread.
+     */
+    void wait(handle_t handle);
+
+    /**
+     * @return  the vierkant::Device used by this UploadQueue.
+     */
+    [[nodiscard]] const vierkant::DevicePtr &device() const { return m_device; }
+
+    /**
+     * @return  the timeline-semaphore signaled by submitted batches.
+     */
+    [[nodiscard]] const vierkant::Semaphore &semaphore() const { return m_semaphore; }
+
+    /**
+     * @return  the staging-ring used by this UploadQueue.
+     */
+    [[nodiscard]] const vierkant::StagingRingPtr &staging_ring() const { return m_staging_ring; }
+
+private:
+    //! per-image state in an open batch
+    struct image_upload_t
+    {
+        VkImageLayout final_layout = VK_IMAGE_LAYOUT_READ_ONLY_OPTIMAL;
+        bool generate_mipmaps = false;
+    };
+
+    //! a batch of uploads, recorded into a single command-buffer
+    struct batch_t
+    {
+        vierkant::CommandBuffer command_buffer;
+        uint64_t value = 0;
+
+        //! dedicated staging-buffers for uploads exceeding the staging-ring
+        std::vector<vierkant::BufferPtr> staging_buffers;
+
+        std::unordered_set<vierkant::BufferPtr> buffers;
+        std::unordered_map<vierkant::ImagePtr, image_upload_t> images;
+    };
+
+    //! pending ownership-acquisition for a submitted batch
+    struct acquire_t
+    {
+        uint64_t value = 0;
+        std::vector<VkBufferMemoryBarrier2> buffer_barriers;
+        std::vector<VkImageMemoryBarrier2> image_barriers;
+        std::vector<vierkant::ImagePtr> mipmap_images;
+
+        //! keep resources alive until acquired
+        std::vector<vierkant::BufferPtr> buffers;
+        std::vector<vierkant::ImagePtr> images;
+    };
+
+    explicit UploadQueue(const create_info_t &create_info);
+
+    //! return the open batch, beginning a new one if necessary. requires a locked mutex
+    batch_t &open_batch();
+
+    //! allocate staging-memory, flushing and waiting for in-flight batches if necessary. requires a locked mutex
+    StagingRing::allocation_t allocate(std::unique_lock<std::mutex> &lock, size_t num_bytes, size_t alignment);
+
+    //! submit the open batch, if any. requires a locked mutex
+    void submit();
+
+    //! release command-buffers and staging-buffers of completed batches. requires a locked mutex
+    void reclaim();
+
+    vierkant::DevicePtr m_device;
+
+    vierkant::StagingRingPtr m_staging_ring;
+
+    VkQueue m_queue = VK_NULL_HANDLE;
+
+    uint32_t m_src_queue_family = 0, m_dst_queue_family = 0;
+
+    vierkant::CommandPoolPtr m_command_pool;
+
+    vierkant::Semaphore m_semaphore;
+
+    //! timeline-values for the open and the last submitted batch
+    uint64_t m_next_value = 1, m_submitted_value = 0;
+
+    std::optional<batch_t> m_batch;
+
+    std::deque<batch_t> m_in_flight;
+
+    std::vector<acquire_t> m_pending_acquires;
+
+    //! separate mutex for pending acquisitions, 'acquire' never waits for staging
+    std::mutex m_mutex, m_acquire_mutex;
+};
+
+}// namespace vierkant
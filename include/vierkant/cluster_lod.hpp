@@ -0,0 +1,112 @@
+#pragma once
+
+#include <vierkant/Mesh.hpp>
+
+namespace vierkant
+{
+
+struct cluster_lod_params_t
+{
+    //! maximum number of vertices per meshlet/cluster
+    size_t max_vertices = 64;
+
+    //! maximum number of triangles per meshlet/cluster
+    size_t max_triangles = 84;
+
+    //! cone-weight used during meshlet-generation. useful for cluster-culling
+    float cone_weight = 0.5f;
+
+    //! number of neighboring clusters merged into a group before simplification
+    uint32_t group_size = 8;
+
+    //! target index-count ratio for each group-simplification
+    float simplify_ratio = 0.5f;
+
+    //! groups not reaching this ratio during simplification are not simplified any further
+    float max_simplify_ratio = 0.85f;
+
+    //! maximum number of DAG-levels
+    uint32_t max_levels = 16;
+};
+
+/**
+ * @brief   cluster_lod_t groups a hierarchy of meshlets/clusters and corresponding lod-information.
+ *
+ *          meshlets of all levels are stored in a combined array. all arrays follow the layout used by
+ *          vierkant::mesh_buffer_bundle_t, meshlet_lods are parallel to meshlets.
+ *          meshlet_vertices are relative to the provided vertex-array.
+ */
+struct cluster_lod_t
+{
+    //! combined meshlets for all DAG-levels
+    std::vector<Mesh::meshlet_t> meshlets;
+
+    //! lod-information for each meshlet
+    std::vector<Mesh::meshlet_lod_t> meshlet_lods;
+
+    //! indices into vertex-buffer, referenced by meshlets
+    std::vector<index_t> meshlet_vertices;
+
+    //! micro-indices into meshlet_vertices, referenced by meshlets
+    std::vector<uint8_t> meshlet_triangles;
+
+    //! number of generated DAG-levels (including the full-resolution level)
+    uint32_t num_levels = 0;
+};
+
+/**
+ * @brief   create_cluster_lod generates a hierarchical cluster-lod (a DAG of meshlet-groups) for a triangle-mesh.
+ *
+ *          starting with full-resolution meshlets, neighboring clusters are merged into groups,
+ *          simplified with locked group-borders and re-split into new clusters. this is repeated until the mesh
+ *          cannot be simplified any further.
+ *          each cluster records the simplification-error/bounds of its own group and of its parent-group.
+ *          errors and bounds are monotonic along the DAG, allowing a consistent cut by screen-space error.
+ *
+ * @param   vertices        pointer to vertex-data, a position (3 floats) is expected at offset 0.
+ * @param   num_vertices    number of vertices
+ * @param   vertex_stride   vertex-stride in bytes
+ * @param   indices         pointer to triangle-list indices
+ * @param   num_indices     number of indices
+ * @param   params          a struct grouping parameters
+ * @return  a struct containing a hierarchy of meshlets and lod-information.
+ */
+cluster_lod_t create_cluster_lod(const float *vertices, size_t num_vertices, size_t vertex_stride,
+                                 const index_t *indices, size_t num_indices, const cluster_lod_params_t &params = {});
+
+/**
+ * @brief   cluster_lod_projected_error returns a screen-space error for a lod-error and its bounds.
+ *
+ * @param   bounds      bounding-sphere the error applies to
+ * @param   error       an object-space simplification-error
+ * @param   eye         eye/camera-position
+ * @param   proj_scale  a projection-dependent scale, e.g. 0.5 * viewport_height / tan(0.5 * fovy)
+ * @return  the projected error
+ */
+inline float cluster_lod_projected_error(const vierkant::Sphere &bounds, float error, const glm::vec3 &eye,
+                                         float proj_scale)
+{
+    if(error <= 0.f) { return 0.f; }
+    if(error == std::numeric_limits<float>::max()) { return error; }
+    float d = glm::length(bounds.center - eye) - bounds.radius;
+    return d > 0.f ? error * proj_scale / d : std::numeric_limits<float>::max();
+}
+
+/**
+ * @brief   cluster_lod_select can be used to determine if a cluster is part of the DAG-cut for a provided threshold.
+ *
+ * @param   meshlet_lod     lod-information for a cluster/meshlet
+ * @param   eye             eye/camera-position
+ * @param   proj_scale      a projection-dependent scale, e.g. 0.5 * viewport_height / tan(0.5 * fovy)
+ * @param   threshold       maximum tolerated screen-space error
+ * @return  true, if the cluster should be rendered.
+ */
+inline bool cluster_lod_select(const Mesh::meshlet_lod_t &meshlet_lod, const glm::vec3 &eye, float proj_scale,
+                               float threshold)
+{
+    return cluster_lod_projected_error(meshlet_lod.bounds, meshlet_lod.error, eye, proj_scale) <= threshold &&
+           cluster_lod_projected_error(meshlet_lod.parent_bounds, meshlet_lod.parent_error, eye, proj_scale) >
+                   threshold;
+}
+
+}// namespace vierkant
@@ -69,8 +69,19 @@ struct descriptor_t
 //! maps binding-indices to descriptors
 using descriptor_map_t = std::map<uint32_t, descriptor_t>;
 
-//! maps a descriptor_map_t to a shared VkDescriptorSet
-using descriptor_set_map_t = std::unordered_map<vierkant::descriptor_map_t, vierkant::DescriptorSetPtr>;
+//! a cached VkDescriptorSet, stored alongside the descriptors used to create it
+struct descriptor_set_entry_t
+{
+    //! copy of used descriptors, resources are stripped for 'relax_reuse'
+    vierkant::descriptor_map_t descriptors;
+
+    vierkant::DescriptorSetPtr descriptor_set;
+
+    bool relax_reuse = false;
+};
+
+//! maps hash-values of a descriptor_map_t (see 'descriptor_hash') to cached VkDescriptorSets
+using descriptor_set_map_t = std::unordered_multimap<uint64_t, descriptor_set_entry_t>;
 
 /**
  * @brief   Create a shared VkDescriptorPool (DescriptorPoolPtr)
@@ -82,6 +93,39 @@ using descriptor_set_map_t = std::unordered_map<vierkant::descriptor_map_t, vier
 DescriptorPoolPtr create_descriptor_pool(const vierkant::DevicePtr &device, const descriptor_count_t &counts,
                                          uint32_t max_sets);
 
+//! creation-parameters of a descriptor-set-layout, sufficient to re-create an identically defined layout
+struct descriptor_set_layout_desc_t
+{
+    VkDescriptorSetLayoutCreateFlags flags = 0;
+
+    //! layout-bindings, immutable samplers are not supported
+    std::vector<VkDescriptorSetLayoutBinding> bindings;
+
+    //! binding-flags, one per binding
+    std::vector<VkDescriptorBindingFlags> binding_flags;
+
+    bool operator==(const descriptor_set_layout_desc_t &other) const;
+};
+
+/**
+ * @brief   Create a shared VkDescriptorSetLayout (DescriptorSetLayoutPtr) for a given descriptor_set_layout_desc_t
+ *
+ * @param   device  handle for the vierkant::Device to create the DescriptorSetLayout
+ * @param   desc    a descriptor_set_layout_desc_t
+ * @return  the newly created DescriptorSetLayoutPtr
+ */
+DescriptorSetLayoutPtr create_descriptor_set_layout(const vierkant::DevicePtr &device,
+                                                    const descriptor_set_layout_desc_t &desc);
+
+/**
+ * @brief   descriptor_set_layout_desc returns the creation-parameters for a layout
+ *          created by 'create_descriptor_set_layout' and still alive.
+ *
+ * @param   set_layout  handle for a VkDescriptorSetLayout
+ * @return  creation-parameters or nullopt for unknown layouts
+ */
+std::optional<descriptor_set_layout_desc_t> descriptor_set_layout_desc(VkDescriptorSetLayout set_layout);
+
 /**
  * @brief   Create a shared VkDescriptorSetLayout (DescriptorSetLayoutPtr) for a given array of vierkant::descriptor_t
  *
@@ -115,29 +159,65 @@ DescriptorSetPtr create_descriptor_set(const vierkant::DevicePtr &device, const
 void update_descriptor_set(const vierkant::DevicePtr &device, const descriptor_map_t &descriptors,
                            const DescriptorSetPtr &descriptor_set);
 
+/**
+ * @brief   descriptor_buffer_size returns the number of bytes required to store a descriptor-set
+ *          in a descriptor-buffer.
+ *          the returned size is aligned to 'descriptorBufferOffsetAlignment'.
+ *
+ * @param   device      handle for a vierkant::Device
+ * @param   set_layout  a set-layout, created with 'use_descriptor_buffer'
+ * @return  aligned size in bytes for a descriptor-set using the provided layout.
+ */
+VkDeviceSize descriptor_buffer_size(const vierkant::DevicePtr &device, VkDescriptorSetLayout set_layout);
+
+/**
+ * @brief   descriptor_buffer_compatible checks if all descriptors can be written to a descriptor-buffer.
+ *          requires supported descriptor-types, no variable counts and buffers providing a device-address.
+ *
+ * @param   descriptors a provided descriptor-map
+ * @return  true, if the descriptors can be used with 'update_descriptor_buffer'.
+ */
+bool descriptor_buffer_compatible(const descriptor_map_t &descriptors);
+
 /**
  * @brief   Update an existing shared vierkant::Buffer, used as descriptor-buffer,
  *          with a provided array of vierkant::descriptor_t.
  *
- * @param   device          handle for the vierkant::Device to update the DescriptorSet
- * @param   descriptors     an array of descriptor_t to use for updating the descriptor-buffer
- * @param   descriptor_set  handle for a shared VkDescriptorSet to update
+ * @param   device                  handle for the vierkant::Device to update the descriptor-buffer
+ * @param   set_layout              a set-layout, created with 'use_descriptor_buffer'
+ * @param   descriptors             an array of descriptor_t to use for updating the descriptor-buffer
+ * @param   out_descriptor_buffer   a host-visible buffer, used as descriptor-buffer
+ * @param   offset                  offset in bytes into the descriptor-buffer,
+ *                                  needs to be a multiple of 'descriptorBufferOffsetAlignment'
  */
-void update_descriptor_buffer(const vierkant::DevicePtr &device, const DescriptorSetLayoutPtr &layout,
-                              const descriptor_map_t &descriptors, const vierkant::BufferPtr &out_descriptor_buffer);
+void update_descriptor_buffer(const vierkant::DevicePtr &device, VkDescriptorSetLayout set_layout,
+                              const descriptor_map_t &descriptors, const vierkant::BufferPtr &out_descriptor_buffer,
+                              VkDeviceSize offset = 0);
 
 /**
  * @brief   find_or_create_set_layout can be used to search for an existing descriptor-set-layout or create a new one.
  *          the result be will be returned and stored in a provided cache.
  *
- * @param   device      handle for a vierkant::Device to create new descriptor-set-layouts
- * @param   descriptors a provided descriptor-map
- * @param   current     output cache of retrieved/created descriptor-sets.
+ * @param   device                  handle for a vierkant::Device to create new descriptor-set-layouts
+ * @param   descriptors             a provided descriptor-map
+ * @param   current                 output cache of retrieved/created descriptor-sets.
+ * @param   use_descriptor_buffer   flag indicating if layouts are intended for use with descriptor-buffers.
+ *                                  caches must not be shared between both kinds of layouts.
  * @return  a retrieved or newly created, shared VkDescriptorSetLayout.
  */
 DescriptorSetLayoutPtr find_or_create_set_layout(const vierkant::DevicePtr &device, descriptor_map_t descriptors,
                                                  std::unordered_map<descriptor_map_t, DescriptorSetLayoutPtr> &current,
-                                                 std::unordered_map<descriptor_map_t, DescriptorSetLayoutPtr> &next);
+                                                 std::unordered_map<descriptor_map_t, DescriptorSetLayoutPtr> &next,
+                                                 bool use_descriptor_buffer = false);
+
+/**
+ * @brief   descriptor_hash computes a hash-value for a descriptor-map, without copying or allocating.
+ *
+ * @param   descriptors a provided descriptor-map
+ * @param   relax_reuse flag to ignore resources (buffers, images, acceleration-structures, inline-uniform-blocks)
+ * @return  a hash-value for the descriptor-map
+ */
+uint64_t descriptor_hash(const descriptor_map_t &descriptors, bool relax_reuse = false);
 
 /**
  * @brief   find_or_create_descriptor_set can be used to search for an existing descriptor-set or create a new one.
@@ -175,4 +255,10 @@ struct hash<vierkant::descriptor_map_t>
     size_t operator()(const vierkant::descriptor_map_t &map) const;
 };
 
+template<>
+struct hash<vierkant::descriptor_set_layout_desc_t>
+{
+    size_t operator()(const vierkant::descriptor_set_layout_desc_t &desc) const;
+};
+
 }// namespace std
\ No newline at end of file
@@ -167,6 +167,56 @@ static inline uint32_t xxhash32(const K &key, uint32_t seed)
     return h;
 }
 
+/**
+ * @brief   hash_bytes computes a 64-bit hash for an arbitrary range of bytes.
+ *          four independent lanes of 64-bit words are processed in an xxhash64-like fashion.
+ *          not suitable for cryptographic purposes.
+ *
+ * @param   data        pointer to the data
+ * @param   num_bytes   number of bytes
+ * @param   seed        an optional seed
+ * @return  a 64-bit hash-value
+ */
+inline uint64_t hash_bytes(const void *data, size_t num_bytes, uint64_t seed = 0)
+{
+    constexpr uint64_t prime_1 = 0x9E3779B185EBCA87ULL, prime_2 = 0xC2B2AE3D27D4EB4FULL;
+    constexpr uint64_t prime_3 = 0x165667B19E3779F9ULL;
+
+    auto rotl = [](uint64_t x, uint32_t r) { return (x << r) | (x >> (64 - r)); };
+    auto round = [rotl](uint64_t acc, uint64_t k) { return rotl(acc + k * prime_2, 31) * prime_1; };
+
+    auto ptr = static_cast<const uint8_t *>(data);
+    const uint8_t *end = ptr + num_bytes;
+    uint64_t h = seed + prime_3;
+
+    if(num_bytes >= 32)
+    {
+        uint64_t lanes[4] = {seed + prime_1 + prime_2, seed + prime_2, seed, seed - prime_1};
+
+        for(; ptr + 32 <= end; ptr += 32)
+        {
+            for(uint32_t i = 0; i < 4; ++i)
+            {
+                uint64_t k;
+                memcpy(&k, ptr + 8 * i, sizeof(uint64_t));
+                lanes[i] = round(lanes[i], k);
+            }
+        }
+        h = rotl(lanes[0], 1) + rotl(lanes[1], 7) + rotl(lanes[2], 12) + rotl(lanes[3], 18);
+        for(uint64_t lane: lanes) { h = (h ^ round(0, lane)) * prime_1 + prime_3; }
+    }
+    h += num_bytes;
+
+    for(; ptr + 8 <= end; ptr += 8)
+    {
+        uint64_t k;
+        memcpy(&k, ptr, sizeof(uint64_t));
+        h = rotl(h ^ round(0, k), 27) * prime_1 + prime_3;
+    }
+    for(; ptr < end; ++ptr) { h = rotl(h ^ (*ptr * prime_3), 11) * prime_1; }
+    return murmur3_fmix64(h);
+}
+
 template<class T>
 inline void hash_combine(std::size_t &seed, const T &v)
 {
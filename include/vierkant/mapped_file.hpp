@@ -0,0 +1,85 @@
+#pragma once
+
+#include <filesystem>
+#include <functional>
+#include <span>
+#include <string_view>
+
+#include <crocore/crocore.hpp>
+
+namespace vierkant
+{
+
+DEFINE_CLASS_PTR(MappedFile)
+
+/**
+ * @brief   MappedFile provides read-only access to a memory-mapped file.
+ *          the mapping stays valid for the lifetime of the object.
+ */
+class MappedFile
+{
+public:
+    /**
+     * @brief   create a read-only memory-mapping for a provided file.
+     *
+     * @param   path    path to a regular file
+     * @return  a MappedFilePtr or nullptr, if the file could not be mapped.
+     */
+    static MappedFilePtr create(const std::filesystem::path &path);
+
+    MappedFile(const MappedFile &) = delete;
+
+    MappedFile(MappedFile &&) = delete;
+
+    MappedFile &operator=(MappedFile other) = delete;
+
+    ~MappedFile();
+
+    //! pointer to the mapped bytes, nullptr for empty files
+    [[nodiscard]] const uint8_t *data() const { return m_data; }
+
+    //! size of the mapped file in bytes
+    [[nodiscard]] size_t num_bytes() const { return m_num_bytes; }
+
+    //! mapped bytes as span
+    [[nodiscard]] std::span<const uint8_t> bytes() const { return {m_data, m_num_bytes}; }
+
+    //! mapped bytes as string_view, useful for text-formats
+    [[nodiscard]] std::string_view str() const
+    {
+        return {reinterpret_cast<const char *>(m_data), m_num_bytes};
+    }
+
+private:
+    MappedFile() = default;
+
+    const uint8_t *m_data = nullptr;
+    size_t m_num_bytes = 0;
+
+#ifdef _WIN32
+    void *m_file = nullptr;
+    void *m_mapping = nullptr;
+#endif
+};
+
+/**
+ * @brief   write_file_atomic writes a file to a uniquely named temporary location (process-id + random suffix)
+ *          and renames it into place. concurrent readers, threads or processes never observe a partial file.
+ *
+ * @param   path        destination path, parent-directories are created if necessary
+ * @param   write_fn    functor writing the contents to a provided temporary path, returns false on failure
+ * @return  true if the file was written successfully.
+ */
+bool write_file_atomic(const std::filesystem::path &path,
+                       const std::function<bool(const std::filesystem::path &tmp_path)> &write_fn);
+
+/**
+ * @brief   write_file_atomic writes a file to a uniquely named temporary location and renames it into place.
+ *
+ * @param   path    destination path, parent-directories are created if necessary
+ * @param   bytes   file-contents
+ * @return  true if the file was written successfully.
+ */
+bool write_file_atomic(const std::filesystem::path &path, std::span<const uint8_t> bytes);
+
+}// namespace vierkant
@@ -12,8 +12,11 @@ namespace vierkant::model
 /**
  *  @brief  gltf can be used to load 3d-models in the GL Transmission Format 2.0 (glTF2).
  *          json-, json-embedded and binary flavours are supported.
+ *          binary files (.glb) are memory-mapped, accessors and images are decoded directly from the mapping.
+ *          if a threadpool is provided, images and primitives are decoded in parallel.
  *
  *  @param  path    path to a model-file with either .gltf or .glb extension.
+ *  @param  pool    optional threadpool used for decoding.
  *  @param  id_seed optional stable string seeding deterministic asset-ids (default: path).
  *
  *  @return an optional struct grouping the loaded assets.
@@ -21,4 +24,14 @@ namespace vierkant::model
 std::optional<model_assets_t> gltf(const std::filesystem::path &path, crocore::ThreadPoolClassic* pool = nullptr,
                                    const std::string &id_seed = {});
 
+/**
+ *  @brief  gltf_external_files returns paths of external resources (buffers, images) referenced by a glTF-file.
+ *          embedded resources (data-URIs, glb BIN-chunk) are omitted.
+ *
+ *  @param  path    path to a model-file with either .gltf or .glb extension.
+ *
+ *  @return an array of referenced file-paths, resolved relative to the model's location.
+ */
+std::vector<std::filesystem::path> gltf_external_files(const std::filesystem::path &path);
+
 }// namespace vierkant::model
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <vierkant/model/model_loading.hpp>
+
+namespace vierkant::model
+{
+
+//! format-version for cached model-assets. increment when serialized types or load-routines change
+constexpr uint32_t model_cache_version = 2;
+
+//! parameters for a cached model-load, all of them are part of the cache-key
+struct model_cache_params_t
+{
+    //! directory containing cached model-assets
+    std::filesystem::path cache_dir;
+
+    //! optional stable string seeding deterministic asset-ids (default: path)
+    std::string id_seed;
+
+    //! flag indicating if textures should be compressed (BC5/BC7) before caching
+    bool compress_textures = true;
+
+    //! optional parameters to pack geometries into a vierkant::mesh_buffer_bundle_t before caching
+    std::optional<mesh_buffer_params_t> mesh_buffer_params;
+
+    //! optional OMM generation parameters, requires 'mesh_buffer_params'
+    std::optional<omm_gen_params_t> omm_params;
+};
+
+/**
+ * @brief   model_cache_key returns a content-addressed key for a model-file and load-parameters.
+ *
+ *          the key is derived from the file's bytes, the provided parameters and 'model_cache_version'.
+ *          for external resources referenced by the model (glTF-buffers and -images, obj material-libraries
+ *          and textures) relative paths, sizes and modification-times are included as well.
+ *
+ * @param   path    path to a supported model-file.
+ * @param   params  a struct grouping load-parameters
+ * @param   pool    optional threadpool used for hashing large files
+ * @return  a 64-bit key or 0, if the file could not be read.
+ */
+uint64_t model_cache_key(const std::filesystem::path &path, const model_cache_params_t &params,
+                         crocore::ThreadPoolClassic *pool = nullptr);
+
+/**
+ * @brief   save_model_assets serializes model-assets into a binary file.
+ *
+ * @param   mesh_assets     a struct grouping model-assets
+ * @param   path            output-path, the file is written to a temporary location and renamed on completion
+ * @param   key             an optional key stored in the file-header, e.g. from 'model_cache_key'
+ * @return  true, if the file was written successfully.
+ */
+bool save_model_assets(const model_assets_t &mesh_assets, const std::filesystem::path &path, uint64_t key = 0);
+
+/**
+ * @brief   load_model_assets deserializes model-assets from a binary file.
+ *
+ * @param   path    path to a file created by 'save_model_assets'
+ * @param   key     optional key, if non-zero it is required to match the stored key
+ * @return  an optional struct grouping the loaded assets, nullopt for invalid, outdated or corrupted files.
+ */
+std::optional<model_assets_t> load_model_assets(const std::filesystem::path &path, uint64_t key = 0);
+
+/**
+ * @brief   save_omm_data serializes baked OMM data into a binary file.
+ *
+ * @param   omm_data    baked OMM data, e.g. from 'generate_omm_data'
+ * @param   path        output-path, the file is written to a temporary location and renamed on completion
+ * @param   key         an optional key stored in the file-header, e.g. from 'omm_cache_key'
+ * @return  true, if the file was written successfully.
+ */
+bool save_omm_data(const std::vector<mesh_omm_data_t> &omm_data, const std::filesystem::path &path,
+                   uint64_t key = 0);
+
+/**
+ * @brief   load_omm_data deserializes baked OMM data from a binary file.
+ *
+ * @param   path    path to a file created by 'save_omm_data'
+ * @param   key     optional key, if non-zero it is required to match the stored key
+ * @return  baked OMM data, nullopt for invalid, outdated or corrupted files.
+ */
+std::optional<std::vector<mesh_omm_data_t>> load_omm_data(const std::filesystem::path &path, uint64_t key = 0);
+
+/**
+ * @brief   generate_omm_data_cached bakes OMM data using an on-disk cache, keyed by 'omm_cache_key'.
+ *
+ * @param   mesh_assets     model-assets providing materials + (CPU) textures
+ * @param   bundle          packed mesh-buffer bundle providing geometry/UVs
+ * @param   params          OMM generation parameters
+ * @param   cache_dir       directory containing cached OMM data
+ * @param   pool            optional threadpool used for baking on cache-miss
+ * @return  baked OMM data, see 'generate_omm_data'
+ */
+std::vector<mesh_omm_data_t> generate_omm_data_cached(const model_assets_t &mesh_assets,
+                                                      const vierkant::mesh_buffer_bundle_t &bundle,
+                                                      const omm_gen_params_t &params,
+                                                      const std::filesystem::path &cache_dir,
+                                                      crocore::ThreadPoolClassic *pool = nullptr);
+
+/**
+ * @brief   load_model_cached loads a model using an on-disk cache.
+ *
+ *          on cache-miss the model is loaded via 'load_model', optionally packed, OMM-baked and texture-compressed
+ *          and stored in the cache-directory. subsequent calls with unchanged inputs load the cached assets.
+ *
+ * @param   path    path to a supported model-file.
+ * @param   params  a struct grouping load-parameters
+ * @param   pool    optional threadpool
+ * @return  an optional struct grouping the loaded assets.
+ */
+std::optional<model_assets_t> load_model_cached(const std::filesystem::path &path, const model_cache_params_t &params,
+                                                crocore::ThreadPoolClassic *pool = nullptr);
+
+}// namespace vierkant::model
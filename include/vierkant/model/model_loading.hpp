@@ -5,6 +5,7 @@
 
 #include <filesystem>
 #include <optional>
+#include <span>
 #include <unordered_map>
 #include <variant>
 
@@ -154,6 +155,9 @@ struct load_mesh_params_t
     //! a VkQueue used for required buffer/image-transfers.
     VkQueue load_queue = VK_NULL_HANDLE;
 
+    //! optional UploadQueue. if provided, transfers are batched onto the transfer-queue without blocking
+    vierkant::UploadQueuePtr upload_queue;
+
     //! additional buffer-flags for all created vierkant::Buffers.
     VkBufferUsageFlags buffer_flags = 0;
 
@@ -188,6 +192,9 @@ struct load_mesh_result_t
 
     //! CPU-side OMM data; caller accumulates into a scene-level cache and passes to RayBuilder
     mesh_omm_cache_t omm_cache;
+
+    //! completion-handle for asynchronous uploads, if an UploadQueue was used
+    vierkant::UploadQueue::handle_t upload_handle;
 };
 
 /**
@@ -199,6 +206,21 @@ struct load_mesh_result_t
  */
 load_mesh_result_t load_mesh(const load_mesh_params_t &params, const vierkant::model::model_assets_t &mesh_assets);
 
+/**
+ * @brief   create_sampled_textures realizes all {texture_id, sampler_id}-permutations referenced by materials,
+ *          for base-textures {texture_id, nil} already contained in 'result'.
+ *          VkSamplers are created once per SamplerId and stored in 'result'.
+ *
+ * @param   device          handle to a vierkant::Device
+ * @param   mesh_assets     model-assets providing materials and texture-samplers
+ * @param   result          a load_mesh_result_t containing base-textures, will receive permutations and samplers
+ */
+void create_sampled_textures(const vierkant::DevicePtr &device, const model_assets_t &mesh_assets,
+                             load_mesh_result_t &result);
+
+//! version of cached OMM data, increment to invalidate existing entries
+constexpr uint32_t omm_cache_version = 1;
+
 /**
  * @brief   generate_omm_data bakes CPU opacity-micromaps for all alpha-masked entries of a packed bundle.
  *
@@ -209,19 +231,99 @@ load_mesh_result_t load_mesh(const load_mesh_params_t &params, const vierkant::m
  * @param   mesh_assets     model-assets providing materials + (CPU) textures
  * @param   bundle          packed mesh-buffer bundle providing geometry/UVs
  * @param   params          OMM generation parameters
- * @return  baked OMM data, one entry per alpha-masked submesh that produced micromaps
+ * @param   pool            optional threadpool, entries are baked in parallel. output is identical either way.
+ * @return  baked OMM data, one entry per alpha-masked submesh that produced micromaps, ordered by entry-index
  */
 std::vector<mesh_omm_data_t> generate_omm_data(const model_assets_t &mesh_assets,
                                                const vierkant::mesh_buffer_bundle_t &bundle,
-                                               const omm_gen_params_t &params);
+                                               const omm_gen_params_t &params,
+                                               crocore::ThreadPoolClassic *pool = nullptr);
+
+/**
+ * @brief   omm_cache_key returns a content-addressed key for OMM data generated by 'generate_omm_data'.
+ *          the key is derived from positions, UVs and indices of all alpha-masked entries, the contents of their
+ *          color-textures, OMM generation parameters and 'omm_cache_version'.
+ *
+ * @param   mesh_assets     model-assets providing materials + (CPU) textures
+ * @param   bundle          packed mesh-buffer bundle providing geometry/UVs
+ * @param   params          OMM generation parameters
+ * @return  a non-zero 64-bit key
+ */
+uint64_t omm_cache_key(const model_assets_t &mesh_assets, const vierkant::mesh_buffer_bundle_t &bundle,
+                       const omm_gen_params_t &params);
+
+/**
+ * @brief   compression_mode selects a block-compression mode for an image:
+ *          BC6H for float-images, BC5 for normal-maps, BC4 for single-channel images,
+ *          BC1 for opaque color-images (RGB or RGBA with alpha fully 255) and BC7 otherwise.
+ *
+ * @param   img             an image
+ * @param   is_normal_map   flag indicating if the image is used as normal-map
+ * @return  a block-compression mode
+ */
+bcn::CompressionMode compression_mode(const crocore::ImageConstPtr &img, bool is_normal_map);
+
+//! version of the texture-cache, increment to invalidate existing entries
+constexpr uint32_t texture_cache_version = 1;
+
+//! parameters for a persistent cache of compressed textures
+struct texture_cache_params_t
+{
+    //! directory containing cached textures, stored as KTX2-files
+    std::filesystem::path cache_dir;
+
+    //! size-limit for the cache-directory, least recently used entries are evicted first
+    size_t max_num_bytes = 1ULL << 32;
+};
 
 /**
  * @brief   compress_textures will compress all images found provided mesh_assets in-place.
  *
  * @param   mesh_assets     a mesh_assets struct.
+ * @param   pool            optional threadpool used for compression
+ * @param   cache_params    optional parameters for a persistent texture-cache, compressed textures are reused from
+ *                          and stored to disk
  * @return  true, if all images contained in mesh_assets are compressed.
  */
-bool compress_textures(vierkant::model::model_assets_t &mesh_assets, crocore::ThreadPoolClassic *pool = nullptr);
+bool compress_textures(vierkant::model::model_assets_t &mesh_assets, crocore::ThreadPoolClassic *pool = nullptr,
+                       const std::optional<texture_cache_params_t> &cache_params = {});
+
+/**
+ * @brief   texture_cache_key computes a key for compressed textures from source-pixels and compression-settings.
+ *
+ * @param   compress_info   a struct providing an image and compression-settings
+ * @return  a non-zero key or 0 for unsupported images
+ */
+uint64_t texture_cache_key(const bcn::compress_info_t &compress_info);
+
+/**
+ * @brief   load_cached_texture reads a compressed texture from a cache-directory and marks it as recently used.
+ *
+ * @param   cache_dir   a cache-directory
+ * @param   key         a key, as returned by texture_cache_key
+ * @return  a compressed texture or nullopt for cache-misses
+ */
+std::optional<bcn::compress_result_t> load_cached_texture(const std::filesystem::path &cache_dir, uint64_t key);
+
+/**
+ * @brief   store_cached_texture writes a compressed texture into a cache-directory.
+ *          entries are written to a temporary file and renamed, so concurrent writers are safe.
+ *
+ * @param   cache_dir       an existing cache-directory
+ * @param   key             a key, as returned by texture_cache_key
+ * @param   compress_result a compressed texture
+ * @return  true, if the entry was stored
+ */
+bool store_cached_texture(const std::filesystem::path &cache_dir, uint64_t key,
+                          const bcn::compress_result_t &compress_result);
+
+/**
+ * @brief   trim_texture_cache evicts least recently used entries until a cache-directory fits into a size-limit.
+ *
+ * @param   cache_dir       a cache-directory
+ * @param   max_num_bytes   size-limit in bytes
+ */
+void trim_texture_cache(const std::filesystem::path &cache_dir, size_t max_num_bytes);
 
 /**
  * @brief   create_texture can be used to create a texture from an existing host-image
@@ -237,7 +339,7 @@ vierkant::ImagePtr create_texture(const vierkant::DevicePtr &device, const croco
 
 /**
  * @brief   create_compressed_texture can be used to create a texture from pre-compressed block-compressed blocks.
- *          used format will be either VK_FORMAT_BC5_UNORM_BLOCK or VK_FORMAT_BC7_UNORM_BLOCK.
+ *          used format is derived from the compression-mode (BC1, BC3, BC4, BC5, BC6H or BC7).
  *
  * @param   device              handle to a vierkant::Device
  * @param   compression_result  a struct providing compressed blocks
@@ -249,6 +351,45 @@ vierkant::ImagePtr create_compressed_texture(const vierkant::DevicePtr &device,
                                              const vierkant::bcn::compress_result_t &compression_result,
                                              vierkant::Image::Format format, VkQueue load_queue);
 
+/**
+ * @brief   create_compressed_texture can be used to create a layered texture from pre-compressed faces,
+ *          e.g. read from KTX2/DDS-files. 6 faces will create a cube-map.
+ *
+ * @param   device      handle to a vierkant::Device
+ * @param   faces       an array of compress_result_t structs sharing mode and dimensions, one per layer
+ * @param   format      a vierkant::Image::Format struct providing sampler+texture settings
+ * @param   load_queue  the VkQueue that shall be used for required image-transfers.
+ * @return  a newly created texture
+ */
+vierkant::ImagePtr create_compressed_texture(const vierkant::DevicePtr &device,
+                                             std::span<const vierkant::bcn::compress_result_t> faces,
+                                             vierkant::Image::Format format, VkQueue load_queue);
+
+/**
+ * @brief   create_texture_async creates a texture from an existing host-image and schedules its upload
+ *          using an UploadQueue (non-blocking). mipmaps are generated during UploadQueue::acquire.
+ *
+ * @param   upload_queue    an UploadQueue
+ * @param   img             an image
+ * @param   format          a vierkant::Image::Format struct providing sampler+texture settings
+ * @return  a newly created texture, usable after acquisition via 'upload_queue'
+ */
+vierkant::ImagePtr create_texture_async(const vierkant::UploadQueuePtr &upload_queue, const crocore::ImagePtr &img,
+                                        vierkant::Image::Format format = {});
+
+/**
+ * @brief   create_compressed_texture_async creates a texture from pre-compressed faces
+ *          and schedules its upload using an UploadQueue (non-blocking).
+ *
+ * @param   upload_queue    an UploadQueue
+ * @param   faces           an array of compress_result_t structs sharing mode and dimensions, one per layer
+ * @param   format          a vierkant::Image::Format struct providing sampler+texture settings
+ * @return  a newly created texture, usable after acquisition via 'upload_queue'
+ */
+vierkant::ImagePtr create_compressed_texture_async(const vierkant::UploadQueuePtr &upload_queue,
+                                                   std::span<const vierkant::bcn::compress_result_t> faces,
+                                                   vierkant::Image::Format format = {});
+
 /**
  * @brief   create_sampler creates a VkSampler from a texture_sampler_t descriptor.
  *
@@ -17,4 +17,14 @@ std::optional<model_assets_t> wavefront_obj(const std::filesystem::path &path,
                                             crocore::ThreadPoolClassic *pool = nullptr,
                                             const std::string &id_seed = {});
 
+/**
+ *  @brief  wavefront_obj_external_files returns paths of external resources referenced by an obj-file,
+ *          i.e. material-libraries (.mtl) and the textures referenced by them.
+ *
+ *  @param  path    path to a model-file with .obj extension.
+ *
+ *  @return an array of referenced file-paths, resolved relative to the model's location.
+ */
+std::vector<std::filesystem::path> wavefront_obj_external_files(const std::filesystem::path &path);
+
 }// namespace vierkant::model
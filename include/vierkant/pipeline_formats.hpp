@@ -225,6 +225,9 @@ struct graphics_pipeline_info_t
     VkPipeline base_pipeline = VK_NULL_HANDLE;
     int32_t base_pipeline_index = -1;
 
+    //! descriptor-sets are provided via descriptor-buffers (VK_EXT_descriptor_buffer)
+    bool use_descriptor_buffer = false;
+
     // optionally provide specialization-constants
     std::optional<vierkant::pipeline_specialization> specialization;
 
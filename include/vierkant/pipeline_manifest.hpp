@@ -0,0 +1,78 @@
+#pragma once
+
+#include <filesystem>
+#include <optional>
+
+#include <vierkant/descriptor.hpp>
+#include <vierkant/pipeline_formats.hpp>
+
+namespace vierkant
+{
+
+/**
+ * @brief   pipeline_manifest_t is a compact, serializable record of pipeline-keys.
+ *          handles contained in pipeline-formats are replaced by indices into de-duplicated arrays
+ *          of SPIR-V code and descriptor-set-layouts, so pipelines can be re-created in another process.
+ */
+struct pipeline_manifest_t
+{
+    //! reference to SPIR-V code used for a shader-stage
+    struct shader_t
+    {
+        VkShaderStageFlagBits stage = VK_SHADER_STAGE_ALL;
+        uint32_t code_index = 0;
+        std::string entry_point_name;
+    };
+
+    //! a recorded pipeline-key
+    struct pipeline_t
+    {
+        VkPipelineBindPoint bind_point = VK_PIPELINE_BIND_POINT_GRAPHICS;
+
+        //! shader-stages, ordered like in the original format
+        std::vector<shader_t> shaders;
+
+        //! indices into 'set_layouts'
+        std::vector<uint32_t> set_layout_indices;
+
+        std::vector<VkPushConstantRange> push_constant_ranges;
+
+        std::optional<vierkant::pipeline_specialization> specialization;
+
+        //! graphics only: fixed-function state. shader-stages, set-layouts and handles are cleared
+        graphics_pipeline_info_t graphics_info;
+
+        //! graphics only: owned copy of 'graphics_info.color_attachment_formats'
+        std::vector<VkFormat> color_attachment_formats;
+
+        //! raytracing only
+        uint32_t max_recursion = 1;
+    };
+
+    //! de-duplicated SPIR-V code
+    std::vector<std::vector<uint32_t>> shader_codes;
+
+    //! de-duplicated descriptor-set-layouts
+    std::vector<descriptor_set_layout_desc_t> set_layouts;
+
+    std::vector<pipeline_t> pipelines;
+};
+
+/**
+ * @brief   save_pipeline_manifest serializes a pipeline-manifest into a binary file.
+ *
+ * @param   manifest    a pipeline_manifest_t
+ * @param   path        output-path, the file is written to a temporary location and renamed on completion
+ * @return  true, if the file was written successfully.
+ */
+bool save_pipeline_manifest(const pipeline_manifest_t &manifest, const std::filesystem::path &path);
+
+/**
+ * @brief   load_pipeline_manifest deserializes a pipeline-manifest from a binary file.
+ *
+ * @param   path    path to a file created by 'save_pipeline_manifest'
+ * @return  a pipeline_manifest_t, nullopt for invalid, outdated or corrupted files.
+ */
+std::optional<pipeline_manifest_t> load_pipeline_manifest(const std::filesystem::path &path);
+
+}// namespace vierkant
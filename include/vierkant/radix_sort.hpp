@@ -0,0 +1,59 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <span>
+
+namespace vierkant
+{
+
+/**
+ * @brief   radix_sort performs a stable LSD radix-sort on 64-bit keys (8 passes of 8 bits).
+ *          all histograms are gathered in a single sweep, passes over bytes shared by all keys are skipped.
+ *
+ * @param   items   an array of items to sort, contains the sorted items after returning
+ * @param   tmp     scratch-space, at least as large as 'items'
+ * @param   key_fn  functor returning a uint64_t sort-key for an item
+ */
+template<typename T, typename KeyFn>
+void radix_sort(std::span<T> items, std::span<T> tmp, KeyFn key_fn)
+{
+    constexpr uint32_t num_digits = sizeof(uint64_t);
+    if(items.size() < 2) { return; }
+    assert(tmp.size() >= items.size());
+
+    std::array<std::array<size_t, 256>, num_digits> histograms = {};
+
+    for(const auto &item: items)
+    {
+        uint64_t key = key_fn(item);
+        for(uint32_t d = 0; d < num_digits; ++d) { histograms[d][(key >> (8 * d)) & 0xFF]++; }
+    }
+
+    std::span<T> src = items, dst = tmp.first(items.size());
+
+    for(uint32_t d = 0; d < num_digits; ++d)
+    {
+        auto &histogram = histograms[d];
+        const uint32_t shift = 8 * d;
+
+        // all keys share this digit
+        if(histogram[(key_fn(src.front()) >> shift) & 0xFF] == src.size()) { continue; }
+
+        // exclusive prefix-sum -> scatter-offsets
+        size_t offset = 0;
+        for(auto &count: histogram)
+        {
+            size_t num = count;
+            count = offset;
+            offset += num;
+        }
+        for(const auto &item: src) { dst[histogram[(key_fn(item) >> shift) & 0xFF]++] = item; }
+        std::swap(src, dst);
+    }
+    if(src.data() != items.data()) { std::copy(src.begin(), src.end(), items.begin()); }
+}
+
+}// namespace vierkant
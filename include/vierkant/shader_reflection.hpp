@@ -0,0 +1,39 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+namespace vierkant
+{
+
+/**
+ * @brief   shader_reflection_t contains reflection-data for a SPIR-V module, gathered at build-time.
+ *          tables are generated alongside embedded shader-code (shaders.cpp/shaders_slang.cpp),
+ *          so 'create_shader_module' does not need to parse SPIR-V for built-in shaders.
+ */
+struct shader_reflection_t
+{
+    struct entry_point_t
+    {
+        std::string_view name;
+
+        //! VkShaderStageFlags
+        uint32_t stage = 0;
+
+        //! workgroup-size
+        std::array<uint32_t, 3> group_count = {};
+
+        //! descriptor-bindings statically used by this entry-point
+        std::span<const uint32_t> bindings;
+    };
+
+    //! embedded SPIR-V code
+    const void *code = nullptr;
+    size_t num_bytes = 0;
+
+    std::span<const entry_point_t> entry_points;
+};
+
+}// namespace vierkant
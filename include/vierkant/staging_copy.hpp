@@ -4,7 +4,9 @@
 
 #pragma once
 
+#include <span>
 #include <vierkant/Buffer.hpp>
+#include <vierkant/StagingRing.hpp>
 
 namespace vierkant
 {
@@ -25,7 +27,13 @@ struct staging_copy_context_t
 {
     VkCommandBuffer command_buffer = VK_NULL_HANDLE;
     vierkant::BufferPtr staging_buffer;
+
+    //! current offset into 'staging_buffer', not advanced by copies staged from 'staging_ring'
     size_t offset = 0;
+
+    //! optional staging-ring. if provided, copies are staged from the ring.
+    //! 'staging_buffer' is optional then, used as fallback if the ring is exhausted
+    vierkant::StagingRingPtr staging_ring;
 };
 
 /**
@@ -34,9 +42,13 @@ struct staging_copy_context_t
  *
  * @param   context             a provided context for stagin-copies
  * @param   staging_copy_infos  an array of copy-infos
- * @return  total number of bytes (size of staging-buffer | context's current staging-offset)
+ * @return  number of bytes used in the context's staging-buffer (context's current staging-offset)
  */
-size_t staging_copy(staging_copy_context_t &context,
-                    const std::vector<staging_copy_info_t> &staging_copy_infos);
+size_t staging_copy(staging_copy_context_t &context, std::span<const staging_copy_info_t> staging_copy_infos);
+
+inline size_t staging_copy(staging_copy_context_t &context, const std::vector<staging_copy_info_t> &staging_copy_infos)
+{
+    return staging_copy(context, std::span<const staging_copy_info_t>(staging_copy_infos));
+}
 
 }
@@ -15,7 +15,34 @@ namespace vierkant::bcn
 enum CompressionMode : uint32_t
 {
     BC5 = 0,
-    BC7
+    BC7,
+    BC1,
+    BC3,
+    BC4,
+    BC6H
+};
+
+//! encoder quality-levels, trading encode-time for quality. applies to BC7 and BC1/BC3
+enum class Quality : uint32_t
+{
+    UltraFast = 0,
+    VeryFast,
+    Fast,
+    Basic,
+    Slow
+};
+
+//! 2x2 box-filter variants used for mip-generation
+enum class MipFilter : uint32_t
+{
+    //! plain average of 2x2 texels
+    Box = 0,
+
+    //! average in linear space for sRGB-encoded 8-bit color, alpha is averaged linearly
+    BoxSRGB,
+
+    //! average of unpacked normals (8-bit: [0, 255] -> [-1, 1]), renormalized afterwards
+    BoxNormalMap
 };
 
 //! 128-bit block encoding 4x4 texels
@@ -24,6 +51,9 @@ struct block_t
     uint64_t value[2];
 };
 
+//! returns the size in bytes of an encoded 4x4 block. levels store 64-bit blocks (BC1, BC4) tightly packed.
+constexpr uint32_t block_size(CompressionMode mode) { return mode == BC1 || mode == BC4 ? 8 : 16; }
+
 //! groups encoded blocks by level and base-dimension
 struct compress_result_t
 {
@@ -37,10 +67,21 @@ struct compress_result_t
 //! groups parameters passed to compress() routine
 struct compress_info_t
 {
+    //! BC6H requires float-images, all other modes 8-bit images. mismatches result in empty levels
     CompressionMode mode = BC7;
     crocore::ImageConstPtr image;
     bool generate_mipmaps = false;
     vierkant::delegate_fn_t delegate_fn;
+
+    //! filter used to generate mip-levels
+    MipFilter mip_filter = MipFilter::Box;
+
+    //! encoder quality-level, maps onto mode-/partition-search parameters
+    Quality quality = Quality::Basic;
+
+    //! BC7 only: lagrangian multiplier for a rate-distortion post-pass, trading error for redundancy
+    //! in the encoded blocks (better ratios for subsequent lossless compression). 0: disabled
+    float rdo_lambda = 0.f;
 };
 
 /**
@@ -51,4 +92,84 @@ struct compress_info_t
  */
 compress_result_t compress(const compress_info_t &compress_info);
 
+/**
+ * @brief   compress multiple images at once. work-items (image, level, block-rows) of all images
+ *          are balanced across workers using work-stealing, per-image 'delegate_fn' members are ignored.
+ *
+ * @param   compress_infos  an array of bcn::compress_info_t structs
+ * @param   delegate_fn     optional delegate used to run workers, e.g. on a threadpool
+ * @param   num_workers     number of workers including the calling thread, 0: use hardware-concurrency
+ * @return  an array of compress_result_t structs, in order of 'compress_infos'
+ */
+std::vector<compress_result_t> compress(const std::vector<compress_info_t> &compress_infos,
+                                        const vierkant::delegate_fn_t &delegate_fn = {}, uint32_t num_workers = 0);
+
+/**
+ * @brief   downsample_2x2 halves the dimensions of an 8-bit or float image, using a 2x2 box-filter.
+ *          odd dimensions drop the last row/column, dimensions of 1 are kept.
+ *
+ * @param   img     an 8-bit or float image
+ * @param   filter  box-filter variant
+ * @return  a downsampled image, nullptr for unsupported image-types
+ */
+crocore::ImagePtr downsample_2x2(const crocore::ImageConstPtr &img, MipFilter filter = MipFilter::Box);
+
+/**
+ * @brief   get_block gathers a 4x4 block of RGBA-texels from an 8-bit image.
+ *          single-channel images are replicated to RGB, missing channels are zero and missing alpha is 255.
+ *
+ * @param   img     an 8-bit image, dimensions need to cover the block
+ * @param   bx      block-index in x-direction
+ * @param   by      block-index in y-direction
+ * @param   pixels  output-array of 16 RGBA-texels
+ */
+void get_block(const crocore::Image_<uint8_t> &img, uint32_t bx, uint32_t by, uint8_t *pixels);
+
+/**
+ * @brief   decompress a block-compressed mip-chain back into images.
+ *          BC1/BC3/BC7 decode to RGBA, BC4 to single-channel, BC5 to two-channel (8-bit) images.
+ *          BC6H decodes to RGB float-images, limited to single-region blocks (mode 11) as produced by compress(),
+ *          other BC6H-modes decode to zero.
+ *
+ * @param   compress_result a struct grouping mode, encoded blocks and dimensions
+ * @return  an array of decoded images, one per level
+ */
+std::vector<crocore::ImagePtr> decompress(const compress_result_t &compress_result);
+
+//! per-channel image-quality metrics of an image, compared to a reference-image
+struct image_quality_t
+{
+    //! peak signal-to-noise ratio in dB. peak is 1.0 for normalized 8-bit images or the reference-maximum for floats
+    std::vector<float> psnr;
+
+    //! mean structural similarity in [-1, 1], computed over 8x8 windows
+    std::vector<float> ssim;
+
+    //! maximum absolute error, normalized for 8-bit images
+    std::vector<float> max_error;
+};
+
+/**
+ * @brief   image_quality measures per-channel image-quality metrics for an image, compared to a reference.
+ *          images need to share dimensions and type (8-bit or float), channels present in both images are compared.
+ *
+ * @param   reference   a reference-image
+ * @param   image       an image to measure
+ * @return  a struct grouping per-channel metrics, empty for incompatible images
+ */
+image_quality_t image_quality(const crocore::ImageConstPtr &reference, const crocore::ImageConstPtr &image);
+
+/**
+ * @brief   image_quality measures per-channel image-quality metrics for all levels of a compressed image.
+ *          reference-levels are generated from 'reference', same as done by compress().
+ *
+ * @param   reference       the uncompressed source-image
+ * @param   compress_result a struct grouping mode, encoded blocks and dimensions
+ * @param   mip_filter      filter used to generate reference-levels, should match the one used for compression
+ * @return  an array of image_quality_t structs, one per level
+ */
+std::vector<image_quality_t> image_quality(const crocore::ImageConstPtr &reference,
+                                           const compress_result_t &compress_result,
+                                           MipFilter mip_filter = MipFilter::Box);
+
 }// namespace vierkant::bcn
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <filesystem>
+#include <optional>
+#include <span>
+
+#include <vierkant/texture_block_compression.hpp>
+#include <volk.h>
+
+namespace vierkant::bcn
+{
+
+//! supercompression-schemes for KTX2-files, values match KTX2's 'supercompressionScheme'
+enum class Supercompression : uint32_t
+{
+    None = 0,
+    Zlib = 3
+};
+
+/**
+ * @brief   vk_format returns the VkFormat corresponding to a block-compression mode.
+ *
+ * @param   mode    a block-compression mode
+ * @return  a VkFormat
+ */
+VkFormat vk_format(CompressionMode mode);
+
+/**
+ * @brief   check_faces checks if faces can be stored in a KTX2- or DDS-file.
+ *          faces need to share mode, dimensions and levels, which follow the container's mip-chain.
+ *
+ * @param   faces   a single face or 6 cube-faces
+ * @return  true, if the faces can be written by write_ktx2/write_dds
+ */
+bool check_faces(const std::vector<compress_result_t> &faces);
+
+/**
+ * @brief   write_ktx2 writes block-compressed faces into a KTX2-file.
+ *          all faces need to share mode, dimensions and number of levels.
+ *          levels need to follow KTX2's mip-chain (max(1, base >> level)), which holds for power-of-two sizes.
+ *
+ * @param   path                path of the file to write
+ * @param   faces               a single face or 6 cube-faces (+X, -X, +Y, -Y, +Z, -Z)
+ * @param   supercompression    optional supercompression applied to each level
+ * @return  true, if the file was written
+ */
+bool write_ktx2(const std::filesystem::path &path, const std::vector<compress_result_t> &faces,
+                Supercompression supercompression = Supercompression::None);
+
+/**
+ * @brief   read_ktx2 reads block-compressed faces from KTX2-data.
+ *
+ * @param   data    bytes of a KTX2-file, e.g. memory-mapped
+ * @return  an array of faces (1 or 6 for cube-maps), nullopt for invalid or unsupported data
+ */
+std::optional<std::vector<compress_result_t>> read_ktx2(std::span<const uint8_t> data);
+
+/**
+ * @brief   write_dds writes block-compressed faces into a DDS-file, using a DX10-header.
+ *          requirements for 'faces' are the same as for write_ktx2.
+ *
+ * @param   path    path of the file to write
+ * @param   faces   a single face or 6 cube-faces (+X, -X, +Y, -Y, +Z, -Z)
+ * @return  true, if the file was written
+ */
+bool write_dds(const std::filesystem::path &path, const std::vector<compress_result_t> &faces);
+
+/**
+ * @brief   read_dds reads block-compressed faces from DDS-data. legacy FourCC-headers (DXT1/DXT5/ATI1/ATI2)
+ *          and DX10-headers are supported.
+ *
+ * @param   data    bytes of a DDS-file, e.g. memory-mapped
+ * @return  an array of faces (1 or 6 for cube-maps), nullopt for invalid or unsupported data
+ */
+std::optional<std::vector<compress_result_t>> read_dds(std::span<const uint8_t> data);
+
+/**
+ * @brief   load_compressed_texture memory-maps a KTX2- or DDS-file and reads its block-compressed faces.
+ *          the container-format is detected from the file's contents.
+ *
+ * @param   path    path to a KTX2- or DDS-file
+ * @return  an array of faces (1 or 6 for cube-maps), nullopt for missing, invalid or unsupported files
+ */
+std::optional<std::vector<compress_result_t>> load_compressed_texture(const std::filesystem::path &path);
+
+}// namespace vierkant::bcn
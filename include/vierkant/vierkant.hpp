@@ -7,20 +7,25 @@
 #include "vierkant/Buffer.hpp"
 #include "vierkant/Camera.hpp"
 #include "vierkant/CameraControl.hpp"
+#include "vierkant/Defragmenter.hpp"
 #include "vierkant/Device.hpp"
 #include "vierkant/DrawContext.hpp"
 #include "vierkant/Font.hpp"
+#include "vierkant/FrameArena.hpp"
 #include "vierkant/Framebuffer.hpp"
 #include "vierkant/Geometry.hpp"
 #include "vierkant/Image.hpp"
 #include "vierkant/Instance.hpp"
 #include "vierkant/Material.hpp"
+#include "vierkant/MemoryTracker.hpp"
 #include "vierkant/Mesh.hpp"
 #include "vierkant/Pipeline.hpp"
 #include "vierkant/Rasterizer.hpp"
 #include "vierkant/Scene.hpp"
 #include "vierkant/SceneRenderer.hpp"
+#include "vierkant/StagingRing.hpp"
 #include "vierkant/SwapChain.hpp"
+#include "vierkant/UploadQueue.hpp"
 #include "vierkant/Window.hpp"
 #include "vierkant/intersection.hpp"
 #include <vierkant/Semaphore.hpp>
\ No newline at end of file
@@ -0,0 +1,520 @@
+#include <spdlog/spdlog.h>
+#include <vierkant/AssetStreamer.hpp>
+#include <vierkant/model/model_cache.hpp>
+
+namespace vierkant
+{
+
+namespace
+{
+
+template<typename T>
+inline size_t num_bytes(const std::vector<T> &array)
+{
+    return array.size() * sizeof(T);
+}
+
+size_t num_bytes(const vierkant::geometry_variant_t &geometry_data)
+{
+    size_t ret = 0;
+
+    if(const auto *entries = std::get_if<std::vector<vierkant::Mesh::entry_create_info_t>>(&geometry_data))
+    {
+        std::unordered_set<const vierkant::Geometry *> geometries;
+
+        for(const auto &entry: *entries)
+        {
+            if(!entry.geometry || !geometries.insert(entry.geometry.get()).second) { continue; }
+            const auto &g = *entry.geometry;
+            ret += num_bytes(g.positions) + num_bytes(g.colors) + num_bytes(g.tex_coords) + num_bytes(g.normals) +
+                   num_bytes(g.tangents) + num_bytes(g.bone_indices) + num_bytes(g.bone_weights) +
+                   num_bytes(g.indices);
+        }
+    }
+    else if(const auto *bundle = std::get_if<vierkant::mesh_buffer_bundle_t>(&geometry_data))
+    {
+        ret += num_bytes(bundle->vertex_buffer) + num_bytes(bundle->index_buffer) +
+               num_bytes(bundle->bone_vertex_buffer) + num_bytes(bundle->morph_buffer) + num_bytes(bundle->meshlets) +
+               num_bytes(bundle->meshlet_vertices) + num_bytes(bundle->meshlet_triangles) +
+               num_bytes(bundle->meshlet_lods);
+    }
+    return ret;
+}
+
+size_t num_bytes(const vierkant::model::texture_variant_t &texture_variant)
+{
+    return std::visit(
+            [](auto &&img) -> size_t {
+                using T = std::decay_t<decltype(img)>;
+
+                if constexpr(std::is_same_v<T, crocore::ImagePtr>)
+                {
+                    // account for mipmaps
+                    return img ? img->num_bytes() * 4 / 3 : 0;
+                }
+                else
+                {
+                    size_t ret = 0;
+                    for(const auto &lvl: img.levels) { ret += num_bytes(lvl); }
+                    return ret;
+                }
+            },
+            texture_variant);
+}
+
+}// namespace
+
+struct AssetStreamer::request_t
+{
+    stream_handle_t handle = 0;
+    float priority = 0.f;
+    StreamState state = StreamState::Queued;
+
+    std::filesystem::path path;
+    std::string id_seed;
+
+    //! parsed cpu-assets, geometry and textures are released after upload
+    std::optional<model::model_assets_t> mesh_assets;
+
+    bool mesh_published = false;
+
+    //! number of outstanding compress-jobs
+    uint32_t num_pending_textures = 0;
+
+    //! textures ready for upload
+    std::deque<vierkant::TextureId> ready_textures;
+
+    //! VkSamplers created so far, only accessed from 'update'
+    std::unordered_map<vierkant::SamplerId, vierkant::VkSamplerPtr> samplers;
+
+    size_t cpu_bytes = 0, gpu_bytes = 0;
+
+    bool released = false;
+};
+
+float stream_priority(const glm::vec3 &eye, const vierkant::Sphere &bounds, float fovy)
+{
+    float distance = glm::length(bounds.center - eye);
+    if(distance <= bounds.radius) { return std::numeric_limits<float>::infinity(); }
+
+    // tan of the sphere's angular radius, relative to tan(fovy / 2)
+    float tan_radius = bounds.radius / std::sqrt(distance * distance - bounds.radius * bounds.radius);
+    return tan_radius / std::tan(0.5f * fovy);
+}
+
+AssetStreamerPtr AssetStreamer::create(create_info_t create_info)
+{
+    return AssetStreamerPtr(new AssetStreamer(std::move(create_info)));
+}
+
+AssetStreamer::AssetStreamer(create_info_t create_info) : m_create_info(std::move(create_info))
+{
+    assert(m_create_info.asset_provider);
+    assert(m_create_info.load_params.device);
+}
+
+AssetStreamer::~AssetStreamer()
+{
+    // running jobs reference this instance
+    std::unique_lock lock(m_mutex);
+    m_shutdown = true;
+    m_jobs.clear();
+    m_condition.wait(lock, [this] { return !m_num_jobs_in_flight; });
+}
+
+stream_handle_t AssetStreamer::request(const std::filesystem::path &path, float priority, const std::string &id_seed)
+{
+    auto request = std::make_shared<request_t>();
+    request->priority = priority;
+    request->path = path;
+    request->id_seed = id_seed;
+    auto handle = add_request(request);
+
+    std::unique_lock lock(m_mutex);
+    m_jobs.push_back({request, [this, request] { parse(request); }, true});
+    dispatch_jobs(lock);
+    return handle;
+}
+
+stream_handle_t AssetStreamer::request(model::model_assets_t mesh_assets, float priority)
+{
+    auto request = std::make_shared<request_t>();
+    request->priority = priority;
+    auto handle = add_request(request);
+    parsed(request, std::move(mesh_assets));
+    return handle;
+}
+
+stream_handle_t AssetStreamer::add_request(RequestPtr request)
+{
+    std::unique_lock lock(m_mutex);
+    request->handle = m_next_handle++;
+    m_requests[request->handle] = request;
+    return request->handle;
+}
+
+void AssetStreamer::set_priority(stream_handle_t handle, float priority)
+{
+    std::unique_lock lock(m_mutex);
+    auto it = m_requests.find(handle);
+    if(it != m_requests.end()) { it->second->priority = priority; }
+}
+
+StreamState AssetStreamer::state(stream_handle_t handle) const
+{
+    std::unique_lock lock(m_mutex);
+    auto it = m_requests.find(handle);
+    return it != m_requests.end() ? it->second->state : StreamState::Invalid;
+}
+
+void AssetStreamer::release(stream_handle_t handle)
+{
+    std::unique_lock lock(m_mutex);
+    auto it = m_requests.find(handle);
+    if(it == m_requests.end()) { return; }
+
+    auto request = it->second;
+    request->released = true;
+    m_cpu_bytes -= request->cpu_bytes;
+    m_gpu_bytes -= request->gpu_bytes;
+    std::erase_if(m_jobs, [&request](const auto &job) { return job.request == request; });
+    m_requests.erase(it);
+}
+
+bool AssetStreamer::idle() const
+{
+    std::unique_lock lock(m_mutex);
+    return m_jobs.empty() && !m_num_jobs_in_flight && std::ranges::all_of(m_requests, [](const auto &pair) {
+               return pair.second->state == StreamState::Done || pair.second->state == StreamState::Failed;
+           });
+}
+
+AssetStreamer::stats_t AssetStreamer::stats() const
+{
+    std::unique_lock lock(m_mutex);
+    stats_t ret = {};
+    ret.cpu_bytes = m_cpu_bytes;
+    ret.gpu_bytes = m_gpu_bytes;
+    ret.num_requests = static_cast<uint32_t>(m_requests.size());
+    ret.num_jobs_queued = static_cast<uint32_t>(m_jobs.size());
+    ret.num_jobs_in_flight = m_num_jobs_in_flight;
+    return ret;
+}
+
+void AssetStreamer::parse(const RequestPtr &request)
+{
+    {
+        std::unique_lock lock(m_mutex);
+        request->state = StreamState::Loading;
+    }
+
+    // no threadpool passed down, waiting on nested jobs from within a job could exhaust the pool
+    std::optional<model::model_assets_t> mesh_assets;
+
+    if(!m_create_info.cache_dir.empty())
+    {
+        model::model_cache_params_t cache_params = {};
+        cache_params.cache_dir = m_create_info.cache_dir;
+        cache_params.id_seed = request->id_seed;
+        cache_params.compress_textures = m_create_info.compress_textures;
+        mesh_assets = model::load_model_cached(request->path, cache_params);
+    }
+    else { mesh_assets = model::load_model(request->path, nullptr, request->id_seed); }
+
+    // OMM-baking requires uncompressed textures
+    if(mesh_assets && m_create_info.load_params.omm_params && mesh_assets->omm_data.empty())
+    {
+        if(const auto *bundle = std::get_if<vierkant::mesh_buffer_bundle_t>(&mesh_assets->geometry_data))
+        {
+            const auto &omm_params = *m_create_info.load_params.omm_params;
+            mesh_assets->omm_data =
+                    m_create_info.cache_dir.empty()
+                            ? model::generate_omm_data(*mesh_assets, *bundle, omm_params)
+                            : model::generate_omm_data_cached(*mesh_assets, *bundle, omm_params,
+                                                              m_create_info.cache_dir / "omm");
+        }
+    }
+    parsed(request, std::move(mesh_assets));
+}
+
+void AssetStreamer::parsed(const RequestPtr &request, std::optional<model::model_assets_t> mesh_assets)
+{
+    std::unique_lock lock(m_mutex);
+    if(request->released) { return; }
+
+    if(!mesh_assets)
+    {
+        spdlog::warn("AssetStreamer: could not load '{}'", request->path.string());
+        request->state = StreamState::Failed;
+        return;
+    }
+    request->cpu_bytes = num_bytes(mesh_assets->geometry_data);
+    for(const auto &[id, texture_variant]: mesh_assets->textures) { request->cpu_bytes += num_bytes(texture_variant); }
+    m_cpu_bytes += request->cpu_bytes;
+
+    request->mesh_assets = std::move(mesh_assets);
+    request->state = StreamState::Uploading;
+
+    for(const auto &[id, texture_variant]: request->mesh_assets->textures)
+    {
+        if(m_create_info.compress_textures && std::holds_alternative<crocore::ImagePtr>(texture_variant))
+        {
+            request->num_pending_textures++;
+            m_jobs.push_back({request, [this, request, texture_id = id] { compress(request, texture_id); }});
+        }
+        else { request->ready_textures.push_back(id); }
+    }
+    dispatch_jobs(lock);
+}
+
+void AssetStreamer::compress(const RequestPtr &request, const vierkant::TextureId &texture_id)
+{
+    // texture-values are only written by their own compress-job
+    auto &texture_variant = request->mesh_assets->textures.at(texture_id);
+    const auto &img = std::get<crocore::ImagePtr>(texture_variant);
+
+    bool is_normal_map = std::ranges::any_of(request->mesh_assets->materials, [&texture_id](const auto &m) {
+        auto it = m.texture_data.find(TextureType::Normal);
+        return it != m.texture_data.end() && it->second.texture_id == texture_id;
+    });
+
+    std::optional<vierkant::bcn::compress_result_t> compressed;
+
+    if(img)
+    {
+        vierkant::bcn::compress_info_t compress_info = {};
+        compress_info.image = img;
+        compress_info.mode = model::compression_mode(img, is_normal_map);
+        compress_info.mip_filter =
+                is_normal_map ? vierkant::bcn::MipFilter::BoxNormalMap : vierkant::bcn::MipFilter::Box;
+        compress_info.generate_mipmaps = true;
+        compressed = vierkant::bcn::compress(compress_info);
+    }
+
+    std::unique_lock lock(m_mutex);
+    size_t bytes_before = num_bytes(texture_variant);
+    if(compressed) { texture_variant = std::move(*compressed); }
+    size_t bytes_after = num_bytes(texture_variant);
+
+    request->cpu_bytes = request->cpu_bytes + bytes_after - bytes_before;
+    if(!request->released) { m_cpu_bytes = m_cpu_bytes + bytes_after - bytes_before; }
+    request->num_pending_textures--;
+    request->ready_textures.push_back(texture_id);
+}
+
+std::optional<AssetStreamer::job_t> AssetStreamer::next_job()
+{
+    // linear search, priorities may change at any time
+    bool cpu_budget_exceeded = m_cpu_bytes && m_cpu_bytes >= m_create_info.cpu_budget;
+    auto best_it = m_jobs.end();
+
+    for(auto it = m_jobs.begin(); it != m_jobs.end(); ++it)
+    {
+        // parsing is paused, while pending data exceeds the cpu-budget
+        if(it->parse && cpu_budget_exceeded) { continue; }
+        if(best_it == m_jobs.end() || it->request->priority > best_it->request->priority) { best_it = it; }
+    }
+    if(best_it == m_jobs.end()) { return {}; }
+
+    auto ret = std::move(*best_it);
+    m_jobs.erase(best_it);
+    return ret;
+}
+
+void AssetStreamer::dispatch_jobs(std::unique_lock<std::mutex> & /*lock*/)
+{
+    if(!m_create_info.pool || m_shutdown) { return; }
+
+    uint32_t max_jobs_in_flight = m_create_info.max_jobs_in_flight
+                                          ? m_create_info.max_jobs_in_flight
+                                          : std::max<uint32_t>(m_create_info.pool->num_threads(), 1);
+
+    while(m_num_jobs_in_flight < max_jobs_in_flight)
+    {
+        auto job = next_job();
+        if(!job) { break; }
+        m_num_jobs_in_flight++;
+        m_create_info.pool->post([this, job = std::move(*job)]() mutable { run_job(std::move(job)); });
+    }
+}
+
+void AssetStreamer::run_job(job_t job)
+{
+    try
+    {
+        job.fn();
+    } catch(std::exception &e)
+    {
+        spdlog::error("AssetStreamer: job failed: {}", e.what());
+        std::unique_lock lock(m_mutex);
+        job.request->state = StreamState::Failed;
+    }
+
+    std::unique_lock lock(m_mutex);
+    m_num_jobs_in_flight--;
+    dispatch_jobs(lock);
+    m_condition.notify_all();
+}
+
+void AssetStreamer::update()
+{
+    std::unique_lock lock(m_mutex);
+
+    if(m_create_info.pool) { dispatch_jobs(lock); }
+    else
+    {
+        // no threadpool -> run jobs synchronously
+        while(auto job = next_job())
+        {
+            m_num_jobs_in_flight++;
+            lock.unlock();
+            run_job(std::move(*job));
+            lock.lock();
+        }
+    }
+
+    // requests with pending uploads, ordered by priority
+    std::vector<RequestPtr> requests;
+    for(const auto &[handle, request]: m_requests)
+    {
+        if(request->state == StreamState::Uploading) { requests.push_back(request); }
+    }
+    std::ranges::sort(requests, [](const auto &lhs, const auto &rhs) { return lhs->priority > rhs->priority; });
+
+    size_t num_upload_bytes = 0;
+
+    auto fits_budgets = [this, &num_upload_bytes](size_t num_bytes) -> bool {
+        bool fits_gpu_budget = !m_gpu_bytes || m_gpu_bytes + num_bytes <= m_create_info.gpu_budget;
+        bool fits_upload_budget = !num_upload_bytes || num_upload_bytes + num_bytes <= m_create_info.max_upload_bytes;
+        return fits_gpu_budget && fits_upload_budget;
+    };
+
+    for(const auto &request: requests)
+    {
+        if(request->released) { continue; }
+
+        if(!request->mesh_published)
+        {
+            size_t geometry_bytes = num_bytes(request->mesh_assets->geometry_data);
+            if(!fits_budgets(geometry_bytes)) { continue; }
+
+            lock.unlock();
+            upload_mesh(request);
+            lock.lock();
+
+            request->mesh_published = true;
+            request->cpu_bytes -= geometry_bytes;
+            request->gpu_bytes += geometry_bytes;
+            num_upload_bytes += geometry_bytes;
+
+            if(!request->released)
+            {
+                m_cpu_bytes -= geometry_bytes;
+                m_gpu_bytes += geometry_bytes;
+            }
+        }
+
+        while(!request->ready_textures.empty() && !request->released)
+        {
+            auto texture_id = request->ready_textures.front();
+            size_t texture_bytes = num_bytes(request->mesh_assets->textures.at(texture_id));
+            if(!fits_budgets(texture_bytes)) { break; }
+            request->ready_textures.pop_front();
+
+            lock.unlock();
+            upload_texture(request, texture_id);
+            lock.lock();
+
+            request->cpu_bytes -= texture_bytes;
+            request->gpu_bytes += texture_bytes;
+            num_upload_bytes += texture_bytes;
+
+            if(!request->released)
+            {
+                m_cpu_bytes -= texture_bytes;
+                m_gpu_bytes += texture_bytes;
+            }
+        }
+
+        if(!request->released && !request->num_pending_textures && request->ready_textures.empty() &&
+           request->mesh_published)
+        {
+            request->state = StreamState::Done;
+            request->mesh_assets.reset();
+            m_cpu_bytes -= request->cpu_bytes;
+            request->cpu_bytes = 0;
+        }
+    }
+
+    // submit batched uploads, if any
+    if(m_create_info.load_params.upload_queue) { m_create_info.load_params.upload_queue->flush(); }
+
+    // budgets might have changed
+    dispatch_jobs(lock);
+}
+
+void AssetStreamer::upload_mesh(const RequestPtr &request)
+{
+    auto &assets = *request->mesh_assets;
+
+    // textures are uploaded individually, geometry is moved out to free memory
+    model::model_assets_t mesh_assets = {};
+    mesh_assets.geometry_data = std::move(assets.geometry_data);
+    mesh_assets.materials = assets.materials;
+    mesh_assets.texture_samplers = assets.texture_samplers;
+    mesh_assets.lights = assets.lights;
+    mesh_assets.light_instances = assets.light_instances;
+    mesh_assets.cameras = assets.cameras;
+    mesh_assets.root_node = assets.root_node;
+    mesh_assets.root_bone = assets.root_bone;
+    mesh_assets.node_animations = assets.node_animations;
+    mesh_assets.omm_data = assets.omm_data;
+
+    // OMMs were baked during parsing, while uncompressed textures were available
+    auto load_params = m_create_info.load_params;
+    load_params.omm_params = {};
+
+    auto result = model::load_mesh(load_params, mesh_assets);
+    m_create_info.asset_provider->populate(result);
+    if(m_create_info.mesh_fn) { m_create_info.mesh_fn(request->handle, result); }
+}
+
+void AssetStreamer::upload_texture(const RequestPtr &request, const vierkant::TextureId &texture_id)
+{
+    const auto &device = m_create_info.load_params.device;
+    const auto &upload_queue = m_create_info.load_params.upload_queue;
+    auto load_queue = m_create_info.load_params.load_queue ? m_create_info.load_params.load_queue : device->queue();
+    auto &texture_variant = request->mesh_assets->textures.at(texture_id);
+
+    auto vk_img = std::visit(
+            [&device, &upload_queue, load_queue](auto &&img) -> vierkant::ImagePtr {
+                using T = std::decay_t<decltype(img)>;
+
+                if constexpr(std::is_same_v<T, crocore::ImagePtr>)
+                {
+                    if(upload_queue) { return model::create_texture_async(upload_queue, img); }
+                    return model::create_texture(device, img, {}, load_queue);
+                }
+                else
+                {
+                    vierkant::Image::Format fmt;
+                    fmt.max_anisotropy = device->properties().core.limits.maxSamplerAnisotropy;
+                    if(upload_queue) { return model::create_compressed_texture_async(upload_queue, {&img, 1}, fmt); }
+                    return model::create_compressed_texture(device, img, fmt, load_queue);
+                }
+            },
+            texture_variant);
+
+    // release cpu-data
+    texture_variant = crocore::ImagePtr();
+    if(!vk_img) { return; }
+
+    model::load_mesh_result_t result;
+    result.textures[{texture_id, vierkant::SamplerId::nil()}] = vk_img;
+    result.samplers = std::move(request->samplers);
+    model::create_sampled_textures(device, *request->mesh_assets, result);
+    m_create_info.asset_provider->populate(result);
+    request->samplers = std::move(result.samplers);
+}
+
+}// namespace vierkant
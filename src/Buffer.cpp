@@ -131,8 +131,14 @@ BufferPtr Buffer::create(DevicePtr device, const void *data, size_t num_bytes, V
 
 Buffer::Buffer(const create_info_t &create_info)
     : m_device(create_info.device), m_usage(create_info.usage), m_mem_usage(create_info.mem_usage),
-      m_min_alignment(create_info.alignment), m_pool(create_info.pool), m_name(create_info.name)
-{}
+      m_min_alignment(create_info.alignment), m_pool(create_info.pool), m_name(create_info.name),
+      m_memory_category(create_info.memory_category)
+{
+    if(m_memory_category == MemoryCategory::UNDEFINED)
+    {
+        m_memory_category = vierkant::memory_category_from_usage(m_usage, m_mem_usage);
+    }
+}
 
 Buffer::~Buffer()
 {
@@ -140,7 +146,11 @@ Buffer::~Buffer()
     unmap();
 
     // destroy buffer
-    if(m_buffer) { vmaDestroyBuffer(m_device->vk_mem_allocator(), m_buffer, m_allocation); }
+    if(m_buffer)
+    {
+        m_device->memory_tracker().remove(m_memory_category, m_allocation);
+        vmaDestroyBuffer(m_device->vk_mem_allocator(), m_buffer, m_allocation);
+    }
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -176,6 +186,15 @@ void Buffer::unmap()
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
+VkBufferUsageFlags Buffer::create_usage_flags() const
+{
+    // device-local contents can only be written and relocated via transfers
+    if(!is_host_visible()) { return m_usage | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT; }
+    return m_usage;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
 VkBuffer Buffer::handle() const { return m_buffer; }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -195,6 +214,7 @@ void Buffer::set_data(const void *data, size_t num_bytes)
         if(m_buffer)
         {
             unmap();
+            m_device->memory_tracker().remove(m_memory_category, m_allocation);
             vmaDestroyBuffer(m_device->vk_mem_allocator(), m_buffer, m_allocation);
         }
 
@@ -202,16 +222,27 @@ void Buffer::set_data(const void *data, size_t num_bytes)
         VkBufferCreateInfo buffer_info = {};
         buffer_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
         buffer_info.size = num_bytes;
-        buffer_info.usage = m_usage;
-        if(!is_host_visible() && data) { buffer_info.usage |= VK_BUFFER_USAGE_TRANSFER_DST_BIT; }
+        buffer_info.usage = create_usage_flags();
         buffer_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
         VmaAllocationCreateInfo alloc_info = {};
         alloc_info.usage = m_mem_usage;
         alloc_info.pool = m_pool.get();
 
+        // use a dedicated pool for our category, if configured
+        uint32_t memory_type_index;
+        if(!alloc_info.pool && vmaFindMemoryTypeIndexForBufferInfo(m_device->vk_mem_allocator(), &buffer_info,
+                                                                   &alloc_info, &memory_type_index) == VK_SUCCESS)
+        {
+            alloc_info.pool = m_device->memory_pool(m_memory_category, memory_type_index);
+        }
+
         vmaCreateBufferWithAlignment(m_device->vk_mem_allocator(), &buffer_info, &alloc_info, m_min_alignment,
                                      &m_buffer, &m_allocation, &m_allocation_info);
+        m_device->memory_tracker().add(m_memory_category, m_allocation);
+
+        // allows mapping allocations back to buffers, e.g. during defragmentation
+        vmaSetAllocationUserData(m_device->vk_mem_allocator(), m_allocation, this);
 
         //! set optional name for debugging
         if(!m_name.empty()) { m_device->set_object_name(uint64_t(m_buffer), VK_OBJECT_TYPE_BUFFER, m_name); }
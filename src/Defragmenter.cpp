@@ -0,0 +1,187 @@
+#include <vierkant/Defragmenter.hpp>
+
+namespace vierkant
+{
+
+DefragmenterPtr Defragmenter::create(const create_info_t &create_info)
+{
+    return DefragmenterPtr(new Defragmenter(create_info));
+}
+
+Defragmenter::Defragmenter(const create_info_t &create_info)
+    : m_device(create_info.device), m_create_info(create_info)
+{
+    m_queue = m_device->queue(m_create_info.queue_type);
+    m_command_pool =
+            vierkant::create_command_pool(m_device, m_create_info.queue_type, VK_COMMAND_POOL_CREATE_TRANSIENT_BIT);
+}
+
+Defragmenter::~Defragmenter() { end_pool(); }
+
+void Defragmenter::begin_next_pool()
+{
+    std::vector<VmaPool> pools = m_device->memory_pools();
+    if(m_create_info.default_pools) { pools.insert(pools.begin(), VK_NULL_HANDLE); }
+    if(pools.empty()) { return; }
+
+    m_pool = pools[m_pool_index++ % pools.size()];
+
+    VmaDefragmentationInfo defrag_info = {};
+    defrag_info.flags = m_create_info.flags;
+    defrag_info.pool = m_pool;
+    defrag_info.maxBytesPerPass = m_create_info.max_bytes_per_pass;
+    defrag_info.maxAllocationsPerPass = m_create_info.max_allocations_per_pass;
+
+    if(vmaBeginDefragmentation(m_device->vk_mem_allocator(), &defrag_info, &m_context) != VK_SUCCESS)
+    {
+        spdlog::warn("Defragmenter: could not begin defragmentation");
+        m_context = VK_NULL_HANDLE;
+    }
+}
+
+void Defragmenter::end_pool()
+{
+    if(!m_context) { return; }
+
+    VmaDefragmentationStats defrag_stats = {};
+    vmaEndDefragmentation(m_device->vk_mem_allocator(), m_context, &defrag_stats);
+    m_context = VK_NULL_HANDLE;
+    m_stats.num_bytes_moved += defrag_stats.bytesMoved;
+    m_stats.num_bytes_freed += defrag_stats.bytesFreed;
+    m_stats.num_allocations_moved += defrag_stats.allocationsMoved;
+    m_stats.num_device_memory_blocks_freed += defrag_stats.deviceMemoryBlocksFreed;
+}
+
+bool Defragmenter::run_pass(uint32_t &num_relocations)
+{
+    auto allocator = m_device->vk_mem_allocator();
+
+    VmaDefragmentationPassMoveInfo pass_info = {};
+    if(vmaBeginDefragmentationPass(allocator, m_context, &pass_info) == VK_SUCCESS) { return false; }
+    m_stats.num_passes++;
+
+    std::vector<relocation_t> relocations;
+
+    auto command_buffer = vierkant::CommandBuffer(m_device, m_command_pool.get());
+    command_buffer.begin();
+
+    // order copies after all prior work on the queue
+    vierkant::stage_barrier(command_buffer.handle(), VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+                            VK_ACCESS_2_MEMORY_WRITE_BIT, VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+                            VK_ACCESS_2_TRANSFER_READ_BIT | VK_ACCESS_2_TRANSFER_WRITE_BIT);
+
+    for(uint32_t i = 0; i < pass_info.moveCount; ++i)
+    {
+        auto &move = pass_info.pMoves[i];
+
+        VmaAllocationInfo allocation_info;
+        vmaGetAllocationInfo(allocator, move.srcAllocation, &allocation_info);
+        auto buffer = static_cast<vierkant::Buffer *>(allocation_info.pUserData);
+
+        bool movable = buffer && buffer->m_buffer && !buffer->is_host_visible() &&
+                       !(buffer->m_usage & VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_STORAGE_BIT_KHR);
+        if(!movable)
+        {
+            move.operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_IGNORE;
+            m_stats.num_allocations_ignored++;
+            continue;
+        }
+
+        // create a new buffer, bound to the destination-allocation
+        VkBufferCreateInfo buffer_info = {};
+        buffer_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        buffer_info.size = buffer->m_num_bytes;
+        buffer_info.usage = buffer->create_usage_flags();
+        buffer_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+        VkBuffer new_buffer = VK_NULL_HANDLE;
+        if(vkCreateBuffer(m_device->handle(), &buffer_info, nullptr, &new_buffer) != VK_SUCCESS ||
+           vmaBindBufferMemory(allocator, move.dstTmpAllocation, new_buffer) != VK_SUCCESS)
+        {
+            vkDestroyBuffer(m_device->handle(), new_buffer, nullptr);
+            move.operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_IGNORE;
+            m_stats.num_allocations_ignored++;
+            continue;
+        }
+
+        VkBufferCopy2 copy_region = {};
+        copy_region.sType = VK_STRUCTURE_TYPE_BUFFER_COPY_2;
+        copy_region.size = buffer->m_num_bytes;
+
+        VkCopyBufferInfo2 copy_info = {};
+        copy_info.sType = VK_STRUCTURE_TYPE_COPY_BUFFER_INFO_2;
+        copy_info.srcBuffer = buffer->m_buffer;
+        copy_info.dstBuffer = new_buffer;
+        copy_info.regionCount = 1;
+        copy_info.pRegions = &copy_region;
+        vkCmdCopyBuffer2(command_buffer.handle(), &copy_info);
+
+        relocation_t relocation = {};
+        relocation.buffer = buffer;
+        relocation.old_handle = buffer->m_buffer;
+        relocation.new_handle = new_buffer;
+        relocation.old_device_address = buffer->m_device_address;
+        relocations.push_back(relocation);
+    }
+
+    vierkant::stage_barrier(command_buffer.handle(), VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                            VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+                            VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT);
+    command_buffer.submit(m_queue, true);
+
+    // copies are complete, swap handles and release old buffers
+    for(auto &relocation: relocations)
+    {
+        auto buffer = relocation.buffer;
+        vkDestroyBuffer(m_device->handle(), relocation.old_handle, nullptr);
+        buffer->m_buffer = relocation.new_handle;
+
+        if(!buffer->m_name.empty())
+        {
+            m_device->set_object_name(uint64_t(buffer->m_buffer), VK_OBJECT_TYPE_BUFFER, buffer->m_name);
+        }
+
+        if(buffer->m_usage & VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT)
+        {
+            VkBufferDeviceAddressInfo address_info = {};
+            address_info.sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO;
+            address_info.buffer = buffer->m_buffer;
+            buffer->m_device_address = vkGetBufferDeviceAddress(m_device->handle(), &address_info);
+        }
+        relocation.new_device_address = buffer->m_device_address;
+    }
+
+    // moves allocations into their new place
+    bool pending = vmaEndDefragmentationPass(allocator, m_context, &pass_info) == VK_INCOMPLETE;
+
+    for(const auto &relocation: relocations)
+    {
+        vmaGetAllocationInfo(allocator, relocation.buffer->m_allocation, &relocation.buffer->m_allocation_info);
+        if(relocation_delegate) { relocation_delegate(relocation); }
+    }
+    num_relocations += relocations.size();
+    return pending;
+}
+
+uint32_t Defragmenter::update(std::chrono::nanoseconds time_budget)
+{
+    auto start_time = std::chrono::steady_clock::now();
+    uint32_t num_relocations = 0;
+    size_t num_pools = m_device->memory_pools().size() + (m_create_info.default_pools ? 1 : 0);
+    size_t num_pools_completed = 0;
+
+    while(num_pools_completed < num_pools && std::chrono::steady_clock::now() - start_time < time_budget)
+    {
+        if(!m_context) { begin_next_pool(); }
+        if(!m_context) { break; }
+
+        if(!run_pass(num_relocations))
+        {
+            end_pool();
+            num_pools_completed++;
+        }
+    }
+    return num_relocations;
+}
+
+}// namespace vierkant
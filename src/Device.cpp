@@ -210,6 +210,14 @@ Device::Device(const create_info_t &create_info) : m_physical_device(create_info
     // use KHR_unified_image_layouts when available
     enable_extension(VK_KHR_UNIFIED_IMAGE_LAYOUTS_EXTENSION_NAME);
 
+    // memory-budgets per heap, used by vma if available
+    bool use_memory_budget = vierkant::check_device_extension_support(create_info.physical_device,
+                                                                      {VK_EXT_MEMORY_BUDGET_EXTENSION_NAME});
+    if(use_memory_budget && !crocore::contains(extensions, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME))
+    {
+        extensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+    }
+
     // TODO: present fifo-latest-ready
     // enable_extension(VK_EXT_PRESENT_MODE_FIFO_LATEST_READY_EXTENSION_NAME);
 
@@ -429,7 +437,11 @@ Device::Device(const create_info_t &create_info) : m_physical_device(create_info
         allocator_info.flags |= VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT;
     }
 
+    if(use_memory_budget) { allocator_info.flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT; }
+
     vmaCreateAllocator(&allocator_info, &m_vk_mem_allocator);
+    m_memory_tracker = std::make_unique<vierkant::MemoryTracker>(m_vk_mem_allocator);
+    m_memory_pool_block_sizes = create_info.memory_pool_block_sizes;
     m_max_usable_samples = max_usable_sample_count(m_physical_device);
 }
 
@@ -447,6 +459,9 @@ Device::~Device()
         vkDestroyCommandPool(m_device, m_command_pool_transient, nullptr);
         m_command_pool_transient = nullptr;
     }
+    m_memory_pools.clear();
+    m_memory_tracker.reset();
+
     if(m_vk_mem_allocator)
     {
         vmaDestroyAllocator(m_vk_mem_allocator);
@@ -461,6 +476,45 @@ Device::~Device()
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+VmaPool Device::memory_pool(vierkant::MemoryCategory category, uint32_t memory_type_index) const
+{
+    auto block_size_it = m_memory_pool_block_sizes.find(category);
+    if(block_size_it == m_memory_pool_block_sizes.end()) { return VK_NULL_HANDLE; }
+
+    std::lock_guard lock(m_memory_pool_mutex);
+    auto &pool = m_memory_pools[{category, memory_type_index}];
+
+    if(!pool)
+    {
+        VmaPoolCreateInfo pool_create_info = {};
+        pool_create_info.memoryTypeIndex = memory_type_index;
+        pool_create_info.blockSize = block_size_it->second;
+
+        VmaPool vma_pool = VK_NULL_HANDLE;
+        if(vmaCreatePool(m_vk_mem_allocator, &pool_create_info, &vma_pool) != VK_SUCCESS)
+        {
+            spdlog::warn("Device: could not create memory-pool (category: {}, memory-type: {})",
+                         static_cast<uint32_t>(category), memory_type_index);
+            m_memory_pools.erase({category, memory_type_index});
+            return VK_NULL_HANDLE;
+        }
+
+        // pools are owned by the device, capture the raw allocator-handle
+        pool = {vma_pool, [allocator = m_vk_mem_allocator](VmaPool p) { vmaDestroyPool(allocator, p); }};
+    }
+    return pool.get();
+}
+
+std::vector<VmaPool> Device::memory_pools() const
+{
+    std::lock_guard lock(m_memory_pool_mutex);
+    std::vector<VmaPool> ret;
+    for(const auto &[key, pool]: m_memory_pools) { ret.push_back(pool.get()); }
+    return ret;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 VkQueue Device::queue(Queue type) const
 {
     auto queue_it = m_queues.find(type);
@@ -0,0 +1,78 @@
+#include <vierkant/FrameArena.hpp>
+
+namespace vierkant
+{
+
+//! alignment for blocks allocated from upstream
+constexpr size_t block_alignment = alignof(std::max_align_t);
+
+FrameArenaPtr FrameArena::create(const create_info_t &create_info)
+{
+    return FrameArenaPtr(new FrameArena(create_info));
+}
+
+FrameArena::FrameArena(const create_info_t &create_info)
+    : m_upstream(create_info.upstream ? create_info.upstream : std::pmr::new_delete_resource())
+{
+    add_block(std::max<size_t>(create_info.num_bytes, 1));
+    m_stats = {};
+}
+
+FrameArena::~FrameArena()
+{
+    for(const auto &block: m_blocks) { m_upstream->deallocate(block.data, block.num_bytes, block_alignment); }
+}
+
+void FrameArena::add_block(size_t num_bytes)
+{
+    block_t block = {};
+    block.data = static_cast<uint8_t *>(m_upstream->allocate(num_bytes, block_alignment));
+    block.num_bytes = num_bytes;
+    m_blocks.push_back(block);
+    m_offset = 0;
+    m_stats.num_upstream_allocations++;
+}
+
+void FrameArena::reset()
+{
+    // coalesce overflow-blocks into a single block, large enough for the last frame
+    if(m_blocks.size() > 1)
+    {
+        size_t num_bytes = capacity();
+        for(const auto &block: m_blocks) { m_upstream->deallocate(block.data, block.num_bytes, block_alignment); }
+        m_blocks.clear();
+        add_block(num_bytes);
+    }
+    m_offset = 0;
+    m_last_frame_stats = m_stats;
+    m_stats = {};
+}
+
+size_t FrameArena::capacity() const
+{
+    size_t ret = 0;
+    for(const auto &block: m_blocks) { ret += block.num_bytes; }
+    return ret;
+}
+
+void *FrameArena::do_allocate(size_t num_bytes, size_t alignment)
+{
+    auto aligned_offset = [this](size_t align) {
+        auto address = reinterpret_cast<uintptr_t>(m_blocks.back().data) + m_offset;
+        return m_offset + (align - address % align) % align;
+    };
+    size_t offset = aligned_offset(alignment);
+
+    // overflow, continue in a new block
+    if(offset + num_bytes > m_blocks.back().num_bytes)
+    {
+        add_block(std::max(num_bytes + alignment, capacity()));
+        offset = aligned_offset(alignment);
+    }
+    m_stats.num_bytes += offset + num_bytes - m_offset;
+    m_stats.num_allocations++;
+    m_offset = offset + num_bytes;
+    return m_blocks.back().data + offset;
+}
+
+}// namespace vierkant
@@ -256,8 +256,9 @@ Image::Image(DevicePtr device, const void *data, const VkImagePtr &shared_image,
         // number of images in the mipmap chain
         m_num_mip_levels = static_cast<uint32_t>(std::floor(std::log2(std::max(width(), height())))) + 1;
 
-        // BC7 has blocks >= 4 pixels and thus 2 levels less
-        bool compressed = m_format.format == VK_FORMAT_BC7_UNORM_BLOCK || m_format.format == VK_FORMAT_BC7_SRGB_BLOCK;
+        // BCn has blocks >= 4 pixels and thus 2 levels less
+        bool compressed =
+                m_format.format >= VK_FORMAT_BC1_RGB_UNORM_BLOCK && m_format.format <= VK_FORMAT_BC7_SRGB_BLOCK;
         if(compressed) { m_num_mip_levels = std::max(static_cast<int32_t>(m_num_mip_levels) - 2, 1); }
 
         // in order to generate mipmaps we need to be able to transfer from base mip-level
@@ -294,13 +295,27 @@ Image::Image(DevicePtr device, const void *data, const VkImagePtr &shared_image,
         alloc_info.usage = m_format.memory_usage;
         alloc_info.pool = m_format.memory_pool.get();
 
+        auto memory_category = m_format.memory_category == MemoryCategory::UNDEFINED
+                                       ? vierkant::memory_category_from_usage(img_usage)
+                                       : m_format.memory_category;
+
+        // use a dedicated pool for our category, if configured
+        uint32_t memory_type_index;
+        if(!alloc_info.pool && vmaFindMemoryTypeIndexForImageInfo(m_device->vk_mem_allocator(), &image_create_info,
+                                                                  &alloc_info, &memory_type_index) == VK_SUCCESS)
+        {
+            alloc_info.pool = m_device->memory_pool(memory_category, memory_type_index);
+        }
+
         VkImage image;
         VmaAllocation allocation;
         vmaCreateImage(m_device->vk_mem_allocator(), &image_create_info, &alloc_info, &image, &allocation, nullptr);
+        m_device->memory_tracker().add(memory_category, allocation);
 
         // debug name
         if(!m_format.name.empty()) { m_device->set_object_name(uint64_t(image), VK_OBJECT_TYPE_IMAGE, m_format.name); }
-        m_image = VkImagePtr(image, [device = m_device, allocation](VkImage img) {
+        m_image = VkImagePtr(image, [device = m_device, allocation, memory_category](VkImage img) {
+            device->memory_tracker().remove(memory_category, allocation);
             vmaDestroyImage(device->vk_mem_allocator(), img, allocation);
         });
     }
@@ -436,7 +451,8 @@ void Image::transition_layout(VkImageLayout new_layout, VkCommandBuffer cmd_buff
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 void Image::barrier(VkImageLayout new_layout, VkCommandBuffer command_buffer, VkPipelineStageFlags2 src_stage,
-                    VkAccessFlags2 src_access, VkPipelineStageFlags2 dst_stage, VkAccessFlags2 dst_access)
+                    VkAccessFlags2 src_access, VkPipelineStageFlags2 dst_stage, VkAccessFlags2 dst_access,
+                    uint32_t src_queue_family, uint32_t dst_queue_family)
 {
 
     VkImageMemoryBarrier2 barrier = {};
@@ -448,7 +464,8 @@ void Image::barrier(VkImageLayout new_layout, VkCommandBuffer command_buffer, Vk
     barrier.subresourceRange.layerCount = m_format.num_layers;
     barrier.subresourceRange.aspectMask = m_format.aspect;
 
-    barrier.srcQueueFamilyIndex = barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.srcQueueFamilyIndex = src_queue_family;
+    barrier.dstQueueFamilyIndex = dst_queue_family;
     barrier.srcStageMask = src_stage;
     barrier.srcAccessMask = src_access;
     barrier.oldLayout = *m_image_layout;
@@ -804,6 +821,7 @@ bool Image::Format::operator==(const Image::Format &other) const
     if(memory_pool != other.memory_pool) { return false; }
     if(initial_cmd_buffer != other.initial_cmd_buffer) { return false; }
     if(name != other.name) { return false; }
+    if(memory_category != other.memory_category) { return false; }
     return true;
 }
 
@@ -847,5 +865,6 @@ size_t std::hash<vierkant::Image::Format>::operator()(vierkant::Image::Format co
     hash_combine(h, fmt.memory_pool);
     hash_combine(h, fmt.initial_cmd_buffer);
     hash_combine(h, fmt.name);
+    hash_combine(h, fmt.memory_category);
     return h;
 }
@@ -0,0 +1,120 @@
+#include <cassert>
+#include <vierkant/MemoryTracker.hpp>
+
+namespace vierkant
+{
+
+MemoryCategory memory_category_from_usage(VkBufferUsageFlags usage, VmaMemoryUsage mem_usage)
+{
+    if(usage & VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_STORAGE_BIT_KHR)
+    {
+        return MemoryCategory::ACCELERATION_STRUCTURE;
+    }
+    if(usage & (VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT)) { return MemoryCategory::MESH; }
+    if(mem_usage == VMA_MEMORY_USAGE_CPU_ONLY && (usage & VK_BUFFER_USAGE_TRANSFER_SRC_BIT))
+    {
+        return MemoryCategory::STAGING;
+    }
+    return MemoryCategory::OTHER;
+}
+
+MemoryCategory memory_category_from_usage(VkImageUsageFlags usage)
+{
+    constexpr VkImageUsageFlags render_target_usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+                                                      VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT |
+                                                      VK_IMAGE_USAGE_STORAGE_BIT;
+    return (usage & render_target_usage) ? MemoryCategory::RENDER_TARGET : MemoryCategory::TEXTURE;
+}
+
+MemoryTracker::MemoryTracker(VmaAllocator allocator) : m_allocator(allocator)
+{
+    const VkPhysicalDeviceMemoryProperties *memory_properties = nullptr;
+    vmaGetMemoryProperties(m_allocator, &memory_properties);
+    m_memory_properties = *memory_properties;
+}
+
+void MemoryTracker::add(MemoryCategory category, VmaAllocation allocation)
+{
+    if(!allocation) { return; }
+    auto category_index = static_cast<uint32_t>(category);
+    assert(category_index < num_categories);
+
+    VmaAllocationInfo allocation_info;
+    vmaGetAllocationInfo(m_allocator, allocation, &allocation_info);
+    uint32_t heap_index = m_memory_properties.memoryTypes[allocation_info.memoryType].heapIndex;
+    m_num_bytes[category_index][heap_index] += allocation_info.size;
+    m_num_allocations[category_index]++;
+}
+
+void MemoryTracker::remove(MemoryCategory category, VmaAllocation allocation)
+{
+    if(!allocation) { return; }
+    auto category_index = static_cast<uint32_t>(category);
+    assert(category_index < num_categories);
+
+    VmaAllocationInfo allocation_info;
+    vmaGetAllocationInfo(m_allocator, allocation, &allocation_info);
+    uint32_t heap_index = m_memory_properties.memoryTypes[allocation_info.memoryType].heapIndex;
+    m_num_bytes[category_index][heap_index] -= allocation_info.size;
+    m_num_allocations[category_index]--;
+}
+
+MemoryTracker::category_stats_t MemoryTracker::stats(MemoryCategory category) const
+{
+    auto category_index = static_cast<uint32_t>(category);
+    assert(category_index < num_categories);
+
+    category_stats_t ret = {};
+    for(uint32_t i = 0; i < m_memory_properties.memoryHeapCount; ++i)
+    {
+        ret.num_bytes += m_num_bytes[category_index][i];
+    }
+    ret.num_allocations = m_num_allocations[category_index];
+    return ret;
+}
+
+VkDeviceSize MemoryTracker::num_bytes(MemoryCategory category, uint32_t heap_index) const
+{
+    auto category_index = static_cast<uint32_t>(category);
+    if(category_index >= num_categories || heap_index >= m_memory_properties.memoryHeapCount) { return 0; }
+    return m_num_bytes[category_index][heap_index];
+}
+
+std::vector<MemoryTracker::heap_stats_t> MemoryTracker::heap_stats() const
+{
+    std::array<VmaBudget, VK_MAX_MEMORY_HEAPS> budgets = {};
+    vmaGetHeapBudgets(m_allocator, budgets.data());
+
+    std::vector<heap_stats_t> ret(m_memory_properties.memoryHeapCount);
+
+    for(uint32_t i = 0; i < ret.size(); ++i)
+    {
+        auto &heap = ret[i];
+        heap.heap_index = i;
+        heap.flags = m_memory_properties.memoryHeaps[i].flags;
+        heap.size = m_memory_properties.memoryHeaps[i].size;
+        heap.usage = budgets[i].usage;
+        heap.budget = budgets[i].budget;
+        heap.block_bytes = budgets[i].statistics.blockBytes;
+        for(uint32_t c = 0; c < num_categories; ++c) { heap.category_bytes[c] = m_num_bytes[c][i]; }
+    }
+    return ret;
+}
+
+void MemoryTracker::update()
+{
+    // refreshes cached budgets, fetched via VK_EXT_memory_budget
+    vmaSetCurrentFrameIndex(m_allocator, ++m_frame_index);
+
+    if(!budget_exceeded_delegate) { return; }
+
+    for(const auto &heap: heap_stats())
+    {
+        if(heap.budget && static_cast<double>(heap.usage) > budget_threshold * static_cast<double>(heap.budget))
+        {
+            budget_exceeded_delegate(heap);
+        }
+    }
+}
+
+}// namespace vierkant
@@ -4,6 +4,7 @@
 #include <crocore/utils.hpp>
 #include <meshoptimizer.h>
 #include <vierkant/Mesh.hpp>
+#include <vierkant/cluster_lod.hpp>
 #include <vierkant/vertex_splicer.hpp>
 
 namespace vierkant
@@ -132,11 +133,13 @@ vierkant::MeshPtr Mesh::create_from_bundle(const vierkant::DevicePtr &device,
     num_staging_bytes += num_array_bytes(mesh_buffer_bundle.meshlets);
     num_staging_bytes += num_array_bytes(mesh_buffer_bundle.meshlet_vertices);
     num_staging_bytes += num_array_bytes(mesh_buffer_bundle.meshlet_triangles);
+    num_staging_bytes += num_array_bytes(mesh_buffer_bundle.meshlet_lods);
 
     auto staging_buffer = create_info.staging_buffer;
 
-    // combine buffers into staging buffer
-    if(!staging_buffer)
+    // combine buffers into staging buffer, not required for asynchronous uploads
+    if(create_info.upload_queue) { staging_buffer = nullptr; }
+    else if(!staging_buffer)
     {
         staging_buffer = vierkant::Buffer::create(device, nullptr, num_staging_bytes, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
                                                   VMA_MEMORY_USAGE_CPU_ONLY);
@@ -147,26 +150,40 @@ vierkant::MeshPtr Mesh::create_from_bundle(const vierkant::DevicePtr &device,
     }
 
     auto staging_copy = [num_array_bytes, staging_buffer, &staging_offset, command_buffer = create_info.command_buffer,
+                         upload_queue = create_info.upload_queue,
                          device](const auto &array, vierkant::BufferPtr &outbuffer, VkBufferUsageFlags flags) {
         flags |= VK_BUFFER_USAGE_TRANSFER_DST_BIT;
 
         size_t num_bytes = num_array_bytes(array);
 
-        assert(staging_buffer->num_bytes() - num_bytes >= staging_offset);
-
-        // copy array into staging-buffer
-        auto staging_data = static_cast<uint8_t *>(staging_buffer->map()) + staging_offset;
-        memcpy(staging_data, array.data(), num_bytes);
-
         if(!outbuffer)
         {
-            outbuffer = vierkant::Buffer::create(device, nullptr, num_bytes, flags, VMA_MEMORY_USAGE_GPU_ONLY);
+            vierkant::Buffer::create_info_t buffer_info = {};
+            buffer_info.device = device;
+            buffer_info.num_bytes = num_bytes;
+            buffer_info.usage = flags;
+            buffer_info.mem_usage = VMA_MEMORY_USAGE_GPU_ONLY;
+            buffer_info.memory_category = vierkant::MemoryCategory::MESH;
+            outbuffer = vierkant::Buffer::create(buffer_info);
         }
         else
         {
             outbuffer->set_data(nullptr, num_bytes);
         }
 
+        // asynchronous upload via transfer-queue
+        if(upload_queue)
+        {
+            upload_queue->upload(outbuffer, array.data(), num_bytes);
+            return;
+        }
+
+        assert(staging_buffer->num_bytes() - num_bytes >= staging_offset);
+
+        // copy array into staging-buffer
+        auto staging_data = static_cast<uint8_t *>(staging_buffer->map()) + staging_offset;
+        memcpy(staging_data, array.data(), num_bytes);
+
         // issue copy from staging-buffer to GPU-buffer
         staging_buffer->copy_to(outbuffer, command_buffer, staging_offset, 0, num_bytes);
         staging_offset += num_bytes;
@@ -197,6 +214,11 @@ vierkant::MeshPtr Mesh::create_from_bundle(const vierkant::DevicePtr &device,
         staging_copy(mesh_buffer_bundle.meshlets, mesh->meshlets, buffer_flags);
         staging_copy(mesh_buffer_bundle.meshlet_vertices, mesh->meshlet_vertices, buffer_flags);
         staging_copy(mesh_buffer_bundle.meshlet_triangles, mesh->meshlet_triangles, buffer_flags);
+
+        if(!mesh_buffer_bundle.meshlet_lods.empty())
+        {
+            staging_copy(mesh_buffer_bundle.meshlet_lods, mesh->meshlet_lods, buffer_flags);
+        }
     }
 
     if(!mesh_buffer_bundle.bone_vertex_buffer.empty())
@@ -274,6 +296,9 @@ mesh_buffer_bundle_t create_mesh_buffers(const std::vector<Mesh::entry_create_in
         size_t num_morph_targets = 0;
 
         std::vector<vierkant::Mesh::lod_t> lods;
+
+        uint32_t base_cluster_meshlet = 0;
+        uint32_t num_cluster_meshlets = 0;
     };
     std::map<vierkant::GeometryConstPtr, extra_offset_t> extra_offset_map;
 
@@ -595,6 +620,68 @@ mesh_buffer_bundle_t create_mesh_buffers(const std::vector<Mesh::entry_create_in
         }
     }
 
+    // optional hierarchical cluster-lod generation
+    if(params.generate_meshlets && params.generate_cluster_lods)
+    {
+        spdlog::stopwatch sw;
+
+        // meshlets for discrete LODs are always selected
+        ret.meshlet_lods.resize(ret.meshlets.size());
+
+        vierkant::cluster_lod_params_t cluster_lod_params = {};
+        cluster_lod_params.max_vertices = params.meshlet_max_vertices;
+        cluster_lod_params.max_triangles = params.meshlet_max_triangles;
+        cluster_lod_params.cone_weight = params.meshlet_cone_weight;
+        cluster_lod_params.group_size = params.cluster_lod_group_size;
+
+        for(auto &[geom, offsets]: splicer.offsets)
+        {
+            if(geom->topology != VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST) { continue; }
+
+            spdlog::stopwatch single_timer;
+
+            auto &extra_offsets = extra_offset_map[geom];
+            const auto &lod_0 = extra_offsets.lods.front();
+
+            auto vertices = ret.vertex_buffer.data() + offsets.base_vertex * ret.vertex_stride;
+
+            auto cluster_lod = vierkant::create_cluster_lod(
+                    reinterpret_cast<const float *>(vertices), geom->positions.size(), ret.vertex_stride,
+                    ret.index_buffer.data() + lod_0.base_index, lod_0.num_indices, cluster_lod_params);
+
+            spdlog::trace("generate_cluster_lods: {} ({} triangles -> {} meshlets, {} levels)",
+                          std::chrono::duration_cast<std::chrono::milliseconds>(single_timer.elapsed()),
+                          lod_0.num_indices / 3, cluster_lod.meshlets.size(), cluster_lod.num_levels);
+
+            extra_offsets.base_cluster_meshlet = ret.meshlets.size();
+            extra_offsets.num_cluster_meshlets = cluster_lod.meshlets.size();
+
+            size_t meshlet_vertex_offset = ret.meshlet_vertices.size();
+            size_t meshlet_triangle_offset = ret.meshlet_triangles.size();
+
+            for(auto &m: cluster_lod.meshlets)
+            {
+                m.vertex_offset += meshlet_vertex_offset;
+                m.triangle_offset += meshlet_triangle_offset;
+            }
+
+            // add entry vertex-offset
+            for(auto &v: cluster_lod.meshlet_vertices) { v += offsets.base_vertex; }
+
+            ret.meshlets.insert(ret.meshlets.end(), cluster_lod.meshlets.begin(), cluster_lod.meshlets.end());
+            ret.meshlet_lods.insert(ret.meshlet_lods.end(), cluster_lod.meshlet_lods.begin(),
+                                    cluster_lod.meshlet_lods.end());
+            ret.meshlet_vertices.insert(ret.meshlet_vertices.end(), cluster_lod.meshlet_vertices.begin(),
+                                        cluster_lod.meshlet_vertices.end());
+            ret.meshlet_triangles.insert(ret.meshlet_triangles.end(), cluster_lod.meshlet_triangles.begin(),
+                                         cluster_lod.meshlet_triangles.end());
+        }
+
+        spdlog::debug("generate_cluster_lods: {} ({} mesh(es) - {} meshlets)",
+                      std::chrono::duration_cast<std::chrono::milliseconds>(sw.elapsed()), splicer.offsets.size(),
+                      ret.meshlets.size());
+    }
+
     // keep track of used material-indices
     std::set<uint32_t> material_index_set;
 
@@ -613,6 +700,10 @@ mesh_buffer_bundle_t create_mesh_buffers(const std::vector<Mesh::entry_create_in
         // all LOD base/meshlet indices
         entry.lods = extra_offsets.lods;
 
+        // optional cluster-lod meshlet-range
+        entry.base_cluster_meshlet = extra_offsets.base_cluster_meshlet;
+        entry.num_cluster_meshlets = extra_offsets.num_cluster_meshlets;
+
         // use provided transforms for sub-meshes, if any
         entry.transform = entry_info.transform;
 
@@ -658,6 +749,8 @@ std::hash<vierkant::mesh_buffer_params_t>::operator()(vierkant::mesh_buffer_para
     vierkant::hash_combine(hash_val, params.meshlet_max_vertices);
     vierkant::hash_combine(hash_val, params.meshlet_max_triangles);
     vierkant::hash_combine(hash_val, params.meshlet_cone_weight);
+    vierkant::hash_combine(hash_val, params.generate_cluster_lods);
+    vierkant::hash_combine(hash_val, params.cluster_lod_group_size);
     return hash_val;
 }
 
@@ -717,10 +717,14 @@ vierkant::Framebuffer &PBRDeferred::geometry_pass(cull_result_t &cull_result)
 
             // add descriptor for a jitter-offset
             drawable.descriptors[Rasterizer::BINDING_JITTER_OFFSET] = camera_desc;
+        }
 
-            // stage drawables
-            m_g_renderer_main.stage_drawable(drawable);
-            if(use_gpu_culling)
+        // stage drawables, a single batch per renderer
+        m_g_renderer_main.stage_drawables(cull_result.drawables);
+
+        if(use_gpu_culling)
+        {
+            for(auto &drawable: cull_result.drawables)
             {
                 if(drawable.descriptors.contains(Rasterizer::BINDING_DEPTH_PYRAMID) &&
                    drawable.pipeline_format.specialization)
@@ -728,8 +732,8 @@ vierkant::Framebuffer &PBRDeferred::geometry_pass(cull_result_t &cull_result)
                     //layout (constant_id = 3) const bool post_pass
                     drawable.pipeline_format.specialization->set(3, VK_TRUE);
                 }
-                m_g_renderer_post.stage_drawable(drawable);
             }
+            m_g_renderer_post.stage_drawables(cull_result.drawables);
         }
     }
 
@@ -788,10 +792,14 @@ vierkant::Framebuffer &PBRDeferred::geometry_pass(cull_result_t &cull_result)
             constexpr size_t stride = sizeof(Rasterizer::mesh_draw_t);
             constexpr size_t staging_stride = 2 * sizeof(matrix_struct_t);
 
-            std::vector<VkDeviceAddress> vertex_buffer_addresses;
-            std::vector<vierkant::matrix_struct_t> matrix_data(2 * frame_context.dirty_drawable_indices.size());
-            std::vector<vierkant::material_struct_t> material_data(frame_context.dirty_drawable_indices.size());
-            std::vector<vierkant::staging_copy_info_t> staging_copies;
+            // transient data lives in the rasterizer's frame-arena, which is reset before invoking this delegate
+            std::pmr::memory_resource *arena = m_g_renderer_main.frame_arena().get();
+            std::pmr::vector<VkDeviceAddress> vertex_buffer_addresses(arena);
+            std::pmr::vector<vierkant::matrix_struct_t> matrix_data(2 * frame_context.dirty_drawable_indices.size(),
+                                                                    arena);
+            std::pmr::vector<vierkant::material_struct_t> material_data(frame_context.dirty_drawable_indices.size(),
+                                                                        arena);
+            std::pmr::vector<vierkant::staging_copy_info_t> staging_copies(arena);
             uint32_t i = 0;
 
             // transform updates for drawables
@@ -845,7 +853,7 @@ vierkant::Framebuffer &PBRDeferred::geometry_pass(cull_result_t &cull_result)
             if(!frame_context.mesh_compute_result.vertex_buffer_offsets.empty())
             {
                 vertex_buffer_addresses.reserve(frame_context.mesh_compute_result.vertex_buffer_offsets.size());
-                std::unordered_set<uint32_t> mesh_indices;
+                std::pmr::unordered_set<uint32_t> mesh_indices(arena);
 
                 for(const auto &[obj_id, offset]: frame_context.mesh_compute_result.vertex_buffer_offsets)
                 {
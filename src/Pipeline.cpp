@@ -189,6 +189,7 @@ PipelinePtr Pipeline::create(DevicePtr device, graphics_pipeline_info_t format)
     pipeline_info.subpass = format.subpass;
     pipeline_info.basePipelineHandle = format.base_pipeline;
     pipeline_info.basePipelineIndex = format.base_pipeline_index;
+    if(format.use_descriptor_buffer) { pipeline_info.flags |= VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT; }
 
     VkPipelineRenderingCreateInfo rendering_create_info = {};
     rendering_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO;
@@ -199,11 +200,19 @@ PipelinePtr Pipeline::create(DevicePtr device, graphics_pipeline_info_t format)
     rendering_create_info.stencilAttachmentFormat = format.stencil_attachment_format;
     pipeline_info.pNext = &rendering_create_info;
 
+    VkPipelineCreationFeedback creation_feedback = {};
+    VkPipelineCreationFeedbackCreateInfo feedback_create_info = {};
+    feedback_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_CREATION_FEEDBACK_CREATE_INFO;
+    feedback_create_info.pPipelineCreationFeedback = &creation_feedback;
+    rendering_create_info.pNext = &feedback_create_info;
+
     VkPipeline pipeline = VK_NULL_HANDLE;
     vkCheck(vkCreateGraphicsPipelines(device->handle(), format.pipeline_cache, 1, &pipeline_info, nullptr, &pipeline),
             "failed to create graphics pipeline!");
 
-    return PipelinePtr(new Pipeline(std::move(device), pipeline_layout, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline));
+    auto ret = PipelinePtr(new Pipeline(std::move(device), pipeline_layout, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline));
+    ret->m_creation_feedback = creation_feedback;
+    return ret;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -243,13 +252,21 @@ PipelinePtr Pipeline::create(DevicePtr device, vierkant::raytracing_pipeline_inf
     pipeline_create_info.layout = pipeline_layout;
     pipeline_create_info.maxPipelineRayRecursionDepth = raytracing_info.max_recursion;
 
+    VkPipelineCreationFeedback creation_feedback = {};
+    VkPipelineCreationFeedbackCreateInfo feedback_create_info = {};
+    feedback_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_CREATION_FEEDBACK_CREATE_INFO;
+    feedback_create_info.pPipelineCreationFeedback = &creation_feedback;
+    pipeline_create_info.pNext = &feedback_create_info;
+
     VkPipeline pipeline = VK_NULL_HANDLE;
-    vkCheck(vkCreateRayTracingPipelinesKHR(device->handle(), VK_NULL_HANDLE, VK_NULL_HANDLE, 1, &pipeline_create_info,
-                                           VK_NULL_HANDLE, &pipeline),
+    vkCheck(vkCreateRayTracingPipelinesKHR(device->handle(), VK_NULL_HANDLE, raytracing_info.pipeline_cache, 1,
+                                           &pipeline_create_info, VK_NULL_HANDLE, &pipeline),
             "could not create raytracing pipeline");
 
-    return PipelinePtr(
+    auto ret = PipelinePtr(
             new Pipeline(std::move(device), pipeline_layout, VK_PIPELINE_BIND_POINT_RAY_TRACING_KHR, pipeline));
+    ret->m_creation_feedback = creation_feedback;
+    return ret;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -280,12 +297,20 @@ PipelinePtr Pipeline::create(DevicePtr device, vierkant::compute_pipeline_info_t
     pipeline_create_info.layout = pipeline_layout;
     pipeline_create_info.stage = stage_create_infos.back();
 
+    VkPipelineCreationFeedback creation_feedback = {};
+    VkPipelineCreationFeedbackCreateInfo feedback_create_info = {};
+    feedback_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_CREATION_FEEDBACK_CREATE_INFO;
+    feedback_create_info.pPipelineCreationFeedback = &creation_feedback;
+    pipeline_create_info.pNext = &feedback_create_info;
+
     VkPipeline pipeline = VK_NULL_HANDLE;
-    vkCheck(vkCreateComputePipelines(device->handle(), VK_NULL_HANDLE, 1, &pipeline_create_info, VK_NULL_HANDLE,
-                                     &pipeline),
+    vkCheck(vkCreateComputePipelines(device->handle(), compute_info.pipeline_cache, 1, &pipeline_create_info,
+                                     VK_NULL_HANDLE, &pipeline),
             "could not create compute pipeline");
 
-    return PipelinePtr(new Pipeline(std::move(device), pipeline_layout, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline));
+    auto ret = PipelinePtr(new Pipeline(std::move(device), pipeline_layout, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline));
+    ret->m_creation_feedback = creation_feedback;
+    return ret;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,435 @@
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <functional>
+
+#include <spdlog/spdlog.h>
+#include <vierkant/PipelineCache.hpp>
+#include <vierkant/hash.hpp>
+#include <vierkant/mapped_file.hpp>
+
+namespace vierkant
+{
+
+namespace
+{
+
+//! 'VKPC'
+constexpr uint32_t pipeline_cache_magic = 0x43504B56;
+
+constexpr uint32_t pipeline_cache_version = 1;
+
+//! file-header preceding VkPipelineCache-data, identifying device and driver
+struct pipeline_cache_header_t
+{
+    uint32_t magic = pipeline_cache_magic;
+    uint32_t version = pipeline_cache_version;
+    uint32_t vendor_id = 0;
+    uint32_t device_id = 0;
+    uint32_t driver_version = 0;
+    uint8_t pipeline_cache_uuid[VK_UUID_SIZE] = {};
+    uint64_t num_bytes = 0;
+    uint64_t hash = 0;
+};
+
+pipeline_cache_header_t create_header(const vierkant::DevicePtr &device)
+{
+    const auto &properties = device->properties().core;
+    pipeline_cache_header_t header = {};
+    header.vendor_id = properties.vendorID;
+    header.device_id = properties.deviceID;
+    header.driver_version = properties.driverVersion;
+    memcpy(header.pipeline_cache_uuid, properties.pipelineCacheUUID, VK_UUID_SIZE);
+    return header;
+}
+
+//! read VkPipelineCache-data from a file, empty if missing, corrupted or created by another device/driver
+std::vector<uint8_t> read_cache_data(const vierkant::DevicePtr &device, const std::filesystem::path &path)
+{
+    auto mapped_file = vierkant::MappedFile::create(path);
+    if(!mapped_file || mapped_file->num_bytes() < sizeof(pipeline_cache_header_t)) { return {}; }
+
+    pipeline_cache_header_t header;
+    memcpy(&header, mapped_file->data(), sizeof(header));
+    auto expected = create_header(device);
+    auto data = mapped_file->bytes().subspan(sizeof(pipeline_cache_header_t));
+
+    if(header.magic != expected.magic || header.version != expected.version ||
+       header.vendor_id != expected.vendor_id || header.device_id != expected.device_id ||
+       header.driver_version != expected.driver_version ||
+       memcmp(header.pipeline_cache_uuid, expected.pipeline_cache_uuid, VK_UUID_SIZE) != 0)
+    {
+        spdlog::debug("pipeline-cache: device or driver changed, discarding {}", path.string());
+        return {};
+    }
+
+    if(header.num_bytes != data.size() || header.hash != vierkant::hash_bytes(data.data(), data.size()))
+    {
+        spdlog::warn("pipeline-cache: corrupted file {}", path.string());
+        return {};
+    }
+
+    // driver-header, see VkPipelineCacheHeaderVersionOne
+    VkPipelineCacheHeaderVersionOne vk_header = {};
+    if(data.size() < sizeof(vk_header)) { return {}; }
+    memcpy(&vk_header, data.data(), sizeof(vk_header));
+
+    if(vk_header.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE || vk_header.vendorID != expected.vendor_id ||
+       vk_header.deviceID != expected.device_id ||
+       memcmp(vk_header.pipelineCacheUUID, expected.pipeline_cache_uuid, VK_UUID_SIZE) != 0)
+    {
+        return {};
+    }
+    return {data.begin(), data.end()};
+}
+
+}// namespace
+
+PipelineCache::PipelineCache(vierkant::DevicePtr device, std::filesystem::path cache_path)
+    : m_device(std::move(device)), m_cache_path(std::move(cache_path))
+{
+    std::vector<uint8_t> initial_data;
+    if(!m_cache_path.empty()) { initial_data = read_cache_data(m_device, m_cache_path); }
+
+    // VkPipelineCache is internally synchronized, pipelines are created concurrently from multiple threads
+    VkPipelineCacheCreateInfo create_info = {};
+    create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    create_info.initialDataSize = initial_data.size();
+    create_info.pInitialData = initial_data.data();
+
+    if(vkCreatePipelineCache(m_device->handle(), &create_info, nullptr, &m_pipeline_cache) != VK_SUCCESS)
+    {
+        // retry without potentially rejected initial data
+        create_info.initialDataSize = 0;
+        create_info.pInitialData = nullptr;
+        initial_data.clear();
+        vkCheck(vkCreatePipelineCache(m_device->handle(), &create_info, nullptr, &m_pipeline_cache),
+                "failed to create pipeline-cache");
+    }
+    m_num_loaded_bytes = initial_data.size();
+}
+
+PipelineCache::~PipelineCache()
+{
+    try
+    {
+        if(!m_cache_path.empty()) { save(); }
+    } catch(const std::exception &e)
+    {
+        spdlog::warn("could not save pipeline-cache: {}", e.what());
+    }
+    clear();
+    vkDestroyPipelineCache(m_device->handle(), m_pipeline_cache, nullptr);
+}
+
+bool PipelineCache::save(const std::filesystem::path &path) const
+{
+    auto out_path = path.empty() ? m_cache_path : path;
+    if(out_path.empty()) { return false; }
+
+    // the cache might grow concurrently between size-query and retrieval -> VK_INCOMPLETE, query again
+    std::vector<uint8_t> data;
+    VkResult result;
+    do
+    {
+        size_t num_bytes = 0;
+        result = vkGetPipelineCacheData(m_device->handle(), m_pipeline_cache, &num_bytes, nullptr);
+        if(result != VK_SUCCESS) { break; }
+        data.resize(num_bytes);
+        result = vkGetPipelineCacheData(m_device->handle(), m_pipeline_cache, &num_bytes, data.data());
+        data.resize(num_bytes);
+    } while(result == VK_INCOMPLETE);
+
+    if(result != VK_SUCCESS)
+    {
+        spdlog::warn("could not retrieve pipeline-cache data (VkResult: {})", static_cast<int>(result));
+        return false;
+    }
+
+    auto header = create_header(m_device);
+    header.num_bytes = data.size();
+    header.hash = vierkant::hash_bytes(data.data(), data.size());
+
+    return vierkant::write_file_atomic(out_path, [&header, &data](const std::filesystem::path &tmp_path) {
+        std::ofstream stream(tmp_path, std::ios::binary | std::ios::trunc);
+        stream.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        stream.write(reinterpret_cast<const char *>(data.data()), static_cast<std::streamsize>(data.size()));
+        return stream.good();
+    });
+}
+
+void PipelineCache::merge(const PipelineCachePtr &other)
+{
+    if(!other || other.get() == this) { return; }
+    vkCheck(vkMergePipelineCaches(m_device->handle(), m_pipeline_cache, 1, &other->m_pipeline_cache),
+            "failed to merge pipeline-caches");
+}
+
+PipelineCache::stats_t PipelineCache::stats() const
+{
+    stats_t ret = {};
+    ret.num_hits = m_num_hits;
+    ret.num_misses = m_num_misses;
+    ret.num_vk_cache_hits = m_num_vk_cache_hits;
+    ret.creation_duration = std::chrono::nanoseconds(m_creation_duration.load());
+    ret.num_loaded_bytes = m_num_loaded_bytes;
+    ret.num_precompiled = m_num_precompiled;
+    return ret;
+}
+
+pipeline_manifest_t PipelineCache::manifest() const
+{
+    std::unique_lock lock(m_manifest_mutex);
+    return m_manifest;
+}
+
+size_t PipelineCache::precompile(const pipeline_manifest_t &manifest, crocore::ThreadPoolClassic *pool)
+{
+    // canonical shader-code and set-layouts for all manifest-entries
+    std::vector<shader_module_t> shader_modules;
+    for(const auto &code: manifest.shader_codes)
+    {
+        size_t num_bytes = code.size() * sizeof(uint32_t);
+        const uint32_t *ptr = canonical_code(code.data(), num_bytes);
+        shader_modules.push_back(vierkant::create_shader_module(ptr, num_bytes));
+    }
+
+    std::vector<VkDescriptorSetLayout> set_layouts;
+    for(const auto &desc: manifest.set_layouts) { set_layouts.push_back(canonical_set_layout(desc)); }
+
+    auto shader_module = [&shader_modules](const pipeline_manifest_t::shader_t &shader) {
+        auto ret = shader_modules[shader.code_index];
+        ret.entry_point_name = shader.entry_point_name;
+        return ret;
+    };
+
+    std::vector<std::function<void()>> jobs;
+
+    auto add_job = [this, &jobs]<typename FMT_T>(FMT_T key, std::unordered_map<FMT_T, PipelinePtr> &map,
+                                                  std::shared_mutex &mutex) {
+        if(has(map, mutex, key)) { return; }
+
+        jobs.emplace_back([this, key = std::move(key), &map, &mutex] {
+            auto pipeline = create_pipeline(key);
+            if(!pipeline) { return; }
+            record(key);
+            m_num_precompiled++;
+            std::unique_lock lock(mutex);
+            map.insert(std::make_pair(key, std::move(pipeline)));
+        });
+    };
+
+    for(const auto &p: manifest.pipelines)
+    {
+        std::vector<VkDescriptorSetLayout> layouts;
+        for(auto idx: p.set_layout_indices) { layouts.push_back(set_layouts[idx]); }
+
+        if(p.bind_point == VK_PIPELINE_BIND_POINT_GRAPHICS)
+        {
+            auto key = p.graphics_info;
+            for(const auto &shader: p.shaders) { key.shader_stages[shader.stage] = shader_module(shader); }
+            key.descriptor_set_layouts = std::move(layouts);
+            key.push_constant_ranges = p.push_constant_ranges;
+            key.specialization = p.specialization;
+            {
+                std::unique_lock lock(m_canonical_mutex);
+                key.color_attachment_formats = m_owned_attachment_formats.emplace_back(
+                        p.color_attachment_formats.begin(), p.color_attachment_formats.end());
+            }
+            add_job(std::move(key), m_graphics_pipelines, m_graphics_pipeline_mutex);
+        }
+        else if(p.bind_point == VK_PIPELINE_BIND_POINT_RAY_TRACING_KHR)
+        {
+            raytracing_pipeline_info_t key = {};
+            for(const auto &shader: p.shaders) { key.shader_stages.insert({shader.stage, shader_module(shader)}); }
+            key.max_recursion = p.max_recursion;
+            key.descriptor_set_layouts = std::move(layouts);
+            key.push_constant_ranges = p.push_constant_ranges;
+            key.specialization = p.specialization;
+            add_job(std::move(key), m_ray_pipelines, m_ray_pipeline_mutex);
+        }
+        else if(p.bind_point == VK_PIPELINE_BIND_POINT_COMPUTE && !p.shaders.empty())
+        {
+            compute_pipeline_info_t key = {};
+            key.shader_stage = shader_module(p.shaders.front());
+            key.descriptor_set_layouts = std::move(layouts);
+            key.push_constant_ranges = p.push_constant_ranges;
+            key.specialization = p.specialization;
+            add_job(std::move(key), m_compute_pipelines, m_compute_pipeline_mutex);
+        }
+    }
+
+    // compile in parallel
+    auto num_precompiled = m_num_precompiled.load();
+
+    if(pool && jobs.size() > 1)
+    {
+        std::vector<std::future<void>> tasks;
+        for(const auto &job: jobs) { tasks.push_back(pool->post(job)); }
+        for(auto &t: tasks) { t.wait(); }
+    }
+    else
+    {
+        for(const auto &job: jobs) { job(); }
+    }
+    return m_num_precompiled - num_precompiled;
+}
+
+const uint32_t *PipelineCache::canonical_code(const uint32_t *code, size_t num_bytes)
+{
+    // keyed by content, callers might free or re-use their code-memory
+    uint64_t h = vierkant::hash_bytes(code, num_bytes);
+
+    auto find_code = [this, h, code, num_bytes]() -> const uint32_t * {
+        auto [first, last] = m_code_hashes.equal_range(h);
+        for(auto it = first; it != last; ++it)
+        {
+            const auto &[code_ptr, code_size] = it->second;
+            if(code_size == num_bytes && memcmp(code_ptr, code, num_bytes) == 0) { return code_ptr; }
+        }
+        return nullptr;
+    };
+
+    {
+        std::shared_lock lock(m_canonical_mutex);
+        if(auto ptr = find_code()) { return ptr; }
+    }
+    std::unique_lock lock(m_canonical_mutex);
+    if(auto ptr = find_code()) { return ptr; }
+
+    // first sight, store an owned copy
+    auto &owned_code = m_owned_codes.emplace_back(code, code + num_bytes / sizeof(uint32_t));
+    m_code_hashes.insert({h, {owned_code.data(), num_bytes}});
+    return owned_code.data();
+}
+
+VkDescriptorSetLayout PipelineCache::canonical_set_layout(const descriptor_set_layout_desc_t &desc)
+{
+    std::unique_lock lock(m_canonical_mutex);
+    auto &set_layout = m_canonical_set_layouts[desc];
+    if(!set_layout) { set_layout = vierkant::create_descriptor_set_layout(m_device, desc); }
+    return set_layout.get();
+}
+
+bool PipelineCache::canonical_set_layouts(std::vector<VkDescriptorSetLayout> &set_layouts)
+{
+    bool ret = true;
+
+    for(auto &set_layout: set_layouts)
+    {
+        // identically defined set-layouts are compatible
+        if(auto desc = vierkant::descriptor_set_layout_desc(set_layout)) { set_layout = canonical_set_layout(*desc); }
+        else { ret = false; }
+    }
+    return ret;
+}
+
+bool PipelineCache::canonicalize(graphics_pipeline_info_t &format)
+{
+    format.pipeline_cache = VK_NULL_HANDLE;
+    for(auto &[stage, shader]: format.shader_stages)
+    {
+        shader.create_info.pCode = canonical_code(shader.create_info.pCode, shader.create_info.codeSize);
+    }
+
+    // the caller's range of attachment-formats might not outlive the key
+    {
+        std::unique_lock lock(m_canonical_mutex);
+        format.color_attachment_formats = m_owned_attachment_formats.emplace_back(
+                format.color_attachment_formats.begin(), format.color_attachment_formats.end());
+    }
+    return canonical_set_layouts(format.descriptor_set_layouts) && !format.base_pipeline;
+}
+
+bool PipelineCache::canonicalize(raytracing_pipeline_info_t &format)
+{
+    format.pipeline_cache = VK_NULL_HANDLE;
+    for(auto &[stage, shader]: format.shader_stages)
+    {
+        shader.create_info.pCode = canonical_code(shader.create_info.pCode, shader.create_info.codeSize);
+    }
+    return canonical_set_layouts(format.descriptor_set_layouts);
+}
+
+bool PipelineCache::canonicalize(compute_pipeline_info_t &format)
+{
+    format.pipeline_cache = VK_NULL_HANDLE;
+    auto &create_info = format.shader_stage.create_info;
+    create_info.pCode = canonical_code(create_info.pCode, create_info.codeSize);
+    return canonical_set_layouts(format.descriptor_set_layouts);
+}
+
+pipeline_manifest_t::shader_t PipelineCache::record_shader(VkShaderStageFlagBits stage,
+                                                           const shader_module_t &shader_module)
+{
+    const auto *code = shader_module.create_info.pCode;
+    auto [it, inserted] = m_manifest_codes.try_emplace(code, static_cast<uint32_t>(m_manifest.shader_codes.size()));
+    if(inserted)
+    {
+        m_manifest.shader_codes.emplace_back(code, code + shader_module.create_info.codeSize / sizeof(uint32_t));
+    }
+    return {stage, it->second, shader_module.entry_point_name};
+}
+
+pipeline_manifest_t::pipeline_t
+PipelineCache::record_common(VkPipelineBindPoint bind_point, const std::vector<VkDescriptorSetLayout> &set_layouts,
+                             const std::vector<VkPushConstantRange> &push_constant_ranges,
+                             const std::optional<pipeline_specialization> &specialization)
+{
+    pipeline_manifest_t::pipeline_t ret = {};
+    ret.bind_point = bind_point;
+    ret.push_constant_ranges = push_constant_ranges;
+    ret.specialization = specialization;
+
+    for(auto set_layout: set_layouts)
+    {
+        auto desc = vierkant::descriptor_set_layout_desc(set_layout).value_or(descriptor_set_layout_desc_t{});
+        auto [it, inserted] =
+                m_manifest_set_layouts.try_emplace(desc, static_cast<uint32_t>(m_manifest.set_layouts.size()));
+        if(inserted) { m_manifest.set_layouts.push_back(desc); }
+        ret.set_layout_indices.push_back(it->second);
+    }
+    return ret;
+}
+
+void PipelineCache::record(const graphics_pipeline_info_t &format)
+{
+    std::unique_lock lock(m_manifest_mutex);
+    auto pipeline = record_common(VK_PIPELINE_BIND_POINT_GRAPHICS, format.descriptor_set_layouts,
+                                  format.push_constant_ranges, format.specialization);
+    for(const auto &[stage, shader]: format.shader_stages) { pipeline.shaders.push_back(record_shader(stage, shader)); }
+
+    // fixed-function state, without handles
+    pipeline.graphics_info = format;
+    pipeline.graphics_info.shader_stages = {};
+    pipeline.graphics_info.color_attachment_formats = {};
+    pipeline.graphics_info.base_pipeline = VK_NULL_HANDLE;
+    pipeline.graphics_info.specialization = {};
+    pipeline.graphics_info.pipeline_cache = VK_NULL_HANDLE;
+    pipeline.graphics_info.descriptor_set_layouts = {};
+    pipeline.graphics_info.push_constant_ranges = {};
+    pipeline.color_attachment_formats = {format.color_attachment_formats.begin(),
+                                         format.color_attachment_formats.end()};
+    m_manifest.pipelines.push_back(std::move(pipeline));
+}
+
+void PipelineCache::record(const raytracing_pipeline_info_t &format)
+{
+    std::unique_lock lock(m_manifest_mutex);
+    auto pipeline = record_common(VK_PIPELINE_BIND_POINT_RAY_TRACING_KHR, format.descriptor_set_layouts,
+                                  format.push_constant_ranges, format.specialization);
+    for(const auto &[stage, shader]: format.shader_stages) { pipeline.shaders.push_back(record_shader(stage, shader)); }
+    pipeline.max_recursion = format.max_recursion;
+    m_manifest.pipelines.push_back(std::move(pipeline));
+}
+
+void PipelineCache::record(const compute_pipeline_info_t &format)
+{
+    std::unique_lock lock(m_manifest_mutex);
+    auto pipeline = record_common(VK_PIPELINE_BIND_POINT_COMPUTE, format.descriptor_set_layouts,
+                                  format.push_constant_ranges, format.specialization);
+    pipeline.shaders.push_back(record_shader(VK_SHADER_STAGE_COMPUTE_BIT, format.shader_stage));
+    m_manifest.pipelines.push_back(std::move(pipeline));
+}
+
+}// namespace vierkant
@@ -1,7 +1,9 @@
 #include <crocore/Area.hpp>
+#include <map>
 #include <unordered_set>
 #include <vierkant/Pipeline.hpp>
 #include <vierkant/Rasterizer.hpp>
+#include <vierkant/radix_sort.hpp>
 
 #include <ranges>
 #include <vierkant/staging_copy.hpp>
@@ -18,6 +20,11 @@ using duration_t = std::chrono::duration<float>;
 //! number of gpu-queries (currently only start-/end-timestamps)
 constexpr uint32_t query_count = 2;
 
+//! usage-flags for descriptor-buffers, containing resources and combined image-samplers
+constexpr VkBufferUsageFlags descriptor_buffer_usage = VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT |
+                                                       VK_BUFFER_USAGE_SAMPLER_DESCRIPTOR_BUFFER_BIT_EXT |
+                                                       VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 struct texture_index_key_t
@@ -40,7 +47,7 @@ struct texture_index_hash_t
     }
 };
 
-using texture_index_map_t = std::unordered_map<texture_index_key_t, size_t, texture_index_hash_t>;
+using texture_index_map_t = std::pmr::unordered_map<texture_index_key_t, size_t, texture_index_hash_t>;
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -55,9 +62,9 @@ Rasterizer::Rasterizer(DevicePtr device, const create_info_t &create_info)
     viewport = create_info.viewport;
     scissor = create_info.scissor;
     indirect_draw = create_info.indirect_draw;
+    use_bindless = create_info.use_bindless;
     sample_count = create_info.sample_count;
 
-    m_staged_drawables.resize(create_info.num_frames_in_flight);
     m_frame_assets.resize(create_info.num_frames_in_flight);
 
     m_queue = create_info.queue;
@@ -101,6 +108,8 @@ Rasterizer::Rasterizer(DevicePtr device, const create_info_t &create_info)
     m_push_constant_range.offset = 0;
     m_push_constant_range.size = sizeof(push_constants_t);
     m_push_constant_range.stageFlags = VK_SHADER_STAGE_ALL;
+
+    m_frame_arena = vierkant::FrameArena::create({});
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -109,6 +118,14 @@ Rasterizer::Rasterizer(Rasterizer &&other) noexcept : Rasterizer() { swap(*this,
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+Rasterizer::~Rasterizer()
+{
+    // release pending batches
+    collect_batches();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 Rasterizer &Rasterizer::operator=(Rasterizer other)
 {
     swap(*this, other);
@@ -120,9 +137,6 @@ Rasterizer &Rasterizer::operator=(Rasterizer other)
 void swap(Rasterizer &lhs, Rasterizer &rhs) noexcept
 {
     if(&lhs == &rhs) { return; }
-    std::lock(lhs.m_staging_mutex, rhs.m_staging_mutex);
-    std::lock_guard<std::mutex> lock_lhs(lhs.m_staging_mutex, std::adopt_lock);
-    std::lock_guard<std::mutex> lock_rhs(rhs.m_staging_mutex, std::adopt_lock);
 
     std::swap(lhs.viewport, rhs.viewport);
     std::swap(lhs.scissor, rhs.scissor);
@@ -130,6 +144,7 @@ void swap(Rasterizer &lhs, Rasterizer &rhs) noexcept
     std::swap(lhs.debug_draw_flags, rhs.debug_draw_flags);
     std::swap(lhs.debug_label, rhs.debug_label);
     std::swap(lhs.indirect_draw, rhs.indirect_draw);
+    std::swap(lhs.use_bindless, rhs.use_bindless);
     std::swap(lhs.draw_indirect_delegate, rhs.draw_indirect_delegate);
     std::swap(lhs.m_device, rhs.m_device);
     std::swap(lhs.sample_count, rhs.sample_count);
@@ -137,7 +152,7 @@ void swap(Rasterizer &lhs, Rasterizer &rhs) noexcept
     std::swap(lhs.m_queue, rhs.m_queue);
     std::swap(lhs.m_command_pool, rhs.m_command_pool);
     std::swap(lhs.m_descriptor_pool, rhs.m_descriptor_pool);
-    std::swap(lhs.m_staged_drawables, rhs.m_staged_drawables);
+    lhs.m_staging_head = rhs.m_staging_head.exchange(lhs.m_staging_head);
     std::swap(lhs.m_frame_assets, rhs.m_frame_assets);
     std::swap(lhs.m_current_index, rhs.m_current_index);
     std::swap(lhs.m_push_constant_range, rhs.m_push_constant_range);
@@ -146,23 +161,62 @@ void swap(Rasterizer &lhs, Rasterizer &rhs) noexcept
     std::swap(lhs.use_mesh_shader, rhs.use_mesh_shader);
     std::swap(lhs.use_gpu_timestamps, rhs.use_gpu_timestamps);
     std::swap(lhs.m_mesh_task_count, rhs.m_mesh_task_count);
+    std::swap(lhs.m_frame_arena, rhs.m_frame_arena);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-void Rasterizer::stage_drawable(drawable_t drawable)
+void Rasterizer::stage_drawable(drawable_t drawable, uint64_t order_key)
 {
-    std::lock_guard lock_guard(m_staging_mutex);
-    m_staged_drawables[m_current_index].push_back(std::move(drawable));
+    auto batch = new staging_batch_t;
+    batch->drawable = std::move(drawable);
+    batch->order_key = order_key;
+    stage_batch(batch);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-void Rasterizer::stage_drawables(const std::span<drawable_t> &drawables)
+void Rasterizer::stage_drawables(const std::span<drawable_t> &drawables, uint64_t order_key)
 {
-    std::lock_guard lock_guard(m_staging_mutex);
-    auto &frame_drawables = m_staged_drawables[m_current_index];
-    frame_drawables.insert(frame_drawables.end(), drawables.begin(), drawables.end());
+    if(drawables.empty()) { return; }
+
+    // copy outside of any critical section
+    auto batch = new staging_batch_t;
+    batch->drawables.assign(drawables.begin(), drawables.end());
+    batch->order_key = order_key;
+    stage_batch(batch);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void Rasterizer::stage_batch(staging_batch_t *batch)
+{
+    batch->next = m_staging_head.load(std::memory_order_relaxed);
+    while(!m_staging_head.compare_exchange_weak(batch->next, batch, std::memory_order_release,
+                                                std::memory_order_relaxed)) {}
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+std::vector<std::unique_ptr<Rasterizer::staging_batch_t>> Rasterizer::collect_batches()
+{
+    std::vector<std::unique_ptr<staging_batch_t>> ret;
+
+    // detach all batches at once, the list is in reverse staging-order
+    for(auto batch = m_staging_head.exchange(nullptr, std::memory_order_acquire); batch; batch = batch->next)
+    {
+        ret.emplace_back(batch);
+    }
+    std::reverse(ret.begin(), ret.end());
+
+    // common case: no order-keys in use, staging-order is final
+    auto key_differs = [](const auto &lhs, const auto &rhs) { return lhs->order_key != rhs->order_key; };
+    if(std::adjacent_find(ret.begin(), ret.end(), key_differs) != ret.end())
+    {
+        std::stable_sort(ret.begin(), ret.end(),
+                         [](const auto &lhs, const auto &rhs) { return lhs->order_key < rhs->order_key; });
+    }
+    return ret;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -175,6 +229,9 @@ VkCommandBuffer Rasterizer::render(const vierkant::Framebuffer &framebuffer, boo
     // re-use prior assets and command-buffer, run delegate for buffer-updates
     if(recycle_commands && frame_assets.command_buffer)
     {
+        // delegates may allocate transient data from the frame-arena
+        m_frame_arena->reset();
+
         // invoke delegate
         if(indirect_draw && draw_indirect_delegate) { draw_indirect_delegate(frame_assets.indirect_indexed_bundle); }
         return frame_assets.command_buffer.handle();
@@ -232,6 +289,9 @@ void Rasterizer::render(const rendering_info_t &rendering_info)
     // re-use prior assets and command-buffer, run delegate for buffer-updates
     if(rendering_info.recycle_commands && rendering_info.command_buffer)
     {
+        // delegates may allocate transient data from the frame-arena
+        m_frame_arena->reset();
+
         // invoke delegate
         if(indirect_draw && draw_indirect_delegate) { draw_indirect_delegate(frame_assets.indirect_indexed_bundle); }
         return;
@@ -255,11 +315,20 @@ void Rasterizer::render(const rendering_info_t &rendering_info)
 
 void Rasterizer::render(VkCommandBuffer command_buffer, frame_assets_t &frame_assets)
 {
+    // transient containers below are allocated from the frame-arena
+    m_frame_arena->reset();
+    std::pmr::memory_resource *arena = m_frame_arena.get();
+
     // (re-)create assets and commands
     frame_assets.indirect_bundle.num_draws = frame_assets.indirect_indexed_bundle.num_draws = 0;
-    std::unordered_map<descriptor_map_t, DescriptorSetLayoutPtr> next_set_layouts;
+    std::unordered_map<descriptor_map_t, DescriptorSetLayoutPtr> next_set_layouts, next_buffer_set_layouts;
     descriptor_set_map_t next_descriptor_sets;
 
+    // bindless: merged draw-batches, per-frame descriptor-sets packed into a descriptor-buffer if available
+    const bool bindless = use_bindless && indirect_draw;
+    const bool use_descriptor_buffer =
+            bindless && vkCmdBindDescriptorBuffersEXT && vkCmdSetDescriptorBufferOffsetsEXT && vkGetDescriptorEXT;
+
     struct indirect_draw_asset_t
     {
         uint32_t count_buffer_offset = 0;
@@ -267,15 +336,24 @@ void Rasterizer::render(VkCommandBuffer command_buffer, frame_assets_t &frame_as
         uint32_t first_draw_index = 0;
         uint32_t first_indexed_draw_index = 0;
         VkRect2D scissor = {};
-        std::vector<VkDescriptorSet> descriptor_set_handles;
+        std::array<VkDescriptorSet, 2> descriptor_set_handles = {};
         VkDescriptorSetLayout descriptor_set_layout = VK_NULL_HANDLE;
 
+        //! offsets into a descriptor-buffer for drawable- and texture-descriptors
+        bool use_descriptor_buffer = false;
+        std::array<VkDeviceSize, 2> descriptor_buffer_offsets = {};
+
         const drawable_t *drawable = nullptr;
     };
-    using draw_batch_t = std::vector<std::pair<const Mesh *, indirect_draw_asset_t>>;
-    std::unordered_map<graphics_pipeline_info_t, draw_batch_t> pipelines;
+    using draw_batch_t = std::pmr::vector<std::pair<const Mesh *, indirect_draw_asset_t>>;
 
-    std::vector<vierkant::ImagePtr> textures;
+    //! consecutive draw-batches sharing a pipeline, in sorted order
+    struct pipeline_batch_t
+    {
+        const graphics_pipeline_info_t *pipeline_info = nullptr;
+        draw_batch_t draws;
+    };
+    std::pmr::vector<pipeline_batch_t> pipelines(arena);
 
     auto create_texture_hash = [](const std::vector<vierkant::ImagePtr> &textures_) -> uint64_t {
         size_t texture_hash = 0;
@@ -283,63 +361,62 @@ void Rasterizer::render(VkCommandBuffer command_buffer, frame_assets_t &frame_as
         return texture_hash;
     };
 
-    auto create_mesh_key = [create_texture_hash](const drawable_t &drawable) -> texture_index_key_t {
-        const auto it = drawable.descriptors.find(BINDING_TEXTURES);
-        if(it == drawable.descriptors.end() || it->second.images.empty()) { return {drawable.mesh.get(), {}}; }
-        const auto &drawable_textures = it->second.images;
-        return {drawable.mesh.get(), create_texture_hash(drawable_textures)};
-    };
+    vierkant::descriptor_map_t bindless_texture_desc;
+
+    auto &desc_all_textures = bindless_texture_desc[BINDING_TEXTURES];
+    desc_all_textures.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    desc_all_textures.stage_flags = VK_SHADER_STAGE_FRAGMENT_BIT;
+    auto &textures = desc_all_textures.images;
 
-    texture_index_map_t texture_base_index_map;
+    texture_index_map_t texture_base_index_map(arena);
 
-    // swoop all texture-indices
-    for(const auto &drawable: frame_assets.drawables)
+    // swoop all texture-indices, hashing textures once per drawable
+    for(auto &drawable: frame_assets.drawables)
     {
+        drawable.material.base_texture_index = 0;
         auto it = drawable.descriptors.find(BINDING_TEXTURES);
         if(it == drawable.descriptors.end() || it->second.images.empty()) { continue; }
 
         const auto &drawable_textures = it->second.images;
 
         // insert other textures from drawables
-        if(texture_index_key_t key = {drawable.mesh.get(), create_texture_hash(drawable_textures)};
-           !texture_base_index_map.contains(key))
-        {
-            texture_base_index_map[key] = textures.size();
-            textures.insert(textures.end(), drawable_textures.begin(), drawable_textures.end());
-        }
-    }
+        auto [index_it, inserted] = texture_base_index_map.try_emplace(
+                {drawable.mesh.get(), create_texture_hash(drawable_textures)}, textures.size());
+        if(inserted) { textures.insert(textures.end(), drawable_textures.begin(), drawable_textures.end()); }
 
-    vierkant::descriptor_map_t bindless_texture_desc;
-
-    auto &desc_all_textures = bindless_texture_desc[BINDING_TEXTURES];
-    desc_all_textures.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    desc_all_textures.stage_flags = VK_SHADER_STAGE_FRAGMENT_BIT;
-    desc_all_textures.images = textures;
+        // adjust baseTextureIndex
+        drawable.material.base_texture_index = index_it->second;
+    }
 
     auto bindless_texture_layout = vierkant::find_or_create_set_layout(
             m_device, bindless_texture_desc, frame_assets.descriptor_set_layouts, next_set_layouts);
 
-    // create/resize draw_indirect buffers
-    resize_draw_indirect_buffers(frame_assets.drawables.size(), frame_assets);
-
-    for(auto &drawable: frame_assets.drawables)
+    DescriptorSetLayoutPtr bindless_texture_buffer_layout;
+    if(use_descriptor_buffer)
     {
-        // adjust baseTextureIndex
-        drawable.material.base_texture_index = texture_base_index_map[create_mesh_key(drawable)];
+        bindless_texture_buffer_layout =
+                vierkant::find_or_create_set_layout(m_device, bindless_texture_desc,
+                                                    frame_assets.descriptor_buffer_set_layouts, next_buffer_set_layouts,
+                                                    true);
     }
 
+    // create/resize draw_indirect buffers
+    resize_draw_indirect_buffers(frame_assets.drawables.size(), frame_assets);
+
     // create/update uniform/storage buffers
     update_buffers(frame_assets.drawables, frame_assets);
 
-    // sort by pipelines
     struct indexed_drawable_t
     {
         uint32_t object_index = 0;
         uint32_t meshlet_visibility_index = 0;
+        uint32_t pipeline_id = 0;
         vierkant::DescriptorSetLayoutPtr descriptor_set_layout = nullptr;
+        bool use_descriptor_buffer = false;
         drawable_t *drawable = nullptr;
     };
-    std::unordered_map<graphics_pipeline_info_t, std::vector<indexed_drawable_t>> pipeline_drawables;
+    std::pmr::vector<indexed_drawable_t> indexed_drawables(arena);
+    indexed_drawables.reserve(frame_assets.drawables.size());
 
     // meshlet-visibility index
     uint32_t meshlet_visibility_index = 0;
@@ -394,102 +471,192 @@ void Rasterizer::render(VkCommandBuffer command_buffer, frame_assets_t &frame_as
             // only provide a global texture-array for indirect draws
             if(indirect_draw) { drawable.descriptors.erase(BINDING_TEXTURES); }
 
-            indexed_drawable.descriptor_set_layout = vierkant::find_or_create_set_layout(
-                    m_device, drawable.descriptors, frame_assets.descriptor_set_layouts, next_set_layouts);
+            // user-provided descriptors might not be expressible in a descriptor-buffer
+            indexed_drawable.use_descriptor_buffer =
+                    use_descriptor_buffer && vierkant::descriptor_buffer_compatible(drawable.descriptors);
+
+            if(indexed_drawable.use_descriptor_buffer)
+            {
+                indexed_drawable.descriptor_set_layout = vierkant::find_or_create_set_layout(
+                        m_device, drawable.descriptors, frame_assets.descriptor_buffer_set_layouts,
+                        next_buffer_set_layouts, true);
+            }
+            else
+            {
+                indexed_drawable.descriptor_set_layout = vierkant::find_or_create_set_layout(
+                        m_device, drawable.descriptors, frame_assets.descriptor_set_layouts, next_set_layouts);
+            }
             pipeline_format.descriptor_set_layouts = {indexed_drawable.descriptor_set_layout.get()};
         }
         else
         {
             indexed_drawable.descriptor_set_layout = std::move(drawable.descriptor_set_layout);
         }
+        pipeline_format.use_descriptor_buffer = indexed_drawable.use_descriptor_buffer;
 
         // bindless texture-array
-        pipeline_format.descriptor_set_layouts.push_back(bindless_texture_layout.get());
+        pipeline_format.descriptor_set_layouts.push_back(indexed_drawable.use_descriptor_buffer
+                                                                 ? bindless_texture_buffer_layout.get()
+                                                                 : bindless_texture_layout.get());
 
         // enough meshlet-visibility bits for lod0
         indexed_drawable.meshlet_visibility_index = meshlet_visibility_index;
         meshlet_visibility_index += div_up(drawable.num_meshlets, 32);
 
         // push intermediate struct
-        pipeline_drawables[pipeline_format].push_back(indexed_drawable);
+        indexed_drawables.push_back(std::move(indexed_drawable));
     }
 
+    auto &batch_stats = frame_assets.batch_stats;
+    batch_stats = {};
+    batch_stats.num_drawables = indexed_drawables.size();
+    auto sort_start = steady_clock::now();
+
+    // 64-bit sort-keys: pipeline (16) | descriptor-set-layout (12) | mesh (20) | material (16)
+    struct sort_item_t
+    {
+        uint64_t key = 0;
+        uint32_t index = 0;
+    };
+    std::pmr::vector<sort_item_t> sort_items(indexed_drawables.size(), arena), sort_tmp(sort_items.size(), arena);
+
+    // ids are assigned in order of appearance, pipeline-infos are only hashed if they differ from their predecessor
+    std::pmr::unordered_map<graphics_pipeline_info_t, uint32_t> pipeline_ids(arena);
+    std::pmr::unordered_map<VkDescriptorSetLayout, uint32_t> set_layout_ids(arena);
+    std::pmr::unordered_map<const vierkant::Mesh *, uint32_t> mesh_ids(arena);
+    const graphics_pipeline_info_t *last_pipeline_info = nullptr;
+
+    for(uint32_t i = 0; i < indexed_drawables.size(); ++i)
+    {
+        auto &indexed_drawable = indexed_drawables[i];
+        const auto &drawable = *indexed_drawable.drawable;
+        const auto &pipeline_format = drawable.pipeline_format;
+
+        if(!last_pipeline_info || !(*last_pipeline_info == pipeline_format))
+        {
+            indexed_drawable.pipeline_id = pipeline_ids.try_emplace(pipeline_format, pipeline_ids.size()).first->second;
+        }
+        else { indexed_drawable.pipeline_id = indexed_drawables[i - 1].pipeline_id; }
+        last_pipeline_info = &pipeline_format;
+
+        uint64_t set_layout_id =
+                set_layout_ids.try_emplace(indexed_drawable.descriptor_set_layout.get(), set_layout_ids.size())
+                        .first->second;
+        uint64_t mesh_id = mesh_ids.try_emplace(drawable.mesh.get(), mesh_ids.size()).first->second;
+        uint64_t material_id = drawable.material.base_texture_index;
+
+        // blending depends on submission-order, which is preserved by a stable sort
+        bool blending = pipeline_format.blend_state.blendEnable ||
+                        std::ranges::any_of(pipeline_format.attachment_blend_states,
+                                            [](const auto &blend_state) { return blend_state.blendEnable; });
+        if(blending) { mesh_id = material_id = 0; }
+
+        sort_items[i].index = i;
+        sort_items[i].key = std::min<uint64_t>(indexed_drawable.pipeline_id, 0xFFFF) << 48 |
+                            std::min<uint64_t>(set_layout_id, 0xFFF) << 36 |
+                            std::min<uint64_t>(mesh_id, 0xFFFFF) << 16 | std::min<uint64_t>(material_id, 0xFFFF);
+    }
+    vierkant::radix_sort(std::span(sort_items), std::span(sort_tmp), [](const sort_item_t &item) { return item.key; });
+    batch_stats.sort_time = duration_cast<double_millisecond_t>(steady_clock::now() - sort_start);
+
     // batch/pipeline index
     uint32_t count_buffer_offset = 0;
 
-    // fill up indirect draw buffers
-    for(const auto &[pipe_fmt, indexed_drawables]: pipeline_drawables)
+    // bindless meshlet-draws do not bind vertex-/index-buffers, batches are only split by pipeline-state
+    auto is_meshlet_draw = [this](const drawable_t &drawable) {
+        return vkCmdDrawMeshTasksEXT && use_mesh_shader && drawable.mesh && drawable.mesh->index_buffer &&
+               drawable.mesh->meshlets;
+    };
+    // identical meshes (or bindless meshlet-draws) sharing descriptors and scissor are merged into one batch
+    auto can_merge_batch = [bindless, &is_meshlet_draw](const indirect_draw_asset_t &batch,
+                                                        const indexed_drawable_t &indexed_drawable) {
+        const auto &drawable = *indexed_drawable.drawable;
+        const auto &batch_scissor = batch.scissor, &scissor = drawable.pipeline_format.scissor;
+        bool same_mesh = batch.drawable->mesh == drawable.mesh &&
+                         batch.descriptor_set_layout == indexed_drawable.descriptor_set_layout.get();
+        bool meshlet_draws = bindless && is_meshlet_draw(*batch.drawable) && is_meshlet_draw(drawable);
+        return (same_mesh || meshlet_draws) && batch.drawable->descriptors == drawable.descriptors &&
+               batch_scissor.offset.x == scissor.offset.x && batch_scissor.offset.y == scissor.offset.y &&
+               batch_scissor.extent.width == scissor.extent.width &&
+               batch_scissor.extent.height == scissor.extent.height;
+    };
+
+    // fill up indirect draw buffers, in sorted order
+    for(uint32_t i = 0; i < sort_items.size(); ++i)
     {
-        auto &indirect_draws = pipelines[pipe_fmt];
+        auto &indexed_drawable = indexed_drawables[sort_items[i].index];
+        auto &drawable = indexed_drawable.drawable;
 
-        // gather indirect drawing commands into buffers
-        for(auto &indexed_drawable: indexed_drawables)
+        // pipeline changed
+        if(!i || indexed_drawable.pipeline_id != indexed_drawables[sort_items[i - 1].index].pipeline_id)
         {
-            auto &drawable = indexed_drawable.drawable;
+            pipelines.push_back({&drawable->pipeline_format, draw_batch_t(arena)});
+        }
+        auto &indirect_draws = pipelines.back().draws;
 
-            // create new indirect-draw batch
-            if(!indirect_draw || indirect_draws.empty() || indirect_draws.back().first != drawable->mesh.get())
-            {
-                indirect_draw_asset_t new_draw = {};
-                new_draw.count_buffer_offset = count_buffer_offset++;
-                new_draw.first_draw_index = frame_assets.indirect_bundle.num_draws;
-                new_draw.first_indexed_draw_index = frame_assets.indirect_indexed_bundle.num_draws;
-                new_draw.scissor = drawable->pipeline_format.scissor;
-                new_draw.drawable = drawable;
-                new_draw.descriptor_set_layout = indexed_drawable.descriptor_set_layout.get();
-                indirect_draws.emplace_back(drawable->mesh.get(), std::move(new_draw));
-            }
-            auto &indirect_draw_asset = indirect_draws.back().second;
-            indirect_draw_asset.num_draws++;
+        // create new indirect-draw batch
+        if(!indirect_draw || indirect_draws.empty() || !can_merge_batch(indirect_draws.back().second, indexed_drawable))
+        {
+            indirect_draw_asset_t new_draw = {};
+            new_draw.count_buffer_offset = count_buffer_offset++;
+            new_draw.first_draw_index = frame_assets.indirect_bundle.num_draws;
+            new_draw.first_indexed_draw_index = frame_assets.indirect_indexed_bundle.num_draws;
+            new_draw.scissor = drawable->pipeline_format.scissor;
+            new_draw.drawable = drawable;
+            new_draw.descriptor_set_layout = indexed_drawable.descriptor_set_layout.get();
+            new_draw.use_descriptor_buffer = indexed_drawable.use_descriptor_buffer;
+            indirect_draws.emplace_back(drawable->mesh.get(), std::move(new_draw));
+            batch_stats.num_batches++;
+        }
+        auto &indirect_draw_asset = indirect_draws.back().second;
+        indirect_draw_asset.num_draws++;
 
-            if(drawable->mesh && drawable->mesh->index_buffer)
+        if(drawable->mesh && drawable->mesh->index_buffer)
+        {
+            // keep track of assigned draw-command-indices
+            if(frame_assets.indirect_indexed_bundle.draw_command_indices)//  == indirect_draw
             {
-                // keep track of assigned draw-command-indices
-                if(frame_assets.indirect_indexed_bundle.draw_command_indices)//  == indirect_draw
-                {
-                    auto *draw_command_indices =
-                            static_cast<uint32_t *>(frame_assets.indirect_indexed_bundle.draw_command_indices->map());
-                    draw_command_indices[indexed_drawable.object_index] =
-                            frame_assets.indirect_indexed_bundle.num_draws;
-                }
-
-                // assign into draw-command buffer
-                auto *draw_command = static_cast<indexed_indirect_command_t *>(
-                                             frame_assets.indirect_indexed_bundle.draws_in->map()) +
-                                     frame_assets.indirect_indexed_bundle.num_draws++;
-
-                //! VkDrawIndexedIndirectCommand
-                *draw_command = {};
-                draw_command->vk_draw.firstIndex = drawable->base_index;
-                draw_command->vk_draw.indexCount = drawable->num_indices;
-                draw_command->vk_draw.vertexOffset = drawable->vertex_offset;
-                draw_command->vk_draw.firstInstance = indexed_drawable.object_index;
-                draw_command->vk_draw.instanceCount = drawable->num_instances;
-
-                draw_command->count_buffer_offset = indirect_draw_asset.count_buffer_offset;
-                draw_command->first_draw_index = indirect_draw_asset.first_indexed_draw_index;
-                draw_command->object_index = indexed_drawable.object_index;
-                draw_command->flags =
-                        DRAW_COMMAND_FLAG_ENABLED | (drawable->mesh->meshlets ? DRAW_COMMAND_FLAG_MESHLETS : 0);
-
-                draw_command->base_meshlet = drawable->base_meshlet;
-                draw_command->num_meshlets = drawable->num_meshlets;
-
-                //! VkDrawMeshTasksIndirectCommandEXT
-                draw_command->vk_mesh_draw.groupCountX = div_up(drawable->num_meshlets, m_mesh_task_count);
-                draw_command->vk_mesh_draw.groupCountY = draw_command->vk_mesh_draw.groupCountZ = 1;
-                draw_command->meshlet_visibility_index = indexed_drawable.meshlet_visibility_index;
+                auto *draw_command_indices =
+                        static_cast<uint32_t *>(frame_assets.indirect_indexed_bundle.draw_command_indices->map());
+                draw_command_indices[indexed_drawable.object_index] = frame_assets.indirect_indexed_bundle.num_draws;
             }
-            else
-            {
-                auto draw_command = static_cast<VkDrawIndirectCommand *>(frame_assets.indirect_bundle.draws_in->map()) +
-                                    frame_assets.indirect_bundle.num_draws++;
 
-                draw_command->vertexCount = drawable->num_vertices;
-                draw_command->instanceCount = drawable->num_instances;
-                draw_command->firstVertex = drawable->vertex_offset;
-                draw_command->firstInstance = indexed_drawable.object_index;
-            }
+            // assign into draw-command buffer
+            auto *draw_command =
+                    static_cast<indexed_indirect_command_t *>(frame_assets.indirect_indexed_bundle.draws_in->map()) +
+                    frame_assets.indirect_indexed_bundle.num_draws++;
+
+            //! VkDrawIndexedIndirectCommand
+            *draw_command = {};
+            draw_command->vk_draw.firstIndex = drawable->base_index;
+            draw_command->vk_draw.indexCount = drawable->num_indices;
+            draw_command->vk_draw.vertexOffset = drawable->vertex_offset;
+            draw_command->vk_draw.firstInstance = indexed_drawable.object_index;
+            draw_command->vk_draw.instanceCount = drawable->num_instances;
+
+            draw_command->count_buffer_offset = indirect_draw_asset.count_buffer_offset;
+            draw_command->first_draw_index = indirect_draw_asset.first_indexed_draw_index;
+            draw_command->object_index = indexed_drawable.object_index;
+            draw_command->flags =
+                    DRAW_COMMAND_FLAG_ENABLED | (drawable->mesh->meshlets ? DRAW_COMMAND_FLAG_MESHLETS : 0);
+
+            draw_command->base_meshlet = drawable->base_meshlet;
+            draw_command->num_meshlets = drawable->num_meshlets;
+
+            //! VkDrawMeshTasksIndirectCommandEXT
+            draw_command->vk_mesh_draw.groupCountX = div_up(drawable->num_meshlets, m_mesh_task_count);
+            draw_command->vk_mesh_draw.groupCountY = draw_command->vk_mesh_draw.groupCountZ = 1;
+            draw_command->meshlet_visibility_index = indexed_drawable.meshlet_visibility_index;
+        }
+        else
+        {
+            auto draw_command = static_cast<VkDrawIndirectCommand *>(frame_assets.indirect_bundle.draws_in->map()) +
+                                frame_assets.indirect_bundle.num_draws++;
+
+            draw_command->vertexCount = drawable->num_vertices;
+            draw_command->instanceCount = drawable->num_instances;
+            draw_command->firstVertex = drawable->vertex_offset;
+            draw_command->firstInstance = indexed_drawable.object_index;
         }
     }
 
@@ -507,13 +674,28 @@ void Rasterizer::render(VkCommandBuffer command_buffer, frame_assets_t &frame_as
         draw_buffer_indexed = frame_assets.indirect_indexed_bundle.draws_out;
     }
 
+    // bindless: unique descriptor-sets of this frame, stored consecutively in a descriptor-buffer.
+    // offsets are re-assigned every frame, they are not stable ids into a persistent heap.
+    std::pmr::unordered_map<descriptor_map_t, std::pair<VkDescriptorSetLayout, VkDeviceSize>> descriptor_buffer_entries(
+            arena);
+    VkDeviceSize descriptor_buffer_num_bytes = 0;
+
+    auto descriptor_buffer_offset = [this, &descriptor_buffer_entries, &descriptor_buffer_num_bytes](
+                                            VkDescriptorSetLayout set_layout,
+                                            const descriptor_map_t &descriptors) -> VkDeviceSize {
+        auto it = descriptor_buffer_entries.find(descriptors);
+        if(it != descriptor_buffer_entries.end()) { return it->second.second; }
+
+        VkDeviceSize offset = descriptor_buffer_num_bytes;
+        descriptor_buffer_num_bytes += vierkant::descriptor_buffer_size(m_device, set_layout);
+        descriptor_buffer_entries[descriptors] = {set_layout, offset};
+        return offset;
+    };
+
     // set buffer-descriptors after delegate
-    for(const auto &[pipe_fmt, indexed_drawables]: pipeline_drawables)
+    for(auto &pipeline_batch: pipelines)
     {
-        if(indexed_drawables.empty()) { continue; }
-        auto &indirect_draws = pipelines[pipe_fmt];
-
-        for(auto &draw_asset: indirect_draws | std::views::values)
+        for(auto &draw_asset: pipeline_batch.draws | std::views::values)
         {
             auto descriptors = draw_asset.drawable->descriptors;
 
@@ -532,6 +714,15 @@ void Rasterizer::render(VkCommandBuffer command_buffer, frame_assets_t &frame_as
                 }
             }
 
+            if(draw_asset.use_descriptor_buffer)
+            {
+                assert(vierkant::descriptor_buffer_compatible(descriptors));
+                draw_asset.descriptor_buffer_offsets = {
+                        descriptor_buffer_offset(draw_asset.descriptor_set_layout, descriptors),
+                        descriptor_buffer_offset(bindless_texture_buffer_layout.get(), bindless_texture_desc)};
+                continue;
+            }
+
             auto descriptor_set = vierkant::find_or_create_descriptor_set(
                     m_device, draw_asset.descriptor_set_layout, descriptors, m_descriptor_pool,
                     frame_assets.descriptor_sets, next_descriptor_sets, false);
@@ -543,6 +734,29 @@ void Rasterizer::render(VkCommandBuffer command_buffer, frame_assets_t &frame_as
         }
     }
 
+    // write all descriptors into a (grow-only) host-visible descriptor-buffer
+    if(descriptor_buffer_num_bytes)
+    {
+        if(!frame_assets.descriptor_buffer || frame_assets.descriptor_buffer->num_bytes() < descriptor_buffer_num_bytes)
+        {
+            vierkant::Buffer::create_info_t buffer_info = {};
+            buffer_info.device = m_device;
+            buffer_info.usage = descriptor_buffer_usage;
+            buffer_info.mem_usage = VMA_MEMORY_USAGE_CPU_TO_GPU;
+            buffer_info.num_bytes = std::max<VkDeviceSize>(descriptor_buffer_num_bytes, 1UL << 16);
+            buffer_info.alignment = m_device->properties().descriptor_buffer.descriptorBufferOffsetAlignment;
+            buffer_info.name = "Rasterizer: frame_asset.descriptor_buffer";
+            frame_assets.descriptor_buffer = vierkant::Buffer::create(buffer_info);
+        }
+
+        for(const auto &[descriptors, entry]: descriptor_buffer_entries)
+        {
+            const auto &[set_layout, offset] = entry;
+            vierkant::update_descriptor_buffer(m_device, set_layout, descriptors, frame_assets.descriptor_buffer,
+                                               offset);
+        }
+    }
+
     // push constants
     push_constants_t push_constants = {};
     push_constants.size = {viewport.width, viewport.height};
@@ -558,14 +772,27 @@ void Rasterizer::render(VkCommandBuffer command_buffer, frame_assets_t &frame_as
         vkCmdWriteTimestamp2(command_buffer, VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT, frame_assets.query_pool.get(), 0);
     }
 
+    // bind a single descriptor-buffer, pipelines only select offsets
+    if(descriptor_buffer_num_bytes)
+    {
+        VkDescriptorBufferBindingInfoEXT descriptor_buffer_binding = {};
+        descriptor_buffer_binding.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_BUFFER_BINDING_INFO_EXT;
+        descriptor_buffer_binding.address = frame_assets.descriptor_buffer->device_address();
+        descriptor_buffer_binding.usage = descriptor_buffer_usage;
+        vkCmdBindDescriptorBuffersEXT(command_buffer, 1, &descriptor_buffer_binding);
+    }
+
     // grouped by pipelines
-    for(auto &[pipe_fmt, indirect_draws]: pipelines)
+    for(auto &[pipeline_info, indirect_draws]: pipelines)
     {
+        const auto &pipe_fmt = *pipeline_info;
+
         // select/create pipeline
         auto pipeline = m_pipeline_cache->pipeline(pipe_fmt);
 
         // bind pipeline
         pipeline->bind(command_buffer);
+        batch_stats.num_pipeline_binds++;
 
         bool dynamic_scissor = crocore::contains(pipe_fmt.dynamic_states, VK_DYNAMIC_STATE_SCISSOR);
 
@@ -577,6 +804,9 @@ void Rasterizer::render(VkCommandBuffer command_buffer, frame_assets_t &frame_as
 
         const vierkant::Mesh *current_mesh = nullptr;
 
+        // skip redundant binds, descriptors are shared by consecutive batches in bindless mode
+        const indirect_draw_asset_t *bound_asset = nullptr;
+
         for(auto &[mesh, draw_asset]: indirect_draws)
         {
             push_constants.base_draw_index = draw_asset.first_indexed_draw_index;
@@ -589,13 +819,36 @@ void Rasterizer::render(VkCommandBuffer command_buffer, frame_assets_t &frame_as
             if(mesh && current_mesh != mesh)
             {
                 current_mesh = mesh;
-                if(!use_meshlets) { mesh->bind_buffers(command_buffer); }
+                if(!use_meshlets)
+                {
+                    mesh->bind_buffers(command_buffer);
+                    batch_stats.num_mesh_binds++;
+                }
             }
 
-            // bind descriptor sets (uniforms, samplers)
-            vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline->layout(), 0,
-                                    draw_asset.descriptor_set_handles.size(), draw_asset.descriptor_set_handles.data(),
-                                    0, nullptr);
+            if(!bound_asset || bound_asset->descriptor_set_handles != draw_asset.descriptor_set_handles ||
+               bound_asset->descriptor_buffer_offsets != draw_asset.descriptor_buffer_offsets)
+            {
+                bound_asset = &draw_asset;
+                batch_stats.num_descriptor_binds++;
+
+                if(draw_asset.use_descriptor_buffer)
+                {
+                    // set offsets into descriptor-buffer (uniforms, samplers)
+                    constexpr std::array<uint32_t, 2> buffer_indices = {0, 0};
+                    vkCmdSetDescriptorBufferOffsetsEXT(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                                       pipeline->layout(), 0, buffer_indices.size(),
+                                                       buffer_indices.data(),
+                                                       draw_asset.descriptor_buffer_offsets.data());
+                }
+                else
+                {
+                    // bind descriptor sets (uniforms, samplers)
+                    vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline->layout(), 0,
+                                            draw_asset.descriptor_set_handles.size(),
+                                            draw_asset.descriptor_set_handles.data(), 0, nullptr);
+                }
+            }
 
             if(dynamic_scissor)
             {
@@ -603,6 +856,9 @@ void Rasterizer::render(VkCommandBuffer command_buffer, frame_assets_t &frame_as
                 vkCmdSetScissor(command_buffer, 0, 1, &draw_asset.scissor);
             }
 
+            // one call per batch for indirect draws, otherwise one per drawable
+            batch_stats.num_draw_calls += indirect_draw ? 1 : draw_asset.num_draws;
+
             if(indirect_draw)
             {
                 constexpr size_t indexed_indirect_cmd_stride = sizeof(indexed_indirect_command_t);
@@ -713,6 +969,7 @@ void Rasterizer::render(VkCommandBuffer command_buffer, frame_assets_t &frame_as
 
     // keep the stuff in use
     frame_assets.descriptor_set_layouts = std::move(next_set_layouts);
+    frame_assets.descriptor_buffer_set_layouts = std::move(next_buffer_set_layouts);
     frame_assets.descriptor_sets = std::move(next_descriptor_sets);
 }
 
@@ -720,9 +977,8 @@ void Rasterizer::render(VkCommandBuffer command_buffer, frame_assets_t &frame_as
 
 void Rasterizer::reset()
 {
-    std::lock_guard lock_guard(m_staging_mutex);
+    collect_batches();
     m_current_index = 0;
-    m_staged_drawables.clear();
     for(auto &frame_asset: m_frame_assets) { frame_asset = {}; }
 }
 
@@ -730,19 +986,22 @@ void Rasterizer::reset()
 
 void Rasterizer::update_buffers(const std::vector<drawable_t> &drawables, frame_assets_t &frame_asset)
 {
-    std::vector<VkDeviceAddress> vertex_buffer_refs;
-    std::vector<mesh_entry_t> mesh_entries;
-    std::map<std::pair<const vierkant::Mesh *, uint32_t>, uint32_t> mesh_entry_map;
+    // transient containers are allocated from the frame-arena
+    std::pmr::memory_resource *arena = m_frame_arena.get();
+
+    std::pmr::vector<VkDeviceAddress> vertex_buffer_refs(arena);
+    std::pmr::vector<mesh_entry_t> mesh_entries(arena);
+    std::pmr::map<std::pair<const vierkant::Mesh *, uint32_t>, uint32_t> mesh_entry_map(arena);
 
     // maps -> material-index
-    std::unordered_map<vierkant::MaterialId, uint32_t> material_index_map;
+    std::pmr::unordered_map<vierkant::MaterialId, uint32_t> material_index_map(arena);
 
     // joined drawable buffers
     frame_asset.mesh_draws.resize(drawables.size());
-    std::vector<material_struct_t> material_data;
+    std::pmr::vector<material_struct_t> material_data(arena);
 
     // joined meshlet-visibilities (1 bit per meshlet)
-    std::vector<uint32_t> meshlet_visibility_data;
+    std::pmr::vector<uint32_t> meshlet_visibility_data(arena);
 
     for(uint32_t i = 0; i < drawables.size(); i++)
     {
@@ -809,9 +1068,11 @@ void Rasterizer::update_buffers(const std::vector<drawable_t> &drawables, frame_
         // create/upload joined buffers
         if(!out_buffer)
         {
-            out_buffer = vierkant::Buffer::create(device, array,
-                                                  VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                                                  VMA_MEMORY_USAGE_CPU_TO_GPU);
+            // device-addresses are required to reference buffers from descriptor-buffers
+            constexpr VkBufferUsageFlags usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                                                 VK_BUFFER_USAGE_TRANSFER_SRC_BIT |
+                                                 VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+            out_buffer = vierkant::Buffer::create(device, array, usage, VMA_MEMORY_USAGE_CPU_TO_GPU);
         }
         else
         {
@@ -819,13 +1080,14 @@ void Rasterizer::update_buffers(const std::vector<drawable_t> &drawables, frame_
         }
     };
 
-    std::vector<staging_copy_info_t> staging_copies;
+    std::pmr::vector<staging_copy_info_t> staging_copies(arena);
 
     auto add_staging_copy = [&staging_copies, &frame_asset,
-                             device = m_device]<typename T>(const std::vector<T> &array, vierkant::BufferPtr &outbuffer,
-                                                            VkPipelineStageFlags2 dst_stage, VkAccessFlags2 dst_access,
-                                                            const std::string &label) {
-        using elem_t = std::vector<T>::value_type;
+                             device = m_device]<typename T, typename Alloc>(
+                                    const std::vector<T, Alloc> &array, vierkant::BufferPtr &outbuffer,
+                                    VkPipelineStageFlags2 dst_stage, VkAccessFlags2 dst_access,
+                                    const std::string &label) {
+        using elem_t = T;
         size_t num_bytes = array.size() * sizeof(elem_t);
 
         if(!outbuffer)
@@ -1002,14 +1264,22 @@ void Rasterizer::resize_draw_indirect_buffers(uint32_t num_drawables, frame_asse
 
 Rasterizer::frame_assets_t &Rasterizer::next_frame()
 {
-    uint32_t current_index;
+    uint32_t current_index = m_current_index;
+    m_current_index = (m_current_index + 1) % m_frame_assets.size();
+    auto &frame_assets = m_frame_assets[current_index];
+
+    // gather staged drawables, re-using capacity
+    auto batches = collect_batches();
+    size_t num_drawables = 0;
+    for(const auto &batch: batches) { num_drawables += batch->drawables.size() + (batch->drawable ? 1 : 0); }
+
+    frame_assets.drawables.clear();
+    frame_assets.drawables.reserve(num_drawables);
+    for(auto &batch: batches)
     {
-        std::lock_guard<std::mutex> lock_guard(m_staging_mutex);
-        current_index = m_current_index;
-        m_current_index = (m_current_index + 1) % m_frame_assets.size();
-        m_frame_assets[current_index].drawables = std::move(m_staged_drawables[current_index]);
+        if(batch->drawable) { frame_assets.drawables.push_back(std::move(*batch->drawable)); }
+        std::move(batch->drawables.begin(), batch->drawables.end(), std::back_inserter(frame_assets.drawables));
     }
-    auto &frame_assets = m_frame_assets[current_index];
 
     // retrieve last frame-timestamps for this index
     uint64_t timestamps[query_count] = {};
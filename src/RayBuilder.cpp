@@ -263,6 +263,7 @@ RayBuilder::build_result_t RayBuilder::create_mesh_structures(const SceneConstPt
                 m_device->properties().acceleration_structure.minAccelerationStructureScratchOffsetAlignment;
         scratch_buffer_info.usage = VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
         scratch_buffer_info.mem_usage = VMA_MEMORY_USAGE_GPU_ONLY;
+        scratch_buffer_info.memory_category = vierkant::MemoryCategory::ACCELERATION_STRUCTURE;
         acceleration_asset.scratch_buffer = vierkant::Buffer::create(scratch_buffer_info);
 
         // assign acceleration structure and scratch_buffer
@@ -658,6 +659,7 @@ RayBuilder::scene_acceleration_data_t RayBuilder::create_toplevel(const scene_ac
     instance_buffer_info.usage = VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT |
                                  VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR;
     instance_buffer_info.mem_usage = VMA_MEMORY_USAGE_CPU_TO_GPU;
+    instance_buffer_info.memory_category = vierkant::MemoryCategory::ACCELERATION_STRUCTURE;
     instance_buffer_info.data = instances.data();
     instance_buffer_info.num_bytes = instances.size() * sizeof(VkAccelerationStructureInstanceKHR);
 
@@ -1056,6 +1058,7 @@ RayBuilder::scene_acceleration_context_ptr RayBuilder::create_scene_acceleration
             m_device->properties().acceleration_structure.minAccelerationStructureScratchOffsetAlignment;
     scratch_buffer_info.usage = VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
     scratch_buffer_info.mem_usage = VMA_MEMORY_USAGE_GPU_ONLY;
+    scratch_buffer_info.memory_category = vierkant::MemoryCategory::ACCELERATION_STRUCTURE;
     ret->scratch_buffer_top = vierkant::Buffer::create(scratch_buffer_info);
 
     vierkant::Buffer::create_info_t buffer_info = {};
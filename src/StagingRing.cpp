@@ -0,0 +1,136 @@
+#include <vierkant/StagingRing.hpp>
+
+namespace vierkant
+{
+
+StagingRingPtr StagingRing::create(const create_info_t &create_info)
+{
+    auto ret = StagingRingPtr(new StagingRing(create_info));
+    if(!ret->m_data)
+    {
+        spdlog::error("StagingRing: could not map staging-buffer ({} bytes)", create_info.num_bytes);
+        return nullptr;
+    }
+    return ret;
+}
+
+StagingRing::StagingRing(const create_info_t &create_info)
+    : m_num_bytes(create_info.num_bytes), m_semaphore(create_info.device)
+{
+    vierkant::Buffer::create_info_t buffer_info = {};
+    buffer_info.device = create_info.device;
+    buffer_info.num_bytes = m_num_bytes;
+    buffer_info.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+    buffer_info.mem_usage = VMA_MEMORY_USAGE_CPU_ONLY;
+    buffer_info.name = create_info.name;
+    m_buffer = vierkant::Buffer::create(buffer_info);
+
+    // persistently mapped
+    m_data = static_cast<uint8_t *>(m_buffer->map());
+}
+
+void StagingRing::reclaim()
+{
+    auto value = m_semaphore.value();
+
+    while(!m_retired_ranges.empty() && m_retired_ranges.front().timeline_value <= value)
+    {
+        m_tail = m_retired_ranges.front().end;
+        m_retired_ranges.pop_front();
+    }
+}
+
+StagingRing::allocation_t StagingRing::allocate(size_t num_bytes, size_t alignment)
+{
+    alignment = std::max<size_t>(alignment, 1);
+    if(!num_bytes || num_bytes > m_num_bytes) { return {}; }
+
+    std::lock_guard lock(m_mutex);
+    reclaim();
+
+    // nothing in use, restart at the beginning of the ring
+    if(m_head == m_tail) { m_head = m_tail = (m_head + m_num_bytes - 1) / m_num_bytes * m_num_bytes; }
+
+    // align offset inside the ring, wrap around to the start if the remaining space is too small
+    uint64_t offset = m_head % m_num_bytes;
+    uint64_t aligned_offset = (offset + alignment - 1) / alignment * alignment;
+    uint64_t start = m_head - offset + aligned_offset;
+
+    if(aligned_offset + num_bytes > m_num_bytes) { start = m_head - offset + m_num_bytes; }
+
+    // ranges in use need to stay intact
+    if(start + num_bytes - m_tail > m_num_bytes) { return {}; }
+    m_head = start + num_bytes;
+
+    allocation_t ret = {};
+    ret.buffer = m_buffer;
+    ret.offset = start % m_num_bytes;
+    ret.data = m_data + ret.offset;
+    ret.num_bytes = num_bytes;
+    return ret;
+}
+
+bool StagingRing::upload(VkCommandBuffer command_buffer, const void *data, size_t num_bytes,
+                         const vierkant::BufferPtr &dst, size_t dst_offset)
+{
+    assert(command_buffer && dst);
+
+    // resizing would discard existing contents and invalidate previously recorded copies
+    if(dst->num_bytes() < dst_offset + num_bytes)
+    {
+        spdlog::error("StagingRing::upload: destination too small ({} < {} bytes)", dst->num_bytes(),
+                      dst_offset + num_bytes);
+        return false;
+    }
+
+    auto allocation = allocate(num_bytes);
+    if(!allocation) { return false; }
+    memcpy(allocation.data, data, num_bytes);
+
+    VkBufferCopy2 copy_region = {};
+    copy_region.sType = VK_STRUCTURE_TYPE_BUFFER_COPY_2;
+    copy_region.size = num_bytes;
+    copy_region.srcOffset = allocation.offset;
+    copy_region.dstOffset = dst_offset;
+
+    VkCopyBufferInfo2 copy_info2 = {};
+    copy_info2.sType = VK_STRUCTURE_TYPE_COPY_BUFFER_INFO_2;
+    copy_info2.srcBuffer = m_buffer->handle();
+    copy_info2.dstBuffer = dst->handle();
+    copy_info2.regionCount = 1;
+    copy_info2.pRegions = &copy_region;
+    vkCmdCopyBuffer2(command_buffer, &copy_info2);
+    return true;
+}
+
+bool StagingRing::upload(VkCommandBuffer command_buffer, const void *data, size_t num_bytes,
+                         const vierkant::ImagePtr &dst, VkOffset3D img_offset, VkExtent3D extent, uint32_t layer,
+                         uint32_t level)
+{
+    assert(command_buffer && dst);
+    auto allocation = allocate(num_bytes, image_copy_alignment);
+    if(!allocation) { return false; }
+    memcpy(allocation.data, data, num_bytes);
+    dst->copy_from(m_buffer, command_buffer, allocation.offset, img_offset, extent, layer, level);
+    return true;
+}
+
+vierkant::semaphore_submit_info_t StagingRing::retire(VkPipelineStageFlags2 signal_stage)
+{
+    std::lock_guard lock(m_mutex);
+    m_retired_ranges.push_back({m_head, ++m_timeline_value});
+
+    vierkant::semaphore_submit_info_t ret = {};
+    ret.semaphore = m_semaphore.handle();
+    ret.signal_value = m_timeline_value;
+    ret.signal_stage = signal_stage;
+    return ret;
+}
+
+size_t StagingRing::num_bytes_used() const
+{
+    std::lock_guard lock(m_mutex);
+    return m_head - m_tail;
+}
+
+}// namespace vierkant
@@ -0,0 +1,388 @@
+#include <vierkant/UploadQueue.hpp>
+
+namespace vierkant
+{
+
+namespace
+{
+
+//! number of bytes covered by an image-subresource (one layer of a mip-level)
+size_t subresource_num_bytes(const vierkant::Image::Format &fmt, uint32_t level)
+{
+    size_t width = std::max<uint32_t>(fmt.extent.width >> level, 1);
+    size_t height = std::max<uint32_t>(fmt.extent.height >> level, 1);
+    size_t depth = std::max<uint32_t>(fmt.extent.depth >> level, 1);
+
+    // block-compressed formats use 4x4 blocks
+    size_t num_blocks = ((width + 3) / 4) * ((height + 3) / 4) * depth;
+
+    switch(fmt.format)
+    {
+        case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+        case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+        case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+        case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+        case VK_FORMAT_BC4_UNORM_BLOCK:
+        case VK_FORMAT_BC4_SNORM_BLOCK: return num_blocks * 8;
+
+        case VK_FORMAT_BC2_UNORM_BLOCK:
+        case VK_FORMAT_BC2_SRGB_BLOCK:
+        case VK_FORMAT_BC3_UNORM_BLOCK:
+        case VK_FORMAT_BC3_SRGB_BLOCK:
+        case VK_FORMAT_BC5_UNORM_BLOCK:
+        case VK_FORMAT_BC5_SNORM_BLOCK:
+        case VK_FORMAT_BC6H_UFLOAT_BLOCK:
+        case VK_FORMAT_BC6H_SFLOAT_BLOCK:
+        case VK_FORMAT_BC7_UNORM_BLOCK:
+        case VK_FORMAT_BC7_SRGB_BLOCK: return num_blocks * 16;
+
+        default: return width * height * depth * vierkant::num_bytes(fmt.format);
+    }
+}
+
+}// namespace
+
+UploadQueuePtr UploadQueue::create(const create_info_t &create_info)
+{
+    auto ret = UploadQueuePtr(new UploadQueue(create_info));
+    if(!ret->m_staging_ring)
+    {
+        spdlog::error("UploadQueue: could not create staging-ring ({} bytes)", create_info.staging_num_bytes);
+        return nullptr;
+    }
+    return ret;
+}
+
+UploadQueue::UploadQueue(const create_info_t &create_info)
+    : m_device(create_info.device), m_semaphore(create_info.device)
+{
+    vierkant::StagingRing::create_info_t staging_info = {};
+    staging_info.device = m_device;
+    staging_info.num_bytes = create_info.staging_num_bytes;
+    staging_info.name = "UploadQueue";
+    m_staging_ring = vierkant::StagingRing::create(staging_info);
+
+    const auto &queue_family_indices = m_device->queue_family_indices();
+    m_src_queue_family = static_cast<uint32_t>(queue_family_indices.at(Device::Queue::TRANSFER).index);
+    m_dst_queue_family = static_cast<uint32_t>(queue_family_indices.at(create_info.dst_queue_type).index);
+    m_queue = m_device->queue(Device::Queue::TRANSFER);
+    m_command_pool =
+            vierkant::create_command_pool(m_device, Device::Queue::TRANSFER, VK_COMMAND_POOL_CREATE_TRANSIENT_BIT);
+}
+
+UploadQueue::~UploadQueue()
+{
+    // an open batch is discarded, in-flight batches need to complete
+    std::lock_guard lock(m_mutex);
+    if(m_submitted_value) { m_semaphore.wait(m_submitted_value); }
+}
+
+UploadQueue::batch_t &UploadQueue::open_batch()
+{
+    if(!m_batch)
+    {
+        m_batch = batch_t();
+        m_batch->command_buffer = vierkant::CommandBuffer(m_device, m_command_pool.get());
+        m_batch->command_buffer.begin();
+        m_batch->value = m_next_value;
+    }
+    return *m_batch;
+}
+
+StagingRing::allocation_t UploadQueue::allocate(std::unique_lock<std::mutex> &lock, size_t num_bytes,
+                                                size_t alignment)
+{
+    reclaim();
+    auto ret = m_staging_ring->allocate(num_bytes, alignment);
+
+    // ring exhausted, submit pending copies and wait for in-flight batches without holding the lock
+    if(!ret && num_bytes <= m_staging_ring->num_bytes())
+    {
+        submit();
+
+        if(uint64_t value = m_submitted_value; value > m_semaphore.value())
+        {
+            lock.unlock();
+            m_semaphore.wait(value);
+            lock.lock();
+            reclaim();
+        }
+        ret = m_staging_ring->allocate(num_bytes, alignment);
+    }
+
+    // oversized or still exhausted, fall back to a dedicated staging-buffer
+    if(!ret)
+    {
+        auto staging_buffer = vierkant::Buffer::create(m_device, nullptr, num_bytes, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                                       VMA_MEMORY_USAGE_CPU_ONLY);
+        ret.buffer = staging_buffer;
+        ret.data = staging_buffer->map();
+        ret.num_bytes = num_bytes;
+        open_batch().staging_buffers.push_back(std::move(staging_buffer));
+    }
+    return ret;
+}
+
+UploadQueue::handle_t UploadQueue::upload(const vierkant::BufferPtr &dst, const void *data, size_t num_bytes,
+                                          size_t dst_offset)
+{
+    if(!dst || !data || !num_bytes) { return {}; }
+
+    // resizing would discard existing contents and invalidate copies of pending batches
+    if(dst->num_bytes() < dst_offset + num_bytes)
+    {
+        spdlog::error("UploadQueue: destination-buffer too small ({} < {} bytes)", dst->num_bytes(),
+                      dst_offset + num_bytes);
+        return {};
+    }
+
+    std::unique_lock lock(m_mutex);
+    auto allocation = allocate(lock, num_bytes, 16);
+    memcpy(allocation.data, data, num_bytes);
+    auto &batch = open_batch();
+
+    VkBufferCopy2 copy_region = {};
+    copy_region.sType = VK_STRUCTURE_TYPE_BUFFER_COPY_2;
+    copy_region.size = num_bytes;
+    copy_region.srcOffset = allocation.offset;
+    copy_region.dstOffset = dst_offset;
+
+    VkCopyBufferInfo2 copy_info2 = {};
+    copy_info2.sType = VK_STRUCTURE_TYPE_COPY_BUFFER_INFO_2;
+    copy_info2.srcBuffer = allocation.buffer->handle();
+    copy_info2.dstBuffer = dst->handle();
+    copy_info2.regionCount = 1;
+    copy_info2.pRegions = &copy_region;
+    vkCmdCopyBuffer2(batch.command_buffer.handle(), &copy_info2);
+
+    batch.buffers.insert(dst);
+    return {batch.value};
+}
+
+UploadQueue::handle_t UploadQueue::upload(const vierkant::ImagePtr &dst, const void *data, size_t num_bytes,
+                                          uint32_t layer, uint32_t level, VkImageLayout final_layout)
+{
+    if(!dst || !data || !num_bytes) { return {}; }
+    const auto &fmt = dst->format();
+
+    if(level >= dst->num_mip_levels() || layer >= fmt.num_layers || num_bytes > subresource_num_bytes(fmt, level))
+    {
+        spdlog::error("UploadQueue: upload exceeds image-subresource (layer: {}, level: {}, {} bytes)", layer, level,
+                      num_bytes);
+        return {};
+    }
+
+    std::unique_lock lock(m_mutex);
+    auto allocation = allocate(lock, num_bytes, StagingRing::image_copy_alignment);
+    memcpy(allocation.data, data, num_bytes);
+    auto &batch = open_batch();
+
+    // no-op for subsequent levels/layers
+    dst->transition_layout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, batch.command_buffer.handle());
+
+    VkBufferImageCopy2 region = {};
+    region.sType = VK_STRUCTURE_TYPE_BUFFER_IMAGE_COPY_2;
+    region.bufferOffset = allocation.offset;
+    region.imageSubresource.aspectMask = fmt.aspect;
+    region.imageSubresource.mipLevel = level;
+    region.imageSubresource.baseArrayLayer = layer;
+    region.imageSubresource.layerCount = 1;
+    region.imageExtent = {std::max<uint32_t>(fmt.extent.width >> level, 1),
+                          std::max<uint32_t>(fmt.extent.height >> level, 1),
+                          std::max<uint32_t>(fmt.extent.depth >> level, 1)};
+
+    VkCopyBufferToImageInfo2 copy_info = {};
+    copy_info.sType = VK_STRUCTURE_TYPE_COPY_BUFFER_TO_IMAGE_INFO_2;
+    copy_info.regionCount = 1;
+    copy_info.pRegions = &region;
+    copy_info.srcBuffer = allocation.buffer->handle();
+    copy_info.dstImage = dst->image();
+    copy_info.dstImageLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    vkCmdCopyBufferToImage2(batch.command_buffer.handle(), &copy_info);
+
+    // blits require a graphics-queue, mipmaps are generated during 'acquire'
+    auto &image_upload = batch.images[dst];
+    image_upload.final_layout = final_layout;
+    image_upload.generate_mipmaps |=
+            !level && fmt.use_mipmap && fmt.autogenerate_mipmaps && dst->num_mip_levels() > 1;
+    return {batch.value};
+}
+
+void UploadQueue::submit()
+{
+    if(!m_batch) { return; }
+    auto batch = std::move(*m_batch);
+    m_batch.reset();
+
+    VkCommandBuffer command_buffer = batch.command_buffer.handle();
+    bool transfer_ownership = m_src_queue_family != m_dst_queue_family;
+    uint32_t src_queue_family = transfer_ownership ? m_src_queue_family : VK_QUEUE_FAMILY_IGNORED;
+    uint32_t dst_queue_family = transfer_ownership ? m_dst_queue_family : VK_QUEUE_FAMILY_IGNORED;
+
+    acquire_t acquire = {};
+    acquire.value = batch.value;
+
+    // release buffers to the destination queue-family, semaphores cover memory-dependencies otherwise
+    std::vector<VkBufferMemoryBarrier2> release_barriers;
+
+    for(const auto &buffer: batch.buffers)
+    {
+        if(!transfer_ownership) { break; }
+
+        VkBufferMemoryBarrier2 barrier = {};
+        barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
+        barrier.buffer = buffer->handle();
+        barrier.offset = 0;
+        barrier.size = VK_WHOLE_SIZE;
+        barrier.srcQueueFamilyIndex = src_queue_family;
+        barrier.dstQueueFamilyIndex = dst_queue_family;
+        barrier.srcStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
+        barrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+        release_barriers.push_back(barrier);
+
+        // matching acquire-operation, destination-stages are provided by 'acquire'
+        barrier.srcStageMask = VK_PIPELINE_STAGE_2_NONE;
+        barrier.srcAccessMask = VK_ACCESS_2_NONE;
+        acquire.buffer_barriers.push_back(barrier);
+        acquire.buffers.push_back(buffer);
+    }
+
+    if(!release_barriers.empty())
+    {
+        VkDependencyInfo dependency_info = {};
+        dependency_info.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+        dependency_info.bufferMemoryBarrierCount = static_cast<uint32_t>(release_barriers.size());
+        dependency_info.pBufferMemoryBarriers = release_barriers.data();
+        vkCmdPipelineBarrier2(command_buffer, &dependency_info);
+    }
+
+    for(const auto &[image, image_upload]: batch.images)
+    {
+        // mipmap-generation expects all levels in transfer-layout
+        auto layout = image_upload.generate_mipmaps ? VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL : image_upload.final_layout;
+
+        if(transfer_ownership || layout != image->image_layout())
+        {
+            image->barrier(layout, command_buffer, VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                           VK_PIPELINE_STAGE_2_NONE, VK_ACCESS_2_NONE, src_queue_family, dst_queue_family);
+        }
+
+        if(transfer_ownership)
+        {
+            // matching acquire-operation, requires identical layouts
+            VkImageMemoryBarrier2 barrier = {};
+            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+            barrier.image = image->image();
+            barrier.subresourceRange.aspectMask = image->format().aspect;
+            barrier.subresourceRange.levelCount = image->num_mip_levels();
+            barrier.subresourceRange.layerCount = image->format().num_layers;
+            barrier.srcQueueFamilyIndex = src_queue_family;
+            barrier.dstQueueFamilyIndex = dst_queue_family;
+            barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            barrier.newLayout = layout;
+            acquire.image_barriers.push_back(barrier);
+        }
+        if(image_upload.generate_mipmaps) { acquire.mipmap_images.push_back(image); }
+        acquire.images.push_back(image);
+    }
+
+    vierkant::semaphore_submit_info_t signal_info = {};
+    signal_info.semaphore = m_semaphore.handle();
+    signal_info.signal_value = batch.value;
+    signal_info.signal_stage = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+    batch.command_buffer.submit(m_queue, false, VK_NULL_HANDLE, {m_staging_ring->retire(), signal_info});
+
+    m_submitted_value = batch.value;
+    m_next_value = batch.value + 1;
+
+    // command-buffer, staging-buffers and destinations stay alive until completion
+    m_in_flight.push_back(std::move(batch));
+
+    std::lock_guard lock(m_acquire_mutex);
+    m_pending_acquires.push_back(std::move(acquire));
+}
+
+void UploadQueue::reclaim()
+{
+    auto value = m_semaphore.value();
+    while(!m_in_flight.empty() && m_in_flight.front().value <= value) { m_in_flight.pop_front(); }
+}
+
+UploadQueue::handle_t UploadQueue::flush()
+{
+    std::lock_guard lock(m_mutex);
+    reclaim();
+    submit();
+    return {m_submitted_value};
+}
+
+vierkant::semaphore_submit_info_t UploadQueue::acquire(VkCommandBuffer command_buffer,
+                                                       VkPipelineStageFlags2 dst_stage)
+{
+    std::vector<acquire_t> pending_acquires;
+    {
+        std::lock_guard lock(m_acquire_mutex);
+        std::swap(pending_acquires, m_pending_acquires);
+    }
+    if(pending_acquires.empty()) { return {}; }
+
+    vierkant::semaphore_submit_info_t ret = {};
+    ret.semaphore = m_semaphore.handle();
+
+    // mipmap-generation requires transfer-stages
+    for(const auto &acquire: pending_acquires)
+    {
+        ret.wait_value = std::max(ret.wait_value, acquire.value);
+        if(!acquire.mipmap_images.empty()) { dst_stage |= VK_PIPELINE_STAGE_2_TRANSFER_BIT; }
+    }
+    ret.wait_stage = dst_stage;
+
+    std::vector<VkBufferMemoryBarrier2> buffer_barriers;
+    std::vector<VkImageMemoryBarrier2> image_barriers;
+
+    for(const auto &acquire: pending_acquires)
+    {
+        for(auto barrier: acquire.buffer_barriers)
+        {
+            barrier.dstStageMask = dst_stage;
+            barrier.dstAccessMask = VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT;
+            buffer_barriers.push_back(barrier);
+        }
+        for(auto barrier: acquire.image_barriers)
+        {
+            barrier.dstStageMask = dst_stage;
+            barrier.dstAccessMask = VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT;
+            image_barriers.push_back(barrier);
+        }
+    }
+
+    if(!buffer_barriers.empty() || !image_barriers.empty())
+    {
+        VkDependencyInfo dependency_info = {};
+        dependency_info.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+        dependency_info.bufferMemoryBarrierCount = static_cast<uint32_t>(buffer_barriers.size());
+        dependency_info.pBufferMemoryBarriers = buffer_barriers.data();
+        dependency_info.imageMemoryBarrierCount = static_cast<uint32_t>(image_barriers.size());
+        dependency_info.pImageMemoryBarriers = image_barriers.data();
+        vkCmdPipelineBarrier2(command_buffer, &dependency_info);
+    }
+
+    for(const auto &acquire: pending_acquires)
+    {
+        for(const auto &image: acquire.mipmap_images) { image->generate_mipmaps(command_buffer); }
+    }
+    return ret;
+}
+
+bool UploadQueue::complete(handle_t handle) const { return handle.value <= m_semaphore.value(); }
+
+void UploadQueue::wait(handle_t handle)
+{
+    {
+        std::lock_guard lock(m_mutex);
+        if(handle.value > m_submitted_value) { submit(); }
+    }
+    m_semaphore.wait(handle.value);
+}
+
+}// namespace vierkant
@@ -0,0 +1,259 @@
+#pragma once
+
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <optional>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+namespace vierkant::serialization
+{
+
+/**
+ *  minimal binary (de-)serialization, shared by on-disk caches (model-cache, pipeline-manifest).
+ *
+ *  a single 'process(ar, value)' handles both directions, depending on 'Archive::is_loading'.
+ *  trivially-copyable types, strings, vectors, maps, optionals and variants are supported,
+ *  other types provide a 'serialize(Archive &, T &)'-overload in this namespace.
+ *  input-archives never read out of bounds, corrupted sizes invalidate the archive instead.
+ */
+
+class output_archive_t
+{
+public:
+    static constexpr bool is_loading = false;
+
+    std::vector<uint8_t> bytes;
+
+    void raw(const void *data, size_t num_bytes)
+    {
+        auto ptr = static_cast<const uint8_t *>(data);
+        bytes.insert(bytes.end(), ptr, ptr + num_bytes);
+    }
+};
+
+class input_archive_t
+{
+public:
+    static constexpr bool is_loading = true;
+
+    explicit input_archive_t(std::span<const uint8_t> bytes) : m_ptr(bytes.data()), m_end(bytes.data() + bytes.size())
+    {}
+
+    void raw(void *data, size_t num_bytes)
+    {
+        if(!can_read(num_bytes))
+        {
+            memset(data, 0, num_bytes);
+            return;
+        }
+        memcpy(data, m_ptr, num_bytes);
+        m_ptr += num_bytes;
+    }
+
+    //! check if a number of bytes is available, guards against allocations from corrupted sizes
+    bool can_read(size_t num_bytes) { return can_read(num_bytes, 1); }
+
+    //! check if a number of elements is available, without overflowing 'num_elements * element_size'
+    bool can_read(size_t num_elements, size_t element_size)
+    {
+        if(num_elements > static_cast<size_t>(m_end - m_ptr) / element_size)
+        {
+            m_valid = false;
+            m_ptr = m_end;
+        }
+        return m_valid;
+    }
+
+    void invalidate() { m_valid = false; }
+
+    [[nodiscard]] bool valid() const { return m_valid; }
+
+    [[nodiscard]] bool complete() const { return m_valid && m_ptr == m_end; }
+
+private:
+    const uint8_t *m_ptr = nullptr, *m_end = nullptr;
+    bool m_valid = true;
+};
+
+template<typename T>
+concept named_uuid_type = requires(const T &id) {
+    { id.str() } -> std::convertible_to<std::string>;
+    T::from_string(std::string());
+};
+
+template<typename T>
+concept trivially_serializable = std::is_trivially_copyable_v<T> && !named_uuid_type<T>;
+
+template<typename Archive>
+inline uint64_t process_size(Archive &ar, size_t size)
+{
+    auto ret = static_cast<uint64_t>(size);
+    ar.raw(&ret, sizeof(ret));
+    return ret;
+}
+
+// forward declarations, all overloads need to be visible for nested types
+template<typename Archive, typename T>
+void process(Archive &ar, T &value);
+
+template<typename Archive>
+void process(Archive &ar, std::string &str);
+
+template<typename Archive, typename T>
+void process(Archive &ar, std::vector<T> &array);
+
+template<typename Archive, typename K, typename V, typename... Ts>
+void process(Archive &ar, std::map<K, V, Ts...> &map);
+
+template<typename Archive, typename K, typename V, typename... Ts>
+void process(Archive &ar, std::unordered_map<K, V, Ts...> &map);
+
+template<typename Archive, typename T>
+void process(Archive &ar, std::optional<T> &opt);
+
+template<typename Archive, typename... Ts>
+void process(Archive &ar, std::variant<Ts...> &variant);
+
+//! types provide a 'serialize(Archive &, T &)'-overload in this namespace, found via argument-dependent lookup
+template<typename Archive, typename T>
+void process(Archive &ar, T &value)
+{
+    if constexpr(requires { serialize(ar, value); }) { serialize(ar, value); }
+    else if constexpr(named_uuid_type<T>)
+    {
+        std::string str;
+        if constexpr(!Archive::is_loading) { str = value.str(); }
+        process(ar, str);
+        if constexpr(Archive::is_loading) { value = T::from_string(str); }
+    }
+    else
+    {
+        static_assert(trivially_serializable<T>, "missing serialize-function");
+        ar.raw(&value, sizeof(T));
+    }
+}
+
+template<typename Archive>
+void process(Archive &ar, std::string &str)
+{
+    auto size = process_size(ar, str.size());
+
+    if constexpr(Archive::is_loading)
+    {
+        if(!ar.can_read(size)) { return; }
+        str.resize(size);
+    }
+    ar.raw(str.data(), size);
+}
+
+template<typename Archive, typename T>
+void process(Archive &ar, std::vector<T> &array)
+{
+    auto size = process_size(ar, array.size());
+
+    if constexpr(Archive::is_loading)
+    {
+        // each element occupies at least one byte
+        if(!ar.can_read(size, trivially_serializable<T> ? sizeof(T) : 1)) { return; }
+        array.resize(size);
+    }
+
+    if constexpr(trivially_serializable<T>) { ar.raw(array.data(), size * sizeof(T)); }
+    else
+    {
+        for(auto &elem: array) { process(ar, elem); }
+    }
+}
+
+template<typename Archive, typename Map>
+void process_map(Archive &ar, Map &map)
+{
+    auto size = process_size(ar, map.size());
+
+    if constexpr(Archive::is_loading)
+    {
+        map.clear();
+
+        for(uint64_t i = 0; i < size && ar.valid(); ++i)
+        {
+            typename Map::key_type key = {};
+            typename Map::mapped_type value = {};
+            process(ar, key);
+            process(ar, value);
+            map.emplace(std::move(key), std::move(value));
+        }
+    }
+    else
+    {
+        for(auto &[key, value]: map)
+        {
+            auto key_copy = key;
+            process(ar, key_copy);
+            process(ar, value);
+        }
+    }
+}
+
+template<typename Archive, typename K, typename V, typename... Ts>
+void process(Archive &ar, std::map<K, V, Ts...> &map)
+{
+    process_map(ar, map);
+}
+
+template<typename Archive, typename K, typename V, typename... Ts>
+void process(Archive &ar, std::unordered_map<K, V, Ts...> &map)
+{
+    process_map(ar, map);
+}
+
+template<typename Archive, typename T>
+void process(Archive &ar, std::optional<T> &opt)
+{
+    uint8_t has_value = opt.has_value();
+    ar.raw(&has_value, sizeof(has_value));
+
+    if constexpr(Archive::is_loading)
+    {
+        if(has_value) { opt.emplace(); }
+        else { opt.reset(); }
+    }
+    if(opt) { process(ar, *opt); }
+}
+
+template<typename Variant, size_t I = 0>
+Variant variant_from_index(size_t index)
+{
+    if constexpr(I < std::variant_size_v<Variant>)
+    {
+        if(index == I) { return Variant(std::in_place_index<I>); }
+        return variant_from_index<Variant, I + 1>(index);
+    }
+    else { return {}; }
+}
+
+template<typename Archive, typename... Ts>
+void process(Archive &ar, std::variant<Ts...> &variant)
+{
+    auto index = static_cast<uint32_t>(variant.index());
+    ar.raw(&index, sizeof(index));
+
+    if constexpr(Archive::is_loading)
+    {
+        if(index >= sizeof...(Ts))
+        {
+            ar.invalidate();
+            return;
+        }
+        variant = variant_from_index<std::variant<Ts...>>(index);
+    }
+    std::visit([&ar](auto &value) { process(ar, value); }, variant);
+}
+
+}// namespace vierkant::serialization
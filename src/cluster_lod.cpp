@@ -0,0 +1,329 @@
+#include <numeric>
+#include <unordered_map>
+
+#include <meshoptimizer.h>
+#include <vierkant/cluster_lod.hpp>
+
+namespace vierkant
+{
+
+namespace
+{
+
+//! internal representation of a cluster during DAG-construction
+struct cluster_t
+{
+    //! indices into the provided vertex-array
+    std::vector<index_t> vertices;
+
+    //! micro-indices into vertices
+    std::vector<uint8_t> triangles;
+
+    //! bounds/cone-information for the cluster itself
+    meshopt_Bounds meshlet_bounds = {};
+
+    //! bounds/error of the group this cluster was generated from
+    vierkant::Sphere bounds;
+    float error = 0.f;
+
+    //! bounds/error of the group consuming this cluster
+    vierkant::Sphere parent_bounds;
+    float parent_error = std::numeric_limits<float>::max();
+
+    uint32_t level = 0;
+};
+
+/**
+ * @brief   merge_spheres returns a sphere enclosing both provided spheres.
+ */
+vierkant::Sphere merge_spheres(const vierkant::Sphere &lhs, const vierkant::Sphere &rhs)
+{
+    glm::vec3 diff = rhs.center - lhs.center;
+    float d = glm::length(diff);
+
+    if(d + rhs.radius <= lhs.radius) { return lhs; }
+    if(d + lhs.radius <= rhs.radius) { return rhs; }
+
+    float radius = 0.5f * (d + lhs.radius + rhs.radius);
+    return {lhs.center + diff * ((radius - lhs.radius) / d), radius};
+}
+
+/**
+ * @brief   split_clusters splits a triangle-list into meshlet-sized clusters.
+ */
+std::vector<cluster_t> split_clusters(const std::vector<index_t> &indices, const float *vertices, size_t num_vertices,
+                                      size_t vertex_stride, const cluster_lod_params_t &params)
+{
+    // round down to multiple of 4 (alignment reasons in mesh_opt)
+    auto max_vertices = params.max_vertices & ~3;
+    auto max_triangles = params.max_triangles & ~3;
+
+    size_t max_meshlets = meshopt_buildMeshletsBound(indices.size(), max_vertices, max_triangles);
+    if(!max_meshlets) { return {}; }
+
+    std::vector<meshopt_Meshlet> meshlets(max_meshlets);
+    std::vector<uint32_t> meshlet_vertices(max_meshlets * max_vertices);
+    std::vector<uint8_t> meshlet_triangles(max_meshlets * max_triangles * 3);
+
+    size_t meshlet_count = meshopt_buildMeshlets(meshlets.data(), meshlet_vertices.data(), meshlet_triangles.data(),
+                                                 indices.data(), indices.size(), vertices, num_vertices, vertex_stride,
+                                                 max_vertices, max_triangles, params.cone_weight);
+
+    std::vector<cluster_t> ret(meshlet_count);
+
+    for(uint32_t i = 0; i < meshlet_count; ++i)
+    {
+        const auto &m = meshlets[i];
+        auto &cluster = ret[i];
+
+        // optimize internal meshlet vertex-ordering for locality
+        meshopt_optimizeMeshlet(&meshlet_vertices[m.vertex_offset], &meshlet_triangles[m.triangle_offset],
+                                m.triangle_count, m.vertex_count);
+
+        cluster.vertices = {meshlet_vertices.begin() + m.vertex_offset,
+                            meshlet_vertices.begin() + m.vertex_offset + m.vertex_count};
+        cluster.triangles = {meshlet_triangles.begin() + m.triangle_offset,
+                             meshlet_triangles.begin() + m.triangle_offset + m.triangle_count * 3};
+        cluster.meshlet_bounds =
+                meshopt_computeMeshletBounds(cluster.vertices.data(), cluster.triangles.data(), m.triangle_count,
+                                             vertices, num_vertices, vertex_stride);
+    }
+    return ret;
+}
+
+/**
+ * @brief   group_clusters greedily groups neighboring clusters, i.e. clusters sharing the most vertex-positions.
+ *
+ * @return  an array of groups, containing indices into clusters.
+ */
+std::vector<std::vector<uint32_t>> group_clusters(const std::vector<cluster_t> &clusters,
+                                                  const std::vector<uint32_t> &pending,
+                                                  const std::vector<index_t> &position_remap, uint32_t group_size)
+{
+    // map vertex-positions to referencing clusters (indices into pending)
+    std::unordered_map<index_t, std::vector<uint32_t>> position_clusters;
+
+    for(uint32_t i = 0; i < pending.size(); ++i)
+    {
+        for(auto v: clusters[pending[i]].vertices)
+        {
+            auto &position_cluster_indices = position_clusters[position_remap[v]];
+            if(position_cluster_indices.empty() || position_cluster_indices.back() != i)
+            {
+                position_cluster_indices.push_back(i);
+            }
+        }
+    }
+
+    // number of shared vertex-positions between adjacent clusters
+    std::vector<std::unordered_map<uint32_t, uint32_t>> adjacency(pending.size());
+
+    for(const auto &[position, cluster_indices]: position_clusters)
+    {
+        for(auto a: cluster_indices)
+        {
+            for(auto b: cluster_indices)
+            {
+                if(a != b) { adjacency[a][b]++; }
+            }
+        }
+    }
+
+    std::vector<std::vector<uint32_t>> ret;
+    std::vector<bool> grouped(pending.size(), false);
+
+    for(uint32_t seed = 0; seed < pending.size(); ++seed)
+    {
+        if(grouped[seed]) { continue; }
+
+        std::vector<uint32_t> group = {seed};
+        grouped[seed] = true;
+
+        while(group.size() < group_size)
+        {
+            // find the ungrouped neighbor sharing the most vertices, lowest index wins ties
+            uint32_t best = std::numeric_limits<uint32_t>::max(), best_shared = 0;
+
+            for(auto member: group)
+            {
+                for(const auto &[neighbor, num_shared]: adjacency[member])
+                {
+                    if(grouped[neighbor]) { continue; }
+
+                    if(num_shared > best_shared || (num_shared == best_shared && neighbor < best))
+                    {
+                        best = neighbor;
+                        best_shared = num_shared;
+                    }
+                }
+            }
+
+            // no more neighbors
+            if(best == std::numeric_limits<uint32_t>::max()) { break; }
+
+            group.push_back(best);
+            grouped[best] = true;
+        }
+
+        for(auto &idx: group) { idx = pending[idx]; }
+        ret.push_back(std::move(group));
+    }
+    return ret;
+}
+
+}// namespace
+
+cluster_lod_t create_cluster_lod(const float *vertices, size_t num_vertices, size_t vertex_stride,
+                                 const index_t *indices, size_t num_indices, const cluster_lod_params_t &params)
+{
+    cluster_lod_t ret = {};
+    if(!vertices || !num_vertices || !indices || num_indices < 3) { return ret; }
+
+    // level 0 -> full-resolution clusters, error 0
+    std::vector<cluster_t> clusters =
+            split_clusters({indices, indices + num_indices}, vertices, num_vertices, vertex_stride, params);
+
+    for(auto &cluster: clusters)
+    {
+        cluster.bounds = {*reinterpret_cast<glm::vec3 *>(cluster.meshlet_bounds.center),
+                          cluster.meshlet_bounds.radius};
+    }
+
+    // map vertices to unique positions, attribute-seams need to be locked consistently
+    std::vector<index_t> position_remap(num_vertices);
+    meshopt_Stream position_stream = {vertices, sizeof(glm::vec3), vertex_stride};
+    size_t num_positions = meshopt_generateVertexRemapMulti(position_remap.data(), nullptr, num_vertices,
+                                                            num_vertices, &position_stream, 1);
+
+    std::vector<uint32_t> pending(clusters.size());
+    std::iota(pending.begin(), pending.end(), 0);
+
+    std::vector<uint8_t> vertex_lock(num_vertices);
+    uint32_t level = 0;
+
+    while(pending.size() > 1 && level + 1 < params.max_levels)
+    {
+        auto groups = group_clusters(clusters, pending, position_remap, std::max<uint32_t>(params.group_size, 1));
+
+        // lock all vertex-positions shared between groups
+        std::vector<uint32_t> position_group(num_positions, std::numeric_limits<uint32_t>::max());
+        std::vector<uint8_t> position_lock(num_positions, 0);
+
+        for(uint32_t g = 0; g < groups.size(); ++g)
+        {
+            for(auto c: groups[g])
+            {
+                for(auto v: clusters[c].vertices)
+                {
+                    auto &group_index = position_group[position_remap[v]];
+                    if(group_index == std::numeric_limits<uint32_t>::max()) { group_index = g; }
+                    else if(group_index != g) { position_lock[position_remap[v]] = 1; }
+                }
+            }
+        }
+        for(size_t v = 0; v < num_vertices; ++v) { vertex_lock[v] = position_lock[position_remap[v]]; }
+
+        std::vector<uint32_t> next_pending;
+        bool simplified_any = false;
+
+        for(const auto &group: groups)
+        {
+            // merge triangles of all clusters in group
+            std::vector<index_t> merged_indices;
+            vierkant::Sphere group_bounds = clusters[group.front()].bounds;
+            float group_error = 0.f;
+
+            for(auto c: group)
+            {
+                const auto &cluster = clusters[c];
+                for(auto t: cluster.triangles) { merged_indices.push_back(cluster.vertices[t]); }
+                group_bounds = merge_spheres(group_bounds, cluster.bounds);
+                group_error = std::max(group_error, cluster.error);
+            }
+
+            auto target_index_count = static_cast<size_t>(static_cast<float>(merged_indices.size() / 3) *
+                                                          params.simplify_ratio) *
+                                      3;
+
+            // simplify with locked group-borders, error in object-space
+            constexpr uint32_t options = meshopt_SimplifySparse | meshopt_SimplifyErrorAbsolute;
+            std::vector<index_t> simplified_indices(merged_indices.size());
+            float result_error = 0.f;
+            size_t num_simplified = meshopt_simplifyWithAttributes(
+                    simplified_indices.data(), merged_indices.data(), merged_indices.size(), vertices, num_vertices,
+                    vertex_stride, nullptr, 0, nullptr, 0, vertex_lock.data(), target_index_count,
+                    std::numeric_limits<float>::max(), options, &result_error);
+
+            // not getting any simpler, keep clusters for next level
+            if(!num_simplified || static_cast<float>(num_simplified) >
+                                          static_cast<float>(merged_indices.size()) * params.max_simplify_ratio)
+            {
+                next_pending.insert(next_pending.end(), group.begin(), group.end());
+                continue;
+            }
+            simplified_any = true;
+            simplified_indices.resize(num_simplified);
+
+            // enforce monotonic errors along the DAG
+            group_error = std::max(group_error, result_error);
+
+            for(auto c: group)
+            {
+                clusters[c].parent_bounds = group_bounds;
+                clusters[c].parent_error = group_error;
+            }
+
+            // re-split into new clusters
+            auto new_clusters = split_clusters(simplified_indices, vertices, num_vertices, vertex_stride, params);
+
+            for(auto &cluster: new_clusters)
+            {
+                cluster.bounds = group_bounds;
+                cluster.error = group_error;
+                cluster.level = level + 1;
+                next_pending.push_back(static_cast<uint32_t>(clusters.size()));
+                clusters.push_back(std::move(cluster));
+            }
+        }
+
+        if(!simplified_any) { break; }
+        pending = std::move(next_pending);
+        level++;
+    }
+
+    // combine clusters of all levels into output meshlets
+    ret.meshlets.reserve(clusters.size());
+    ret.meshlet_lods.reserve(clusters.size());
+
+    for(const auto &cluster: clusters)
+    {
+        vierkant::Mesh::meshlet_t out_meshlet = {};
+        out_meshlet.vertex_offset = ret.meshlet_vertices.size();
+        out_meshlet.vertex_count = cluster.vertices.size();
+        out_meshlet.triangle_offset = ret.meshlet_triangles.size();
+        out_meshlet.triangle_count = cluster.triangles.size() / 3;
+        out_meshlet.bounding_sphere = {*reinterpret_cast<const glm::vec3 *>(cluster.meshlet_bounds.center),
+                                       cluster.meshlet_bounds.radius};
+        memcpy(out_meshlet.cone_axis, cluster.meshlet_bounds.cone_axis_s8, sizeof(out_meshlet.cone_axis));
+        out_meshlet.cone_cutoff = cluster.meshlet_bounds.cone_cutoff_s8;
+        ret.meshlets.push_back(out_meshlet);
+
+        vierkant::Mesh::meshlet_lod_t meshlet_lod = {};
+        meshlet_lod.bounds = cluster.bounds;
+        meshlet_lod.error = cluster.error;
+        meshlet_lod.parent_bounds = cluster.parent_bounds;
+        meshlet_lod.parent_error = cluster.parent_error;
+        meshlet_lod.level = cluster.level;
+        ret.meshlet_lods.push_back(meshlet_lod);
+
+        ret.meshlet_vertices.insert(ret.meshlet_vertices.end(), cluster.vertices.begin(), cluster.vertices.end());
+
+        // keep micro-index offsets aligned to 4 bytes
+        ret.meshlet_triangles.insert(ret.meshlet_triangles.end(), cluster.triangles.begin(), cluster.triangles.end());
+        ret.meshlet_triangles.resize((ret.meshlet_triangles.size() + 3) & ~3);
+    }
+    ret.num_levels = clusters.empty() ? 0 : level + 1;
+    return ret;
+}
+
+}// namespace vierkant
@@ -1,3 +1,5 @@
+#include <mutex>
+
 #include <vierkant/descriptor.hpp>
 #include <vierkant/hash.hpp>
 
@@ -5,6 +7,11 @@ namespace vierkant
 {
 
 constexpr uint32_t g_max_bindless_resources = 512;
+
+//! creation-parameters for all alive descriptor-set-layouts
+static std::mutex g_set_layout_mutex;
+static std::unordered_map<VkDescriptorSetLayout, descriptor_set_layout_desc_t> g_set_layout_descs;
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 DescriptorPoolPtr create_descriptor_pool(const vierkant::DevicePtr &device, const descriptor_count_t &counts,
@@ -49,8 +56,12 @@ DescriptorSetLayoutPtr create_descriptor_set_layout(const vierkant::DevicePtr &d
     constexpr VkDescriptorBindingFlags bindless_flags = default_flags | VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT |
                                                         VK_DESCRIPTOR_BINDING_VARIABLE_DESCRIPTOR_COUNT_BIT;
 
-    std::vector<VkDescriptorSetLayoutBinding> bindings;
-    std::vector<VkDescriptorBindingFlags> flags_array;
+    // descriptor-buffers are written by the host, update-after-bind and variable counts are not applicable
+    constexpr VkDescriptorBindingFlags descriptor_buffer_flags = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT;
+
+    descriptor_set_layout_desc_t layout_desc = {};
+    layout_desc.flags = use_descriptor_buffer ? VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT
+                                              : VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
 
     for(const auto &[binding, desc]: descriptors)
     {
@@ -66,30 +77,75 @@ DescriptorSetLayoutPtr create_descriptor_set_layout(const vierkant::DevicePtr &d
         layout_binding.descriptorType = desc.type;
         layout_binding.pImmutableSamplers = nullptr;
         layout_binding.stageFlags = desc.stage_flags;
-        bindings.push_back(layout_binding);
-        flags_array.push_back(desc.variable_count ? bindless_flags : default_flags);
+        layout_desc.bindings.push_back(layout_binding);
+        if(use_descriptor_buffer) { layout_desc.binding_flags.push_back(descriptor_buffer_flags); }
+        else { layout_desc.binding_flags.push_back(desc.variable_count ? bindless_flags : default_flags); }
     }
+    return create_descriptor_set_layout(device, layout_desc);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
 
+DescriptorSetLayoutPtr create_descriptor_set_layout(const vierkant::DevicePtr &device,
+                                                    const descriptor_set_layout_desc_t &desc)
+{
     VkDescriptorSetLayoutBindingFlagsCreateInfo flags_info = {};
     flags_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
-    flags_info.bindingCount = flags_array.size();
-    flags_info.pBindingFlags = flags_array.data();
+    flags_info.bindingCount = static_cast<uint32_t>(desc.binding_flags.size());
+    flags_info.pBindingFlags = desc.binding_flags.data();
 
     VkDescriptorSetLayoutCreateInfo layout_info = {};
     layout_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
     layout_info.pNext = &flags_info;
-    layout_info.bindingCount = static_cast<uint32_t>(bindings.size());
-    layout_info.pBindings = bindings.data();
-    layout_info.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
-
-    if(use_descriptor_buffer) { layout_info.flags |= VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT; }
+    layout_info.bindingCount = static_cast<uint32_t>(desc.bindings.size());
+    layout_info.pBindings = desc.bindings.data();
+    layout_info.flags = desc.flags;
 
     VkDescriptorSetLayout descriptor_set_layout = VK_NULL_HANDLE;
     vkCheck(vkCreateDescriptorSetLayout(device->handle(), &layout_info, nullptr, &descriptor_set_layout),
             "failed to create descriptor set layout!");
 
-    return {descriptor_set_layout,
-            [device](VkDescriptorSetLayout dl) { vkDestroyDescriptorSetLayout(device->handle(), dl, nullptr); }};
+    {
+        std::unique_lock lock(g_set_layout_mutex);
+        g_set_layout_descs[descriptor_set_layout] = desc;
+    }
+
+    return {descriptor_set_layout, [device](VkDescriptorSetLayout dl) {
+                {
+                    std::unique_lock lock(g_set_layout_mutex);
+                    g_set_layout_descs.erase(dl);
+                }
+                vkDestroyDescriptorSetLayout(device->handle(), dl, nullptr);
+            }};
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+std::optional<descriptor_set_layout_desc_t> descriptor_set_layout_desc(VkDescriptorSetLayout set_layout)
+{
+    std::unique_lock lock(g_set_layout_mutex);
+    auto it = g_set_layout_descs.find(set_layout);
+    if(it != g_set_layout_descs.end()) { return it->second; }
+    return {};
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool descriptor_set_layout_desc_t::operator==(const descriptor_set_layout_desc_t &other) const
+{
+    if(flags != other.flags || binding_flags != other.binding_flags) { return false; }
+    if(bindings.size() != other.bindings.size()) { return false; }
+
+    for(uint32_t i = 0; i < bindings.size(); ++i)
+    {
+        const auto &lhs = bindings[i], &rhs = other.bindings[i];
+        if(lhs.binding != rhs.binding || lhs.descriptorType != rhs.descriptorType ||
+           lhs.descriptorCount != rhs.descriptorCount || lhs.stageFlags != rhs.stageFlags)
+        {
+            return false;
+        }
+    }
+    return true;
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -275,7 +331,8 @@ void update_descriptor_set(const vierkant::DevicePtr &device, const descriptor_m
 
 DescriptorSetLayoutPtr find_or_create_set_layout(const vierkant::DevicePtr &device, descriptor_map_t descriptors,
                                                  std::unordered_map<descriptor_map_t, DescriptorSetLayoutPtr> &current,
-                                                 std::unordered_map<descriptor_map_t, DescriptorSetLayoutPtr> &next)
+                                                 std::unordered_map<descriptor_map_t, DescriptorSetLayoutPtr> &next,
+                                                 bool use_descriptor_buffer)
 {
     // clean descriptor-map to enable sharing
     for(auto &[binding, descriptor]: descriptors)
@@ -303,7 +360,7 @@ DescriptorSetLayoutPtr find_or_create_set_layout(const vierkant::DevicePtr &devi
     // not found -> create and insert descriptor-set layout
     if(set_it == next.end())
     {
-        auto new_set = vierkant::create_descriptor_set_layout(device, descriptors);
+        auto new_set = vierkant::create_descriptor_set_layout(device, descriptors, use_descriptor_buffer);
         set_it = next.insert(std::make_pair(std::move(descriptors), std::move(new_set))).first;
     }
     return set_it->second;
@@ -313,14 +370,9 @@ DescriptorSetLayoutPtr find_or_create_set_layout(const vierkant::DevicePtr &devi
 
 struct descriptor_size_fn_t
 {
-    explicit descriptor_size_fn_t(VkPhysicalDevice physical_device)
-    {
-        properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_PROPERTIES_EXT;
-        VkPhysicalDeviceProperties2 device_properties = {};
-        device_properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
-        device_properties.pNext = &properties;
-        vkGetPhysicalDeviceProperties2(physical_device, &device_properties);
-    }
+    explicit descriptor_size_fn_t(const VkPhysicalDeviceDescriptorBufferPropertiesEXT &properties)
+        : properties(properties)
+    {}
 
     inline size_t operator()(VkDescriptorType t) const
     {
@@ -340,29 +392,70 @@ struct descriptor_size_fn_t
             default: throw std::runtime_error("descriptor-type not support in descriptor-buffer");
         }
     }
-    VkPhysicalDeviceDescriptorBufferPropertiesEXT properties = {};
+    const VkPhysicalDeviceDescriptorBufferPropertiesEXT &properties;
 };
 
-void update_descriptor_buffer(const vierkant::DevicePtr &device, const DescriptorSetLayoutPtr &layout,
-                              const descriptor_map_t &descriptors,
-                              const vierkant::BufferPtr & /*out_descriptor_buffer*/)
+VkDeviceSize descriptor_buffer_size(const vierkant::DevicePtr &device, VkDescriptorSetLayout set_layout)
 {
-    assert(vkGetDescriptorSetLayoutSizeEXT && vkGetDescriptorSetLayoutBindingOffsetEXT && vkGetDescriptorEXT &&
-           vkGetAccelerationStructureDeviceAddressKHR);
+    assert(vkGetDescriptorSetLayoutSizeEXT);
+    VkDeviceSize size = 0;
+    vkGetDescriptorSetLayoutSizeEXT(device->handle(), set_layout, &size);
 
-    auto descriptor_size_fn = descriptor_size_fn_t(device->physical_device());
+    // round up, so consecutive sets start at valid offsets
+    auto alignment = std::max<VkDeviceSize>(1, device->properties().descriptor_buffer.descriptorBufferOffsetAlignment);
+    return (size + alignment - 1) / alignment * alignment;
+}
 
-    // query buffer-size for provided layout
-    VkDeviceSize size;
-    vkGetDescriptorSetLayoutSizeEXT(device->handle(), layout.get(), &size);
+bool descriptor_buffer_compatible(const descriptor_map_t &descriptors)
+{
+    for(const auto &[binding, descriptor]: descriptors)
+    {
+        switch(descriptor.type)
+        {
+            case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+            case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+                for(const auto &buf: descriptor.buffers)
+                {
+                    if(buf && !buf->device_address()) { return false; }
+                }
+                break;
+
+            case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+            case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+            case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+            case VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR: break;
 
-    std::vector<uint8_t> out_data(size);
+            default: return false;
+        }
+        if(descriptor.variable_count) { return false; }
+    }
+    return true;
+}
+
+void update_descriptor_buffer(const vierkant::DevicePtr &device, VkDescriptorSetLayout set_layout,
+                              const descriptor_map_t &descriptors, const vierkant::BufferPtr &out_descriptor_buffer,
+                              VkDeviceSize offset)
+{
+    assert(vkGetDescriptorSetLayoutBindingOffsetEXT && vkGetDescriptorEXT);
+    assert(out_descriptor_buffer && offset + descriptor_buffer_size(device, set_layout) <=
+                                            out_descriptor_buffer->num_bytes());
+
+    auto descriptor_size_fn = descriptor_size_fn_t(device->properties().descriptor_buffer);
+
+    // descriptors are written directly into a host-visible descriptor-buffer
+    auto out_data = static_cast<uint8_t *>(out_descriptor_buffer->map());
+    if(!out_data)
+    {
+        spdlog::error("update_descriptor_buffer: descriptor-buffer is not host-visible");
+        return;
+    }
+    out_data += offset;
 
     for(const auto &[binding, descriptor]: descriptors)
     {
-        VkDeviceSize offset;
-        vkGetDescriptorSetLayoutBindingOffsetEXT(device->handle(), layout.get(), binding, &offset);
-        uint8_t *data_ptr = out_data.data() + offset;
+        VkDeviceSize binding_offset;
+        vkGetDescriptorSetLayoutBindingOffsetEXT(device->handle(), set_layout, binding, &binding_offset);
+        uint8_t *data_ptr = out_data + binding_offset;
 
         auto desc_stride = descriptor_size_fn(descriptor.type);
 
@@ -467,72 +560,122 @@ void update_descriptor_buffer(const vierkant::DevicePtr &device, const Descripto
                                          std::to_string(descriptor.type));
         }
     }
-    // set-layout needs alternative flag:
-    // VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT
-
-    // buffers additional flags:
-    // VK_BUFFER_USAGE_SAMPLER_DESCRIPTOR_BUFFER_BIT_EXT
-    // VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-DescriptorSetPtr find_or_create_descriptor_set(const vierkant::DevicePtr &device, VkDescriptorSetLayout set_layout,
-                                               const descriptor_map_t &descriptors,
-                                               const vierkant::DescriptorPoolPtr &pool, descriptor_set_map_t &last,
-                                               descriptor_set_map_t &current, bool variable_count, bool relax_reuse)
+uint64_t descriptor_hash(const descriptor_map_t &descriptors, bool relax_reuse)
 {
-    auto descriptors_copy = descriptors;
+    if(!relax_reuse) { return std::hash<descriptor_map_t>()(descriptors); }
 
-    if(relax_reuse)
+    // only layout and number of resources
+    size_t h = 0;
+    hash_combine(h, relax_reuse);
+
+    for(const auto &[binding, descriptor]: descriptors)
     {
-        // clean descriptor-map to enable sharing
-        for(auto &[binding, descriptor]: descriptors_copy)
+        hash_combine(h, binding);
+        hash_combine(h, descriptor.type);
+        hash_combine(h, descriptor.stage_flags);
+        hash_combine(h, descriptor.variable_count);
+        hash_combine(h, descriptor.buffers.size());
+        for(const auto &[offset, range]: descriptor.buffer_ranges)
+        {
+            hash_combine(h, offset);
+            hash_combine(h, range);
+        }
+        hash_combine(h, descriptor.images.size());
+        for(const auto &s: descriptor.image_views) { hash_combine(h, s); }
+        hash_combine(h, descriptor.acceleration_structures.size());
+    }
+    return h;
+}
+
+//! compare cached descriptors against a descriptor-map, equivalent to comparing a stripped copy for 'relax_reuse'
+static bool descriptors_equal(const descriptor_set_entry_t &entry, const descriptor_map_t &descriptors,
+                              bool relax_reuse)
+{
+    if(entry.relax_reuse != relax_reuse) { return false; }
+    if(!relax_reuse) { return entry.descriptors == descriptors; }
+    if(entry.descriptors.size() != descriptors.size()) { return false; }
+
+    for(auto lhs_it = entry.descriptors.begin(), rhs_it = descriptors.begin(); lhs_it != entry.descriptors.end();
+        ++lhs_it, ++rhs_it)
+    {
+        const auto &[lhs_binding, lhs] = *lhs_it;
+        const auto &[rhs_binding, rhs] = *rhs_it;
+
+        if(lhs_binding != rhs_binding || lhs.type != rhs.type || lhs.stage_flags != rhs.stage_flags ||
+           lhs.variable_count != rhs.variable_count || lhs.buffers.size() != rhs.buffers.size() ||
+           lhs.buffer_ranges != rhs.buffer_ranges || lhs.images.size() != rhs.images.size() ||
+           lhs.image_views != rhs.image_views ||
+           lhs.acceleration_structures.size() != rhs.acceleration_structures.size())
         {
-            for(auto &img: descriptor.images) { img.reset(); }
-            for(auto &buf: descriptor.buffers) { buf.reset(); }
-            for(auto &as: descriptor.acceleration_structures) { as.reset(); }
-            descriptor.inline_uniform_block.clear();
+            return false;
         }
     }
+    return true;
+}
+
+//! search a cache for matching descriptors
+static descriptor_set_map_t::iterator find_descriptor_set(descriptor_set_map_t &cache, uint64_t hash,
+                                                          const descriptor_map_t &descriptors, bool relax_reuse)
+{
+    auto [first, last] = cache.equal_range(hash);
+    for(auto it = first; it != last; ++it)
+    {
+        if(descriptors_equal(it->second, descriptors, relax_reuse)) { return it; }
+    }
+    return cache.end();
+}
 
-    // handle for a descriptor-set
-    DescriptorSetPtr ret;
+DescriptorSetPtr find_or_create_descriptor_set(const vierkant::DevicePtr &device, VkDescriptorSetLayout set_layout,
+                                               const descriptor_map_t &descriptors,
+                                               const vierkant::DescriptorPoolPtr &pool, descriptor_set_map_t &last,
+                                               descriptor_set_map_t &current, bool variable_count, bool relax_reuse)
+{
+    // hash once, no copies of the descriptor-map on lookup
+    uint64_t hash = descriptor_hash(descriptors, relax_reuse);
+
+    // start searching in current assets
+    auto descriptor_set_it = find_descriptor_set(current, hash, descriptors, relax_reuse);
+    if(descriptor_set_it != current.end()) { return descriptor_set_it->second.descriptor_set; }
 
-    // search/create descriptor set
+    // search in last assets (might already been processed for this frame)
+    auto last_assets_it = find_descriptor_set(last, hash, descriptors, relax_reuse);
 
-    // start searching in next_assets
-    auto descriptor_set_it = current.find(descriptors_copy);
+    descriptor_set_map_t::iterator inserted_it;
 
-    // not found in current assets
-    if(descriptor_set_it == current.end())
+    if(last_assets_it == last.end())
     {
-        // search in last assets (might already been processed for this frame)
-        auto current_assets_it = last.find(descriptors_copy);
+        // create a new descriptor set
+        descriptor_set_entry_t entry = {};
+        entry.descriptors = descriptors;
+        entry.descriptor_set = vierkant::create_descriptor_set(device, pool, set_layout, variable_count);
+        entry.relax_reuse = relax_reuse;
 
-        // not found in last assets
-        if(current_assets_it == last.end())
+        if(relax_reuse)
         {
-            // create a new descriptor set
-            ret = vierkant::create_descriptor_set(device, pool, set_layout, variable_count);
-        }
-        else
-        {
-            // use existing descriptor set
-            ret = std::move(current_assets_it->second);
-            last.erase(current_assets_it);
+            // clean descriptor-map to enable sharing
+            for(auto &[binding, descriptor]: entry.descriptors)
+            {
+                for(auto &img: descriptor.images) { img.reset(); }
+                for(auto &buf: descriptor.buffers) { buf.reset(); }
+                for(auto &as: descriptor.acceleration_structures) { as.reset(); }
+                descriptor.inline_uniform_block.clear();
+            }
         }
-
-        // update the descriptor set
-        vierkant::update_descriptor_set(device, descriptors, ret);
-
-        // insert all created assets and store in map
-        current[descriptors_copy] = ret;
+        inserted_it = current.emplace(hash, std::move(entry));
     }
     else
     {
-        ret = descriptor_set_it->second;
+        // use existing descriptor set, move the node without re-allocating
+        inserted_it = current.insert(last.extract(last_assets_it));
     }
+    const auto &ret = inserted_it->second.descriptor_set;
+
+    // update the descriptor set
+    vierkant::update_descriptor_set(device, descriptors, ret);
     return ret;
 }
 
@@ -575,3 +718,20 @@ size_t std::hash<vierkant::descriptor_map_t>::operator()(const vierkant::descrip
     }
     return h;
 }
+
+size_t std::hash<vierkant::descriptor_set_layout_desc_t>::operator()(
+        const vierkant::descriptor_set_layout_desc_t &desc) const
+{
+    size_t h = 0;
+    hash_combine(h, desc.flags);
+
+    for(uint32_t i = 0; i < desc.bindings.size(); ++i)
+    {
+        hash_combine(h, desc.bindings[i].binding);
+        hash_combine(h, desc.bindings[i].descriptorType);
+        hash_combine(h, desc.bindings[i].descriptorCount);
+        hash_combine(h, desc.bindings[i].stageFlags);
+    }
+    for(auto binding_flags: desc.binding_flags) { hash_combine(h, binding_flags); }
+    return h;
+}
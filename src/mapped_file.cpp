@@ -0,0 +1,129 @@
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <format>
+#include <fstream>
+#include <random>
+
+#include <spdlog/spdlog.h>
+#include <vierkant/mapped_file.hpp>
+
+namespace vierkant
+{
+
+MappedFilePtr MappedFile::create(const std::filesystem::path &path)
+{
+    if(!std::filesystem::is_regular_file(path)) { return nullptr; }
+    auto ret = MappedFilePtr(new MappedFile());
+
+#ifdef _WIN32
+    ret->m_file = CreateFileW(path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if(ret->m_file == INVALID_HANDLE_VALUE)
+    {
+        ret->m_file = nullptr;
+        return nullptr;
+    }
+
+    LARGE_INTEGER file_size = {};
+    if(!GetFileSizeEx(ret->m_file, &file_size)) { return nullptr; }
+    ret->m_num_bytes = static_cast<size_t>(file_size.QuadPart);
+    if(!ret->m_num_bytes) { return ret; }
+
+    ret->m_mapping = CreateFileMappingW(ret->m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if(!ret->m_mapping) { return nullptr; }
+
+    ret->m_data = static_cast<const uint8_t *>(MapViewOfFile(ret->m_mapping, FILE_MAP_READ, 0, 0, 0));
+    if(!ret->m_data) { return nullptr; }
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if(fd < 0) { return nullptr; }
+
+    struct stat file_stat = {};
+    if(fstat(fd, &file_stat) != 0)
+    {
+        close(fd);
+        return nullptr;
+    }
+    ret->m_num_bytes = static_cast<size_t>(file_stat.st_size);
+
+    if(ret->m_num_bytes)
+    {
+        void *ptr = mmap(nullptr, ret->m_num_bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        // mapping stays valid after closing the file-descriptor
+        close(fd);
+        if(ptr == MAP_FAILED) { return nullptr; }
+        ret->m_data = static_cast<const uint8_t *>(ptr);
+    }
+    else { close(fd); }
+#endif
+    return ret;
+}
+
+MappedFile::~MappedFile()
+{
+#ifdef _WIN32
+    if(m_data) { UnmapViewOfFile(m_data); }
+    if(m_mapping) { CloseHandle(m_mapping); }
+    if(m_file) { CloseHandle(m_file); }
+#else
+    if(m_data) { munmap(const_cast<uint8_t *>(m_data), m_num_bytes); }
+#endif
+}
+
+bool write_file_atomic(const std::filesystem::path &path,
+                       const std::function<bool(const std::filesystem::path &tmp_path)> &write_fn)
+{
+    if(!write_fn) { return false; }
+
+#ifdef _WIN32
+    auto pid = static_cast<uint64_t>(GetCurrentProcessId());
+#else
+    auto pid = static_cast<uint64_t>(getpid());
+#endif
+
+    // unique across threads and processes
+    std::random_device rd;
+    auto tmp_path = path;
+    tmp_path += std::format(".{}.{:08x}{:08x}.tmp", pid, rd(), rd());
+
+    std::error_code ec;
+    if(path.has_parent_path()) { std::filesystem::create_directories(path.parent_path(), ec); }
+
+    if(!write_fn(tmp_path))
+    {
+        spdlog::warn("could not write file: {}", tmp_path.string());
+        std::filesystem::remove(tmp_path, ec);
+        return false;
+    }
+    std::filesystem::rename(tmp_path, path, ec);
+
+    if(ec)
+    {
+        spdlog::warn("could not rename file: {} -> {} ({})", tmp_path.string(), path.string(), ec.message());
+        std::filesystem::remove(tmp_path, ec);
+        return false;
+    }
+    return true;
+}
+
+bool write_file_atomic(const std::filesystem::path &path, std::span<const uint8_t> bytes)
+{
+    return write_file_atomic(path, [bytes](const std::filesystem::path &tmp_path) {
+        std::ofstream stream(tmp_path, std::ios::binary | std::ios::trunc);
+        if(!stream.is_open()) { return false; }
+        stream.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        return stream.good();
+    });
+}
+
+}// namespace vierkant
@@ -9,8 +9,11 @@
 #define TINYGLTF_IMPLEMENTATION
 
 #include <deque>
+#include <set>
+#include <span>
 #include <tiny_gltf.h>
 
+#include <vierkant/mapped_file.hpp>
 #include <vierkant/model/gltf.hpp>
 #include <vierkant/transform.hpp>
 
@@ -133,6 +136,285 @@ using node_map_t = std::unordered_map<uint32_t, vierkant::nodes::NodePtr>;
 
 using joint_map_t = std::unordered_map<uint32_t, uint32_t>;
 
+//! byte-ranges for all buffers, either owned by tinygltf or mapped from a glb-file
+using buffer_spans_t = std::vector<std::span<const uint8_t>>;
+
+// glb container
+constexpr uint32_t glb_magic = 0x46546C67;
+constexpr uint32_t glb_chunk_json = 0x4E4F534A;
+constexpr uint32_t glb_chunk_bin = 0x004E4942;
+
+//! placeholder for glb-embedded buffers, prevents tinygltf from copying the BIN-chunk
+constexpr char glb_placeholder_uri[] = "data:application/octet-stream;base64,AAAA";
+constexpr size_t glb_placeholder_size = 3;
+
+struct glb_t
+{
+    std::string_view json;
+    std::span<const uint8_t> bin;
+};
+
+//! images referenced by a glb-file, decoded directly from mapped memory
+struct glb_image_t
+{
+    int buffer_view = -1;
+    std::string uri;
+};
+
+template<typename T>
+struct elem_traits_t
+{
+    using component_t = T;
+    static constexpr uint32_t num_components = 1;
+};
+
+template<glm::length_t L, typename U, glm::qualifier Q>
+struct elem_traits_t<glm::vec<L, U, Q>>
+{
+    using component_t = U;
+    static constexpr uint32_t num_components = L;
+};
+
+template<glm::length_t C, glm::length_t R, typename U, glm::qualifier Q>
+struct elem_traits_t<glm::mat<C, R, U, Q>>
+{
+    using component_t = U;
+    static constexpr uint32_t num_components = C * R;
+};
+
+template<typename T>
+constexpr int component_type()
+{
+    if constexpr(std::is_same_v<T, float>) { return TINYGLTF_COMPONENT_TYPE_FLOAT; }
+    else if constexpr(std::is_same_v<T, uint32_t>) { return TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT; }
+    else if constexpr(std::is_same_v<T, uint16_t>) { return TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT; }
+    else if constexpr(std::is_same_v<T, uint8_t>) { return TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE; }
+    else { return -1; }
+}
+
+template<typename U>
+inline U load_unaligned(const uint8_t *ptr)
+{
+    U ret;
+    memcpy(&ret, ptr, sizeof(U));
+    return ret;
+}
+
+/**
+ * @brief   read_component reads and converts a single accessor-component, applying normalization if requested.
+ */
+template<typename T>
+inline T read_component(const uint8_t *ptr, int component_type, bool normalized)
+{
+    auto convert = [normalized](auto value, float max_value) -> T {
+        if constexpr(std::is_floating_point_v<T>)
+        {
+            if(normalized) { return std::max(static_cast<T>(value) / static_cast<T>(max_value), T(-1)); }
+        }
+        return static_cast<T>(value);
+    };
+
+    switch(component_type)
+    {
+        case TINYGLTF_COMPONENT_TYPE_BYTE: return convert(load_unaligned<int8_t>(ptr), 127.f);
+        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE: return convert(load_unaligned<uint8_t>(ptr), 255.f);
+        case TINYGLTF_COMPONENT_TYPE_SHORT: return convert(load_unaligned<int16_t>(ptr), 32767.f);
+        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT: return convert(load_unaligned<uint16_t>(ptr), 65535.f);
+        case TINYGLTF_COMPONENT_TYPE_INT: return static_cast<T>(load_unaligned<int32_t>(ptr));
+        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT: return static_cast<T>(load_unaligned<uint32_t>(ptr));
+        case TINYGLTF_COMPONENT_TYPE_FLOAT: return static_cast<T>(load_unaligned<float>(ptr));
+        case TINYGLTF_COMPONENT_TYPE_DOUBLE: return static_cast<T>(load_unaligned<double>(ptr));
+        default: return T(0);
+    }
+}
+
+/**
+ * @brief   buffer_view_data returns a bounds-checked pointer into a buffer-view.
+ *
+ * @return  pointer to the requested range or nullptr, if the range is invalid.
+ */
+const uint8_t *buffer_view_data(const tinygltf::Model &model, const buffer_spans_t &buffers, int buffer_view_index,
+                                size_t byte_offset, size_t num_bytes)
+{
+    if(buffer_view_index < 0 || static_cast<size_t>(buffer_view_index) >= model.bufferViews.size()) { return nullptr; }
+    const auto &buffer_view = model.bufferViews[buffer_view_index];
+    if(buffer_view.buffer < 0 || static_cast<size_t>(buffer_view.buffer) >= buffers.size()) { return nullptr; }
+
+    const auto &buffer = buffers[buffer_view.buffer];
+    size_t offset = buffer_view.byteOffset + byte_offset;
+    if(byte_offset + num_bytes > buffer_view.byteLength || offset + num_bytes > buffer.size()) { return nullptr; }
+    return buffer.data() + offset;
+}
+
+/**
+ * @brief   read_accessor decodes an accessor into an array of elements.
+ *
+ *          handles interleaved data, component-conversions, normalized integer-types and sparse accessors.
+ *          data is read directly from the provided buffer-spans (e.g. a mapped glb-file).
+ *
+ * @return  true, if the accessor could be decoded.
+ */
+template<typename T>
+bool read_accessor(const tinygltf::Model &model, const buffer_spans_t &buffers, const tinygltf::Accessor &accessor,
+                   std::vector<T> &out)
+{
+    using traits_t = elem_traits_t<T>;
+    using component_t = typename traits_t::component_t;
+
+    const int num_src_components = tinygltf::GetNumComponentsInType(accessor.type);
+    const int component_size = tinygltf::GetComponentSizeInBytes(accessor.componentType);
+    if(num_src_components <= 0 || component_size <= 0) { return false; }
+
+    const size_t elem_size = static_cast<size_t>(num_src_components) * component_size;
+    const uint32_t num_components = std::min<uint32_t>(num_src_components, traits_t::num_components);
+    const bool same_layout = accessor.componentType == component_type<component_t>() &&
+                             static_cast<uint32_t>(num_src_components) == traits_t::num_components;
+
+    auto read_element = [&](const uint8_t *src, T &dst) {
+        if(same_layout)
+        {
+            memcpy(&dst, src, sizeof(T));
+            return;
+        }
+        auto *dst_components = reinterpret_cast<component_t *>(&dst);
+        for(uint32_t c = 0; c < num_components; ++c)
+        {
+            dst_components[c] = read_component<component_t>(src + c * component_size, accessor.componentType,
+                                                            accessor.normalized);
+        }
+
+        // missing alpha defaults to one
+        if(num_src_components == 3 && traits_t::num_components == 4) { dst_components[3] = component_t(1); }
+    };
+
+    out.assign(accessor.count, T(0));
+
+    if(accessor.bufferView >= 0 && accessor.count)
+    {
+        if(static_cast<size_t>(accessor.bufferView) >= model.bufferViews.size()) { return false; }
+        int stride = accessor.ByteStride(model.bufferViews[accessor.bufferView]);
+        if(stride <= 0) { return false; }
+
+        const uint8_t *data = buffer_view_data(model, buffers, accessor.bufferView, accessor.byteOffset,
+                                               (accessor.count - 1) * stride + elem_size);
+        if(!data) { return false; }
+
+        if(same_layout && static_cast<size_t>(stride) == sizeof(T))
+        {
+            memcpy(out.data(), data, accessor.count * sizeof(T));
+        }
+        else
+        {
+            for(size_t i = 0; i < accessor.count; ++i) { read_element(data + i * stride, out[i]); }
+        }
+    }
+
+    if(accessor.sparse.isSparse)
+    {
+        const auto &sparse = accessor.sparse;
+        const int index_size = tinygltf::GetComponentSizeInBytes(sparse.indices.componentType);
+        if(index_size <= 0 || sparse.count < 0) { return false; }
+
+        const size_t count = sparse.count;
+        const uint8_t *indices = buffer_view_data(model, buffers, sparse.indices.bufferView,
+                                                  sparse.indices.byteOffset, count * index_size);
+        const uint8_t *values =
+                buffer_view_data(model, buffers, sparse.values.bufferView, sparse.values.byteOffset, count * elem_size);
+        if(!indices || !values) { return false; }
+
+        for(size_t i = 0; i < count; ++i)
+        {
+            auto index = read_component<uint32_t>(indices + i * index_size, sparse.indices.componentType, false);
+            if(index < out.size()) { read_element(values + i * elem_size, out[index]); }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief   parse_glb validates a glb-container and returns its JSON- and BIN-chunks.
+ */
+std::optional<glb_t> parse_glb(std::span<const uint8_t> bytes)
+{
+    constexpr size_t header_size = 12, chunk_header_size = 8;
+    if(bytes.size() < header_size + chunk_header_size) { return {}; }
+
+    auto magic = load_unaligned<uint32_t>(bytes.data());
+    auto version = load_unaligned<uint32_t>(bytes.data() + 4);
+    auto length = std::min<size_t>(load_unaligned<uint32_t>(bytes.data() + 8), bytes.size());
+    if(magic != glb_magic || version != 2) { return {}; }
+
+    glb_t ret = {};
+    bool has_json = false;
+
+    for(size_t offset = header_size; offset + chunk_header_size <= length;)
+    {
+        size_t chunk_length = load_unaligned<uint32_t>(bytes.data() + offset);
+        auto chunk_type = load_unaligned<uint32_t>(bytes.data() + offset + 4);
+        offset += chunk_header_size;
+        if(offset + chunk_length > length) { return {}; }
+
+        if(chunk_type == glb_chunk_json && !has_json)
+        {
+            ret.json = {reinterpret_cast<const char *>(bytes.data() + offset), chunk_length};
+            has_json = true;
+        }
+        else if(chunk_type == glb_chunk_bin && ret.bin.empty()) { ret.bin = bytes.subspan(offset, chunk_length); }
+
+        // chunks are 4-byte aligned
+        offset += (chunk_length + 3) & ~size_t(3);
+    }
+    if(!has_json) { return {}; }
+    return ret;
+}
+
+/**
+ * @brief   patch_glb_json prepares the JSON-chunk of a glb-file for tinygltf.
+ *
+ *          the glb-embedded buffer is replaced by a placeholder and images are extracted,
+ *          so neither BIN-chunk nor images are copied during parsing.
+ *
+ * @param   json        the original JSON-chunk
+ * @param   images      output-array for extracted images
+ * @param   has_bin     output-flag, indicating that buffer 0 references the BIN-chunk
+ * @return  the patched JSON-string or nullopt, if parsing failed
+ */
+std::optional<std::string> patch_glb_json(std::string_view json, std::vector<glb_image_t> &images, bool &has_bin)
+{
+    auto doc = nlohmann::json::parse(json.begin(), json.end(), nullptr, false);
+    if(doc.is_discarded() || !doc.is_object()) { return {}; }
+
+    has_bin = false;
+    images.clear();
+
+    if(auto it = doc.find("images"); it != doc.end())
+    {
+        if(it->is_array())
+        {
+            for(const auto &image: *it)
+            {
+                glb_image_t glb_image;
+                glb_image.buffer_view = image.value("bufferView", -1);
+                glb_image.uri = image.value("uri", std::string());
+                images.push_back(std::move(glb_image));
+            }
+        }
+        doc.erase(it);
+    }
+
+    if(auto it = doc.find("buffers"); it != doc.end() && it->is_array() && !it->empty())
+    {
+        auto &buffer = it->front();
+        if(buffer.is_object() && !buffer.contains("uri"))
+        {
+            buffer["uri"] = glb_placeholder_uri;
+            buffer["byteLength"] = glb_placeholder_size;
+            has_bin = true;
+        }
+    }
+    return doc.dump();
+}
+
 vierkant::transform_t node_transform(const tinygltf::Node &tiny_node)
 {
     if(tiny_node.matrix.size() == 16)
@@ -196,99 +478,51 @@ std::optional<glm::mat4> texture_transform(const tinygltf::TextureInfo &texture_
 }
 
 vierkant::GeometryPtr create_geometry(const tinygltf::Primitive &primitive, const tinygltf::Model &model,
-                                      const std::map<std::string, int> &attributes, bool morph_target)
+                                      const buffer_spans_t &buffers, const std::map<std::string, int> &attributes,
+                                      bool morph_target)
 {
     auto geometry = vierkant::Geometry::create();
 
     // extract indices
     if(!morph_target && primitive.indices >= 0 && static_cast<size_t>(primitive.indices) < model.accessors.size())
     {
-        tinygltf::Accessor index_accessor = model.accessors[primitive.indices];
-        const auto &buffer_view = model.bufferViews[index_accessor.bufferView];
-        const auto &buffer = model.buffers[buffer_view.buffer];
-
-        if(buffer_view.target == 0) { spdlog::warn("bufferView.target is zero"); }
-
+        const tinygltf::Accessor &index_accessor = model.accessors[primitive.indices];
         assert(index_accessor.type == TINYGLTF_TYPE_SCALAR);
 
-        auto data =
-                static_cast<const uint8_t *>(buffer.data.data() + index_accessor.byteOffset + buffer_view.byteOffset);
-
-
-        if(index_accessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT)
-        {
-            const auto *ptr = reinterpret_cast<const uint16_t *>(data);
-            geometry->indices = {ptr, ptr + index_accessor.count};
-        }
-        else if(index_accessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE)
+        if(index_accessor.bufferView >= 0 &&
+           static_cast<size_t>(index_accessor.bufferView) < model.bufferViews.size() &&
+           model.bufferViews[index_accessor.bufferView].target == 0)
         {
-            const auto *ptr = reinterpret_cast<const uint8_t *>(data);
-            geometry->indices = {ptr, ptr + index_accessor.count};
+            spdlog::warn("bufferView.target is zero");
         }
-        else if(index_accessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT)
-        {
-            const auto *ptr = reinterpret_cast<const uint32_t *>(data);
-            geometry->indices = {ptr, ptr + index_accessor.count};
-        }
-        else
+
+        if(!read_accessor(model, buffers, index_accessor, geometry->indices))
         {
-            spdlog::error("unsupported index-type: {}", index_accessor.componentType);
+            spdlog::error("could not read indices (type: {})", index_accessor.componentType);
+            geometry->indices.clear();
         }
     }
 
     for(const auto &[attrib, accessor_idx]: attributes)
     {
-        tinygltf::Accessor accessor = model.accessors[accessor_idx];
-        const auto &buffer_view = model.bufferViews[accessor.bufferView];
-        const auto &buffer = model.buffers[buffer_view.buffer];
-
-        if(accessor.sparse.isSparse) { assert(false); }
-
-        auto insert = [&accessor, &buffer_view](const tinygltf::Buffer &input, auto &array) {
-            using elem_t = typename std::decay<decltype(array)>::type::value_type;
-            constexpr size_t elem_size = sizeof(elem_t);
-
-            // data with offset
-            const uint8_t *data = input.data.data() + buffer_view.byteOffset + accessor.byteOffset;
-            uint32_t stride = accessor.ByteStride(buffer_view);
+        if(accessor_idx < 0 || static_cast<size_t>(accessor_idx) >= model.accessors.size()) { continue; }
+        const tinygltf::Accessor &accessor = model.accessors[accessor_idx];
 
-            if(stride == elem_size)
+        auto insert = [&model, &buffers, &accessor, &attrib](auto &array) {
+            if(!read_accessor(model, buffers, accessor, array))
             {
-                const auto *ptr = reinterpret_cast<const elem_t *>(data);
-                auto end = ptr + accessor.count;
-                array = {ptr, end};
-            }
-            else
-            {
-                auto ptr = data;
-                auto end = data + accessor.count * stride;
-
-                // prealloc
-                array.resize(accessor.count);
-                auto dst = reinterpret_cast<uint8_t *>(array.data());
-
-                // stride copy
-                for(; ptr < end; ptr += stride, dst += elem_size) { std::memcpy(dst, ptr, elem_size); }
+                spdlog::warn("could not read vertex-attribute '{}'", attrib);
+                array.clear();
             }
         };
 
-        if(attrib == attrib_position) { insert(buffer, geometry->positions); }
-        else if(attrib == attrib_normal) { insert(buffer, geometry->normals); }
-        else if(attrib == attrib_tangent) { insert(buffer, geometry->tangents); }
-        else if(attrib == attrib_color) { insert(buffer, geometry->colors); }
-        else if(attrib == attrib_texcoord) { insert(buffer, geometry->tex_coords); }
-        else if(attrib == attrib_joints)
-        {
-            assert(accessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT);
-            assert(accessor.type == TINYGLTF_TYPE_VEC4);
-            insert(buffer, geometry->bone_indices);
-        }
-        else if(attrib == attrib_weights)
-        {
-            assert(accessor.componentType == TINYGLTF_COMPONENT_TYPE_FLOAT);
-            assert(accessor.type == TINYGLTF_TYPE_VEC4);
-            insert(buffer, geometry->bone_weights);
-        }
+        if(attrib == attrib_position) { insert(geometry->positions); }
+        else if(attrib == attrib_normal) { insert(geometry->normals); }
+        else if(attrib == attrib_tangent) { insert(geometry->tangents); }
+        else if(attrib == attrib_color) { insert(geometry->colors); }
+        else if(attrib == attrib_texcoord) { insert(geometry->tex_coords); }
+        else if(attrib == attrib_joints) { insert(geometry->bone_indices); }
+        else if(attrib == attrib_weights) { insert(geometry->bone_weights); }
     }// for all attributes
 
     if(!morph_target)
@@ -691,7 +925,7 @@ vierkant::texture_sampler_t convert_sampler(const tinygltf::Sampler &tiny_sample
 }
 
 vierkant::nodes::NodePtr create_bone_hierarchy_bfs(const tinygltf::Skin &skin, const tinygltf::Model &model,
-                                                   node_map_t &node_map)
+                                                   const buffer_spans_t &buffers, node_map_t &node_map)
 {
     vierkant::nodes::NodePtr root_bone;
 
@@ -703,18 +937,16 @@ vierkant::nodes::NodePtr create_bone_hierarchy_bfs(const tinygltf::Skin &skin, c
 
     if(skin.inverseBindMatrices >= 0 && static_cast<uint32_t>(skin.inverseBindMatrices) < model.accessors.size())
     {
-        tinygltf::Accessor bind_matrix_accessor = model.accessors[skin.inverseBindMatrices];
+        const tinygltf::Accessor &bind_matrix_accessor = model.accessors[skin.inverseBindMatrices];
 
         assert(bind_matrix_accessor.type == TINYGLTF_TYPE_MAT4);
         assert(bind_matrix_accessor.componentType == TINYGLTF_COMPONENT_TYPE_FLOAT);
 
-        const auto &buffer_view = model.bufferViews[bind_matrix_accessor.bufferView];
-        const auto &buffer = model.buffers[buffer_view.buffer];
-        assert(bind_matrix_accessor.ByteStride(buffer_view) == sizeof(glm::mat4));
-
-        auto data = reinterpret_cast<const glm::mat4 *>(buffer.data.data() + bind_matrix_accessor.byteOffset +
-                                                        buffer_view.byteOffset);
-        inverse_binding_matrices = {data, data + bind_matrix_accessor.count};
+        if(!read_accessor(model, buffers, bind_matrix_accessor, inverse_binding_matrices))
+        {
+            spdlog::warn("could not read inverse bind-matrices for skin '{}'", skin.name);
+            inverse_binding_matrices.clear();
+        }
     }
 
     if(skin.skeleton >= 0 && static_cast<uint32_t>(skin.skeleton) < model.nodes.size() &&
@@ -754,7 +986,8 @@ vierkant::nodes::NodePtr create_bone_hierarchy_bfs(const tinygltf::Skin &skin, c
 }
 
 vierkant::nodes::node_animation_t create_node_animation(const tinygltf::Animation &tiny_animation,
-                                                        const tinygltf::Model &model, const node_map_t &node_map)
+                                                        const tinygltf::Model &model, const buffer_spans_t &buffers,
+                                                        const node_map_t &node_map)
 {
     spdlog::debug("animation: {}", tiny_animation.name);
 
@@ -780,13 +1013,8 @@ vierkant::nodes::node_animation_t create_node_animation(const tinygltf::Animatio
             if(input_times.empty())
             {
                 const auto &accessor = model.accessors[sampler.input];
-                const auto &buffer_view = model.bufferViews[accessor.bufferView];
-                const auto &buffer = model.buffers[buffer_view.buffer];
                 assert(accessor.type == TINYGLTF_TYPE_SCALAR);
-                assert(accessor.componentType == TINYGLTF_COMPONENT_TYPE_FLOAT);
-                auto data = buffer.data.data() + accessor.byteOffset + buffer_view.byteOffset;
-                auto ptr = reinterpret_cast<const float *>(data);
-                input_times = {ptr, ptr + accessor.count};
+                if(!read_accessor(model, buffers, accessor, input_times) || input_times.empty()) { continue; }
                 animation.duration =
                         std::max(animation.duration, *std::max_element(input_times.begin(), input_times.end()));
 
@@ -803,9 +1031,6 @@ vierkant::nodes::node_animation_t create_node_animation(const tinygltf::Animatio
             }
 
             const auto &accessor = model.accessors[sampler.output];
-            const auto &buffer_view = model.bufferViews[accessor.bufferView];
-            const auto &buffer = model.buffers[buffer_view.buffer];
-            auto data = buffer.data.data() + accessor.byteOffset + buffer_view.byteOffset;
 
             // number of elements per time-point
             bool is_cubic_spline = animation.interpolation_mode == vierkant::InterpolationMode::CubicSpline;
@@ -814,8 +1039,13 @@ vierkant::nodes::node_animation_t create_node_animation(const tinygltf::Animatio
             if(channel.target_path == animation_target_translation)
             {
                 assert(accessor.type == TINYGLTF_TYPE_VEC3);
-                assert(accessor.componentType == TINYGLTF_COMPONENT_TYPE_FLOAT);
-                auto ptr = reinterpret_cast<const glm::vec3 *>(data);
+                std::vector<glm::vec3> values;
+                if(!read_accessor(model, buffers, accessor, values) ||
+                   values.size() < num_elems * input_times.size())
+                {
+                    continue;
+                }
+                auto ptr = values.data();
 
                 for(float t: input_times)
                 {
@@ -829,8 +1059,15 @@ vierkant::nodes::node_animation_t create_node_animation(const tinygltf::Animatio
             else if(channel.target_path == animation_target_rotation)
             {
                 assert(accessor.type == TINYGLTF_TYPE_VEC4);
-                assert(accessor.componentType == TINYGLTF_COMPONENT_TYPE_FLOAT);
-                auto ptr = reinterpret_cast<const float *>(data);
+
+                // rotations can be stored as normalized integers
+                std::vector<glm::vec4> values;
+                if(!read_accessor(model, buffers, accessor, values) ||
+                   values.size() < num_elems * input_times.size())
+                {
+                    continue;
+                }
+                auto ptr = reinterpret_cast<const float *>(values.data());
 
                 for(float t: input_times)
                 {
@@ -851,8 +1088,13 @@ vierkant::nodes::node_animation_t create_node_animation(const tinygltf::Animatio
             else if(channel.target_path == animation_target_scale)
             {
                 assert(accessor.type == TINYGLTF_TYPE_VEC3);
-                assert(accessor.componentType == TINYGLTF_COMPONENT_TYPE_FLOAT);
-                auto ptr = reinterpret_cast<const glm::vec3 *>(data);
+                std::vector<glm::vec3> values;
+                if(!read_accessor(model, buffers, accessor, values) ||
+                   values.size() < num_elems * input_times.size())
+                {
+                    continue;
+                }
+                auto ptr = values.data();
 
                 for(float t: input_times)
                 {
@@ -866,9 +1108,10 @@ vierkant::nodes::node_animation_t create_node_animation(const tinygltf::Animatio
             else if(channel.target_path == animation_target_weights)
             {
                 assert(accessor.type == TINYGLTF_TYPE_SCALAR);
-                assert(accessor.componentType == TINYGLTF_COMPONENT_TYPE_FLOAT);
-                auto ptr = reinterpret_cast<const float *>(data);
-                const uint32_t num_weights = accessor.count / input_times.size();
+                std::vector<float> values;
+                if(!read_accessor(model, buffers, accessor, values)) { continue; }
+                auto ptr = values.data();
+                const uint32_t num_weights = accessor.count / (num_elems * input_times.size());
 
                 for(float t: input_times)
                 {
@@ -928,6 +1171,32 @@ bool LoadImageDataFunction(tinygltf::Image * /*tiny_image*/, const int image_idx
     return true;
 }
 
+crocore::ImagePtr load_glb_image(const tinygltf::Model &model, const buffer_spans_t &buffers,
+                                 const glb_image_t &image, const std::filesystem::path &base_dir)
+{
+    try
+    {
+        if(image.buffer_view >= 0)
+        {
+            // decode from mapped memory
+            if(static_cast<size_t>(image.buffer_view) >= model.bufferViews.size()) { return nullptr; }
+            size_t num_bytes = model.bufferViews[image.buffer_view].byteLength;
+            auto data = buffer_view_data(model, buffers, image.buffer_view, 0, num_bytes);
+            if(!data) { return nullptr; }
+            return crocore::create_image_from_data(std::vector<uint8_t>(data, data + num_bytes), 4);
+        }
+        if(tinygltf::IsDataURI(image.uri))
+        {
+            std::vector<uint8_t> data;
+            std::string mime_type;
+            if(!tinygltf::DecodeDataURI(&data, mime_type, image.uri, 0, false)) { return nullptr; }
+            return crocore::create_image_from_data(data, 4);
+        }
+        if(!image.uri.empty()) { return crocore::create_image_from_file((base_dir / image.uri).string(), 4); }
+    } catch(std::exception &e) { spdlog::error(e.what()); }
+    return nullptr;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 std::optional<model_assets_t> gltf(const std::filesystem::path &path, crocore::ThreadPoolClassic *const pool,
@@ -947,12 +1216,41 @@ std::optional<model_assets_t> gltf(const std::filesystem::path &path, crocore::T
     bool ret = false;
     auto ext_str = path.extension().string();
     std::transform(ext_str.begin(), ext_str.end(), ext_str.begin(), ::tolower);
+
+    // glb-files are memory-mapped, only the JSON-chunk is parsed by tinygltf
+    vierkant::MappedFilePtr mapped_file;
+    std::optional<glb_t> glb;
+    std::vector<glb_image_t> glb_images;
+    bool has_glb_bin = false;
+
     if(ext_str == ".gltf") { ret = loader.LoadASCIIFromFile(&model, &err, &warn, path.string()); }
-    else if(ext_str == ".glb") { ret = loader.LoadBinaryFromFile(&model, &err, &warn, path.string()); }
+    else if(ext_str == ".glb")
+    {
+        mapped_file = vierkant::MappedFile::create(path);
+        if(mapped_file) { glb = parse_glb(mapped_file->bytes()); }
+
+        std::optional<std::string> json;
+        if(glb) { json = patch_glb_json(glb->json, glb_images, has_glb_bin); }
+
+        if(json)
+        {
+            ret = loader.LoadASCIIFromString(&model, &err, &warn, json->c_str(), static_cast<uint32_t>(json->size()),
+                                             path.parent_path().string());
+        }
+        else { err = "invalid glb-file: " + path.string(); }
+    }
     if(!warn.empty()) { spdlog::warn(warn); }
     if(!err.empty()) { spdlog::error(err); }
     if(!ret) { return {}; }
 
+    // glb-embedded buffer is accessed from mapped memory
+    buffer_spans_t buffers(model.buffers.size());
+    for(uint32_t i = 0; i < model.buffers.size(); ++i)
+    {
+        if(has_glb_bin && i == 0) { buffers[i] = glb->bin; }
+        else { buffers[i] = model.buffers[i].data; }
+    }
+
     if(!model.extensionsUsed.empty()) { spdlog::debug("model using extensions: {}", model.extensionsUsed); }
 
     const tinygltf::Scene &scene = model.scenes[model.defaultScene >= 0 ? model.defaultScene : 0];
@@ -969,19 +1267,46 @@ std::optional<model_assets_t> gltf(const std::filesystem::path &path, crocore::T
     std::map<uint32_t, crocore::ImagePtr> image_cache;
     std::map<uint32_t, vierkant::texture_sampler_t> sampler_cache;
 
+    if(glb)
+    {
+        // decode images referenced by textures
+        std::set<uint32_t> image_sources;
+        for(const auto &t: model.textures)
+        {
+            if(t.source >= 0 && static_cast<size_t>(t.source) < glb_images.size()) { image_sources.insert(t.source); }
+        }
+
+        for(auto source: image_sources)
+        {
+            auto load_fn = [&model, &buffers, &glb_images, &path, source] {
+                return load_glb_image(model, buffers, glb_images[source], path.parent_path());
+            };
+            if(pool) { img_context.image_cache[source] = pool->post(load_fn); }
+            else
+            {
+                auto img = load_fn();
+                if(!img) { return {}; }
+                image_cache[source] = std::move(img);
+            }
+        }
+    }
+
     if(pool)
     {
-        // wait for image-futures, check for nullptr
+        // wait for all image-futures, check for nullptr
+        bool images_complete = true;
+
         for(auto &[idx, img_future]: img_context.image_cache)
         {
             auto img = img_future.get();
-
-            // fail to load image, bail out
-            if(!img) { return {}; }
+            images_complete = images_complete && img;
             image_cache[idx] = std::move(img);
         }
+
+        // fail to load image, bail out
+        if(!images_complete) { return {}; }
     }
-    else
+    else if(!glb)
     {
         for(const auto &t: model.textures)
         {
@@ -1070,23 +1395,40 @@ std::optional<model_assets_t> gltf(const std::filesystem::path &path, crocore::T
 
     node_map_t node_map;
 
-    // cache geometries (index_accessor, attributes) -> geometry
+    // geometries are created after traversal, one primitive per task
+    struct geometry_job_t
+    {
+        const tinygltf::Primitive *primitive = nullptr;
+        const std::map<std::string, int> *attributes = nullptr;
+        bool morph_target = false;
+        vierkant::GeometryPtr geometry;
+    };
+    std::vector<geometry_job_t> geometry_jobs;
+
+    // reference from an entry (or one of its morph-targets) to a geometry-job
+    struct geometry_ref_t
+    {
+        size_t entry_index = 0;
+        int morph_index = -1;
+        size_t job_index = 0;
+    };
+    std::vector<geometry_ref_t> geometry_refs;
+
+    // cache geometries (index_accessor, attributes) -> geometry-job
     using geometry_key = std::tuple<int, const std::map<std::string, int> &>;
-    std::map<geometry_key, vierkant::GeometryPtr> geometry_cache;
+    std::map<geometry_key, size_t> geometry_cache;
 
-    auto get_geometry = [&geometry_cache, &model](const tinygltf::Primitive &primitive,
-                                                  const std::map<std::string, int> &attributes,
-                                                  bool morph_target = false) {
-        vierkant::GeometryPtr geometry;
+    auto get_geometry = [&geometry_cache, &geometry_jobs](const tinygltf::Primitive &primitive,
+                                                          const std::map<std::string, int> &attributes,
+                                                          bool morph_target = false) -> size_t {
         geometry_key geom_key = {primitive.indices, attributes};
         auto it = geometry_cache.find(geom_key);
-        if(!morph_target && it != geometry_cache.end()) { geometry = it->second; }
-        else
-        {
-            geometry = create_geometry(primitive, model, attributes, morph_target);
-            geometry_cache[geom_key] = geometry;
-        }
-        return geometry;
+        if(!morph_target && it != geometry_cache.end()) { return it->second; }
+
+        size_t job_index = geometry_jobs.size();
+        geometry_jobs.push_back({&primitive, &attributes, morph_target, nullptr});
+        if(!morph_target) { geometry_cache[geom_key] = job_index; }
+        return job_index;
     };
 
     while(!node_queue.empty())
@@ -1118,7 +1460,7 @@ std::optional<model_assets_t> gltf(const std::filesystem::path &path, crocore::T
             if(tiny_node.skin >= 0 && static_cast<uint32_t>(tiny_node.skin) < model.skins.size())
             {
                 const tinygltf::Skin &skin = model.skins[tiny_node.skin];
-                out_assets.root_bone = create_bone_hierarchy_bfs(skin, model, node_map);
+                out_assets.root_bone = create_bone_hierarchy_bfs(skin, model, buffers, node_map);
             }
 
             for(const auto &primitive: mesh.primitives)
@@ -1130,7 +1472,7 @@ std::optional<model_assets_t> gltf(const std::filesystem::path &path, crocore::T
                 }
                 vierkant::Mesh::entry_create_info_t create_info = {};
                 create_info.name = current_node->name;
-                create_info.geometry = get_geometry(primitive, primitive.attributes);
+                geometry_refs.push_back({entry_create_infos.size(), -1, get_geometry(primitive, primitive.attributes)});
                 create_info.transform = world_transform;
                 create_info.node_index = current_node->index;
                 create_info.morph_weights = {mesh.weights.begin(), mesh.weights.end()};
@@ -1142,7 +1484,10 @@ std::optional<model_assets_t> gltf(const std::filesystem::path &path, crocore::T
 
                 for(const auto &morph_target: primitive.targets)
                 {
-                    create_info.morph_targets.push_back(get_geometry(primitive, morph_target, true));
+                    auto morph_index = static_cast<int>(create_info.morph_targets.size());
+                    geometry_refs.push_back(
+                            {entry_create_infos.size(), morph_index, get_geometry(primitive, morph_target, true)});
+                    create_info.morph_targets.push_back(nullptr);
                 }
 
                 // pushback new entry
@@ -1206,13 +1551,77 @@ std::optional<model_assets_t> gltf(const std::filesystem::path &path, crocore::T
         }
     }
 
+    // decode accessors directly from buffers, one primitive per task
+    auto create_job_geometry = [&model, &buffers](geometry_job_t &job) {
+        job.geometry = create_geometry(*job.primitive, model, buffers, *job.attributes, job.morph_target);
+    };
+
+    if(pool)
+    {
+        std::vector<std::future<void>> geometry_tasks;
+        geometry_tasks.reserve(geometry_jobs.size());
+
+        for(auto &job: geometry_jobs)
+        {
+            geometry_tasks.push_back(pool->post([&create_job_geometry, &job] { create_job_geometry(job); }));
+        }
+        for(auto &task: geometry_tasks) { task.wait(); }
+    }
+    else
+    {
+        for(auto &job: geometry_jobs) { create_job_geometry(job); }
+    }
+
+    for(const auto &ref: geometry_refs)
+    {
+        auto &create_info = entry_create_infos[ref.entry_index];
+        const auto &geometry = geometry_jobs[ref.job_index].geometry;
+        if(ref.morph_index < 0) { create_info.geometry = geometry; }
+        else { create_info.morph_targets[ref.morph_index] = geometry; }
+    }
+
     // animations
     for(const auto &tiny_animation: model.animations)
     {
-        auto node_animation = create_node_animation(tiny_animation, model, node_map);
+        auto node_animation = create_node_animation(tiny_animation, model, buffers, node_map);
         out_assets.node_animations.push_back(std::move(node_animation));
     }
     return out_assets;
 }
 
+std::vector<std::filesystem::path> gltf_external_files(const std::filesystem::path &path)
+{
+    auto mapped_file = vierkant::MappedFile::create(path);
+    if(!mapped_file) { return {}; }
+
+    std::string_view json = mapped_file->str();
+    if(auto glb = parse_glb(mapped_file->bytes())) { json = glb->json; }
+
+    auto doc = nlohmann::json::parse(json.begin(), json.end(), nullptr, false);
+    if(doc.is_discarded() || !doc.is_object()) { return {}; }
+
+    std::vector<std::filesystem::path> ret;
+
+    for(const char *key: {"buffers", "images"})
+    {
+        auto it = doc.find(key);
+        if(it == doc.end() || !it->is_array()) { continue; }
+
+        for(const auto &item: *it)
+        {
+            auto uri_it = item.is_object() ? item.find("uri") : item.end();
+            if(uri_it == item.end() || !uri_it->is_string()) { continue; }
+
+            auto uri = uri_it->get<std::string>();
+            if(uri.empty() || tinygltf::IsDataURI(uri)) { continue; }
+
+            // uris are percent-encoded
+            std::string decoded_uri;
+            if(!tinygltf::URIDecode(uri, &decoded_uri, nullptr)) { decoded_uri = uri; }
+            ret.push_back(path.parent_path() / decoded_uri);
+        }
+    }
+    return ret;
+}
+
 }// namespace vierkant::model
@@ -0,0 +1,758 @@
+#include <cstring>
+#include <deque>
+#include <format>
+
+#include <spdlog/spdlog.h>
+#include <vierkant/mapped_file.hpp>
+#include <vierkant/model/gltf.hpp>
+#include <vierkant/model/model_cache.hpp>
+#include <vierkant/model/wavefront_obj.hpp>
+
+#include "binary_archive.hpp"
+
+namespace vierkant::serialization
+{
+
+// forward declarations, all overloads need to be visible for nested types
+template<typename Archive>
+void serialize(Archive &ar, crocore::ImagePtr &img);
+
+template<typename Archive>
+void serialize(Archive &ar, vierkant::Geometry &geometry);
+
+template<typename Archive>
+void serialize(Archive &ar, vierkant::texture_data_t &texture_data);
+
+template<typename Archive>
+void serialize(Archive &ar, vierkant::material_t &material);
+
+template<typename Archive>
+void serialize(Archive &ar, vierkant::bcn::compress_result_t &compress_result);
+
+template<typename Archive>
+void serialize(Archive &ar, vierkant::lightsource_t &light);
+
+template<typename Archive>
+void serialize(Archive &ar, model::lightsource_instance_t &light_instance);
+
+template<typename Archive>
+void serialize(Archive &ar, vierkant::vertex_attrib_t &vertex_attrib);
+
+template<typename Archive>
+void serialize(Archive &ar, vierkant::Mesh::entry_t &entry);
+
+template<typename Archive>
+void serialize(Archive &ar, vierkant::mesh_buffer_bundle_t &bundle);
+
+template<typename Archive>
+void serialize(Archive &ar, vierkant::animation_keys_t &keys);
+
+template<typename Archive, typename T>
+void serialize(Archive &ar, vierkant::animation_value_t<T> &animation_value);
+
+template<typename Archive>
+void serialize(Archive &ar, model::mesh_omm_data_t &omm_data);
+
+template<typename Archive>
+void serialize(Archive &ar, crocore::ImagePtr &img)
+{
+    // width, height, num_components, bytes per component
+    uint32_t dims[4] = {};
+
+    if(img && img->width() && img->height() && img->num_components())
+    {
+        dims[0] = img->width();
+        dims[1] = img->height();
+        dims[2] = img->num_components();
+        dims[3] = static_cast<uint32_t>(img->num_bytes() / (size_t(dims[0]) * dims[1] * dims[2]));
+    }
+    ar.raw(dims, sizeof(dims));
+    size_t num_pixels = size_t(dims[0]) * dims[1], pixel_size = size_t(dims[2]) * dims[3];
+    size_t num_bytes = num_pixels * pixel_size;
+
+    if constexpr(Archive::is_loading)
+    {
+        img = nullptr;
+        if(!num_pixels || !pixel_size || !ar.can_read(num_pixels, pixel_size)) { return; }
+
+        if(dims[3] == 1) { img = crocore::Image_<uint8_t>::create(dims[0], dims[1], dims[2]); }
+        else if(dims[3] == sizeof(float)) { img = crocore::Image_<float>::create(dims[0], dims[1], dims[2]); }
+        else
+        {
+            ar.invalidate();
+            return;
+        }
+    }
+    if(num_bytes) { ar.raw(img->data(), num_bytes); }
+}
+
+template<typename Archive>
+void serialize(Archive &ar, vierkant::Geometry &geometry)
+{
+    process(ar, geometry.topology);
+    process(ar, geometry.positions);
+    process(ar, geometry.colors);
+    process(ar, geometry.tex_coords);
+    process(ar, geometry.normals);
+    process(ar, geometry.tangents);
+    process(ar, geometry.bone_indices);
+    process(ar, geometry.bone_weights);
+    process(ar, geometry.indices);
+}
+
+template<typename Archive>
+void serialize(Archive &ar, vierkant::texture_data_t &texture_data)
+{
+    process(ar, texture_data.texture_id);
+    process(ar, texture_data.sampler_id);
+    process(ar, texture_data.texture_transform);
+}
+
+template<typename Archive>
+void serialize(Archive &ar, vierkant::material_t &material)
+{
+    process(ar, material.id);
+    process(ar, material.name);
+    process(ar, material.base_color);
+    process(ar, material.emission);
+    process(ar, material.emissive_strength);
+    process(ar, material.roughness);
+    process(ar, material.metalness);
+    process(ar, material.occlusion);
+    process(ar, material.null_surface);
+    process(ar, material.twosided);
+    process(ar, material.ior);
+    process(ar, material.dispersion);
+    process(ar, material.attenuation_color);
+    process(ar, material.transmission);
+    process(ar, material.attenuation_distance);
+    process(ar, material.phase_asymmetry_g);
+    process(ar, material.scatter_factor);
+    process(ar, material.scatter_color);
+    process(ar, material.diffuse_transmission);
+    process(ar, material.diffuse_transmission_color);
+    process(ar, material.thickness);
+    process(ar, material.blend_mode);
+    process(ar, material.alpha_cutoff);
+    process(ar, material.specular_factor);
+    process(ar, material.specular_color);
+    process(ar, material.clearcoat_factor);
+    process(ar, material.clearcoat_roughness_factor);
+    process(ar, material.sheen_color);
+    process(ar, material.sheen_roughness);
+    process(ar, material.iridescence_factor);
+    process(ar, material.iridescence_ior);
+    process(ar, material.iridescence_thickness_range);
+    process(ar, material.texture_data);
+}
+
+template<typename Archive>
+void serialize(Archive &ar, vierkant::bcn::compress_result_t &compress_result)
+{
+    process(ar, compress_result.mode);
+    process(ar, compress_result.base_width);
+    process(ar, compress_result.base_height);
+    process(ar, compress_result.levels);
+    process(ar, compress_result.duration);
+}
+
+template<typename Archive>
+void serialize(Archive &ar, vierkant::lightsource_t &light)
+{
+    process(ar, light.id);
+    process(ar, light.name);
+    process(ar, light.type);
+    process(ar, light.color);
+    process(ar, light.intensity);
+    process(ar, light.range);
+    process(ar, light.inner_cone_angle);
+    process(ar, light.outer_cone_angle);
+    process(ar, light.size);
+}
+
+template<typename Archive>
+void serialize(Archive &ar, model::lightsource_instance_t &light_instance)
+{
+    process(ar, light_instance.transform);
+    process(ar, light_instance.light_id);
+}
+
+template<typename Archive>
+void serialize(Archive &ar, vierkant::vertex_attrib_t &vertex_attrib)
+{
+    // buffers are created at load-time
+    process(ar, vertex_attrib.buffer_offset);
+    process(ar, vertex_attrib.offset);
+    process(ar, vertex_attrib.stride);
+    process(ar, vertex_attrib.format);
+    process(ar, vertex_attrib.input_rate);
+}
+
+template<typename Archive>
+void serialize(Archive &ar, vierkant::Mesh::entry_t &entry)
+{
+    process(ar, entry.name);
+    process(ar, entry.transform);
+    process(ar, entry.bounding_box);
+    process(ar, entry.bounding_sphere);
+    process(ar, entry.node_index);
+    process(ar, entry.vertex_offset);
+    process(ar, entry.num_vertices);
+    process(ar, entry.lods);
+    process(ar, entry.base_cluster_meshlet);
+    process(ar, entry.num_cluster_meshlets);
+    process(ar, entry.material_index);
+    process(ar, entry.primitive_type);
+    process(ar, entry.morph_vertex_offset);
+    process(ar, entry.morph_weights);
+}
+
+template<typename Archive>
+void serialize(Archive &ar, vierkant::mesh_buffer_bundle_t &bundle)
+{
+    process(ar, bundle.vertex_stride);
+    process(ar, bundle.vertex_attribs);
+    process(ar, bundle.entries);
+    process(ar, bundle.num_materials);
+    process(ar, bundle.vertex_buffer);
+    process(ar, bundle.index_buffer);
+    process(ar, bundle.bone_vertex_buffer);
+    process(ar, bundle.morph_buffer);
+    process(ar, bundle.num_morph_targets);
+    process(ar, bundle.meshlets);
+    process(ar, bundle.meshlet_vertices);
+    process(ar, bundle.meshlet_triangles);
+    process(ar, bundle.meshlet_lods);
+}
+
+template<typename Archive, typename T>
+void serialize(Archive &ar, vierkant::animation_value_t<T> &animation_value)
+{
+    process(ar, animation_value.value);
+    process(ar, animation_value.in_tangent);
+    process(ar, animation_value.out_tangent);
+}
+
+template<typename Archive>
+void serialize(Archive &ar, vierkant::animation_keys_t &keys)
+{
+    process(ar, keys.positions);
+    process(ar, keys.rotations);
+    process(ar, keys.scales);
+    process(ar, keys.morph_weights);
+}
+
+template<typename Archive>
+void serialize(Archive &ar, model::mesh_omm_data_t &omm_data)
+{
+    process(ar, omm_data.entry_index);
+    process(ar, omm_data.color_texture_id);
+    process(ar, omm_data.entry.data);
+    process(ar, omm_data.entry.triangles);
+    process(ar, omm_data.entry.indices);
+}
+
+}// namespace vierkant::serialization
+
+namespace vierkant::model
+{
+
+namespace
+{
+
+//! 'VKMC'
+constexpr uint32_t model_cache_magic = 0x434D4B56;
+
+//! 'VKOM'
+constexpr uint32_t omm_cache_magic = 0x4D4F4B56;
+
+//! chunk-size used for parallel hashing of model-files
+constexpr size_t hash_chunk_size = 1U << 24;
+
+constexpr uint32_t invalid_index = std::numeric_limits<uint32_t>::max();
+
+struct cache_header_t
+{
+    uint32_t magic = model_cache_magic;
+    uint32_t version = model_cache_version;
+    uint64_t key = 0;
+};
+
+using serialization::input_archive_t;
+using serialization::output_archive_t;
+
+//! entries share geometries, which are stored once in a table
+void save_entries(output_archive_t &ar, const std::vector<vierkant::Mesh::entry_create_info_t> &entries)
+{
+    std::vector<vierkant::Geometry *> geometries;
+    std::unordered_map<const vierkant::Geometry *, uint32_t> geometry_indices;
+
+    auto geometry_index = [&geometries, &geometry_indices](const vierkant::GeometryConstPtr &geometry) -> uint32_t {
+        if(!geometry) { return invalid_index; }
+        auto [it, inserted] = geometry_indices.try_emplace(geometry.get(), geometries.size());
+        if(inserted) { geometries.push_back(const_cast<vierkant::Geometry *>(geometry.get())); }
+        return it->second;
+    };
+
+    std::vector<uint32_t> entry_geometries;
+    std::vector<std::vector<uint32_t>> entry_morph_targets;
+
+    for(const auto &entry: entries)
+    {
+        entry_geometries.push_back(geometry_index(entry.geometry));
+        auto &morph_targets = entry_morph_targets.emplace_back();
+        for(const auto &morph_target: entry.morph_targets) { morph_targets.push_back(geometry_index(morph_target)); }
+    }
+
+    process_size(ar, geometries.size());
+    for(auto *geometry: geometries) { serialize(ar, *geometry); }
+
+    process_size(ar, entries.size());
+
+    for(uint32_t i = 0; i < entries.size(); ++i)
+    {
+        auto entry = entries[i];
+        process(ar, entry.name);
+        process(ar, entry_geometries[i]);
+        process(ar, entry.transform);
+        process(ar, entry.node_index);
+        process(ar, entry.material_index);
+        process(ar, entry_morph_targets[i]);
+        process(ar, entry.morph_weights);
+    }
+}
+
+void load_entries(input_archive_t &ar, std::vector<vierkant::Mesh::entry_create_info_t> &entries)
+{
+    auto num_geometries = process_size(ar, 0);
+    if(!ar.can_read(num_geometries)) { return; }
+
+    std::vector<vierkant::GeometryPtr> geometries(num_geometries);
+
+    for(auto &geometry: geometries)
+    {
+        geometry = vierkant::Geometry::create();
+        serialize(ar, *geometry);
+    }
+
+    auto get_geometry = [&ar, &geometries](uint32_t index) -> vierkant::GeometryPtr {
+        if(index == invalid_index) { return nullptr; }
+        if(index >= geometries.size())
+        {
+            ar.invalidate();
+            return nullptr;
+        }
+        return geometries[index];
+    };
+
+    auto num_entries = process_size(ar, 0);
+    if(!ar.can_read(num_entries)) { return; }
+    entries.resize(num_entries);
+
+    for(auto &entry: entries)
+    {
+        uint32_t geometry_index = invalid_index;
+        std::vector<uint32_t> morph_targets;
+
+        process(ar, entry.name);
+        process(ar, geometry_index);
+        process(ar, entry.transform);
+        process(ar, entry.node_index);
+        process(ar, entry.material_index);
+        process(ar, morph_targets);
+        process(ar, entry.morph_weights);
+
+        entry.geometry = get_geometry(geometry_index);
+        for(auto idx: morph_targets) { entry.morph_targets.push_back(get_geometry(idx)); }
+    }
+}
+
+//! node-hierarchies and animations reference nodes, which are stored once in a table
+void save_nodes(output_archive_t &ar, const model_assets_t &mesh_assets)
+{
+    std::vector<vierkant::nodes::NodePtr> nodes;
+    std::unordered_map<const vierkant::nodes::node_t *, uint32_t> node_indices;
+
+    auto node_index = [&node_indices](const vierkant::nodes::node_t *node) -> uint32_t {
+        auto it = node_indices.find(node);
+        return it != node_indices.end() ? it->second : invalid_index;
+    };
+
+    for(const auto &root: {mesh_assets.root_node, mesh_assets.root_bone})
+    {
+        std::deque<vierkant::nodes::NodePtr> queue;
+        if(root) { queue.push_back(root); }
+
+        while(!queue.empty())
+        {
+            auto node = std::move(queue.front());
+            queue.pop_front();
+
+            if(!node_indices.try_emplace(node.get(), nodes.size()).second) { continue; }
+            nodes.push_back(node);
+            queue.insert(queue.end(), node->children.begin(), node->children.end());
+        }
+    }
+
+    process_size(ar, nodes.size());
+
+    for(const auto &node: nodes)
+    {
+        std::vector<uint32_t> children;
+        for(const auto &child: node->children) { children.push_back(node_index(child.get())); }
+        uint32_t parent = node_index(node->parent.get());
+
+        process(ar, node->name);
+        process(ar, node->transform);
+        process(ar, node->offset);
+        process(ar, node->index);
+        process(ar, parent);
+        process(ar, children);
+    }
+
+    uint32_t root_node = node_index(mesh_assets.root_node.get());
+    uint32_t root_bone = node_index(mesh_assets.root_bone.get());
+    process(ar, root_node);
+    process(ar, root_bone);
+
+    process_size(ar, mesh_assets.node_animations.size());
+
+    for(auto animation: mesh_assets.node_animations)
+    {
+        process(ar, animation.name);
+        process(ar, animation.duration);
+        process(ar, animation.ticks_per_sec);
+        process(ar, animation.interpolation_mode);
+
+        std::map<uint32_t, vierkant::animation_keys_t> keys;
+        for(const auto &[node, node_keys]: animation.keys)
+        {
+            auto idx = node_index(node.get());
+            if(idx != invalid_index) { keys[idx] = node_keys; }
+        }
+        process(ar, keys);
+    }
+}
+
+void load_nodes(input_archive_t &ar, model_assets_t &mesh_assets)
+{
+    auto num_nodes = process_size(ar, 0);
+    if(!ar.can_read(num_nodes)) { return; }
+
+    std::vector<vierkant::nodes::NodePtr> nodes(num_nodes);
+    for(auto &node: nodes) { node = std::make_shared<vierkant::nodes::node_t>(); }
+
+    auto get_node = [&ar, &nodes](uint32_t index) -> vierkant::nodes::NodePtr {
+        if(index == invalid_index) { return nullptr; }
+        if(index >= nodes.size())
+        {
+            ar.invalidate();
+            return nullptr;
+        }
+        return nodes[index];
+    };
+
+    for(auto &node: nodes)
+    {
+        uint32_t parent = invalid_index;
+        std::vector<uint32_t> children;
+
+        process(ar, node->name);
+        process(ar, node->transform);
+        process(ar, node->offset);
+        process(ar, node->index);
+        process(ar, parent);
+        process(ar, children);
+
+        node->parent = get_node(parent);
+        for(auto idx: children) { node->children.push_back(get_node(idx)); }
+    }
+
+    uint32_t root_node = invalid_index, root_bone = invalid_index;
+    process(ar, root_node);
+    process(ar, root_bone);
+    mesh_assets.root_node = get_node(root_node);
+    mesh_assets.root_bone = get_node(root_bone);
+
+    auto num_animations = process_size(ar, 0);
+    if(!ar.can_read(num_animations)) { return; }
+    mesh_assets.node_animations.resize(num_animations);
+
+    for(auto &animation: mesh_assets.node_animations)
+    {
+        process(ar, animation.name);
+        process(ar, animation.duration);
+        process(ar, animation.ticks_per_sec);
+        process(ar, animation.interpolation_mode);
+
+        std::map<uint32_t, vierkant::animation_keys_t> keys;
+        process(ar, keys);
+        for(auto &[idx, node_keys]: keys)
+        {
+            if(auto node = get_node(idx)) { animation.keys[node] = std::move(node_keys); }
+        }
+    }
+}
+
+void save_assets(output_archive_t &ar, const model_assets_t &mesh_assets)
+{
+    auto &assets = const_cast<model_assets_t &>(mesh_assets);
+
+    auto geometry_type = static_cast<uint32_t>(assets.geometry_data.index());
+    process(ar, geometry_type);
+
+    if(auto *entries = std::get_if<std::vector<vierkant::Mesh::entry_create_info_t>>(&assets.geometry_data))
+    {
+        save_entries(ar, *entries);
+    }
+    else { serialize(ar, std::get<vierkant::mesh_buffer_bundle_t>(assets.geometry_data)); }
+
+    process(ar, assets.materials);
+    process(ar, assets.textures);
+    process(ar, assets.texture_samplers);
+    process(ar, assets.lights);
+    process(ar, assets.light_instances);
+    process(ar, assets.cameras);
+    save_nodes(ar, assets);
+    process(ar, assets.omm_data);
+}
+
+void load_assets(input_archive_t &ar, model_assets_t &assets)
+{
+    uint32_t geometry_type = 0;
+    process(ar, geometry_type);
+
+    if(geometry_type == 0)
+    {
+        std::vector<vierkant::Mesh::entry_create_info_t> entries;
+        load_entries(ar, entries);
+        assets.geometry_data = std::move(entries);
+    }
+    else if(geometry_type == 1)
+    {
+        vierkant::mesh_buffer_bundle_t bundle;
+        serialize(ar, bundle);
+        assets.geometry_data = std::move(bundle);
+    }
+    else
+    {
+        ar.invalidate();
+        return;
+    }
+
+    process(ar, assets.materials);
+    process(ar, assets.textures);
+    process(ar, assets.texture_samplers);
+    process(ar, assets.lights);
+    process(ar, assets.light_instances);
+    process(ar, assets.cameras);
+    load_nodes(ar, assets);
+    process(ar, assets.omm_data);
+}
+
+}// namespace
+
+uint64_t model_cache_key(const std::filesystem::path &path, const model_cache_params_t &params,
+                         crocore::ThreadPoolClassic *pool)
+{
+    auto mapped_file = vierkant::MappedFile::create(path);
+    if(!mapped_file) { return 0; }
+
+    // hash file-contents, large files in parallel chunks
+    auto bytes = mapped_file->bytes();
+    size_t num_chunks = std::max<size_t>((bytes.size() + hash_chunk_size - 1) / hash_chunk_size, 1);
+    std::vector<uint64_t> chunk_hashes(num_chunks);
+
+    auto hash_chunk = [&bytes, &chunk_hashes](size_t i) {
+        size_t offset = std::min(i * hash_chunk_size, bytes.size());
+        size_t num_bytes = std::min(hash_chunk_size, bytes.size() - offset);
+        chunk_hashes[i] = vierkant::hash_bytes(bytes.data() + offset, num_bytes, i);
+    };
+
+    if(pool && num_chunks > 1)
+    {
+        std::vector<std::future<void>> tasks;
+        for(size_t i = 0; i < num_chunks; ++i) { tasks.push_back(pool->post([&hash_chunk, i] { hash_chunk(i); })); }
+        for(auto &t: tasks) { t.wait(); }
+    }
+    else
+    {
+        for(size_t i = 0; i < num_chunks; ++i) { hash_chunk(i); }
+    }
+
+    size_t h = vierkant::hash_bytes(chunk_hashes.data(), chunk_hashes.size() * sizeof(uint64_t),
+                                    model_cache_version);
+    vierkant::hash_combine(h, params.id_seed);
+    vierkant::hash_combine(h, params.compress_textures);
+    vierkant::hash_combine(h, params.mesh_buffer_params.has_value());
+    if(params.mesh_buffer_params) { vierkant::hash_combine(h, *params.mesh_buffer_params); }
+    vierkant::hash_combine(h, params.omm_params.has_value());
+
+    if(params.omm_params)
+    {
+        vierkant::hash_combine(h, params.omm_params->max_level);
+        vierkant::hash_combine(h, params.omm_params->target_edge);
+        vierkant::hash_combine(h, params.omm_params->states);
+    }
+
+    // external resources referenced by the model (buffers, images, materials)
+    auto ext_str = path.extension().string();
+    std::transform(ext_str.begin(), ext_str.end(), ext_str.begin(), ::tolower);
+
+    std::vector<std::filesystem::path> files;
+    if(ext_str == ".gltf" || ext_str == ".glb") { files = gltf_external_files(path); }
+    else if(ext_str == ".obj") { files = wavefront_obj_external_files(path); }
+    std::sort(files.begin(), files.end());
+    files.erase(std::unique(files.begin(), files.end()), files.end());
+
+    for(const auto &file: files)
+    {
+        std::error_code ec;
+        vierkant::hash_combine(h, file.lexically_relative(path.parent_path()).generic_string());
+        vierkant::hash_combine(h, std::filesystem::file_size(file, ec));
+        vierkant::hash_combine(h, std::filesystem::last_write_time(file, ec).time_since_epoch().count());
+    }
+    return h ? h : 1;
+}
+
+bool save_model_assets(const model_assets_t &mesh_assets, const std::filesystem::path &path, uint64_t key)
+{
+    output_archive_t ar;
+    cache_header_t header = {};
+    header.key = key;
+    ar.raw(&header, sizeof(header));
+    save_assets(ar, mesh_assets);
+    return vierkant::write_file_atomic(path, ar.bytes);
+}
+
+std::optional<model_assets_t> load_model_assets(const std::filesystem::path &path, uint64_t key)
+{
+    auto mapped_file = vierkant::MappedFile::create(path);
+    if(!mapped_file || mapped_file->num_bytes() < sizeof(cache_header_t)) { return {}; }
+
+    cache_header_t header;
+    memcpy(&header, mapped_file->data(), sizeof(header));
+
+    if(header.magic != model_cache_magic || header.version != model_cache_version || (key && header.key != key))
+    {
+        return {};
+    }
+
+    input_archive_t ar(mapped_file->bytes().subspan(sizeof(cache_header_t)));
+    model_assets_t ret;
+    load_assets(ar, ret);
+
+    if(!ar.complete())
+    {
+        spdlog::warn("corrupted model-assets: {}", path.string());
+        return {};
+    }
+    return ret;
+}
+
+bool save_omm_data(const std::vector<mesh_omm_data_t> &omm_data, const std::filesystem::path &path, uint64_t key)
+{
+    output_archive_t ar;
+    cache_header_t header = {omm_cache_magic, omm_cache_version, key};
+    ar.raw(&header, sizeof(header));
+    process(ar, const_cast<std::vector<mesh_omm_data_t> &>(omm_data));
+    return vierkant::write_file_atomic(path, ar.bytes);
+}
+
+std::optional<std::vector<mesh_omm_data_t>> load_omm_data(const std::filesystem::path &path, uint64_t key)
+{
+    auto mapped_file = vierkant::MappedFile::create(path);
+    if(!mapped_file || mapped_file->num_bytes() < sizeof(cache_header_t)) { return {}; }
+
+    cache_header_t header;
+    memcpy(&header, mapped_file->data(), sizeof(header));
+
+    if(header.magic != omm_cache_magic || header.version != omm_cache_version || (key && header.key != key))
+    {
+        return {};
+    }
+
+    input_archive_t ar(mapped_file->bytes().subspan(sizeof(cache_header_t)));
+    std::vector<mesh_omm_data_t> ret;
+    process(ar, ret);
+
+    if(!ar.complete())
+    {
+        spdlog::warn("corrupted OMM data: {}", path.string());
+        return {};
+    }
+    return ret;
+}
+
+std::vector<mesh_omm_data_t> generate_omm_data_cached(const model_assets_t &mesh_assets,
+                                                      const vierkant::mesh_buffer_bundle_t &bundle,
+                                                      const omm_gen_params_t &params,
+                                                      const std::filesystem::path &cache_dir,
+                                                      crocore::ThreadPoolClassic *pool)
+{
+    auto key = omm_cache_key(mesh_assets, bundle, params);
+    auto cache_path = cache_dir / std::format("{:016x}.vkomm", key);
+
+    if(auto omm_data = load_omm_data(cache_path, key))
+    {
+        spdlog::debug("OMM-cache hit: {}", cache_path.string());
+        return std::move(*omm_data);
+    }
+    auto omm_data = generate_omm_data(mesh_assets, bundle, params, pool);
+
+    std::error_code ec;
+    std::filesystem::create_directories(cache_dir, ec);
+    if(save_omm_data(omm_data, cache_path, key)) { spdlog::debug("OMM-cache write: {}", cache_path.string()); }
+    return omm_data;
+}
+
+std::optional<model_assets_t> load_model_cached(const std::filesystem::path &path, const model_cache_params_t &params,
+                                                crocore::ThreadPoolClassic *pool)
+{
+    auto key = model_cache_key(path, params, pool);
+    if(!key) { return {}; }
+
+    auto cache_path = params.cache_dir / std::format("{:016x}.vkmodel", key);
+
+    if(auto mesh_assets = load_model_assets(cache_path, key))
+    {
+        spdlog::debug("model-cache hit: {} -> {}", path.string(), cache_path.string());
+        return mesh_assets;
+    }
+
+    auto mesh_assets = load_model(path, pool, params.id_seed);
+    if(!mesh_assets) { return {}; }
+
+    if(params.mesh_buffer_params)
+    {
+        if(auto *entries = std::get_if<std::vector<vierkant::Mesh::entry_create_info_t>>(&mesh_assets->geometry_data))
+        {
+            auto bundle = vierkant::create_mesh_buffers(*entries, *params.mesh_buffer_params);
+
+            // OMM-baking requires uncompressed textures
+            if(params.omm_params)
+            {
+                mesh_assets->omm_data = generate_omm_data_cached(*mesh_assets, bundle, *params.omm_params,
+                                                                 params.cache_dir / "omm", pool);
+            }
+            mesh_assets->geometry_data = std::move(bundle);
+        }
+    }
+    if(params.compress_textures)
+    {
+        // encoded textures are shared across models and parameter-sets
+        texture_cache_params_t texture_cache_params = {};
+        texture_cache_params.cache_dir = params.cache_dir / "textures";
+        compress_textures(*mesh_assets, pool, texture_cache_params);
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(params.cache_dir, ec);
+    if(save_model_assets(*mesh_assets, cache_path, key))
+    {
+        spdlog::debug("model-cache write: {} -> {}", path.string(), cache_path.string());
+    }
+    return mesh_assets;
+}
+
+}// namespace vierkant::model
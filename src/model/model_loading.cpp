@@ -1,9 +1,14 @@
+#include <bit>
+#include <format>
+
 #include <meshoptimizer.h>
 #include <spdlog/spdlog.h>
 #include <vierkant/hash.hpp>
+#include <vierkant/mapped_file.hpp>
 #include <vierkant/model/gltf.hpp>
 #include <vierkant/model/model_loading.hpp>
 #include <vierkant/model/wavefront_obj.hpp>
+#include <vierkant/texture_file.hpp>
 #include <vierkant/vertex_splicer.hpp>
 
 namespace vierkant::model
@@ -78,9 +83,30 @@ vierkant::VkSamplerPtr create_sampler(const vierkant::DevicePtr &device, const v
     return {sampler, [device](VkSampler s) { vkDestroySampler(device->handle(), s, nullptr); }};
 }
 
-bool compress_textures(vierkant::model::model_assets_t &mesh_assets, crocore::ThreadPoolClassic *pool)
+bcn::CompressionMode compression_mode(const crocore::ImageConstPtr &img, bool is_normal_map)
 {
-    std::chrono::milliseconds compress_total_duration(0);
+    if(std::dynamic_pointer_cast<const crocore::Image_<float>>(img)) { return bcn::BC6H; }
+    if(is_normal_map) { return bcn::BC5; }
+    if(img && img->num_components() == 1) { return bcn::BC4; }
+
+    // opaque color-images fit into BC1's 64-bit blocks
+    auto img_u8 = std::dynamic_pointer_cast<const crocore::Image_<uint8_t>>(img);
+    if(img_u8 && img_u8->num_components() == 3) { return bcn::BC1; }
+    if(img_u8 && img_u8->num_components() == 4)
+    {
+        const uint8_t *data = img_u8->at(0, 0);
+        size_t num_pixels = static_cast<size_t>(img_u8->width()) * img_u8->height();
+        bool opaque = true;
+        for(size_t i = 0; i < num_pixels && opaque; ++i) { opaque = data[4 * i + 3] == 255; }
+        if(opaque) { return bcn::BC1; }
+    }
+    return bcn::BC7;
+}
+
+bool compress_textures(vierkant::model::model_assets_t &mesh_assets, crocore::ThreadPoolClassic *pool,
+                       const std::optional<texture_cache_params_t> &cache_params)
+{
+    auto start_time = std::chrono::steady_clock::now();
     size_t num_pixels = 0;
 
     auto check_normal_map = [&mesh_assets](TextureId tex_id) -> bool {
@@ -93,74 +119,203 @@ bool compress_textures(vierkant::model::model_assets_t &mesh_assets, crocore::Th
                                    });
     };
 
+    // gather all uncompressed images, compressed variants are skipped
+    std::vector<texture_variant_t *> texture_variants;
+    std::vector<bcn::compress_info_t> compress_infos;
+
     for(auto &[tex_id, texture_variant]: mesh_assets.textures)
     {
+        auto *img = std::get_if<crocore::ImagePtr>(&texture_variant);
+        if(!img || !*img) { continue; }
+
         bool is_normal_map = check_normal_map(tex_id);
+        bcn::compress_info_t compress_info = {};
+        compress_info.image = *img;
+        compress_info.mode = compression_mode(*img, is_normal_map);
+        compress_info.mip_filter = is_normal_map ? bcn::MipFilter::BoxNormalMap : bcn::MipFilter::Box;
+        compress_info.generate_mipmaps = true;
+        compress_infos.push_back(std::move(compress_info));
+        texture_variants.push_back(&texture_variant);
+        num_pixels += (*img)->width() * (*img)->height();
+    }
+
+    // lookup previously encoded textures, only misses are compressed
+    std::vector<uint64_t> cache_keys(compress_infos.size(), 0);
+    size_t num_cache_hits = 0;
 
-        try
+    if(cache_params)
+    {
+        std::vector<std::future<void>> tasks;
+
+        for(uint32_t i = 0; i < compress_infos.size(); ++i)
         {
-            texture_variant = std::visit(
-                    [pool, is_normal_map, &compress_total_duration, &num_pixels](auto &&img) -> texture_variant_t {
-                        using T = std::decay_t<decltype(img)>;
-
-                        if constexpr(std::is_same_v<T, crocore::ImagePtr>)
-                        {
-                            if(img)
-                            {
-                                bcn::compress_info_t compress_info = {};
-                                compress_info.image = img;
-                                compress_info.mode = is_normal_map ? bcn::BC5 : bcn::BC7;
-                                compress_info.generate_mipmaps = true;
-                                if(pool)
-                                {
-                                    compress_info.delegate_fn = [pool](auto fn) { return pool->post(fn); };
-                                }
-                                auto compressed_img = bcn::compress(compress_info);
-                                compress_total_duration += compressed_img.duration;
-                                num_pixels += img->width() * img->height();
-                                return compressed_img;
-                            }
-                        }
-
-                        // variant was already compressed
-                        return img;
-                    },
-                    texture_variant);
-        } catch(std::bad_variant_access &e)
+            auto fn = [&, i] {
+                cache_keys[i] = texture_cache_key(compress_infos[i]);
+                if(!cache_keys[i]) { return; }
+                if(auto cached = load_cached_texture(cache_params->cache_dir, cache_keys[i]))
+                {
+                    *texture_variants[i] = std::move(*cached);
+                }
+            };
+            if(pool) { tasks.push_back(pool->post(fn)); }
+            else { fn(); }
+        }
+        for(const auto &t: tasks) { t.wait(); }
+
+        // keep only misses
+        uint32_t num_misses = 0;
+
+        for(uint32_t i = 0; i < compress_infos.size(); ++i)
         {
-            spdlog::error("could not compress textures: {}", e.what());
-            return false;
+            if(std::holds_alternative<bcn::compress_result_t>(*texture_variants[i])) { continue; }
+            compress_infos[num_misses] = std::move(compress_infos[i]);
+            texture_variants[num_misses] = texture_variants[i];
+            cache_keys[num_misses++] = cache_keys[i];
         }
+        num_cache_hits = compress_infos.size() - num_misses;
+        compress_infos.resize(num_misses);
+        texture_variants.resize(num_misses);
+        cache_keys.resize(num_misses);
     }
-    float mpx_per_sec =
-            1.e-6f * static_cast<float>(num_pixels) / std::chrono::duration<float>(compress_total_duration).count();
-    spdlog::debug("compressed {} images in {} ms - avg. {:03.2f} Mpx/s", mesh_assets.textures.size(),
-                  compress_total_duration.count(), mpx_per_sec);
+
+    // schedule work-items of all textures at once
+    vierkant::delegate_fn_t delegate_fn;
+    uint32_t num_workers = 1;
+
+    if(pool)
+    {
+        delegate_fn = [pool](auto fn) { return pool->post(fn); };
+        num_workers = static_cast<uint32_t>(pool->num_threads()) + 1;
+    }
+    auto compress_results = bcn::compress(compress_infos, delegate_fn, num_workers);
+
+    if(cache_params)
+    {
+        std::error_code ec;
+        std::filesystem::create_directories(cache_params->cache_dir, ec);
+
+        for(uint32_t i = 0; i < compress_results.size(); ++i)
+        {
+            if(cache_keys[i]) { store_cached_texture(cache_params->cache_dir, cache_keys[i], compress_results[i]); }
+        }
+        if(!compress_results.empty()) { trim_texture_cache(cache_params->cache_dir, cache_params->max_num_bytes); }
+    }
+
+    for(uint32_t i = 0; i < compress_results.size(); ++i) { *texture_variants[i] = std::move(compress_results[i]); }
+
+    auto duration =
+            std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time);
+    float mpx_per_sec = 1.e-6f * static_cast<float>(num_pixels) / std::chrono::duration<float>(duration).count();
+    spdlog::debug("compressed {} images in {} ms ({} cached) - avg. {:03.2f} Mpx/s",
+                  compress_results.size() + num_cache_hits, duration.count(), num_cache_hits, mpx_per_sec);
     return true;
 }
 
-std::vector<mesh_omm_data_t> generate_omm_data(const model_assets_t &mesh_assets,
-                                               const vierkant::mesh_buffer_bundle_t &bundle,
-                                               const omm_gen_params_t &params)
+uint64_t texture_cache_key(const bcn::compress_info_t &compress_info)
 {
-    std::vector<mesh_omm_data_t> ret;
+    const uint8_t *data = nullptr;
+    auto img_u8 = std::dynamic_pointer_cast<const crocore::Image_<uint8_t>>(compress_info.image);
+    auto img_f = std::dynamic_pointer_cast<const crocore::Image_<float>>(compress_info.image);
+    if(img_u8) { data = img_u8->at(0, 0); }
+    else if(img_f) { data = reinterpret_cast<const uint8_t *>(img_f->at(0, 0)); }
+    if(!data) { return 0; }
+
+    // pixel-data is hashed in chunks, combined with image-layout and compression-settings
+    constexpr size_t chunk_size = 1U << 20;
+    size_t num_bytes = compress_info.image->num_bytes();
+    std::vector<uint64_t> values;
+
+    for(size_t offset = 0; offset < num_bytes; offset += chunk_size)
+    {
+        values.push_back(vierkant::hash_bytes(data + offset, std::min(chunk_size, num_bytes - offset), offset));
+    }
+    const auto &img = compress_info.image;
+    values.insert(values.end(), {texture_cache_version, static_cast<uint64_t>(img->width()),
+                                 static_cast<uint64_t>(img->height()), static_cast<uint64_t>(img->num_components()),
+                                 img_f != nullptr, compress_info.mode, static_cast<uint64_t>(compress_info.quality),
+                                 std::bit_cast<uint32_t>(compress_info.rdo_lambda),
+                                 static_cast<uint64_t>(compress_info.mip_filter), compress_info.generate_mipmaps});
+    return std::max<uint64_t>(vierkant::hash_range(values.begin(), values.end()), 1);
+}
 
-    if(bundle.vertex_stride != sizeof(vierkant::packed_vertex_t))
+std::optional<bcn::compress_result_t> load_cached_texture(const std::filesystem::path &cache_dir, uint64_t key)
+{
+    auto path = cache_dir / std::format("{:016x}.ktx2", key);
+    auto faces = bcn::load_compressed_texture(path);
+    if(!faces || faces->size() != 1) { return {}; }
+
+    // refresh access-time for LRU-eviction
+    std::error_code ec;
+    std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), ec);
+    return std::move(faces->front());
+}
+
+bool store_cached_texture(const std::filesystem::path &cache_dir, uint64_t key,
+                          const bcn::compress_result_t &compress_result)
+{
+    // non power-of-two mip-chains can't be stored in KTX2-files
+    std::vector<bcn::compress_result_t> faces = {compress_result};
+    if(!bcn::check_faces(faces)) { return false; }
+    auto path = cache_dir / std::format("{:016x}.ktx2", key);
+    return vierkant::write_file_atomic(
+            path, [&faces](const std::filesystem::path &tmp_path) { return bcn::write_ktx2(tmp_path, faces); });
+}
+
+void trim_texture_cache(const std::filesystem::path &cache_dir, size_t max_num_bytes)
+{
+    struct entry_t
     {
-        spdlog::warn("generate_omm_data: non-packed vertex stride {}, skipping", bundle.vertex_stride);
-        return ret;
+        std::filesystem::path path;
+        std::filesystem::file_time_type time;
+        size_t num_bytes;
+    };
+    std::vector<entry_t> entries;
+    size_t num_bytes = 0;
+
+    // entries might be removed concurrently, errors are ignored
+    std::error_code ec;
+    for(const auto &dir_entry: std::filesystem::directory_iterator(cache_dir, ec))
+    {
+        if(dir_entry.path().extension() != ".ktx2") { continue; }
+        entry_t entry = {dir_entry.path(), dir_entry.last_write_time(ec), dir_entry.file_size(ec)};
+        if(ec) { continue; }
+        num_bytes += entry.num_bytes;
+        entries.push_back(std::move(entry));
+    }
+    if(num_bytes <= max_num_bytes) { return; }
+
+    // evict least recently used entries first
+    std::ranges::sort(entries, [](const auto &lhs, const auto &rhs) { return lhs.time < rhs.time; });
+
+    for(const auto &entry: entries)
+    {
+        if(num_bytes <= max_num_bytes) { break; }
+        if(std::filesystem::remove(entry.path, ec)) { num_bytes -= entry.num_bytes; }
     }
+}
+
+namespace
+{
 
+//! an alpha-masked bundle-entry and its color-image
+struct omm_job_t
+{
+    uint32_t entry_index = 0;
+    vierkant::TextureId color_texture_id;
+    crocore::ImagePtr img;
+};
+
+//! gather all entries with alpha-masked materials and CPU-side color-images, ordered by entry-index
+std::vector<omm_job_t> omm_jobs(const model_assets_t &mesh_assets, const vierkant::mesh_buffer_bundle_t &bundle)
+{
+    std::vector<omm_job_t> ret;
     const auto &materials = mesh_assets.materials;
     const auto &textures = mesh_assets.textures;
 
-    const auto *vertex_base = reinterpret_cast<const vierkant::packed_vertex_t *>(bundle.vertex_buffer.data());
-
     for(uint32_t entry_idx = 0; entry_idx < bundle.entries.size(); ++entry_idx)
     {
         const auto &entry = bundle.entries[entry_idx];
         if(entry.lods.empty() || entry.material_index >= materials.size()) { continue; }
-        const auto &lod_0 = entry.lods.front();
         const auto &material = materials[entry.material_index];
 
         // opacity micromaps encode an alpha-test; only meaningful for mask materials
@@ -174,92 +329,193 @@ std::vector<mesh_omm_data_t> generate_omm_data(const model_assets_t &mesh_assets
         if(tex_it == textures.end()) { continue; }
 
         const auto *cpu_img = std::get_if<crocore::ImagePtr>(&tex_it->second);
-        if(!cpu_img || !*cpu_img) { continue; }  // BCN-only, no CPU data
+        if(!cpu_img || !*cpu_img) { continue; }// BCN-only, no CPU data
+
+        const uint32_t num_components = (*cpu_img)->num_components();
+        if(num_components < 2 || num_components == 3) { continue; }// no alpha channel
+        ret.push_back({entry_idx, color_texture_id, *cpu_img});
+    }
+    return ret;
+}
 
-        const auto &img = *cpu_img;
-        const uint32_t num_components = img->num_components();
-        if(num_components < 2 || num_components == 3) { continue; }  // no alpha channel
-        const uint32_t alpha_offset = num_components - 1;
+//! bake opacity-micromaps for a single entry, nullopt if no micromaps are produced
+std::optional<mesh_omm_entry_t> generate_omm_entry(const vierkant::mesh_buffer_bundle_t &bundle, const omm_job_t &job,
+                                                   const omm_gen_params_t &params)
+{
+    const auto &entry = bundle.entries[job.entry_index];
+    const auto &lod_0 = entry.lods.front();
+    const auto &img = job.img;
+    const uint32_t num_components = img->num_components();
+    const uint32_t alpha_offset = num_components - 1;
+
+    const uint32_t num_triangles = lod_0.num_indices / 3;
+    const uint32_t num_vertices = entry.num_vertices;
+
+    // extract float2 UVs from packed vertex buffer (fp16 → float)
+    std::vector<float> uvs(num_vertices * 2);
+    const auto *verts = reinterpret_cast<const vierkant::packed_vertex_t *>(bundle.vertex_buffer.data()) +
+                        entry.vertex_offset;
+    for(uint32_t v = 0; v < num_vertices; ++v)
+    {
+        uvs[2 * v + 0] = meshopt_dequantizeHalf(verts[v].texcoord_x);
+        uvs[2 * v + 1] = meshopt_dequantizeHalf(verts[v].texcoord_y);
+    }
 
-        const uint32_t num_triangles = lod_0.num_indices / 3;
-        const uint32_t num_vertices = entry.num_vertices;
+    const uint32_t *indices = bundle.index_buffer.data() + lod_0.base_index;
 
-        // extract float2 UVs from packed vertex buffer (fp16 → float)
-        std::vector<float> uvs(num_vertices * 2);
-        const auto *verts = vertex_base + entry.vertex_offset;
-        for(uint32_t v = 0; v < num_vertices; ++v)
-        {
-            uvs[2 * v + 0] = meshopt_dequantizeHalf(verts[v].texcoord_x);
-            uvs[2 * v + 1] = meshopt_dequantizeHalf(verts[v].texcoord_y);
-        }
+    std::vector<unsigned char> levels(num_triangles);
+    std::vector<unsigned int> sources(num_triangles);
+    std::vector<int> omm_indices(num_triangles);
+
+    size_t omm_count = meshopt_opacityMapMeasure(levels.data(), sources.data(), omm_indices.data(), indices,
+                                                 lod_0.num_indices, uvs.data(), num_vertices, 2 * sizeof(float),
+                                                 img->width(), img->height(), params.max_level, params.target_edge);
+
+    if(omm_count == 0) { return {}; }
 
-        const uint32_t *indices = bundle.index_buffer.data() + lod_0.base_index;
+    // compute per-entry sizes and offsets
+    std::vector<unsigned int> offsets(omm_count);
+    size_t total_data_size = 0;
+    for(size_t i = 0; i < omm_count; ++i)
+    {
+        offsets[i] = static_cast<unsigned int>(total_data_size);
+        total_data_size += meshopt_opacityMapEntrySize(levels[i], params.states);
+    }
+
+    std::vector<unsigned char> omm_data(total_data_size);
+    const auto *tex_data = static_cast<const unsigned char *>(img->data()) + alpha_offset;
+    const size_t tex_stride = num_components;
+    const size_t tex_pitch = static_cast<size_t>(img->width()) * num_components;
+
+    for(size_t i = 0; i < omm_count; ++i)
+    {
+        const uint32_t src = sources[i];
+        const float uv0[2] = {uvs[indices[src * 3 + 0] * 2 + 0], uvs[indices[src * 3 + 0] * 2 + 1]};
+        const float uv1[2] = {uvs[indices[src * 3 + 1] * 2 + 0], uvs[indices[src * 3 + 1] * 2 + 1]};
+        const float uv2[2] = {uvs[indices[src * 3 + 2] * 2 + 0], uvs[indices[src * 3 + 2] * 2 + 1]};
+        meshopt_opacityMapRasterize(omm_data.data() + offsets[i], levels[i], params.states, uv0, uv1, uv2, tex_data,
+                                    tex_stride, tex_pitch, img->width(), img->height());
+    }
 
-        std::vector<unsigned char> levels(num_triangles);
-        std::vector<unsigned int> sources(num_triangles);
-        std::vector<int> omm_indices(num_triangles);
+    size_t new_omm_count =
+            meshopt_opacityMapCompact(omm_data.data(), omm_data.size(), levels.data(), offsets.data(), omm_count,
+                                      omm_indices.data(), num_triangles, params.states);
+    if(new_omm_count == 0) { return {}; }
 
-        size_t omm_count = meshopt_opacityMapMeasure(
-                levels.data(), sources.data(), omm_indices.data(), indices, lod_0.num_indices, uvs.data(),
-                num_vertices, 2 * sizeof(float), img->width(), img->height(), params.max_level,
-                params.target_edge);
+    // trim data buffer to actual used size
+    const size_t final_data_size =
+            offsets[new_omm_count - 1] + meshopt_opacityMapEntrySize(levels[new_omm_count - 1], params.states);
+    omm_data.resize(final_data_size);
 
-        if(omm_count == 0) { continue; }
+    const uint16_t vk_format = static_cast<uint16_t>(params.states == 2 ? VK_OPACITY_MICROMAP_FORMAT_2_STATE_EXT
+                                                                        : VK_OPACITY_MICROMAP_FORMAT_4_STATE_EXT);
 
-        // compute per-entry sizes and offsets
-        std::vector<unsigned int> offsets(omm_count);
-        size_t total_data_size = 0;
-        for(size_t i = 0; i < omm_count; ++i)
+    std::vector<VkMicromapTriangleEXT> triangles(new_omm_count);
+    for(size_t i = 0; i < new_omm_count; ++i)
+    {
+        triangles[i].dataOffset = offsets[i];
+        triangles[i].subdivisionLevel = levels[i];
+        triangles[i].format = vk_format;
+    }
+
+    mesh_omm_entry_t omm_entry;
+    omm_entry.data = std::move(omm_data);
+    omm_entry.triangles = std::move(triangles);
+    omm_entry.indices.assign(omm_indices.begin(), omm_indices.end());
+    return omm_entry;
+}
+
+}// namespace
+
+std::vector<mesh_omm_data_t> generate_omm_data(const model_assets_t &mesh_assets,
+                                               const vierkant::mesh_buffer_bundle_t &bundle,
+                                               const omm_gen_params_t &params, crocore::ThreadPoolClassic *pool)
+{
+    std::vector<mesh_omm_data_t> ret;
+
+    if(bundle.vertex_stride != sizeof(vierkant::packed_vertex_t))
+    {
+        spdlog::warn("generate_omm_data: non-packed vertex stride {}, skipping", bundle.vertex_stride);
+        return ret;
+    }
+    auto jobs = omm_jobs(mesh_assets, bundle);
+
+    // entries are baked independently, results are gathered in entry-order to keep output deterministic
+    std::vector<std::optional<mesh_omm_entry_t>> omm_entries(jobs.size());
+
+    if(pool && jobs.size() > 1)
+    {
+        std::vector<std::future<void>> tasks;
+        for(size_t i = 0; i < jobs.size(); ++i)
         {
-            offsets[i] = static_cast<unsigned int>(total_data_size);
-            total_data_size += meshopt_opacityMapEntrySize(levels[i], params.states);
+            tasks.push_back(pool->post([&, i] { omm_entries[i] = generate_omm_entry(bundle, jobs[i], params); }));
         }
+        for(auto &t: tasks) { t.wait(); }
+    }
+    else
+    {
+        for(size_t i = 0; i < jobs.size(); ++i) { omm_entries[i] = generate_omm_entry(bundle, jobs[i], params); }
+    }
 
-        std::vector<unsigned char> omm_data(total_data_size);
-        const auto *tex_data = static_cast<const unsigned char *>(img->data()) + alpha_offset;
-        const size_t tex_stride = num_components;
-        const size_t tex_pitch = static_cast<size_t>(img->width()) * num_components;
-
-        for(size_t i = 0; i < omm_count; ++i)
+    for(size_t i = 0; i < jobs.size(); ++i)
+    {
+        if(omm_entries[i])
         {
-            const uint32_t src = sources[i];
-            const float uv0[2] = {uvs[indices[src * 3 + 0] * 2 + 0], uvs[indices[src * 3 + 0] * 2 + 1]};
-            const float uv1[2] = {uvs[indices[src * 3 + 1] * 2 + 0], uvs[indices[src * 3 + 1] * 2 + 1]};
-            const float uv2[2] = {uvs[indices[src * 3 + 2] * 2 + 0], uvs[indices[src * 3 + 2] * 2 + 1]};
-            meshopt_opacityMapRasterize(omm_data.data() + offsets[i], levels[i], params.states, uv0, uv1, uv2,
-                                        tex_data, tex_stride, tex_pitch, img->width(), img->height());
+            ret.push_back({jobs[i].entry_index, jobs[i].color_texture_id, std::move(*omm_entries[i])});
         }
+    }
+    return ret;
+}
 
-        size_t new_omm_count = meshopt_opacityMapCompact(omm_data.data(), omm_data.size(), levels.data(),
-                                                          offsets.data(), omm_count, omm_indices.data(),
-                                                          num_triangles, params.states);
-        if(new_omm_count == 0) { continue; }
+uint64_t omm_cache_key(const model_assets_t &mesh_assets, const vierkant::mesh_buffer_bundle_t &bundle,
+                       const omm_gen_params_t &params)
+{
+    size_t h = omm_cache_version;
+    vierkant::hash_combine(h, params.max_level);
+    vierkant::hash_combine(h, params.target_edge);
+    vierkant::hash_combine(h, params.states);
 
-        // trim data buffer to actual used size
-        const size_t final_data_size =
-                offsets[new_omm_count - 1] + meshopt_opacityMapEntrySize(levels[new_omm_count - 1], params.states);
-        omm_data.resize(final_data_size);
+    // alpha-textures are hashed once, even when referenced by multiple entries
+    std::unordered_map<const crocore::Image *, uint64_t> image_hashes;
 
-        const uint16_t vk_format = static_cast<uint16_t>(
-                params.states == 2 ? VK_OPACITY_MICROMAP_FORMAT_2_STATE_EXT
-                                   : VK_OPACITY_MICROMAP_FORMAT_4_STATE_EXT);
+    //! vertex-attributes used for OMM-generation, normals and tangents are ignored
+    struct omm_vertex_t
+    {
+        float pos_x, pos_y, pos_z;
+        uint16_t texcoord_x, texcoord_y;
+    };
+    std::vector<omm_vertex_t> omm_vertices;
 
-        std::vector<VkMicromapTriangleEXT> triangles(new_omm_count);
-        for(size_t i = 0; i < new_omm_count; ++i)
+    for(const auto &job: omm_jobs(mesh_assets, bundle))
+    {
+        const auto &entry = bundle.entries[job.entry_index];
+        const auto &lod_0 = entry.lods.front();
+        const auto *verts = reinterpret_cast<const vierkant::packed_vertex_t *>(bundle.vertex_buffer.data()) +
+                            entry.vertex_offset;
+
+        omm_vertices.resize(entry.num_vertices);
+        for(uint32_t v = 0; v < entry.num_vertices; ++v)
         {
-            triangles[i].dataOffset = offsets[i];
-            triangles[i].subdivisionLevel = levels[i];
-            triangles[i].format = vk_format;
+            omm_vertices[v] = {verts[v].pos_x, verts[v].pos_y, verts[v].pos_z, verts[v].texcoord_x,
+                               verts[v].texcoord_y};
         }
 
-        mesh_omm_entry_t omm_entry;
-        omm_entry.data = std::move(omm_data);
-        omm_entry.triangles = std::move(triangles);
-        omm_entry.indices.assign(omm_indices.begin(), omm_indices.end());
-
-        ret.push_back({entry_idx, color_texture_id, std::move(omm_entry)});
+        auto [it, inserted] = image_hashes.try_emplace(job.img.get(), 0);
+        if(inserted)
+        {
+            it->second = vierkant::hash_bytes(job.img->data(), job.img->num_bytes(), job.img->width());
+            vierkant::hash_combine(it->second, job.img->height());
+            vierkant::hash_combine(it->second, job.img->num_components());
+        }
+        vierkant::hash_combine(h, job.entry_index);
+        vierkant::hash_combine(h, job.color_texture_id);
+        vierkant::hash_combine(h, it->second);
+        vierkant::hash_combine(h,
+                               vierkant::hash_bytes(omm_vertices.data(), omm_vertices.size() * sizeof(omm_vertex_t)));
+        vierkant::hash_combine(h, vierkant::hash_bytes(bundle.index_buffer.data() + lod_0.base_index,
+                                                       lod_0.num_indices * sizeof(uint32_t)));
     }
-    return ret;
+    return h ? h : 1;
 }
 
 model::load_mesh_result_t load_mesh(const load_mesh_params_t &params,
@@ -276,12 +532,15 @@ model::load_mesh_result_t load_mesh(const load_mesh_params_t &params,
 
     auto cmd_buf = vierkant::CommandBuffer(params.device, command_pool.get());
 
-    auto mesh_staging_buf = vierkant::Buffer::create(params.device, nullptr, 1U << 20, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                                                     VMA_MEMORY_USAGE_CPU_ONLY);
+    auto mesh_staging_buf = params.upload_queue ? nullptr
+                                                : vierkant::Buffer::create(params.device, nullptr, 1U << 20,
+                                                                           VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                                                           VMA_MEMORY_USAGE_CPU_ONLY);
 
-    auto create_texture = [device = params.device, cmd_buf_handle = cmd_buf.handle(),
-                           &staging_buffers](const crocore::ImagePtr &img) -> vierkant::ImagePtr {
+    auto create_texture = [device = params.device, cmd_buf_handle = cmd_buf.handle(), &staging_buffers,
+                           &upload_queue = params.upload_queue](const crocore::ImagePtr &img) -> vierkant::ImagePtr {
         if(!img) { return nullptr; }
+        if(upload_queue) { return create_texture_async(upload_queue, img); }
 
         vierkant::Image::Format fmt;
         fmt.format = vk_format(img);
@@ -308,6 +567,7 @@ model::load_mesh_result_t load_mesh(const load_mesh_params_t &params,
     mesh_create_info.mesh_buffer_params = params.mesh_buffers_params;
     mesh_create_info.command_buffer = cmd_buf.handle();
     mesh_create_info.staging_buffer = mesh_staging_buf;
+    mesh_create_info.upload_queue = params.upload_queue;
     ret.mesh = std::visit(
             [&mesh_create_info, &device = params.device](auto &&geometry_data) -> vierkant::MeshPtr {
                 using T = std::decay_t<decltype(geometry_data)>;
@@ -350,7 +610,10 @@ model::load_mesh_result_t load_mesh(const load_mesh_params_t &params,
                         vierkant::Image::Format fmt;
                         fmt.usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
                         fmt.max_anisotropy = params.device->properties().core.limits.maxSamplerAnisotropy;
-                        ret.textures[key] = create_compressed_texture(params.device, img, fmt, params.load_queue);
+                        ret.textures[key] =
+                                params.upload_queue
+                                        ? create_compressed_texture_async(params.upload_queue, std::span(&img, 1), fmt)
+                                        : create_compressed_texture(params.device, img, fmt, params.load_queue);
                     }
                 },
                 tex_variant);
@@ -365,30 +628,63 @@ model::load_mesh_result_t load_mesh(const load_mesh_params_t &params,
 
         // no material-mutation: ids stay stable, drawable resolves textures by {texture_id, sampler_id}
         ret.materials[asset_mat.id] = asset_mat;
+    }
+    create_sampled_textures(params.device, mesh_assets, ret);
 
+    // OMM: adopt pre-baked bundle data if present (survives texture-compression), else live-bake
+    // from CPU images while they are still alive. Either way, stamp the runtime mesh-id here.
+    if(!mesh_assets.omm_data.empty())
+    {
+        for(const auto &d: mesh_assets.omm_data)
+        {
+            ret.omm_cache[{ret.mesh->id, d.entry_index, d.color_texture_id}] = d.entry;
+        }
+    }
+    else if(params.omm_params)
+    {
+        if(const auto *bundle = std::get_if<vierkant::mesh_buffer_bundle_t>(&mesh_assets.geometry_data))
+        {
+            for(auto &d: generate_omm_data(mesh_assets, *bundle, *params.omm_params))
+            {
+                ret.omm_cache[{ret.mesh->id, d.entry_index, d.color_texture_id}] = std::move(d.entry);
+            }
+        }
+    }
+
+    // submit asynchronous transfers, or submit and sync
+    if(params.upload_queue) { ret.upload_handle = params.upload_queue->flush(); }
+    else { cmd_buf.submit(params.load_queue ? params.load_queue : params.device->queue(), true); }
+    return ret;
+}
+
+void create_sampled_textures(const vierkant::DevicePtr &device, const model_assets_t &mesh_assets,
+                             load_mesh_result_t &result)
+{
+    for(const auto &asset_mat: mesh_assets.materials)
+    {
         for(const auto &[tex_type, tex_data]: asset_mat.texture_data)
         {
             // sampler_id nil -> base image under {texture_id, nil} already exists
             if(!tex_data.sampler_id) { continue; }
 
             texture_key_t key = {tex_data.texture_id, tex_data.sampler_id};
-            if(ret.textures.contains(key)) { continue; }
+            if(result.textures.contains(key)) { continue; }
 
-            auto base_it = ret.textures.find({tex_data.texture_id, vierkant::SamplerId::nil()});
-            if(base_it == ret.textures.end()) { continue; }
+            auto base_it = result.textures.find({tex_data.texture_id, vierkant::SamplerId::nil()});
+            if(base_it == result.textures.end()) { continue; }
             auto base_img = base_it->second;
 
             // get-or-create one VkSampler per SamplerId
             vierkant::VkSamplerPtr vk_sampler;
-            if(auto sampler_it = ret.samplers.find(tex_data.sampler_id); sampler_it != ret.samplers.end())
+            if(auto sampler_it = result.samplers.find(tex_data.sampler_id); sampler_it != result.samplers.end())
             {
                 vk_sampler = sampler_it->second;
             }
             else if(auto desc_it = mesh_assets.texture_samplers.find(tex_data.sampler_id);
                     desc_it != mesh_assets.texture_samplers.end())
             {
-                vk_sampler = create_sampler(params.device, desc_it->second, base_img->num_mip_levels());
-                ret.samplers[tex_data.sampler_id] = vk_sampler;
+                vk_sampler = create_sampler(device, desc_it->second, base_img->num_mip_levels());
+                result.samplers[tex_data.sampler_id] = vk_sampler;
             }
             else
             {
@@ -400,33 +696,9 @@ model::load_mesh_result_t load_mesh(const load_mesh_params_t &params,
             // realize the sampled permutation under the composite key
             auto vk_img = base_img->clone();
             vk_img->set_sampler(vk_sampler);
-            ret.textures[key] = vk_img;
-        }
-    }
-
-    // OMM: adopt pre-baked bundle data if present (survives texture-compression), else live-bake
-    // from CPU images while they are still alive. Either way, stamp the runtime mesh-id here.
-    if(!mesh_assets.omm_data.empty())
-    {
-        for(const auto &d: mesh_assets.omm_data)
-        {
-            ret.omm_cache[{ret.mesh->id, d.entry_index, d.color_texture_id}] = d.entry;
-        }
-    }
-    else if(params.omm_params)
-    {
-        if(const auto *bundle = std::get_if<vierkant::mesh_buffer_bundle_t>(&mesh_assets.geometry_data))
-        {
-            for(auto &d: generate_omm_data(mesh_assets, *bundle, *params.omm_params))
-            {
-                ret.omm_cache[{ret.mesh->id, d.entry_index, d.color_texture_id}] = std::move(d.entry);
-            }
+            result.textures[key] = vk_img;
         }
     }
-
-    // submit transfer and sync
-    cmd_buf.submit(params.load_queue ? params.load_queue : params.device->queue(), true);
-    return ret;
 }
 
 vierkant::ImagePtr create_texture(const vierkant::DevicePtr &device, const crocore::ImagePtr &img,
@@ -461,30 +733,53 @@ vierkant::ImagePtr create_compressed_texture(const vierkant::DevicePtr &device,
                                              const vierkant::bcn::compress_result_t &compression_result,
                                              vierkant::Image::Format format, VkQueue load_queue)
 {
-    // adhoc using global pool
-    auto pool = vierkant::create_command_pool(device, vierkant::Device::Queue::GRAPHICS,
-                                              VK_COMMAND_POOL_CREATE_TRANSIENT_BIT);
-    auto command_buffer = vierkant::CommandBuffer(device, pool.get());
-    command_buffer.begin();
+    return create_compressed_texture(device, std::span(&compression_result, 1), format, load_queue);
+}
 
+//! derive an image-format for pre-compressed faces
+static vierkant::Image::Format compressed_format(std::span<const vierkant::bcn::compress_result_t> faces,
+                                                 vierkant::Image::Format format)
+{
+    const auto &compression_result = faces.front();
     format.usage |= VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
-    format.format = compression_result.mode == bcn::BC7 ? VK_FORMAT_BC7_UNORM_BLOCK : VK_FORMAT_BC5_UNORM_BLOCK;
+    format.format = bcn::vk_format(compression_result.mode);
     format.extent = {compression_result.base_width, compression_result.base_height, 1};
     format.address_mode_u = VK_SAMPLER_ADDRESS_MODE_REPEAT;
     format.address_mode_v = VK_SAMPLER_ADDRESS_MODE_REPEAT;
     format.use_mipmap = compression_result.levels.size() > 1;
     format.autogenerate_mipmaps = false;
     format.initial_layout_transition = false;
+    format.num_layers = static_cast<uint32_t>(faces.size());
+    if(faces.size() == 6) { format.view_type = VK_IMAGE_VIEW_TYPE_CUBE; }
+    return format;
+}
 
+vierkant::ImagePtr create_compressed_texture(const vierkant::DevicePtr &device,
+                                             std::span<const vierkant::bcn::compress_result_t> faces,
+                                             vierkant::Image::Format format, VkQueue load_queue)
+{
+    if(faces.empty()) { return nullptr; }
+
+    // adhoc using global pool
+    auto pool = vierkant::create_command_pool(device, vierkant::Device::Queue::GRAPHICS,
+                                              VK_COMMAND_POOL_CREATE_TRANSIENT_BIT);
+    auto command_buffer = vierkant::CommandBuffer(device, pool.get());
+    command_buffer.begin();
+
+    format = compressed_format(faces, format);
     auto compressed_img = vierkant::Image::create(device, format);
-    std::vector<vierkant::BufferPtr> level_buffers(compression_result.levels.size());
+    std::vector<vierkant::BufferPtr> level_buffers;
     compressed_img->transition_layout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, command_buffer.handle());
 
-    for(uint32_t lvl = 0; lvl < compression_result.levels.size(); ++lvl)
+    for(uint32_t layer = 0; layer < faces.size(); ++layer)
     {
-        level_buffers[lvl] = vierkant::Buffer::create(device, compression_result.levels[lvl],
-                                                      VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY);
-        compressed_img->copy_from(level_buffers[lvl], command_buffer.handle(), 0, {}, {}, 0, lvl);
+        for(uint32_t lvl = 0; lvl < faces[layer].levels.size(); ++lvl)
+        {
+            auto level_buffer = vierkant::Buffer::create(device, faces[layer].levels[lvl],
+                                                         VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY);
+            compressed_img->copy_from(level_buffer, command_buffer.handle(), 0, {}, {}, layer, lvl);
+            level_buffers.push_back(std::move(level_buffer));
+        }
     }
     compressed_img->transition_layout(VK_IMAGE_LAYOUT_READ_ONLY_OPTIMAL, command_buffer.handle());
 
@@ -493,6 +788,44 @@ vierkant::ImagePtr create_compressed_texture(const vierkant::DevicePtr &device,
     return compressed_img;
 }
 
+vierkant::ImagePtr create_texture_async(const vierkant::UploadQueuePtr &upload_queue, const crocore::ImagePtr &img,
+                                        vierkant::Image::Format fmt)
+{
+    if(!upload_queue || !img) { return nullptr; }
+
+    fmt.format = vk_format(img);
+    fmt.usage |= VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+    fmt.extent = {img->width(), img->height(), 1};
+    fmt.address_mode_u = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    fmt.address_mode_v = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    fmt.use_mipmap = true;
+    fmt.initial_layout_transition = false;
+
+    auto vk_img = vierkant::Image::create(upload_queue->device(), fmt);
+    upload_queue->upload(vk_img, img->data(), img->num_bytes());
+    return vk_img;
+}
+
+vierkant::ImagePtr create_compressed_texture_async(const vierkant::UploadQueuePtr &upload_queue,
+                                                   std::span<const vierkant::bcn::compress_result_t> faces,
+                                                   vierkant::Image::Format format)
+{
+    if(!upload_queue || faces.empty()) { return nullptr; }
+
+    auto compressed_img = vierkant::Image::create(upload_queue->device(), compressed_format(faces, format));
+
+    for(uint32_t layer = 0; layer < faces.size(); ++layer)
+    {
+        for(uint32_t lvl = 0; lvl < faces[layer].levels.size(); ++lvl)
+        {
+            const auto &level = faces[layer].levels[lvl];
+            upload_queue->upload(compressed_img, level.data(), level.size() * sizeof(vierkant::bcn::block_t), layer,
+                                 lvl);
+        }
+    }
+    return compressed_img;
+}
+
 std::optional<model_assets_t> load_model(const std::filesystem::path &path, crocore::ThreadPoolClassic *pool,
                                          const std::string &id_seed)
 {
@@ -2,41 +2,575 @@
 // Created by crocdialer on 31.08.23.
 //
 
-#define TINYOBJLOADER_IMPLEMENTATION
-#include <tiny_obj_loader.h>
+#include <cstring>
+#include <numeric>
+#include <set>
 
+#include <spdlog/spdlog.h>
+#include <vierkant/hash.hpp>
+#include <vierkant/mapped_file.hpp>
 #include <vierkant/model/wavefront_obj.hpp>
 
 namespace vierkant::model
 {
 
-vierkant::GeometryPtr create_geometry(const tinyobj::attrib_t &inattrib, const std::vector<tinyobj::index_t> &indices)
+namespace
+{
+
+//! sentinel for missing face-attributes
+constexpr int32_t k_missing = std::numeric_limits<int32_t>::min();
+
+//! minimum number of bytes per parse-chunk
+constexpr size_t k_min_chunk_size = 1U << 20;
+
+//! shapes with more face-corners will be deduplicated in parallel
+constexpr size_t k_min_parallel_corners = 1U << 18;
+
+//! a face-corner, referencing position/tex_coord/normal
+struct corner_t
+{
+    int32_t v = k_missing, vt = k_missing, vn = k_missing;
+
+    bool operator==(const corner_t &other) const = default;
+};
+
+struct corner_hash_t
+{
+    size_t operator()(const corner_t &c) const
+    {
+        uint64_t h = vierkant::murmur3_fmix64(static_cast<uint32_t>(c.v) |
+                                              static_cast<uint64_t>(static_cast<uint32_t>(c.vt)) << 32U);
+        return vierkant::murmur3_fmix64(h ^ static_cast<uint32_t>(c.vn));
+    }
+};
+
+//! state-changes affecting subsequent faces
+struct obj_event_t
+{
+    enum Type
+    {
+        Object,
+        Group,
+        UseMaterial,
+        MaterialLib
+    };
+    Type type = Object;
+
+    //! number of chunk-triangles preceding the event
+    size_t triangle_index = 0;
+
+    std::string value;
+};
+
+//! parse-result for a line-aligned chunk of an obj-file
+struct obj_chunk_t
+{
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec2> tex_coords;
+    std::vector<glm::vec3> normals;
+
+    //! triangulated face-corners, 3 per triangle
+    std::vector<corner_t> corners;
+
+    //! bitmask of relative (negative) corner-indices, resolved after parsing
+    std::vector<uint8_t> relative;
+
+    std::vector<obj_event_t> events;
+};
+
+//! subset of supported mtl-parameters
+struct obj_material_t
+{
+    std::string name;
+    float diffuse[3] = {0.f, 0.f, 0.f};
+    float emission[3] = {0.f, 0.f, 0.f};
+    float dissolve = 1.f;
+    float shininess = 1.f;
+    float ior = 1.f;
+    float roughness = 0.f;
+    float metallic = 0.f;
+    float clearcoat_roughness = 0.f;
+    std::string diffuse_texname;
+    std::string normal_texname;
+};
+
+//! a shape references consecutive triangle-ranges in multiple chunks
+struct obj_shape_t
+{
+    std::string name;
+    int32_t material_index = -1;
+
+    struct segment_t
+    {
+        uint32_t chunk = 0;
+        size_t first_triangle = 0, num_triangles = 0;
+    };
+    std::vector<segment_t> segments;
+    size_t num_triangles = 0;
+};
+
+template<typename Fn>
+void parallel_for(crocore::ThreadPoolClassic *pool, size_t count, Fn fn)
+{
+    if(!pool || count < 2)
+    {
+        for(size_t i = 0; i < count; ++i) { fn(i); }
+        return;
+    }
+    std::vector<std::future<void>> tasks;
+    tasks.reserve(count);
+    for(size_t i = 0; i < count; ++i) { tasks.push_back(pool->post([&fn, i] { fn(i); })); }
+    for(auto &t: tasks) { t.wait(); }
+}
+
+inline bool is_space(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+inline bool is_digit(char c) { return c >= '0' && c <= '9'; }
+
+inline const char *skip_space(const char *p, const char *end)
+{
+    while(p < end && is_space(*p)) { ++p; }
+    return p;
+}
+
+inline std::string_view trim(std::string_view str)
+{
+    while(!str.empty() && is_space(str.front())) { str.remove_prefix(1); }
+    while(!str.empty() && is_space(str.back())) { str.remove_suffix(1); }
+    return str;
+}
+
+inline std::vector<std::string_view> split(std::string_view str)
+{
+    std::vector<std::string_view> ret;
+    const char *p = str.data(), *end = str.data() + str.size();
+
+    while((p = skip_space(p, end)) < end)
+    {
+        const char *token_end = p;
+        while(token_end < end && !is_space(*token_end)) { ++token_end; }
+        ret.emplace_back(p, token_end - p);
+        p = token_end;
+    }
+    return ret;
+}
+
+/**
+ * @brief   fast float-parser for decimal representations, e.g. '-1.2345e-3'.
+ *
+ * @return  pointer past the parsed characters.
+ */
+const char *parse_float(const char *p, const char *end, float &out)
+{
+    constexpr double pow10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    constexpr int max_digits = 19;
+
+    bool negative = false;
+    if(p < end && (*p == '-' || *p == '+')) { negative = *p++ == '-'; }
+
+    uint64_t mantissa = 0;
+    int exponent = 0, num_digits = 0;
+
+    for(; p < end && is_digit(*p); ++p)
+    {
+        if(num_digits < max_digits)
+        {
+            mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+            num_digits += mantissa ? 1 : 0;
+        }
+        else { exponent++; }
+    }
+
+    if(p < end && *p == '.')
+    {
+        for(++p; p < end && is_digit(*p); ++p)
+        {
+            if(num_digits < max_digits)
+            {
+                mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+                num_digits += mantissa ? 1 : 0;
+                exponent--;
+            }
+        }
+    }
+
+    if(p < end && (*p == 'e' || *p == 'E'))
+    {
+        const char *exp_start = p++;
+        bool exp_negative = false;
+        if(p < end && (*p == '-' || *p == '+')) { exp_negative = *p++ == '-'; }
+
+        if(p < end && is_digit(*p))
+        {
+            int exp_value = 0;
+            for(; p < end && is_digit(*p); ++p) { exp_value = std::min(exp_value * 10 + (*p - '0'), 9999); }
+            exponent += exp_negative ? -exp_value : exp_value;
+        }
+        else { p = exp_start; }
+    }
+
+    auto value = static_cast<double>(mantissa);
+    if(mantissa)
+    {
+        if(exponent < 0 && exponent >= -22) { value /= pow10[-exponent]; }
+        else if(exponent > 0 && exponent <= 22) { value *= pow10[exponent]; }
+        else if(exponent) { value *= std::pow(10.0, exponent); }
+    }
+    out = static_cast<float>(negative ? -value : value);
+    return p;
+}
+
+inline const char *parse_int(const char *p, const char *end, int32_t &out)
+{
+    bool negative = false;
+    if(p < end && (*p == '-' || *p == '+')) { negative = *p++ == '-'; }
+
+    int64_t value = 0;
+    for(; p < end && is_digit(*p); ++p) { value = std::min<int64_t>(value * 10 + (*p - '0'), INT32_MAX); }
+    out = static_cast<int32_t>(negative ? -value : value);
+    return p;
+}
+
+/**
+ * @brief   parse a line-aligned range of an obj-file.
+ */
+obj_chunk_t parse_chunk(const char *p, const char *end)
+{
+    obj_chunk_t ret;
+
+    // scratch-space for polygon-corners
+    std::vector<corner_t> polygon;
+    std::vector<uint8_t> polygon_relative;
+
+    auto event = [&ret](obj_event_t::Type type, std::string_view value) {
+        ret.events.push_back({type, ret.corners.size() / 3, std::string(value)});
+    };
+
+    while(p < end)
+    {
+        const char *line_end = static_cast<const char *>(memchr(p, '\n', end - p));
+        if(!line_end) { line_end = end; }
+
+        const char *t = skip_space(p, line_end);
+        p = line_end + 1;
+
+        if(t == line_end || *t == '#') { continue; }
+
+        auto keyword_end = t;
+        while(keyword_end < line_end && !is_space(*keyword_end)) { ++keyword_end; }
+        std::string_view keyword(t, keyword_end - t);
+        std::string_view rest(keyword_end, line_end - keyword_end);
+        t = skip_space(keyword_end, line_end);
+
+        if(keyword == "v")
+        {
+            glm::vec3 v(0.f);
+            for(uint32_t i = 0; i < 3; ++i) { t = skip_space(parse_float(t, line_end, v[i]), line_end); }
+            ret.positions.push_back(v);
+        }
+        else if(keyword == "vt")
+        {
+            glm::vec2 vt(0.f);
+            for(uint32_t i = 0; i < 2; ++i) { t = skip_space(parse_float(t, line_end, vt[i]), line_end); }
+            ret.tex_coords.push_back(vt);
+        }
+        else if(keyword == "vn")
+        {
+            glm::vec3 vn(0.f);
+            for(uint32_t i = 0; i < 3; ++i) { t = skip_space(parse_float(t, line_end, vn[i]), line_end); }
+            ret.normals.push_back(vn);
+        }
+        else if(keyword == "f")
+        {
+            polygon.clear();
+            polygon_relative.clear();
+
+            while(t < line_end)
+            {
+                int32_t indices[3] = {k_missing, k_missing, k_missing};
+                const int32_t counts[3] = {static_cast<int32_t>(ret.positions.size()),
+                                           static_cast<int32_t>(ret.tex_coords.size()),
+                                           static_cast<int32_t>(ret.normals.size())};
+                uint8_t relative = 0;
+
+                // v, v/vt, v//vn, v/vt/vn
+                for(uint32_t i = 0; i < 3 && t < line_end && !is_space(*t); ++i)
+                {
+                    if(*t != '/')
+                    {
+                        int32_t idx = 0;
+                        t = parse_int(t, line_end, idx);
+
+                        // 1-based, negative -> relative to current (chunk-local) attribute-count
+                        if(idx > 0) { indices[i] = idx - 1; }
+                        else if(idx < 0)
+                        {
+                            indices[i] = counts[i] + idx;
+                            relative |= 1U << i;
+                        }
+                    }
+                    if(t < line_end && *t == '/') { ++t; }
+                }
+                while(t < line_end && !is_space(*t)) { ++t; }
+                t = skip_space(t, line_end);
+
+                polygon.push_back({indices[0], indices[1], indices[2]});
+                polygon_relative.push_back(relative);
+            }
+
+            // fan-triangulation
+            for(uint32_t i = 2; i < polygon.size(); ++i)
+            {
+                for(auto j: {0U, i - 1, i})
+                {
+                    ret.corners.push_back(polygon[j]);
+                    ret.relative.push_back(polygon_relative[j]);
+                }
+            }
+        }
+        else if(keyword == "o") { event(obj_event_t::Object, trim(rest)); }
+        else if(keyword == "g")
+        {
+            // group-names are joined by single spaces
+            std::string name;
+            for(const auto &token: split(rest))
+            {
+                if(!name.empty()) { name += " "; }
+                name += token;
+            }
+            event(obj_event_t::Group, name);
+        }
+        else if(keyword == "usemtl")
+        {
+            auto tokens = split(rest);
+            event(obj_event_t::UseMaterial, tokens.empty() ? std::string_view() : tokens.front());
+        }
+        else if(keyword == "mtllib") { event(obj_event_t::MaterialLib, trim(rest)); }
+    }
+    return ret;
+}
+
+/**
+ * @brief   parse texture-statements, skipping options like '-bm 0.5' and returning the filename.
+ */
+std::string parse_texture_name(std::string_view rest)
+{
+    auto tokens = split(rest);
+    size_t i = 0;
+
+    auto is_number = [](std::string_view token) {
+        float unused;
+        return !token.empty() && parse_float(token.data(), token.data() + token.size(), unused) ==
+                                         token.data() + token.size();
+    };
+
+    while(i < tokens.size() && tokens[i].size() > 1 && tokens[i].front() == '-' && !is_number(tokens[i]))
+    {
+        auto option = tokens[i++];
+
+        // options with exactly one non-numeric argument
+        if(option == "-imfchan" || option == "-type" || option == "-colorspace")
+        {
+            i++;
+            continue;
+        }
+        while(i < tokens.size() && (is_number(tokens[i]) || tokens[i] == "on" || tokens[i] == "off")) { i++; }
+    }
+    if(i >= tokens.size()) { return {}; }
+
+    // remaining tokens form the filename
+    const char *name_start = tokens[i].data();
+    const char *name_end = tokens.back().data() + tokens.back().size();
+    return {name_start, name_end};
+}
+
+/**
+ * @brief   load materials from an mtl-file.
+ */
+bool parse_mtl(const std::filesystem::path &path, std::vector<obj_material_t> &materials,
+               std::unordered_map<std::string, int32_t> &material_map)
+{
+    auto mapped_file = vierkant::MappedFile::create(path);
+    if(!mapped_file) { return false; }
+
+    auto str = mapped_file->str();
+    const char *p = str.data(), *end = str.data() + str.size();
+
+    std::optional<obj_material_t> material;
+
+    auto push_material = [&material, &materials, &material_map] {
+        if(material)
+        {
+            material_map[material->name] = static_cast<int32_t>(materials.size());
+            materials.push_back(std::move(*material));
+        }
+        material = {};
+    };
+
+    auto parse_floats = [](const char *t, const char *line_end, float *out, uint32_t count) {
+        for(uint32_t i = 0; i < count; ++i) { t = skip_space(parse_float(t, line_end, out[i]), line_end); }
+    };
+
+    while(p < end)
+    {
+        const char *line_end = static_cast<const char *>(memchr(p, '\n', end - p));
+        if(!line_end) { line_end = end; }
+
+        const char *t = skip_space(p, line_end);
+        p = line_end + 1;
+
+        if(t == line_end || *t == '#') { continue; }
+
+        auto keyword_end = t;
+        while(keyword_end < line_end && !is_space(*keyword_end)) { ++keyword_end; }
+        std::string_view keyword(t, keyword_end - t);
+        std::string_view rest(keyword_end, line_end - keyword_end);
+        t = skip_space(keyword_end, line_end);
+
+        if(keyword == "newmtl")
+        {
+            push_material();
+            material = obj_material_t();
+            material->name = trim(rest);
+            continue;
+        }
+        if(!material) { continue; }
+
+        if(keyword == "Kd") { parse_floats(t, line_end, material->diffuse, 3); }
+        else if(keyword == "Ke") { parse_floats(t, line_end, material->emission, 3); }
+        else if(keyword == "d") { parse_floats(t, line_end, &material->dissolve, 1); }
+        else if(keyword == "Tr")
+        {
+            float transparency = 0.f;
+            parse_floats(t, line_end, &transparency, 1);
+            material->dissolve = 1.f - transparency;
+        }
+        else if(keyword == "Ns") { parse_floats(t, line_end, &material->shininess, 1); }
+        else if(keyword == "Ni") { parse_floats(t, line_end, &material->ior, 1); }
+        else if(keyword == "Pr") { parse_floats(t, line_end, &material->roughness, 1); }
+        else if(keyword == "Pm") { parse_floats(t, line_end, &material->metallic, 1); }
+        else if(keyword == "Pcr") { parse_floats(t, line_end, &material->clearcoat_roughness, 1); }
+        else if(keyword == "map_Kd") { material->diffuse_texname = parse_texture_name(rest); }
+        else if(keyword == "norm") { material->normal_texname = parse_texture_name(rest); }
+    }
+    push_material();
+    return true;
+}
+
+/**
+ * @brief   deduplicate face-corners. first occurrences define the vertex-order.
+ *
+ * @param   corners         an array of face-corners
+ * @param   unique_corners  output-array, containing indices of all unique corners
+ * @param   pool            optional threadpool, used for large inputs
+ * @return  an index-array, mapping corners to unique vertices
+ */
+std::vector<index_t> deduplicate_corners(const std::vector<corner_t> &corners, std::vector<uint32_t> &unique_corners,
+                                         crocore::ThreadPoolClassic *pool)
+{
+    std::vector<index_t> ret(corners.size());
+    unique_corners.clear();
+
+    if(!pool || corners.size() < k_min_parallel_corners)
+    {
+        std::unordered_map<corner_t, index_t, corner_hash_t> vertex_map;
+        vertex_map.reserve(corners.size() / 4);
+
+        for(uint32_t i = 0; i < corners.size(); ++i)
+        {
+            auto [it, inserted] = vertex_map.try_emplace(corners[i], static_cast<index_t>(unique_corners.size()));
+            if(inserted) { unique_corners.push_back(i); }
+            ret[i] = it->second;
+        }
+        return ret;
+    }
+
+    // scatter corners into hash-buckets, range by range
+    const size_t num_buckets = std::max<size_t>(pool->num_threads(), 1) * 4;
+    const size_t range_size = (corners.size() + num_buckets - 1) / num_buckets;
+    std::vector<std::vector<std::vector<uint32_t>>> range_buckets(num_buckets,
+                                                                  std::vector<std::vector<uint32_t>>(num_buckets));
+
+    parallel_for(pool, num_buckets, [&](size_t r) {
+        corner_hash_t hasher;
+        size_t end = std::min(corners.size(), (r + 1) * range_size);
+        for(size_t i = r * range_size; i < end; ++i)
+        {
+            range_buckets[r][hasher(corners[i]) % num_buckets].push_back(static_cast<uint32_t>(i));
+        }
+    });
+
+    // find first occurrences, independently per bucket
+    std::vector<uint32_t> first_occurrence(corners.size());
+
+    parallel_for(pool, num_buckets, [&](size_t b) {
+        std::unordered_map<corner_t, uint32_t, corner_hash_t> bucket_map;
+
+        for(size_t r = 0; r < num_buckets; ++r)
+        {
+            for(auto i: range_buckets[r][b])
+            {
+                auto [it, inserted] = bucket_map.try_emplace(corners[i], i);
+                first_occurrence[i] = it->second;
+            }
+        }
+    });
+
+    // assign vertex-indices in order of first occurrence
+    for(uint32_t i = 0; i < corners.size(); ++i)
+    {
+        if(first_occurrence[i] == i)
+        {
+            ret[i] = static_cast<index_t>(unique_corners.size());
+            unique_corners.push_back(i);
+        }
+        else { ret[i] = ret[first_occurrence[i]]; }
+    }
+    return ret;
+}
+
+struct obj_attributes_t
+{
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec2> tex_coords;
+    std::vector<glm::vec3> normals;
+};
+
+vierkant::GeometryPtr create_geometry(const obj_attributes_t &attributes, const std::vector<corner_t> &corners,
+                                      crocore::ThreadPoolClassic *pool)
 {
     auto geom = vierkant::Geometry::create();
 
-    bool has_normals = !inattrib.normals.empty();
+    bool has_normals = !attributes.normals.empty();
+
+    // without normals, flat vertex-normals are generated from non-shared vertices
+    std::vector<uint32_t> unique_corners;
+
+    if(has_normals) { geom->indices = deduplicate_corners(corners, unique_corners, pool); }
+    else
+    {
+        unique_corners.resize(corners.size());
+        std::iota(unique_corners.begin(), unique_corners.end(), 0);
+        geom->indices.resize(corners.size());
+        std::iota(geom->indices.begin(), geom->indices.end(), 0);
+    }
 
     // start filled with zeros
-    geom->positions.resize(indices.size(), glm::vec3(0.f));
-    geom->tex_coords.resize(indices.size(), glm::vec2(0.f));
-    if(has_normals) { geom->normals.resize(indices.size(), glm::vec3(0.f)); }
+    geom->positions.resize(unique_corners.size(), glm::vec3(0.f));
+    geom->tex_coords.resize(unique_corners.size(), glm::vec2(0.f));
+    if(has_normals) { geom->normals.resize(unique_corners.size(), glm::vec3(0.f)); }
 
-    auto pos_start = reinterpret_cast<const glm::vec<3, tinyobj::real_t, glm::defaultp> *>(inattrib.vertices.data());
-    auto normal_start = reinterpret_cast<const glm::vec<3, tinyobj::real_t, glm::defaultp> *>(inattrib.normals.data());
-    auto texcoord_start =
-            reinterpret_cast<const glm::vec<2, tinyobj::real_t, glm::defaultp> *>(inattrib.texcoords.data());
+    auto valid = [](int32_t idx, size_t count) { return idx >= 0 && static_cast<size_t>(idx) < count; };
 
-    for(uint32_t i = 0; i < indices.size(); ++i)
+    for(uint32_t i = 0; i < unique_corners.size(); ++i)
     {
-        if(indices[i].vertex_index >= 0) { geom->positions[i] = pos_start[indices[i].vertex_index]; }
-        if(has_normals && indices[i].normal_index >= 0) { geom->normals[i] = normal_start[indices[i].normal_index]; }
-        if(indices[i].texcoord_index >= 0) { geom->tex_coords[i] = texcoord_start[indices[i].texcoord_index]; }
+        const auto &c = corners[unique_corners[i]];
+        if(valid(c.v, attributes.positions.size())) { geom->positions[i] = attributes.positions[c.v]; }
+        if(valid(c.vt, attributes.tex_coords.size())) { geom->tex_coords[i] = attributes.tex_coords[c.vt]; }
+        if(has_normals && valid(c.vn, attributes.normals.size())) { geom->normals[i] = attributes.normals[c.vn]; }
     }
 
-    // iota fill indices
-    geom->indices.resize(indices.size());
-    std::iota(geom->indices.begin(), geom->indices.end(), 0);
-
     // calculate missing normals
     if(geom->normals.empty()) { geom->compute_vertex_normals(); }
 
@@ -45,7 +579,9 @@ vierkant::GeometryPtr create_geometry(const tinyobj::attrib_t &inattrib, const s
     return geom;
 }
 
-std::optional<model_assets_t> wavefront_obj(const std::filesystem::path &path, crocore::ThreadPoolClassic * /*pool*/,
+}// namespace
+
+std::optional<model_assets_t> wavefront_obj(const std::filesystem::path &path, crocore::ThreadPoolClassic *pool,
                                             const std::string &id_seed)
 {
     if(!exists(path) || !is_regular_file(path)) { return {}; }
@@ -53,32 +589,157 @@ std::optional<model_assets_t> wavefront_obj(const std::filesystem::path &path, c
     // stable seed for deterministic asset-ids; defaults to the (machine-local) path
     const std::string seed = id_seed.empty() ? path.string() : id_seed;
 
-    tinyobj::attrib_t inattrib;
-    std::vector<tinyobj::shape_t> shapes;
-    std::vector<tinyobj::material_t> materials;
-    std::string warn, err;
+    auto mapped_file = vierkant::MappedFile::create(path);
+    if(!mapped_file)
+    {
+        spdlog::error("failed to load {}", path.string());
+        return {};
+    }
+
+    // split into line-aligned chunks
+    auto str = mapped_file->str();
+    size_t max_num_chunks = pool ? std::max<size_t>(pool->num_threads(), 1) * 4 : 1;
+    size_t num_chunks = std::clamp<size_t>(str.size() / k_min_chunk_size, 1, max_num_chunks);
+    std::vector<size_t> chunk_offsets = {0};
+
+    for(size_t i = 1; i < num_chunks; ++i)
+    {
+        size_t offset = std::max(chunk_offsets.back(), i * str.size() / num_chunks);
+        offset = str.find('\n', offset);
+        if(offset == std::string_view::npos) { break; }
+        if(offset + 1 > chunk_offsets.back()) { chunk_offsets.push_back(offset + 1); }
+    }
+    chunk_offsets.push_back(str.size());
+    num_chunks = chunk_offsets.size() - 1;
+
+    std::vector<obj_chunk_t> chunks(num_chunks);
+    parallel_for(pool, num_chunks, [&](size_t i) {
+        chunks[i] = parse_chunk(str.data() + chunk_offsets[i], str.data() + chunk_offsets[i + 1]);
+    });
+
+    // resolve relative indices and combine attributes
+    obj_attributes_t attributes;
+    std::vector<glm::ivec3> chunk_attribute_offsets(num_chunks);
+
+    for(uint32_t i = 0; i < num_chunks; ++i)
+    {
+        chunk_attribute_offsets[i] = glm::ivec3(attributes.positions.size(), attributes.tex_coords.size(),
+                                                attributes.normals.size());
+        attributes.positions.insert(attributes.positions.end(), chunks[i].positions.begin(),
+                                    chunks[i].positions.end());
+        attributes.tex_coords.insert(attributes.tex_coords.end(), chunks[i].tex_coords.begin(),
+                                     chunks[i].tex_coords.end());
+        attributes.normals.insert(attributes.normals.end(), chunks[i].normals.begin(), chunks[i].normals.end());
+        chunks[i].positions = {};
+        chunks[i].tex_coords = {};
+        chunks[i].normals = {};
+    }
+
+    parallel_for(pool, num_chunks, [&](size_t i) {
+        auto &chunk = chunks[i];
+        const auto &offsets = chunk_attribute_offsets[i];
+
+        for(size_t j = 0; j < chunk.corners.size(); ++j)
+        {
+            if(!chunk.relative[j]) { continue; }
+            auto &c = chunk.corners[j];
+            if(chunk.relative[j] & 1U) { c.v += offsets.x; }
+            if(chunk.relative[j] & 2U) { c.vt += offsets.y; }
+            if(chunk.relative[j] & 4U) { c.vn += offsets.z; }
+        }
+        chunk.relative = {};
+    });
 
     // use obj-file's location as base-dir for material .mtl search
     auto base_dir = path.parent_path();
 
-    bool ret = tinyobj::LoadObj(&inattrib, &shapes, &materials, &warn, &err, path.string().c_str(),
-                                base_dir.string().c_str());
-    if(!warn.empty()) { spdlog::warn(warn); }
-    if(!err.empty()) { spdlog::error(warn); }
-    if(!ret) { spdlog::error("failed to load {}", path.string()); }
+    std::vector<obj_material_t> materials;
+    std::unordered_map<std::string, int32_t> material_map;
+    std::set<std::string> material_libs;
+
+    // walk state-changes in file-order and assemble shapes
+    std::vector<obj_shape_t> shapes(1);
+    int32_t current_material = -1;
+
+    auto add_segment = [&shapes, &current_material](uint32_t chunk, size_t first, size_t last) {
+        if(last <= first) { return; }
+        auto &shape = shapes.back();
+        if(!shape.num_triangles) { shape.material_index = current_material; }
+        shape.segments.push_back({chunk, first, last - first});
+        shape.num_triangles += last - first;
+    };
+
+    for(uint32_t c = 0; c < num_chunks; ++c)
+    {
+        size_t triangle_index = 0;
+
+        for(const auto &event: chunks[c].events)
+        {
+            add_segment(c, triangle_index, event.triangle_index);
+            triangle_index = event.triangle_index;
+
+            switch(event.type)
+            {
+                case obj_event_t::Object:
+                case obj_event_t::Group:
+                    if(shapes.back().num_triangles) { shapes.emplace_back(); }
+                    shapes.back().name = event.value;
+                    break;
+
+                case obj_event_t::UseMaterial:
+                {
+                    auto it = material_map.find(event.value);
+                    if(it == material_map.end()) { spdlog::warn("material '{}' not found in .mtl", event.value); }
+                    current_material = it != material_map.end() ? it->second : -1;
+                    break;
+                }
 
+                case obj_event_t::MaterialLib:
+                    if(material_libs.contains(event.value)) { break; }
+                    material_libs.insert(event.value);
+
+                    // use the first loadable file
+                    for(const auto &filename: split(event.value))
+                    {
+                        if(parse_mtl(base_dir / filename, materials, material_map)) { break; }
+                        spdlog::warn("could not load material-library: {}", (base_dir / filename).string());
+                    }
+                    break;
+            }
+        }
+        add_segment(c, triangle_index, chunks[c].corners.size() / 3);
+    }
+    if(!shapes.back().num_triangles) { shapes.pop_back(); }
+
+    // decode all referenced images
     std::unordered_map<std::string, std::tuple<TextureId, crocore::ImagePtr>> image_cache;
-    auto get_image = [&image_cache, &seed, &base_dir](const std::string &texname) -> std::tuple<TextureId, crocore::ImagePtr> {
-        if(auto it = image_cache.find(texname); it != image_cache.end()) { return it->second; }
+    {
+        std::set<std::string> texnames;
+        for(const auto &mat: materials)
+        {
+            if(!mat.diffuse_texname.empty()) { texnames.insert(mat.diffuse_texname); }
+            if(!mat.normal_texname.empty()) { texnames.insert(mat.normal_texname); }
+        }
+        std::vector<std::string> texname_array = {texnames.begin(), texnames.end()};
+        std::vector<crocore::ImagePtr> images(texname_array.size());
 
-        std::tuple<TextureId, crocore::ImagePtr> ret;
-        try
+        parallel_for(pool, texname_array.size(), [&](size_t i) {
+            try
+            {
+                images[i] = crocore::create_image_from_file((base_dir / texname_array[i]).string(), 4);
+            } catch(std::exception &e) { spdlog::warn(e.what()); }
+        });
+
+        for(uint32_t i = 0; i < texname_array.size(); ++i)
         {
-            ret = {TextureId::from_name(seed + "/" + texname),
-                   crocore::create_image_from_file((base_dir / texname).string(), 4)};
-            image_cache[texname] = ret;
-        } catch(std::exception &e) { spdlog::warn(e.what()); }
-        return ret;
+            if(!images[i]) { continue; }
+            image_cache[texname_array[i]] = {TextureId::from_name(seed + "/" + texname_array[i]), images[i]};
+        }
+    }
+
+    auto get_image = [&image_cache](const std::string &texname) -> std::tuple<TextureId, crocore::ImagePtr> {
+        if(auto it = image_cache.find(texname); it != image_cache.end()) { return it->second; }
+        return {};
     };
 
     model_assets_t mesh_assets = {};
@@ -93,8 +754,6 @@ std::optional<model_assets_t> wavefront_obj(const std::filesystem::path &path, c
         m.emission = {mat.emission[0], mat.emission[1], mat.emission[2]};
         m.roughness = std::clamp(std::max(mat.roughness, std::pow(1.f - mat.shininess, 2.f)), 0.f, 1.f);
         m.metalness = mat.metallic;
-        m.clearcoat_roughness_factor = mat.clearcoat_roughness;
-        //        m.transmission = mat.transmittance[0];
         m.ior = mat.ior;
         m.clearcoat_roughness_factor = mat.clearcoat_roughness;
 
@@ -123,18 +782,91 @@ std::optional<model_assets_t> wavefront_obj(const std::filesystem::path &path, c
     // fallback material
     if(mesh_assets.materials.empty()) { mesh_assets.materials.push_back({}); }
 
-    std::vector<vierkant::Mesh::entry_create_info_t> entry_create_infos;
+    // gather triangle-corners per shape
+    auto shape_corners = [&chunks](const obj_shape_t &shape) {
+        std::vector<corner_t> ret;
+        ret.reserve(shape.num_triangles * 3);
+        for(const auto &s: shape.segments)
+        {
+            auto it = chunks[s.chunk].corners.begin() + static_cast<ptrdiff_t>(3 * s.first_triangle);
+            ret.insert(ret.end(), it, it + static_cast<ptrdiff_t>(3 * s.num_triangles));
+        }
+        return ret;
+    };
 
-    for(const auto &shape: shapes)
-    {
-        vierkant::Mesh::entry_create_info_t entry_info = {};
-        entry_info.geometry = create_geometry(inattrib, shape.mesh.indices);
+    std::vector<vierkant::Mesh::entry_create_info_t> entry_create_infos(shapes.size());
+
+    auto create_entry = [&](size_t i, crocore::ThreadPoolClassic *dedup_pool) {
+        const auto &shape = shapes[i];
+        auto &entry_info = entry_create_infos[i];
+        entry_info.geometry = create_geometry(attributes, shape_corners(shape), dedup_pool);
         entry_info.name = shape.name;
-        entry_info.material_index = shape.mesh.material_ids.empty() ? 0 : std::max(shape.mesh.material_ids.front(), 0);
-        entry_create_infos.push_back(entry_info);
+        entry_info.material_index = std::max(shape.material_index, 0);
+    };
+
+    // large shapes deduplicate in parallel, small shapes are processed in parallel
+    std::vector<size_t> small_shapes;
+    for(size_t i = 0; i < shapes.size(); ++i)
+    {
+        if(shapes[i].num_triangles * 3 >= k_min_parallel_corners) { create_entry(i, pool); }
+        else { small_shapes.push_back(i); }
     }
+    parallel_for(pool, small_shapes.size(), [&](size_t i) { create_entry(small_shapes[i], nullptr); });
+
     mesh_assets.geometry_data = entry_create_infos;
     return mesh_assets;
 }
 
-}// namespace vierkant::model
\ No newline at end of file
+std::vector<std::filesystem::path> wavefront_obj_external_files(const std::filesystem::path &path)
+{
+    auto mapped_file = vierkant::MappedFile::create(path);
+    if(!mapped_file) { return {}; }
+
+    auto base_dir = path.parent_path();
+    auto str = mapped_file->str();
+    const char *p = str.data(), *end = str.data() + str.size();
+
+    std::vector<std::filesystem::path> ret;
+    std::set<std::string_view> material_libs;
+    std::vector<obj_material_t> materials;
+    std::unordered_map<std::string, int32_t> material_map;
+
+    // only 'mtllib'-statements are of interest, geometry is skipped
+    while(p < end)
+    {
+        const char *line_end = static_cast<const char *>(memchr(p, '\n', end - p));
+        if(!line_end) { line_end = end; }
+
+        const char *t = skip_space(p, line_end);
+        p = line_end + 1;
+
+        constexpr std::string_view keyword = "mtllib";
+        if(static_cast<size_t>(line_end - t) <= keyword.size() || std::string_view(t, keyword.size()) != keyword ||
+           !is_space(t[keyword.size()]))
+        {
+            continue;
+        }
+        auto rest = trim(std::string_view(t + keyword.size(), line_end - t - keyword.size()));
+        if(!material_libs.insert(rest).second) { continue; }
+
+        // all candidates are referenced, the first loadable file provides materials
+        bool loaded = false;
+        for(const auto &filename: split(rest))
+        {
+            ret.push_back(base_dir / filename);
+            if(!loaded) { loaded = parse_mtl(base_dir / filename, materials, material_map); }
+        }
+    }
+
+    // textures are resolved relative to the obj-file
+    std::set<std::string> texnames;
+    for(const auto &mat: materials)
+    {
+        if(!mat.diffuse_texname.empty()) { texnames.insert(mat.diffuse_texname); }
+        if(!mat.normal_texname.empty()) { texnames.insert(mat.normal_texname); }
+    }
+    for(const auto &texname: texnames) { ret.push_back(base_dir / texname); }
+    return ret;
+}
+
+}// namespace vierkant::model
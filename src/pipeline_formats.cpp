@@ -57,13 +57,12 @@ static inline bool operator==(const VkPushConstantRange &lhs, const VkPushConsta
 namespace vierkant
 {
 
-shader_module_t create_shader_module(const void *spirv_code, size_t num_bytes)
-{
-    shader_module_t ret{};
-    ret.create_info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-    ret.create_info.codeSize = num_bytes;
-    ret.create_info.pCode = static_cast<const uint32_t *>(spirv_code);
+using entry_point_map_t = std::map<VkShaderStageFlags, std::vector<shader_module_t::entry_point_t>>;
 
+//! runtime-reflection of entry-points, using SPIRV-Reflect
+static entry_point_map_t reflect_entry_points(const void *spirv_code, size_t num_bytes)
+{
+    entry_point_map_t ret;
     SpvReflectShaderModule spv_shader_module;
     spvReflectCreateShaderModule(num_bytes, spirv_code, &spv_shader_module);
 
@@ -88,7 +87,7 @@ shader_module_t create_shader_module(const void *spirv_code, size_t num_bytes)
         assert(stage_lut.contains(spv_entry_point.spirv_execution_model));
 
         // insert entry-point
-        auto &entry_point = ret.entry_points[stage_lut.at(spv_entry_point.spirv_execution_model)].emplace_back();
+        auto &entry_point = ret[stage_lut.at(spv_entry_point.spirv_execution_model)].emplace_back();
         entry_point.name = spv_entry_point.name;
         entry_point.group_count = {spv_entry_point.local_size.x, spv_entry_point.local_size.y,
                                    spv_entry_point.local_size.z};
@@ -107,6 +106,44 @@ shader_module_t create_shader_module(const void *spirv_code, size_t num_bytes)
     return ret;
 }
 
+//! lookup build-time reflection-data for embedded shader-code
+static const shader_reflection_t *find_shader_reflection(const void *spirv_code, size_t num_bytes)
+{
+    static const auto reflection_map = [] {
+        std::unordered_map<const void *, const shader_reflection_t *> ret;
+        for(const auto &r: vierkant::shaders::reflections) { ret[r.code] = &r; }
+        for(const auto &r: vierkant::slang_shaders::reflections) { ret[r.code] = &r; }
+        return ret;
+    }();
+    auto it = reflection_map.find(spirv_code);
+    return it != reflection_map.end() && it->second->num_bytes == num_bytes ? it->second : nullptr;
+}
+
+shader_module_t create_shader_module(const void *spirv_code, size_t num_bytes)
+{
+    shader_module_t ret{};
+    ret.create_info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    ret.create_info.codeSize = num_bytes;
+    ret.create_info.pCode = static_cast<const uint32_t *>(spirv_code);
+
+    if(auto reflection = find_shader_reflection(spirv_code, num_bytes))
+    {
+        for(const auto &table_entry: reflection->entry_points)
+        {
+            auto &entry_point = ret.entry_points[table_entry.stage].emplace_back();
+            entry_point.name = table_entry.name;
+            entry_point.group_count = {table_entry.group_count[0], table_entry.group_count[1],
+                                       table_entry.group_count[2]};
+            entry_point.bindings = {table_entry.bindings.begin(), table_entry.bindings.end()};
+        }
+
+        // cross-check build-time tables
+        assert(ret.entry_points == reflect_entry_points(spirv_code, num_bytes));
+    }
+    else { ret.entry_points = reflect_entry_points(spirv_code, num_bytes); }
+    return ret;
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 std::vector<VkRayTracingShaderGroupCreateInfoKHR> raytracing_shader_groups(const raytracing_shader_map_t &shader_stages)
@@ -287,6 +324,7 @@ bool graphics_pipeline_info_t::operator==(const graphics_pipeline_info_t &other)
     if(subpass != other.subpass) { return false; }
     if(base_pipeline != other.base_pipeline) { return false; }
     if(base_pipeline_index != other.base_pipeline_index) { return false; }
+    if(use_descriptor_buffer != other.use_descriptor_buffer) { return false; }
     if(specialization != other.specialization) { return false; }
     if(pipeline_cache != other.pipeline_cache) { return false; }
     if(dynamic_states != other.dynamic_states) { return false; }
@@ -475,6 +513,7 @@ std::hash<vierkant::graphics_pipeline_info_t>::operator()(vierkant::graphics_pip
     hash_combine(h, fmt.subpass);
     hash_combine(h, fmt.base_pipeline);
     hash_combine(h, fmt.base_pipeline_index);
+    hash_combine(h, fmt.use_descriptor_buffer);
     hash_combine(h, fmt.specialization);
     hash_combine(h, fmt.pipeline_cache);
     for(const auto &ds: fmt.dynamic_states) { hash_combine(h, ds); }
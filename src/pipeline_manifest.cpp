@@ -0,0 +1,204 @@
+#include <cstring>
+#include <map>
+
+#include <spdlog/spdlog.h>
+#include <vierkant/mapped_file.hpp>
+#include <vierkant/pipeline_manifest.hpp>
+
+#include "binary_archive.hpp"
+
+namespace vierkant::serialization
+{
+
+// forward declarations, all overloads need to be visible for nested types
+template<typename Archive>
+void serialize(Archive &ar, vierkant::pipeline_specialization &specialization);
+
+template<typename Archive>
+void serialize(Archive &ar, vierkant::descriptor_set_layout_desc_t &desc);
+
+template<typename Archive>
+void serialize(Archive &ar, vierkant::graphics_pipeline_info_t &fmt);
+
+template<typename Archive>
+void serialize(Archive &ar, vierkant::pipeline_manifest_t::shader_t &shader);
+
+template<typename Archive>
+void serialize(Archive &ar, vierkant::pipeline_manifest_t::pipeline_t &pipeline);
+
+template<typename Archive>
+void serialize(Archive &ar, vierkant::pipeline_manifest_t &manifest);
+
+template<typename Archive>
+void serialize(Archive &ar, vierkant::pipeline_specialization &specialization)
+{
+    struct constant_t
+    {
+        uint32_t constant_id;
+        std::array<uint8_t, 4> blob;
+    };
+    std::vector<constant_t> constants;
+    for(const auto &[constant_id, blob]: specialization.constant_blobs) { constants.push_back({constant_id, blob}); }
+    process(ar, constants);
+
+    specialization.constant_blobs.clear();
+    for(const auto &[constant_id, blob]: constants) { specialization.constant_blobs[constant_id] = blob; }
+}
+
+template<typename Archive>
+void serialize(Archive &ar, vierkant::descriptor_set_layout_desc_t &desc)
+{
+    process(ar, desc.flags);
+    process(ar, desc.bindings);
+    process(ar, desc.binding_flags);
+    for(auto &binding: desc.bindings) { binding.pImmutableSamplers = nullptr; }
+}
+
+template<typename Archive>
+void serialize(Archive &ar, vierkant::graphics_pipeline_info_t &fmt)
+{
+    process(ar, fmt.attachment_count);
+    process(ar, fmt.binding_descriptions);
+    process(ar, fmt.attribute_descriptions);
+    process(ar, fmt.primitive_topology);
+    process(ar, fmt.primitive_restart);
+    process(ar, fmt.num_patch_control_points);
+    process(ar, fmt.front_face);
+    process(ar, fmt.polygon_mode);
+    process(ar, fmt.cull_mode);
+    process(ar, fmt.viewport);
+    process(ar, fmt.scissor);
+    process(ar, fmt.rasterizer_discard);
+    process(ar, fmt.depth_test);
+    process(ar, fmt.depth_write);
+    process(ar, fmt.depth_clamp);
+    process(ar, fmt.depth_compare_op);
+    process(ar, fmt.stencil_test);
+    process(ar, fmt.stencil_state_front);
+    process(ar, fmt.stencil_state_back);
+    process(ar, fmt.line_width);
+    process(ar, fmt.sample_count);
+    process(ar, fmt.sample_shading);
+    process(ar, fmt.min_sample_shading);
+    process(ar, fmt.blend_state);
+    process(ar, fmt.attachment_blend_states);
+    process(ar, fmt.view_mask);
+    process(ar, fmt.depth_attachment_format);
+    process(ar, fmt.stencil_attachment_format);
+    process(ar, fmt.subpass);
+    process(ar, fmt.base_pipeline_index);
+    process(ar, fmt.use_descriptor_buffer);
+    process(ar, fmt.dynamic_states);
+}
+
+template<typename Archive>
+void serialize(Archive &ar, vierkant::pipeline_manifest_t::shader_t &shader)
+{
+    process(ar, shader.stage);
+    process(ar, shader.code_index);
+    process(ar, shader.entry_point_name);
+}
+
+template<typename Archive>
+void serialize(Archive &ar, vierkant::pipeline_manifest_t::pipeline_t &pipeline)
+{
+    process(ar, pipeline.bind_point);
+    process(ar, pipeline.shaders);
+    process(ar, pipeline.set_layout_indices);
+    process(ar, pipeline.push_constant_ranges);
+    process(ar, pipeline.specialization);
+    process(ar, pipeline.max_recursion);
+
+    if(pipeline.bind_point == VK_PIPELINE_BIND_POINT_GRAPHICS)
+    {
+        process(ar, pipeline.graphics_info);
+        process(ar, pipeline.color_attachment_formats);
+    }
+}
+
+template<typename Archive>
+void serialize(Archive &ar, vierkant::pipeline_manifest_t &manifest)
+{
+    process(ar, manifest.shader_codes);
+    process(ar, manifest.set_layouts);
+    process(ar, manifest.pipelines);
+}
+
+}// namespace vierkant::serialization
+
+namespace vierkant
+{
+
+namespace
+{
+
+//! 'VKPM'
+constexpr uint32_t pipeline_manifest_magic = 0x4D504B56;
+
+//! format-version for pipeline-manifests. increment when serialized types change
+constexpr uint32_t pipeline_manifest_version = 2;
+
+struct manifest_header_t
+{
+    uint32_t magic = pipeline_manifest_magic;
+    uint32_t version = pipeline_manifest_version;
+};
+
+using serialization::input_archive_t;
+using serialization::output_archive_t;
+
+//! indices need to reference existing codes/layouts, binding-flags need to match bindings
+bool check_manifest(const pipeline_manifest_t &manifest)
+{
+    for(const auto &desc: manifest.set_layouts)
+    {
+        if(desc.binding_flags.size() != desc.bindings.size()) { return false; }
+    }
+    for(const auto &pipeline: manifest.pipelines)
+    {
+        for(const auto &shader: pipeline.shaders)
+        {
+            if(shader.code_index >= manifest.shader_codes.size()) { return false; }
+        }
+        for(auto idx: pipeline.set_layout_indices)
+        {
+            if(idx >= manifest.set_layouts.size()) { return false; }
+        }
+    }
+    return true;
+}
+
+}// namespace
+
+bool save_pipeline_manifest(const pipeline_manifest_t &manifest, const std::filesystem::path &path)
+{
+    output_archive_t ar;
+    manifest_header_t header = {};
+    ar.raw(&header, sizeof(header));
+    process(ar, const_cast<pipeline_manifest_t &>(manifest));
+
+    return vierkant::write_file_atomic(path, ar.bytes);
+}
+
+std::optional<pipeline_manifest_t> load_pipeline_manifest(const std::filesystem::path &path)
+{
+    auto mapped_file = vierkant::MappedFile::create(path);
+    if(!mapped_file || mapped_file->num_bytes() < sizeof(manifest_header_t)) { return {}; }
+
+    manifest_header_t header;
+    memcpy(&header, mapped_file->data(), sizeof(header));
+    if(header.magic != pipeline_manifest_magic || header.version != pipeline_manifest_version) { return {}; }
+
+    input_archive_t ar(mapped_file->bytes().subspan(sizeof(manifest_header_t)));
+    pipeline_manifest_t ret;
+    process(ar, ret);
+
+    if(!ar.complete() || !check_manifest(ret))
+    {
+        spdlog::warn("corrupted pipeline-manifest: {}", path.string());
+        return {};
+    }
+    return ret;
+}
+
+}// namespace vierkant
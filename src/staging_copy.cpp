@@ -4,42 +4,76 @@
 namespace vierkant
 {
 
-size_t staging_copy(staging_copy_context_t &context, const std::vector<staging_copy_info_t> &staging_copy_infos)
+size_t staging_copy(staging_copy_context_t &context, std::span<const staging_copy_info_t> staging_copy_infos)
 {
-    assert(context.command_buffer && context.staging_buffer);
-
-    // resize staging-buffer if necessary
-    size_t num_staging_bytes = context.offset;
-    for(const auto &info: staging_copy_infos) { num_staging_bytes += info.num_bytes; }
-    num_staging_bytes = std::max<size_t>(num_staging_bytes, 1UL << 20);
-    context.staging_buffer->set_data(nullptr, num_staging_bytes);
+    assert(context.command_buffer && (context.staging_buffer || context.staging_ring));
+
+    // resize staging-buffer to hold all remaining copies, starting at 'first_copy'
+    auto resize_staging_buffer = [&context, staging_copy_infos](size_t first_copy) {
+        size_t num_staging_bytes = context.offset;
+        for(const auto &info: staging_copy_infos.subspan(first_copy)) { num_staging_bytes += info.num_bytes; }
+        num_staging_bytes = std::max<size_t>(num_staging_bytes, 1UL << 20);
+        context.staging_buffer->set_data(nullptr, num_staging_bytes);
+    };
+    bool staging_buffer_resized = false;
 
     struct copy_asset_t
     {
-        std::vector<VkBufferCopy2> copies;
+        //! copies grouped by source-buffer (staging-ring or staging-buffer)
+        std::map<VkBuffer, std::vector<VkBufferCopy2>> copies;
         VkBufferMemoryBarrier2 barrier{};
     };
     std::map<vierkant::Buffer *, copy_asset_t> copy_assets;
 
-    for(const auto &info: staging_copy_infos)
+    for(size_t i = 0; i < staging_copy_infos.size(); ++i)
     {
+        const auto &info = staging_copy_infos[i];
         if(!info.data || !info.num_bytes || !info.dst_buffer) { continue; }
-        assert(context.staging_buffer->num_bytes() - info.num_bytes >= context.offset);
-
-        // copy array into staging-buffer
-        auto staging_data = static_cast<uint8_t *>(context.staging_buffer->map()) + context.offset;
-        memcpy(staging_data, info.data, info.num_bytes);
 
         VkBufferCopy2 copy_region = {};
         copy_region.sType = VK_STRUCTURE_TYPE_BUFFER_COPY_2;
         copy_region.size = info.num_bytes;
-        copy_region.srcOffset = context.offset;
         copy_region.dstOffset = info.dst_offset;
+        VkBuffer staging_buffer = VK_NULL_HANDLE;
 
-        auto &copy_asset = copy_assets[info.dst_buffer.get()];
-        copy_asset.copies.push_back(copy_region);
+        // sub-allocate from persistently mapped ring
+        if(context.staging_ring)
+        {
+            if(auto allocation = context.staging_ring->allocate(info.num_bytes))
+            {
+                memcpy(allocation.data, info.data, info.num_bytes);
+                copy_region.srcOffset = allocation.offset;
+                staging_buffer = allocation.buffer->handle();
+            }
+            else if(!context.staging_buffer)
+            {
+                spdlog::error("staging_copy: staging-ring exhausted ({} bytes requested)", info.num_bytes);
+                continue;
+            }
+        }
+
+        // no ring or ring exhausted -> fall back to staging-buffer
+        if(!staging_buffer)
+        {
+            if(!staging_buffer_resized)
+            {
+                resize_staging_buffer(i);
+                staging_buffer_resized = true;
+            }
+            assert(context.staging_buffer->num_bytes() - info.num_bytes >= context.offset);
+
+            // copy array into staging-buffer
+            auto staging_data = static_cast<uint8_t *>(context.staging_buffer->map()) + context.offset;
+            memcpy(staging_data, info.data, info.num_bytes);
+            copy_region.srcOffset = context.offset;
+            staging_buffer = context.staging_buffer->handle();
+
+            // only copies using the staging-buffer occupy its space
+            context.offset += info.num_bytes;
+        }
 
-        context.offset += info.num_bytes;
+        auto &copy_asset = copy_assets[info.dst_buffer.get()];
+        copy_asset.copies[staging_buffer].push_back(copy_region);
 
         if(info.dst_stage && info.dst_access)
         {
@@ -62,18 +96,24 @@ size_t staging_copy(staging_copy_context_t &context, const std::vector<staging_c
     for(auto &[buf, copy_asset]: copy_assets)
     {
         VkDeviceSize num_bytes = 0;
-        for(const auto &copy: copy_asset.copies) { num_bytes = std::max(num_bytes, copy.size + copy.dstOffset); }
+        for(const auto &[src, copies]: copy_asset.copies)
+        {
+            for(const auto &copy: copies) { num_bytes = std::max(num_bytes, copy.size + copy.dstOffset); }
+        }
 
         // resize if necessary
         buf->set_data(nullptr, num_bytes);
 
-        VkCopyBufferInfo2 copy_info2 = {};
-        copy_info2.sType = VK_STRUCTURE_TYPE_COPY_BUFFER_INFO_2;
-        copy_info2.srcBuffer = context.staging_buffer->handle();
-        copy_info2.dstBuffer = buf->handle();
-        copy_info2.regionCount = copy_asset.copies.size();
-        copy_info2.pRegions = copy_asset.copies.data();
-        vkCmdCopyBuffer2(context.command_buffer, &copy_info2);
+        for(const auto &[src, copies]: copy_asset.copies)
+        {
+            VkCopyBufferInfo2 copy_info2 = {};
+            copy_info2.sType = VK_STRUCTURE_TYPE_COPY_BUFFER_INFO_2;
+            copy_info2.srcBuffer = src;
+            copy_info2.dstBuffer = buf->handle();
+            copy_info2.regionCount = copies.size();
+            copy_info2.pRegions = copies.data();
+            vkCmdCopyBuffer2(context.command_buffer, &copy_info2);
+        }
 
         // potentially correct handle here (might have changed after growing), push barrier
         copy_asset.barrier.buffer = buf->handle();
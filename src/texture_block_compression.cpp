@@ -1,5 +1,7 @@
+#include <atomic>
 #include <cmath>
 #include <cstring>
+#include <thread>
 
 #include "rgbcx.h"
 #include "bc7decomp.h"
@@ -7,25 +9,20 @@
 
 //#include <bc7e/bc7e_avx2.h>
 
+#include <glm/gtc/packing.hpp>
+#include <spdlog/spdlog.h>
 #include <vierkant/texture_block_compression.hpp>
 
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define VIERKANT_BCN_SSE2 1
+#endif
+
 using duration_t = std::chrono::duration<float>;
 
 namespace vierkant::bcn
 {
 
-struct color_quad_u8
-{
-    union
-    {
-        uint8_t m_c[4];
-        struct
-        {
-            uint8_t r, g, b, a;
-        };
-    };
-};
-
 struct init_helper_t
 {
     init_helper_t()
@@ -36,121 +33,941 @@ struct init_helper_t
     }
 };
 
-inline void get_block(const crocore::Image_<uint8_t>::ConstPtr &img, uint32_t bx, uint32_t by, bool alpha,
-                      color_quad_u8 *pPixels)
+/**
+ * @brief   get_block gathers a 4x4 block of RGBA-texels.
+ *          single-channel images are replicated to RGB, missing channels are zero and missing alpha is 'one'.
+ */
+template<typename T>
+inline void get_block(const crocore::Image_<T> &img, uint32_t bx, uint32_t by, T one, T *pixels)
 {
     constexpr uint32_t width = 4, height = 4;
-    assert((bx * width + width) <= img->width());
-    assert((by * height + height) <= img->height());
+    assert((bx * width + width) <= img.width());
+    assert((by * height + height) <= img.height());
+    uint32_t num_components = img.num_components();
 
     for(uint32_t y = 0; y < height; ++y)
     {
-        //        memcpy(pPixels + y * width, img->at(bx * width, by * height + y), width * sizeof(color_quad_u8));
-
         for(uint32_t x = 0; x < width; ++x)
         {
-            auto in = img->at(bx * width + x, by * height + y);
-            color_quad_u8 &out = pPixels[y * width + x];
-            out.r = in[0];
-            out.g = in[1];
-            out.b = in[2];
-            out.a = alpha ? in[3] : 255;
+            auto in = img.at(bx * width + x, by * height + y);
+            T *out = pixels + 4 * (y * width + x);
+            out[0] = in[0];
+            out[1] = num_components == 1 ? in[0] : in[1];
+            out[2] = num_components == 1 ? in[0] : num_components == 2 ? T(0) : in[2];
+            out[3] = num_components == 4 ? in[3] : one;
+        }
+    }
+}
+
+void get_block(const crocore::Image_<uint8_t> &img, uint32_t bx, uint32_t by, uint8_t *pixels)
+{
+    assert((bx * 4 + 4) <= img.width());
+    assert((by * 4 + 4) <= img.height());
+    uint32_t num_components = img.num_components();
+
+#if VIERKANT_BCN_SSE2
+    if(num_components == 4 || num_components == 1)
+    {
+        const __m128i alpha = _mm_set1_epi32(static_cast<int32_t>(0xFF000000));
+
+        for(uint32_t y = 0; y < 4; ++y)
+        {
+            const uint8_t *row = img.at(4 * bx, 4 * by + y);
+            __m128i texels;
+
+            if(num_components == 4) { texels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row)); }
+            else
+            {
+                // replicate 4 single-channel values to RGB, alpha is 255
+                int32_t values;
+                memcpy(&values, row, sizeof(values));
+                texels = _mm_cvtsi32_si128(values);
+                texels = _mm_unpacklo_epi8(texels, texels);
+                texels = _mm_or_si128(_mm_unpacklo_epi16(texels, texels), alpha);
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(pixels + 16 * y), texels);
+        }
+        return;
+    }
+#else
+    if(num_components == 4)
+    {
+        for(uint32_t y = 0; y < 4; ++y) { memcpy(pixels + 16 * y, img.at(4 * bx, 4 * by + y), 16); }
+        return;
+    }
+#endif
+    get_block<uint8_t>(img, bx, by, 255, pixels);
+}
+
+namespace
+{
+
+//! 2x2 box-filter for a row of RGBA8-texels, reading 2 * out_width texels from two source-rows
+void box_row_rgba8(const uint8_t *row0, const uint8_t *row1, uint8_t *out, uint32_t out_width)
+{
+    uint32_t x = 0;
+
+#if VIERKANT_BCN_SSE2
+    const __m128i zero = _mm_setzero_si128(), two = _mm_set1_epi16(2);
+
+    // 8 source-texels per row -> 4 output-texels
+    for(; x + 4 <= out_width; x += 4)
+    {
+        auto load = [](const uint8_t *ptr) { return _mm_loadu_si128(reinterpret_cast<const __m128i *>(ptr)); };
+        __m128i a0 = load(row0 + 8 * x), a1 = load(row0 + 8 * x + 16);
+        __m128i b0 = load(row1 + 8 * x), b1 = load(row1 + 8 * x + 16);
+
+        // vertical sums in 16-bit, two texels per register
+        __m128i s0 = _mm_add_epi16(_mm_unpacklo_epi8(a0, zero), _mm_unpacklo_epi8(b0, zero));
+        __m128i s1 = _mm_add_epi16(_mm_unpackhi_epi8(a0, zero), _mm_unpackhi_epi8(b0, zero));
+        __m128i s2 = _mm_add_epi16(_mm_unpacklo_epi8(a1, zero), _mm_unpacklo_epi8(b1, zero));
+        __m128i s3 = _mm_add_epi16(_mm_unpackhi_epi8(a1, zero), _mm_unpackhi_epi8(b1, zero));
+
+        // horizontal sums of texel-pairs end up in the lower halves
+        s0 = _mm_add_epi16(s0, _mm_srli_si128(s0, 8));
+        s1 = _mm_add_epi16(s1, _mm_srli_si128(s1, 8));
+        s2 = _mm_add_epi16(s2, _mm_srli_si128(s2, 8));
+        s3 = _mm_add_epi16(s3, _mm_srli_si128(s3, 8));
+
+        // (sum + 2) / 4
+        __m128i lo = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(s0, s1), two), 2);
+        __m128i hi = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(s2, s3), two), 2);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 4 * x), _mm_packus_epi16(lo, hi));
+    }
+#endif
+
+    for(; x < out_width; ++x)
+    {
+        for(uint32_t c = 0; c < 4; ++c)
+        {
+            uint32_t sum = row0[8 * x + c] + row0[8 * x + 4 + c] + row1[8 * x + c] + row1[8 * x + 4 + c];
+            out[4 * x + c] = static_cast<uint8_t>((sum + 2) / 4);
+        }
+    }
+}
+
+//! lookup-tables for sRGB <-> linear conversions of 8-bit values
+struct srgb_tables_t
+{
+    float to_linear[256];
+    uint8_t to_srgb[4096];
+
+    srgb_tables_t()
+    {
+        for(uint32_t i = 0; i < 256; ++i)
+        {
+            float v = static_cast<float>(i) / 255.f;
+            to_linear[i] = v <= 0.04045f ? v / 12.92f : std::pow((v + 0.055f) / 1.055f, 2.4f);
+        }
+        for(uint32_t i = 0; i < 4096; ++i)
+        {
+            float v = static_cast<float>(i) / 4095.f;
+            v = v <= 0.0031308f ? v * 12.92f : 1.055f * std::pow(v, 1.f / 2.4f) - 0.055f;
+            to_srgb[i] = static_cast<uint8_t>(std::lround(std::clamp(v, 0.f, 1.f) * 255.f));
+        }
+    }
+};
+
+inline const srgb_tables_t &srgb_tables()
+{
+    static const srgb_tables_t tables;
+    return tables;
+}
+
+/**
+ * @brief   box_filter_2x2 halves the dimensions of an image using a 2x2 box-filter.
+ *          RGBA8-rows are filtered using SIMD, if available.
+ */
+template<typename T>
+crocore::ImagePtr box_filter_2x2(const crocore::Image_<T> &img, MipFilter filter)
+{
+    constexpr bool is_8bit = std::is_same_v<T, uint8_t>;
+    uint32_t width = img.width(), height = img.height(), num_components = img.num_components();
+    assert(num_components <= 4);
+
+    uint32_t out_width = std::max<uint32_t>(width / 2, 1), out_height = std::max<uint32_t>(height / 2, 1);
+    auto ret = crocore::Image_<T>::create(out_width, out_height, num_components);
+
+    uint32_t num_normal_channels = std::min<uint32_t>(num_components, 3);
+
+    // 8-bit normals are stored in [0, 255], unpacked to [-1, 1]
+    auto unpack = [](T v) { return is_8bit ? static_cast<float>(v) / 127.5f - 1.f : static_cast<float>(v); };
+    auto pack = [](float v) -> T {
+        if constexpr(is_8bit) { return static_cast<uint8_t>(std::lround(std::clamp(v * .5f + .5f, 0.f, 1.f) * 255.f)); }
+        else { return v; }
+    };
+
+    for(uint32_t y = 0; y < out_height; ++y)
+    {
+        uint32_t y0 = std::min(2 * y, height - 1), y1 = std::min(2 * y + 1, height - 1);
+
+        if constexpr(is_8bit)
+        {
+            if(filter == MipFilter::Box && num_components == 4 && width == 2 * out_width)
+            {
+                box_row_rgba8(img.at(0, y0), img.at(0, y1), ret->at(0, y), out_width);
+                continue;
+            }
+        }
+
+        for(uint32_t x = 0; x < out_width; ++x)
+        {
+            uint32_t x0 = std::min(2 * x, width - 1), x1 = std::min(2 * x + 1, width - 1);
+            const T *texels[4] = {img.at(x0, y0), img.at(x1, y0), img.at(x0, y1), img.at(x1, y1)};
+            T *out = ret->at(x, y);
+
+            for(uint32_t c = 0; c < num_components; ++c)
+            {
+                if constexpr(is_8bit)
+                {
+                    uint32_t sum = texels[0][c] + texels[1][c] + texels[2][c] + texels[3][c];
+                    out[c] = static_cast<uint8_t>((sum + 2) / 4);
+                }
+                else { out[c] = 0.25f * (texels[0][c] + texels[1][c] + texels[2][c] + texels[3][c]); }
+            }
+
+            if constexpr(is_8bit)
+            {
+                if(filter == MipFilter::BoxSRGB)
+                {
+                    // sRGB applies to color-channels, a trailing alpha-channel is linear
+                    const auto &tables = srgb_tables();
+                    uint32_t num_color_channels = num_components % 2 ? num_components : num_components - 1;
+
+                    for(uint32_t c = 0; c < num_color_channels; ++c)
+                    {
+                        float linear = 0.f;
+                        for(const T *texel: texels) { linear += 0.25f * tables.to_linear[texel[c]]; }
+                        out[c] = tables.to_srgb[std::lround(linear * 4095.f)];
+                    }
+                }
+            }
+
+            if(filter == MipFilter::BoxNormalMap)
+            {
+                glm::vec3 normal(0.f);
+                for(const T *texel: texels)
+                {
+                    for(uint32_t c = 0; c < num_normal_channels; ++c) { normal[c] += 0.25f * unpack(texel[c]); }
+                }
+
+                // renormalize, two-channel normals only need to stay within the unit-circle
+                float length = glm::length(normal);
+                if(length > 0.f && (num_normal_channels == 3 || length > 1.f)) { normal /= length; }
+                for(uint32_t c = 0; c < num_normal_channels; ++c) { out[c] = pack(normal[c]); }
+            }
+        }
+    }
+    return ret;
+}
+
+//! BC6H interpolation-weights for 4-bit indices
+constexpr uint32_t bc6h_weights[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+//! map a float to the space BC6H interpolates in: half-float bits, scaled to 16 bits ('finish_unquantize' inverse)
+inline float bc6h_interpolation_space(float v)
+{
+    constexpr float max_half = 65504.f;
+    uint16_t h = glm::packHalf1x16(std::isnan(v) ? 0.f : std::clamp(v, 0.f, max_half));
+    return static_cast<float>(h) * 64.f / 31.f;
+}
+
+//! unquantize a 10-bit unsigned endpoint-component
+inline uint32_t bc6h_unquantize(uint32_t q)
+{
+    if(q == 0) { return 0; }
+    if(q == 1023) { return 0xFFFF; }
+    return ((q << 15) + 0x4000) >> 9;
+}
+
+//! writes bit-fields into a 128-bit block, LSB first
+struct bit_writer_t
+{
+    block_t *block;
+    uint32_t pos = 0;
+
+    void write(uint32_t value, uint32_t num_bits)
+    {
+        for(uint32_t i = 0; i < num_bits; ++i, ++pos)
+        {
+            block->value[pos / 64] |= uint64_t((value >> i) & 1U) << (pos % 64);
+        }
+    }
+};
+
+//! reads bit-fields from a 128-bit block, LSB first
+struct bit_reader_t
+{
+    const block_t *block;
+    uint32_t pos = 0;
+
+    uint32_t read(uint32_t num_bits)
+    {
+        uint32_t ret = 0;
+        for(uint32_t i = 0; i < num_bits; ++i, ++pos)
+        {
+            ret |= uint32_t((block->value[pos / 64] >> (pos % 64)) & 1U) << i;
+        }
+        return ret;
+    }
+};
+
+/**
+ * @brief   encode_bc6h encodes a block of HDR-texels as BC6H (unsigned), using a single region
+ *          (mode 11, 10-bit endpoints, 4-bit indices). endpoints are fitted along the principal axis.
+ *
+ * @param   block   output-block
+ * @param   pixels  16 RGBA float-texels, alpha is ignored
+ */
+void encode_bc6h(block_t *block, const float *pixels)
+{
+    glm::vec3 values[16], mean(0.f);
+
+    for(uint32_t i = 0; i < 16; ++i)
+    {
+        values[i] = {bc6h_interpolation_space(pixels[4 * i]), bc6h_interpolation_space(pixels[4 * i + 1]),
+                     bc6h_interpolation_space(pixels[4 * i + 2])};
+        mean += values[i] / 16.f;
+    }
+
+    // principal axis via power-iteration on the covariance-matrix
+    glm::mat3 covariance(0.f);
+    for(const auto &v: values) { covariance += glm::outerProduct(v - mean, v - mean); }
+    glm::vec3 axis(1.f);
+
+    for(uint32_t i = 0; i < 8; ++i)
+    {
+        auto next = covariance * axis;
+        float len = glm::length(next);
+        if(len < 1.e-6f) { break; }
+        axis = next / len;
+    }
+    axis = glm::normalize(axis);
+
+    float t_min = std::numeric_limits<float>::max(), t_max = std::numeric_limits<float>::lowest();
+
+    for(const auto &v: values)
+    {
+        float t = glm::dot(v - mean, axis);
+        t_min = std::min(t_min, t);
+        t_max = std::max(t_max, t);
+    }
+    glm::vec3 endpoints_f[2] = {mean + axis * t_min, mean + axis * t_max};
+
+    // quantize endpoints to 10 bits
+    glm::uvec3 endpoints[2];
+    glm::vec3 unquantized[2];
+
+    for(uint32_t e = 0; e < 2; ++e)
+    {
+        for(uint32_t c = 0; c < 3; ++c)
+        {
+            float q = std::round((endpoints_f[e][c] - 32.f) / 64.f);
+            endpoints[e][c] = static_cast<uint32_t>(std::clamp(q, 0.f, 1023.f));
+            unquantized[e][c] = static_cast<float>(bc6h_unquantize(endpoints[e][c]));
+        }
+    }
+
+    // palette and closest indices
+    glm::vec3 palette[16];
+    for(uint32_t i = 0; i < 16; ++i)
+    {
+        auto w = static_cast<float>(bc6h_weights[i]);
+        palette[i] = glm::floor((unquantized[0] * (64.f - w) + unquantized[1] * w + 32.f) / 64.f);
+    }
+
+    uint32_t indices[16];
+
+    for(uint32_t i = 0; i < 16; ++i)
+    {
+        float best_dist = std::numeric_limits<float>::max();
+
+        for(uint32_t j = 0; j < 16; ++j)
+        {
+            auto diff = values[i] - palette[j];
+            float dist = glm::dot(diff, diff);
+            if(dist < best_dist)
+            {
+                best_dist = dist;
+                indices[i] = j;
+            }
+        }
+    }
+
+    // the anchor-index' MSB is implicitly zero, weights are symmetric -> swap endpoints and invert indices
+    if(indices[0] & 8U)
+    {
+        std::swap(endpoints[0], endpoints[1]);
+        for(auto &idx: indices) { idx = 15 - idx; }
+    }
+
+    *block = {};
+    bit_writer_t writer{block};
+
+    // mode 11
+    writer.write(0x03, 5);
+    for(const auto &endpoint: endpoints)
+    {
+        for(uint32_t c = 0; c < 3; ++c) { writer.write(endpoint[c], 10); }
+    }
+    writer.write(indices[0], 3);
+    for(uint32_t i = 1; i < 16; ++i) { writer.write(indices[i], 4); }
+}
+
+/**
+ * @brief   bc7_params maps a quality-level onto bc7enc's mode- and partition-search parameters.
+ *          lower levels evaluate fewer partitions for modes 1/7 and skip least-squares refinement,
+ *          'Slow' enables uber-search and an exhaustive partition-search.
+ */
+bc7enc_compress_block_params bc7_params(Quality quality)
+{
+    bc7enc_compress_block_params params;
+    bc7enc_compress_block_params_init(&params);
+
+    switch(quality)
+    {
+        case Quality::UltraFast:
+            params.m_max_partitions = 1;
+            params.m_try_least_squares = false;
+            break;
+        case Quality::VeryFast:
+            params.m_max_partitions = 4;
+            params.m_try_least_squares = false;
+            break;
+        case Quality::Fast: params.m_max_partitions = 16; break;
+        case Quality::Basic: break;
+        case Quality::Slow:
+            params.m_uber_level = 2;
+            params.m_mode17_partition_estimation_filterbank = false;
+            break;
+    }
+    return params;
+}
+
+//! maps a quality-level onto rgbcx's BC1/BC3 levels [0..18]
+inline uint32_t rgbcx_level(Quality quality)
+{
+    constexpr uint32_t levels[] = {0, 4, 8, 10, 18};
+    return levels[static_cast<uint32_t>(quality)];
+}
+
+//! number of previously encoded blocks searched by the BC7 rate-distortion post-pass
+constexpr uint32_t rdo_window_size = 16;
+
+//! sum of squared differences between a decoded BC7-block and 16 RGBA-texels
+inline float bc7_block_error(const uint8_t *block, const uint8_t *pixels)
+{
+    uint8_t decoded[64];
+    bc7decomp::unpack_bc7(block, reinterpret_cast<bc7decomp::color_rgba *>(decoded));
+
+    float err = 0.f;
+    for(uint32_t i = 0; i < 64; ++i)
+    {
+        auto d = static_cast<float>(decoded[i]) - static_cast<float>(pixels[i]);
+        err += d * d;
+    }
+    return err;
+}
+
+/**
+ * @brief   rdo_bc7_block is a rate-distortion post-pass for an encoded BC7-block, similar to bc7enc_rdo's ERT.
+ *          trailing bytes (mostly indices) are replaced by those of previously encoded blocks,
+ *          choosing the candidate minimizing J = error + lambda * num_unique_bytes.
+ *
+ * @param   block           an encoded BC7-block, modified in-place
+ * @param   pixels          16 RGBA-texels encoded by 'block'
+ * @param   num_previous    number of valid, previously encoded blocks preceding 'block' in memory
+ * @param   lambda          lagrangian multiplier, trading error for redundancy
+ */
+void rdo_bc7_block(uint8_t *block, const uint8_t *pixels, uint32_t num_previous, float lambda)
+{
+    constexpr uint32_t num_bytes = 16;
+    constexpr uint32_t match_lengths[] = {16, 12, 8};
+
+    float best_cost = bc7_block_error(block, pixels) + lambda * num_bytes;
+    uint8_t best[num_bytes], candidate[num_bytes];
+    memcpy(best, block, num_bytes);
+
+    for(uint32_t i = 1; i <= std::min(num_previous, rdo_window_size); ++i)
+    {
+        const uint8_t *previous = block - i * num_bytes;
+
+        for(uint32_t len: match_lengths)
+        {
+            uint32_t offset = num_bytes - len;
+            memcpy(candidate, block, offset);
+            memcpy(candidate + offset, previous + offset, len);
+
+            float cost = bc7_block_error(candidate, pixels) + lambda * static_cast<float>(offset);
+            if(cost < best_cost)
+            {
+                best_cost = cost;
+                memcpy(best, candidate, num_bytes);
+            }
+        }
+    }
+    memcpy(block, best, num_bytes);
+}
+
+/**
+ * @brief   decode_bc6h decodes a BC6H-block (unsigned) into HDR-texels.
+ *          only single-region blocks (mode 11) are supported, other modes decode to zero.
+ *
+ * @param   block   input-block
+ * @param   pixels  16 RGB float-texels
+ */
+void decode_bc6h(const block_t *block, float *pixels)
+{
+    bit_reader_t reader{block};
+
+    if(reader.read(5) != 0x03)
+    {
+        std::fill(pixels, pixels + 48, 0.f);
+        return;
+    }
+    glm::uvec3 endpoints[2];
+
+    for(auto &endpoint: endpoints)
+    {
+        for(uint32_t c = 0; c < 3; ++c) { endpoint[c] = bc6h_unquantize(reader.read(10)); }
+    }
+
+    for(uint32_t i = 0; i < 16; ++i)
+    {
+        uint32_t w = bc6h_weights[reader.read(i ? 4 : 3)];
+
+        for(uint32_t c = 0; c < 3; ++c)
+        {
+            // interpolate and 'finish_unquantize' into half-float bits
+            uint32_t v = (endpoints[0][c] * (64 - w) + endpoints[1][c] * w + 32) >> 6;
+            pixels[3 * i + c] = glm::unpackHalf1x16(static_cast<uint16_t>((v * 31) >> 6));
+        }
+    }
+}
+
+/**
+ * @brief   channel_quality computes psnr, ssim and max-error for a single channel.
+ *
+ * @param   ref     reference channel-values
+ * @param   values  channel-values to measure
+ * @param   width   width of the channel
+ * @param   height  height of the channel
+ * @param   peak    peak signal-value
+ * @param   out     an image_quality_t struct, will receive the channel's metrics
+ */
+void channel_quality(const std::vector<float> &ref, const std::vector<float> &values, uint32_t width, uint32_t height,
+                     float peak, image_quality_t &out)
+{
+    double sum_squares = 0.0;
+    float max_error = 0.f;
+
+    for(size_t i = 0; i < ref.size(); ++i)
+    {
+        float d = values[i] - ref[i];
+        sum_squares += d * d;
+        max_error = std::max(max_error, std::abs(d));
+    }
+    double mse = sum_squares / static_cast<double>(ref.size());
+    out.psnr.push_back(mse > 0.0 ? static_cast<float>(10.0 * std::log10(peak * peak / mse))
+                                 : std::numeric_limits<float>::infinity());
+    out.max_error.push_back(max_error);
+
+    // ssim over 8x8 windows with a stride of 4 texels
+    uint32_t window_x = std::min<uint32_t>(8, width), window_y = std::min<uint32_t>(8, height);
+    const double c1 = std::pow(0.01 * peak, 2.0), c2 = std::pow(0.03 * peak, 2.0);
+    const double n = window_x * window_y;
+    double ssim_sum = 0.0;
+    uint32_t num_windows = 0;
+
+    for(uint32_t y = 0; y + window_y <= height; y += 4)
+    {
+        for(uint32_t x = 0; x + window_x <= width; x += 4)
+        {
+            double sum_a = 0, sum_b = 0, sum_aa = 0, sum_bb = 0, sum_ab = 0;
+
+            for(uint32_t wy = y; wy < y + window_y; ++wy)
+            {
+                for(uint32_t wx = x; wx < x + window_x; ++wx)
+                {
+                    double a = ref[wy * width + wx], b = values[wy * width + wx];
+                    sum_a += a;
+                    sum_b += b;
+                    sum_aa += a * a;
+                    sum_bb += b * b;
+                    sum_ab += a * b;
+                }
+            }
+            double mean_a = sum_a / n, mean_b = sum_b / n;
+            double var_a = sum_aa / n - mean_a * mean_a, var_b = sum_bb / n - mean_b * mean_b;
+            double covar = sum_ab / n - mean_a * mean_b;
+            ssim_sum += ((2 * mean_a * mean_b + c1) * (2 * covar + c2)) /
+                        ((mean_a * mean_a + mean_b * mean_b + c1) * (var_a + var_b + c2));
+            num_windows++;
+        }
+    }
+    out.ssim.push_back(num_windows ? static_cast<float>(ssim_sum / num_windows) : 1.f);
+}
+
+template<typename T>
+image_quality_t image_quality(const crocore::Image_<T> &reference, const crocore::Image_<T> &image)
+{
+    image_quality_t ret;
+    uint32_t width = reference.width(), height = reference.height();
+    uint32_t num_channels = std::min(reference.num_components(), image.num_components());
+
+    // 8-bit values are normalized
+    constexpr float scale = std::is_same_v<T, uint8_t> ? 1.f / 255.f : 1.f;
+    std::vector<float> ref_values(width * height), values(width * height);
+
+    for(uint32_t c = 0; c < num_channels; ++c)
+    {
+        float peak = 0.f;
+
+        for(uint32_t y = 0; y < height; ++y)
+        {
+            for(uint32_t x = 0; x < width; ++x)
+            {
+                ref_values[y * width + x] = static_cast<float>(reference.at(x, y)[c]) * scale;
+                values[y * width + x] = static_cast<float>(image.at(x, y)[c]) * scale;
+                peak = std::max(peak, ref_values[y * width + x]);
+            }
         }
+        if(std::is_same_v<T, uint8_t> || peak <= 0.f) { peak = 1.f; }
+        channel_quality(ref_values, values, width, height, peak, ret);
     }
+    return ret;
 }
 
+}// namespace
+
 inline uint32_t round4(uint32_t v) { return (v + 3) & ~3; }
 
-bcn::compress_result_t compress(const compress_info_t &compress_info)
+//! next level of a mip-chain, box-filtered for exactly halved dimensions and resized otherwise
+crocore::ImageConstPtr mip_level(const crocore::ImageConstPtr &img, uint32_t width, uint32_t height, MipFilter filter)
 {
-    static init_helper_t init_helper;
+    if(img->width() == width && img->height() == height) { return img; }
 
-    assert(std::dynamic_pointer_cast<const crocore::Image_<uint8_t>>(compress_info.image) &&
-           compress_info.image->num_components() >= 3);
+    if(img->width() == 2 * width && img->height() == 2 * height)
+    {
+        if(auto ret = downsample_2x2(img, filter)) { return ret; }
+    }
+    return img->resize(width, height);
+}
 
-    auto start_time = std::chrono::steady_clock::now();
+//! BC5 encodes two channels, all other modes replicate single-channel images
+inline uint32_t min_num_components(CompressionMode mode) { return mode == BC5 ? 2 : 1; }
 
-    bc7enc_compress_block_params pack_params;
-    if(compress_info.mode == BC7) { bc7enc_compress_block_params_init(&pack_params); }
+//! a range of block-rows within a level of an image
+struct work_item_t
+{
+    uint32_t image_index = 0;
+    uint32_t level = 0;
+    uint32_t first_row = 0;
+    uint32_t end_row = 0;
+};
 
-    //    // faster(wtf!?) alternative bc7e
-    //    ispc::bc7e_compress_block_params bc7e_params = {};
-    //    ispc::bc7e_compress_block_params_init_basic(&bc7e_params, true);
+//! per-image state shared by all work-items of an image
+struct image_state_t
+{
+    std::vector<crocore::ImageConstPtr> levels;
+    bc7enc_compress_block_params pack_params = {};
+    std::atomic<uint32_t> num_pending_items = 0;
+};
 
-    uint32_t width = round4(compress_info.image->width());
-    uint32_t height = round4(compress_info.image->height());
+/**
+ * @brief   parallel_for_stealing runs a function for all indices in [0, num_items), using multiple workers.
+ *          the index-range is split into one contiguous segment per worker. workers running out of items
+ *          steal remaining items from other segments. the calling thread participates as first worker.
+ *
+ * @param   num_items       number of items
+ * @param   num_workers     number of workers, including the calling thread
+ * @param   delegate_fn     delegate used to run additional workers
+ * @param   fn              function to run for each index
+ */
+template<typename Fn>
+void parallel_for_stealing(size_t num_items, uint32_t num_workers, const vierkant::delegate_fn_t &delegate_fn,
+                           const Fn &fn)
+{
+    if(!num_items) { return; }
+    num_workers = delegate_fn ? std::clamp<uint32_t>(num_workers, 1, static_cast<uint32_t>(num_items)) : 1;
 
-    // lowest level will be a 4x4 pixel block
-    uint32_t max_levels = static_cast<uint32_t>(
-            std::max<int32_t>(0, static_cast<int32_t>(std::log2(std::max(width, height)) - 2)) + 1);
-    uint32_t num_levels = compress_info.generate_mipmaps ? max_levels : 1;
+    struct alignas(64) segment_t
+    {
+        std::atomic<size_t> next;
+        size_t end;
+    };
+    auto segments = std::make_unique<segment_t[]>(num_workers);
 
-    compress_result_t ret = {};
-    ret.mode = compress_info.mode;
-    ret.base_width = width;
-    ret.base_height = height;
-    ret.levels.resize(num_levels);
+    for(uint32_t w = 0; w < num_workers; ++w)
+    {
+        segments[w].next = num_items * w / num_workers;
+        segments[w].end = num_items * (w + 1) / num_workers;
+    }
 
-    auto source_image = std::dynamic_pointer_cast<const crocore::Image_<uint8_t>>(compress_info.image);
-    bool has_alpha = source_image->num_components() == 4;
+    auto worker = [num_workers, &segments, &fn](uint32_t w) {
+        // drain own segment first, then steal from others
+        for(uint32_t s = 0; s < num_workers; ++s)
+        {
+            auto &segment = segments[(w + s) % num_workers];
+            for(size_t i = segment.next++; i < segment.end; i = segment.next++) { fn(i); }
+        }
+    };
 
     std::vector<std::future<void>> tasks;
+    for(uint32_t w = 1; w < num_workers; ++w) { tasks.push_back(delegate_fn([&worker, w] { worker(w); })); }
+    worker(0);
+    for(const auto &t: tasks) { t.wait(); }
+}
+
+std::vector<compress_result_t> compress(const std::vector<compress_info_t> &compress_infos,
+                                        const vierkant::delegate_fn_t &delegate_fn, uint32_t num_workers)
+{
+    static init_helper_t init_helper;
+
+    auto start_time = std::chrono::steady_clock::now();
+    if(!num_workers) { num_workers = std::max(std::thread::hardware_concurrency(), 1U); }
+
+    std::vector<compress_result_t> ret(compress_infos.size());
+    std::vector<image_state_t> image_states(compress_infos.size());
+
+    // create mip-chains and allocate blocks, one item per image
+    parallel_for_stealing(compress_infos.size(), num_workers, delegate_fn, [&](size_t i) {
+        const auto &compress_info = compress_infos[i];
+        crocore::ImageConstPtr source_image = compress_info.image;
+        auto &result = ret[i];
+        result.mode = compress_info.mode;
+
+        // BC6H requires float-images, all other modes 8-bit images. mismatches result in empty levels
+        bool valid_type = compress_info.mode == BC6H
+                                  ? std::dynamic_pointer_cast<const crocore::Image_<float>>(source_image) != nullptr
+                                  : std::dynamic_pointer_cast<const crocore::Image_<uint8_t>>(source_image) != nullptr;
+        if(!valid_type || source_image->num_components() < min_num_components(compress_info.mode))
+        {
+            spdlog::error("bcn::compress: unsupported image for mode {}", static_cast<uint32_t>(compress_info.mode));
+            return;
+        }
+
+        uint32_t width = round4(source_image->width());
+        uint32_t height = round4(source_image->height());
+
+        // lowest level will be a 4x4 pixel block
+        uint32_t max_levels = static_cast<uint32_t>(
+                std::max<int32_t>(0, static_cast<int32_t>(std::log2(std::max(width, height)) - 2)) + 1);
+        uint32_t num_levels = compress_info.generate_mipmaps ? max_levels : 1;
+
+        result.base_width = width;
+        result.base_height = height;
+        result.levels.resize(num_levels);
+
+        auto &image_state = image_states[i];
+        image_state.pack_params = bc7_params(compress_info.quality);
 
-    for(auto &blocks: ret.levels)
+        for(auto &blocks: result.levels)
+        {
+            source_image = mip_level(source_image, width, height, compress_info.mip_filter);
+            image_state.levels.push_back(source_image);
+
+            // blocks are tightly packed, 64-bit blocks share a block_t
+            size_t num_bytes = (width / 4) * (height / 4) * block_size(compress_info.mode);
+            blocks.resize((num_bytes + sizeof(block_t) - 1) / sizeof(block_t));
+
+            width = std::max<uint32_t>(width / 2, 1);
+            height = std::max<uint32_t>(height / 2, 1);
+
+            // round to multiple of 4
+            width = round4(width);
+            height = round4(height);
+        }
+    });
+
+    // gather work-items for all images and levels, sized to roughly equal amounts of blocks
+    constexpr uint32_t num_blocks_per_item = 256;
+    std::vector<work_item_t> work_items;
+
+    for(uint32_t i = 0; i < ret.size(); ++i)
     {
-        source_image = std::dynamic_pointer_cast<const crocore::Image_<uint8_t>>(source_image->resize(width, height));
+        for(uint32_t lvl = 0; lvl < ret[i].levels.size(); ++lvl)
+        {
+            uint32_t num_blocks_x = image_states[i].levels[lvl]->width() / 4;
+            uint32_t num_blocks_y = image_states[i].levels[lvl]->height() / 4;
+            uint32_t num_rows_per_item = std::max<uint32_t>(num_blocks_per_item / num_blocks_x, 1);
+
+            for(uint32_t row = 0; row < num_blocks_y; row += num_rows_per_item)
+            {
+                work_items.push_back({i, lvl, row, std::min(row + num_rows_per_item, num_blocks_y)});
+                image_states[i].num_pending_items++;
+            }
+        }
+    }
 
-        uint32_t num_blocks_x = width / 4;
-        uint32_t num_blocks_y = height / 4;
-        blocks.resize(num_blocks_x * num_blocks_y);
+    // encode blocks for all images at once
+    parallel_for_stealing(work_items.size(), num_workers, delegate_fn, [&](size_t item_index) {
+        const auto &item = work_items[item_index];
+        const auto &compress_info = compress_infos[item.image_index];
+        auto &image_state = image_states[item.image_index];
+        auto &result = ret[item.image_index];
+        const auto &source_image = image_state.levels[item.level];
+        auto *blocks = reinterpret_cast<uint8_t *>(result.levels[item.level].data());
+        uint32_t num_blocks_x = source_image->width() / 4;
+        uint32_t num_block_bytes = block_size(result.mode);
+        uint32_t bc1_level = rgbcx_level(compress_info.quality);
+
+        // scratch-space for block-encoding
+        uint8_t pixels[64];
+        float pixels_f[64];
+
+        auto image_u8 = std::dynamic_pointer_cast<const crocore::Image_<uint8_t>>(source_image);
+        auto image_f = std::dynamic_pointer_cast<const crocore::Image_<float>>(source_image);
+
+        for(uint32_t by = item.first_row; by < item.end_row; by++)
+        {
+            for(uint32_t bx = 0; bx < num_blocks_x; bx++)
+            {
+                if(image_f) { get_block<float>(*image_f, bx, by, 1.f, pixels_f); }
+                else { get_block(*image_u8, bx, by, pixels); }
+                auto *pBlock = blocks + (bx + by * num_blocks_x) * num_block_bytes;
+
+                // encode one block
+                switch(result.mode)
+                {
+                    case BC1: rgbcx::encode_bc1(bc1_level, pBlock, pixels, true, false); break;
+                    case BC3: rgbcx::encode_bc3(bc1_level, pBlock, pixels); break;
+                    case BC4: rgbcx::encode_bc4(pBlock, pixels, 4); break;
+                    case BC5: rgbcx::encode_bc5(pBlock, pixels, 0, 1, 4); break;
+                    case BC6H: encode_bc6h(reinterpret_cast<block_t *>(pBlock), pixels_f); break;
+                    case BC7: bc7enc_compress_block(pBlock, pixels, &image_state.pack_params); break;
+                }
 
-        constexpr uint32_t num_rows_per_batch = 4;
-        const uint32_t num_batches = (num_blocks_y + num_rows_per_batch - 1) / num_rows_per_batch;
+                // optional rate-distortion post-pass, limited to preceding blocks of this work-item
+                if(result.mode == BC7 && compress_info.rdo_lambda > 0.f)
+                {
+                    uint32_t num_previous = (by - item.first_row) * num_blocks_x + bx;
+                    rdo_bc7_block(pBlock, pixels, num_previous, compress_info.rdo_lambda);
+                }
+            }
+        }
 
-        for(uint32_t i = 0; i < num_batches; i++)
+        // timing, measured until the last item of an image was encoded
+        if(--image_state.num_pending_items == 0)
         {
-            uint32_t first_row = i * num_rows_per_batch;
-            uint32_t end = std::min(num_blocks_y, (i + 1) * num_rows_per_batch);
+            result.duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() -
+                                                                                    start_time);
+        }
+    });
+    return ret;
+}
+
+bcn::compress_result_t compress(const compress_info_t &compress_info)
+{
+    return std::move(compress({compress_info}, compress_info.delegate_fn).front());
+}
+
+crocore::ImagePtr downsample_2x2(const crocore::ImageConstPtr &img, MipFilter filter)
+{
+    if(auto img_u8 = std::dynamic_pointer_cast<const crocore::Image_<uint8_t>>(img))
+    {
+        return box_filter_2x2(*img_u8, filter);
+    }
+    if(auto img_f = std::dynamic_pointer_cast<const crocore::Image_<float>>(img))
+    {
+        return box_filter_2x2(*img_f, filter);
+    }
+    return nullptr;
+}
+
+std::vector<crocore::ImagePtr> decompress(const compress_result_t &compress_result)
+{
+    static init_helper_t init_helper;
+
+    std::vector<crocore::ImagePtr> ret;
+    const auto mode = compress_result.mode;
+    uint32_t width = compress_result.base_width, height = compress_result.base_height;
+    uint32_t num_block_bytes = block_size(mode);
+    uint32_t num_components = mode == BC4 ? 1 : mode == BC5 ? 2 : 4;
+
+    for(const auto &level: compress_result.levels)
+    {
+        uint32_t num_blocks_x = width / 4, num_blocks_y = height / 4;
+        if(level.size() * sizeof(block_t) < num_blocks_x * num_blocks_y * num_block_bytes) { break; }
+        const auto *blocks = reinterpret_cast<const uint8_t *>(level.data());
 
-            // function to encode one row of compressed blocks
-            auto fn = [mode = compress_info.mode, first_row, end, num_blocks_x, source_image, has_alpha, &blocks,
-                       &pack_params] {
-                // scratch-space for block-encoding
-                color_quad_u8 pixels[16];
+        auto img_u8 = mode == BC6H ? nullptr : crocore::Image_<uint8_t>::create(width, height, num_components);
+        auto img_f = mode == BC6H ? crocore::Image_<float>::create(width, height, 3) : nullptr;
 
-                for(uint32_t by = first_row; by < end; by++)
+        // scratch-space for block-decoding
+        uint8_t pixels[64];
+        float pixels_f[48];
+
+        for(uint32_t by = 0; by < num_blocks_y; ++by)
+        {
+            for(uint32_t bx = 0; bx < num_blocks_x; ++bx)
+            {
+                const auto *pBlock = blocks + (bx + by * num_blocks_x) * num_block_bytes;
+
+                // decode one block
+                switch(mode)
                 {
-                    for(uint32_t bx = 0; bx < num_blocks_x; bx++)
+                    case BC1: rgbcx::unpack_bc1(pBlock, pixels, true); break;
+                    case BC3: rgbcx::unpack_bc3(pBlock, pixels); break;
+                    case BC4: rgbcx::unpack_bc4(pBlock, pixels, 4); break;
+                    case BC5: rgbcx::unpack_bc5(pBlock, pixels, 0, 1, 4); break;
+                    case BC6H: decode_bc6h(reinterpret_cast<const block_t *>(pBlock), pixels_f); break;
+                    case BC7: bc7decomp::unpack_bc7(pBlock, reinterpret_cast<bc7decomp::color_rgba *>(pixels)); break;
+                }
+
+                for(uint32_t i = 0; i < 16; ++i)
+                {
+                    uint32_t x = 4 * bx + i % 4, y = 4 * by + i / 4;
+                    if(img_f) { std::copy(pixels_f + 3 * i, pixels_f + 3 * i + 3, img_f->at(x, y)); }
+                    else
                     {
-                        get_block(source_image, bx, by, has_alpha, pixels);
-                        block_t *pBlock = &blocks[bx + by * num_blocks_x];
-
-                        // encode one block
-                        switch(mode)
-                        {
-                            case BC5: rgbcx::encode_bc5(pBlock, reinterpret_cast<uint8_t *>(pixels), 0, 1, 4); break;
-                            case BC7: bc7enc_compress_block(pBlock, pixels, &pack_params); break;
-                        }
+                        // BC1 is used for opaque RGB
+                        if(mode == BC1) { pixels[4 * i + 3] = 255; }
+                        std::copy(pixels + 4 * i, pixels + 4 * i + num_components, img_u8->at(x, y));
                     }
                 }
-            };
-            if(compress_info.delegate_fn) { tasks.push_back(compress_info.delegate_fn(fn)); }
-            else { fn(); }
+            }
         }
+        if(img_f) { ret.push_back(img_f); }
+        else { ret.push_back(img_u8); }
 
-        width = std::max<uint32_t>(width / 2, 1);
-        height = std::max<uint32_t>(height / 2, 1);
+        width = round4(std::max<uint32_t>(width / 2, 1));
+        height = round4(std::max<uint32_t>(height / 2, 1));
+    }
+    return ret;
+}
 
-        // round to multiple of 4
-        width = round4(width);
-        height = round4(height);
+image_quality_t image_quality(const crocore::ImageConstPtr &reference, const crocore::ImageConstPtr &image)
+{
+    if(!reference || !image || reference->width() != image->width() || reference->height() != image->height())
+    {
+        return {};
     }
-    for(const auto &t: tasks) { t.wait(); }
+    auto ref_u8 = std::dynamic_pointer_cast<const crocore::Image_<uint8_t>>(reference);
+    auto img_u8 = std::dynamic_pointer_cast<const crocore::Image_<uint8_t>>(image);
+    if(ref_u8 && img_u8) { return image_quality(*ref_u8, *img_u8); }
+
+    auto ref_f = std::dynamic_pointer_cast<const crocore::Image_<float>>(reference);
+    auto img_f = std::dynamic_pointer_cast<const crocore::Image_<float>>(image);
+    if(ref_f && img_f) { return image_quality(*ref_f, *img_f); }
+    return {};
+}
 
-    // timing
-    ret.duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time);
+std::vector<image_quality_t> image_quality(const crocore::ImageConstPtr &reference,
+                                           const compress_result_t &compress_result, MipFilter mip_filter)
+{
+    std::vector<image_quality_t> ret;
+    if(!reference) { return ret; }
+
+    crocore::ImageConstPtr reference_level = reference;
 
+    for(const auto &img: decompress(compress_result))
+    {
+        // same mip-chain as generated by compress()
+        reference_level = mip_level(reference_level, img->width(), img->height(), mip_filter);
+        ret.push_back(image_quality(reference_level, img));
+    }
     return ret;
 }
 
-}// namespace vierkant::bcn
\ No newline at end of file
+}// namespace vierkant::bcn
@@ -0,0 +1,552 @@
+// zlib-(de)compression for KTX2-supercompression. internal linkage avoids clashes with other stb-implementations,
+// needs to precede other includes that might pull in stb-headers
+#if defined(__clang__)
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunused-function"
+#pragma clang diagnostic ignored "-Wunused-parameter"
+#pragma clang diagnostic ignored "-Wsign-compare"
+#pragma clang diagnostic ignored "-Wimplicit-fallthrough"
+#pragma clang diagnostic ignored "-Wmissing-field-initializers"
+#elif defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+#pragma GCC diagnostic ignored "-Wimplicit-fallthrough"
+#pragma GCC diagnostic ignored "-Wmissing-field-initializers"
+#endif
+
+#define STB_IMAGE_STATIC
+#define STB_IMAGE_IMPLEMENTATION
+#define STBI_ONLY_PNG
+#define STBI_NO_STDIO
+#include "stb_image.h"
+
+#define STB_IMAGE_WRITE_STATIC
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#define STBI_WRITE_NO_STDIO
+#include "stb_image_write.h"
+
+#if defined(__clang__)
+#pragma clang diagnostic pop
+#elif defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+
+#include <cstring>
+#include <fstream>
+
+#include <spdlog/spdlog.h>
+#include <vierkant/mapped_file.hpp>
+#include <vierkant/texture_file.hpp>
+
+namespace vierkant::bcn
+{
+
+namespace
+{
+
+//! KTX2 file-identifier: «KTX 20»\r\n\x1A\n
+constexpr uint8_t ktx2_identifier[12] = {0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+
+struct ktx2_header_t
+{
+    uint8_t identifier[12];
+    uint32_t vk_format;
+    uint32_t type_size;
+    uint32_t pixel_width;
+    uint32_t pixel_height;
+    uint32_t pixel_depth;
+    uint32_t layer_count;
+    uint32_t face_count;
+    uint32_t level_count;
+    uint32_t supercompression_scheme;
+    uint32_t dfd_byte_offset;
+    uint32_t dfd_byte_length;
+    uint32_t kvd_byte_offset;
+    uint32_t kvd_byte_length;
+    uint64_t sgd_byte_offset;
+    uint64_t sgd_byte_length;
+};
+static_assert(sizeof(ktx2_header_t) == 80);
+
+struct ktx2_level_t
+{
+    uint64_t byte_offset;
+    uint64_t byte_length;
+    uint64_t uncompressed_byte_length;
+};
+
+struct dds_pixel_format_t
+{
+    uint32_t size;
+    uint32_t flags;
+    uint32_t four_cc;
+    uint32_t rgb_bit_count;
+    uint32_t bit_masks[4];
+};
+
+struct dds_header_t
+{
+    uint32_t size;
+    uint32_t flags;
+    uint32_t height;
+    uint32_t width;
+    uint32_t pitch_or_linear_size;
+    uint32_t depth;
+    uint32_t mip_map_count;
+    uint32_t reserved1[11];
+    dds_pixel_format_t pixel_format;
+    uint32_t caps;
+    uint32_t caps2;
+    uint32_t caps3;
+    uint32_t caps4;
+    uint32_t reserved2;
+};
+static_assert(sizeof(dds_header_t) == 124);
+
+struct dds_header_dx10_t
+{
+    uint32_t dxgi_format;
+    uint32_t resource_dimension;
+    uint32_t misc_flag;
+    uint32_t array_size;
+    uint32_t misc_flags2;
+};
+
+// DDS header-flags
+constexpr uint32_t DDSD_CAPS = 0x1, DDSD_HEIGHT = 0x2, DDSD_WIDTH = 0x4, DDSD_PIXELFORMAT = 0x1000,
+                   DDSD_MIPMAPCOUNT = 0x20000, DDSD_LINEARSIZE = 0x80000;
+constexpr uint32_t DDPF_FOURCC = 0x4;
+constexpr uint32_t DDSCAPS_COMPLEX = 0x8, DDSCAPS_TEXTURE = 0x1000, DDSCAPS_MIPMAP = 0x400000;
+constexpr uint32_t DDSCAPS2_CUBEMAP = 0x200, DDSCAPS2_CUBEMAP_ALL_FACES = 0xFC00;
+constexpr uint32_t DDS_DIMENSION_TEXTURE2D = 3, DDS_RESOURCE_MISC_TEXTURECUBE = 0x4;
+
+constexpr uint32_t four_cc(const char (&str)[5])
+{
+    return uint32_t(str[0]) | uint32_t(str[1]) << 8 | uint32_t(str[2]) << 16 | uint32_t(str[3]) << 24;
+}
+
+//! per-mode identifiers used by KTX2/DDS
+struct format_info_t
+{
+    CompressionMode mode;
+    VkFormat vk_format;
+    uint32_t dxgi_format;
+    uint32_t legacy_four_cc;
+    uint32_t df_color_model;
+};
+
+constexpr format_info_t format_infos[] = {
+        {BC1, VK_FORMAT_BC1_RGB_UNORM_BLOCK, 71, four_cc("DXT1"), 128},
+        {BC3, VK_FORMAT_BC3_UNORM_BLOCK, 77, four_cc("DXT5"), 130},
+        {BC4, VK_FORMAT_BC4_UNORM_BLOCK, 80, four_cc("ATI1"), 131},
+        {BC5, VK_FORMAT_BC5_UNORM_BLOCK, 83, four_cc("ATI2"), 132},
+        {BC6H, VK_FORMAT_BC6H_UFLOAT_BLOCK, 95, 0, 133},
+        {BC7, VK_FORMAT_BC7_UNORM_BLOCK, 98, 0, 134}};
+
+template<typename Pred>
+const format_info_t *find_format(Pred pred)
+{
+    for(const auto &info: format_infos)
+    {
+        if(pred(info)) { return &info; }
+    }
+    return nullptr;
+}
+
+//! number of bytes for a level, following the container's mip-chain (max(1, base >> level))
+inline size_t level_num_bytes(CompressionMode mode, uint32_t base_width, uint32_t base_height, uint32_t level)
+{
+    size_t width = std::max<uint32_t>(base_width >> level, 1), height = std::max<uint32_t>(base_height >> level, 1);
+    return ((width + 3) / 4) * ((height + 3) / 4) * block_size(mode);
+}
+
+inline size_t align(size_t v, size_t alignment) { return (v + alignment - 1) / alignment * alignment; }
+
+template<typename T>
+inline void append(std::vector<uint8_t> &out, const T &value)
+{
+    auto ptr = reinterpret_cast<const uint8_t *>(&value);
+    out.insert(out.end(), ptr, ptr + sizeof(T));
+}
+
+template<typename T>
+inline bool read_value(std::span<const uint8_t> data, size_t offset, T &value)
+{
+    if(offset > data.size() || sizeof(T) > data.size() - offset) { return false; }
+    memcpy(&value, data.data() + offset, sizeof(T));
+    return true;
+}
+
+//! allocate faces and levels for provided mode and dimensions
+std::vector<compress_result_t> create_faces(CompressionMode mode, uint32_t width, uint32_t height,
+                                            uint32_t num_faces, uint32_t num_levels)
+{
+    std::vector<compress_result_t> ret(num_faces);
+
+    for(auto &face: ret)
+    {
+        face.mode = mode;
+        face.base_width = (width + 3) & ~3U;
+        face.base_height = (height + 3) & ~3U;
+        face.levels.resize(num_levels);
+
+        for(uint32_t lvl = 0; lvl < num_levels; ++lvl)
+        {
+            size_t num_bytes = level_num_bytes(mode, width, height, lvl);
+            face.levels[lvl].resize((num_bytes + sizeof(block_t) - 1) / sizeof(block_t));
+        }
+    }
+    return ret;
+}
+
+bool write_file(const std::filesystem::path &path, const std::vector<uint8_t> &data)
+{
+    std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+    stream.write(reinterpret_cast<const char *>(data.data()), static_cast<std::streamsize>(data.size()));
+    if(!stream.good())
+    {
+        spdlog::error("could not write texture-file: {}", path.string());
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief   ktx2_dfd creates a basic data-format-descriptor for a block-compressed format.
+ *
+ * @param   mode                a block-compression mode
+ * @param   supercompressed     flag indicating that level-data is supercompressed
+ * @return  the descriptor as array of 32-bit words, including the leading total size
+ */
+std::vector<uint32_t> ktx2_dfd(CompressionMode mode, bool supercompressed)
+{
+    // KHR_DF channel-ids: BC3 alpha is stored in the first 64 bits, BC5 stores red/green
+    struct sample_t
+    {
+        uint32_t bit_offset;
+        uint32_t channel;
+    };
+    std::vector<sample_t> samples = {{0, 0}};
+    if(mode == BC3) { samples = {{0, 15}, {64, 0}}; }
+    else if(mode == BC5) { samples = {{0, 0}, {64, 1}}; }
+
+    const auto *format_info = find_format([mode](const auto &info) { return info.mode == mode; });
+    uint32_t num_block_bytes = block_size(mode);
+    uint32_t num_sample_bits = samples.size() > 1 ? 64 : 8 * num_block_bytes;
+    auto descriptor_size = static_cast<uint32_t>(24 + 16 * samples.size());
+
+    // color-primaries BT709, linear transfer-function, 4x4 texel-blocks
+    std::vector<uint32_t> ret = {4 + descriptor_size,
+                                 0,
+                                 2U | descriptor_size << 16,
+                                 format_info->df_color_model | 1U << 8 | 1U << 16,
+                                 3U | 3U << 8,
+                                 supercompressed ? 0 : num_block_bytes,
+                                 0};
+
+    for(const auto &sample: samples)
+    {
+        // BC6H carries a float-qualifier
+        uint32_t channel_type = sample.channel | (mode == BC6H ? 0x80U : 0U);
+        ret.push_back(sample.bit_offset | (num_sample_bits - 1) << 16 | channel_type << 24);
+        ret.push_back(0);
+        ret.push_back(0);
+        ret.push_back(mode == BC6H ? 0x477FE000 : 0xFFFFFFFF);
+    }
+    return ret;
+}
+
+}// namespace
+
+bool check_faces(const std::vector<compress_result_t> &faces)
+{
+    if(faces.size() != 1 && faces.size() != 6) { return false; }
+    const auto &base = faces.front();
+    if(!base.base_width || !base.base_height || base.levels.empty()) { return false; }
+
+    for(const auto &face: faces)
+    {
+        if(face.mode != base.mode || face.base_width != base.base_width || face.base_height != base.base_height ||
+           face.levels.size() != base.levels.size())
+        {
+            return false;
+        }
+
+        for(uint32_t lvl = 0; lvl < face.levels.size(); ++lvl)
+        {
+            size_t num_bytes = level_num_bytes(base.mode, base.base_width, base.base_height, lvl);
+            if(face.levels[lvl].size() != (num_bytes + sizeof(block_t) - 1) / sizeof(block_t)) { return false; }
+        }
+    }
+    return true;
+}
+
+VkFormat vk_format(CompressionMode mode)
+{
+    const auto *format_info = find_format([mode](const auto &info) { return info.mode == mode; });
+    return format_info ? format_info->vk_format : VK_FORMAT_UNDEFINED;
+}
+
+bool write_ktx2(const std::filesystem::path &path, const std::vector<compress_result_t> &faces,
+                Supercompression supercompression)
+{
+    if(!check_faces(faces))
+    {
+        spdlog::error("write_ktx2: incompatible faces or levels");
+        return false;
+    }
+    const auto &base = faces.front();
+    auto num_levels = static_cast<uint32_t>(base.levels.size());
+    bool supercompressed = supercompression != Supercompression::None;
+
+    // level-data, containing all faces of a level
+    std::vector<std::vector<uint8_t>> level_data(num_levels);
+    std::vector<ktx2_level_t> level_index(num_levels);
+
+    for(uint32_t lvl = 0; lvl < num_levels; ++lvl)
+    {
+        size_t num_bytes = level_num_bytes(base.mode, base.base_width, base.base_height, lvl);
+        auto &data = level_data[lvl];
+
+        for(const auto &face: faces)
+        {
+            auto ptr = reinterpret_cast<const uint8_t *>(face.levels[lvl].data());
+            data.insert(data.end(), ptr, ptr + num_bytes);
+        }
+        level_index[lvl].uncompressed_byte_length = data.size();
+
+        if(supercompression == Supercompression::Zlib)
+        {
+            int num_compressed_bytes = 0;
+            auto *compressed = stbi_zlib_compress(data.data(), static_cast<int>(data.size()), &num_compressed_bytes, 8);
+            if(!compressed) { return false; }
+            data.assign(compressed, compressed + num_compressed_bytes);
+            free(compressed);
+        }
+        level_index[lvl].byte_length = data.size();
+    }
+
+    auto dfd = ktx2_dfd(base.mode, supercompressed);
+
+    // key/value-data: {uint32_t length, key\0value\0}, padded to 4 bytes
+    constexpr char writer_key_value[] = "KTXwriter\0vierkant";
+    std::vector<uint8_t> kvd;
+    append(kvd, static_cast<uint32_t>(sizeof(writer_key_value)));
+    kvd.insert(kvd.end(), writer_key_value, writer_key_value + sizeof(writer_key_value));
+    kvd.resize(align(kvd.size(), 4), 0);
+
+    ktx2_header_t header = {};
+    memcpy(header.identifier, ktx2_identifier, sizeof(ktx2_identifier));
+    header.vk_format = vk_format(base.mode);
+    header.type_size = 1;
+    header.pixel_width = base.base_width;
+    header.pixel_height = base.base_height;
+    header.face_count = static_cast<uint32_t>(faces.size());
+    header.level_count = num_levels;
+    header.supercompression_scheme = static_cast<uint32_t>(supercompression);
+    header.dfd_byte_offset = static_cast<uint32_t>(sizeof(ktx2_header_t) + num_levels * sizeof(ktx2_level_t));
+    header.dfd_byte_length = static_cast<uint32_t>(dfd.size() * sizeof(uint32_t));
+    header.kvd_byte_offset = header.dfd_byte_offset + header.dfd_byte_length;
+    header.kvd_byte_length = static_cast<uint32_t>(kvd.size());
+
+    // levels are stored smallest first, aligned to the block-size unless supercompressed
+    size_t alignment = supercompressed ? 1 : block_size(base.mode);
+    size_t offset = header.kvd_byte_offset + header.kvd_byte_length;
+
+    for(uint32_t lvl = num_levels; lvl-- > 0;)
+    {
+        offset = align(offset, alignment);
+        level_index[lvl].byte_offset = offset;
+        offset += level_index[lvl].byte_length;
+    }
+
+    std::vector<uint8_t> out;
+    out.reserve(offset);
+    append(out, header);
+    for(const auto &level: level_index) { append(out, level); }
+    for(auto word: dfd) { append(out, word); }
+    out.insert(out.end(), kvd.begin(), kvd.end());
+
+    for(uint32_t lvl = num_levels; lvl-- > 0;)
+    {
+        out.resize(level_index[lvl].byte_offset, 0);
+        out.insert(out.end(), level_data[lvl].begin(), level_data[lvl].end());
+    }
+    return write_file(path, out);
+}
+
+std::optional<std::vector<compress_result_t>> read_ktx2(std::span<const uint8_t> data)
+{
+    ktx2_header_t header = {};
+    if(!read_value(data, 0, header) || memcmp(header.identifier, ktx2_identifier, sizeof(ktx2_identifier)) != 0)
+    {
+        return {};
+    }
+    const auto *format_info = find_format([&header](const auto &info) { return info.vk_format == header.vk_format; });
+    auto supercompression = static_cast<Supercompression>(header.supercompression_scheme);
+
+    if(!format_info || header.pixel_depth > 1 || header.layer_count > 1 ||
+       (header.face_count != 1 && header.face_count != 6) ||
+       (supercompression != Supercompression::None && supercompression != Supercompression::Zlib))
+    {
+        spdlog::warn("read_ktx2: unsupported format, dimensions or supercompression");
+        return {};
+    }
+    uint32_t num_levels = std::max(header.level_count, 1U);
+    auto ret = create_faces(format_info->mode, header.pixel_width, header.pixel_height, header.face_count, num_levels);
+
+    for(uint32_t lvl = 0; lvl < num_levels; ++lvl)
+    {
+        ktx2_level_t level = {};
+        if(!read_value(data, sizeof(ktx2_header_t) + lvl * sizeof(ktx2_level_t), level) ||
+           level.byte_offset > data.size() || level.byte_length > data.size() - level.byte_offset)
+        {
+            return {};
+        }
+        size_t num_bytes = level_num_bytes(format_info->mode, header.pixel_width, header.pixel_height, lvl);
+        const uint8_t *level_data = data.data() + level.byte_offset;
+        size_t level_size = level.byte_length;
+
+        // inflate supercompressed levels
+        std::unique_ptr<char, decltype(&free)> inflated(nullptr, &free);
+
+        if(supercompression == Supercompression::Zlib)
+        {
+            int num_inflated_bytes = 0;
+            inflated.reset(stbi_zlib_decode_malloc_guesssize_headerflag(
+                    reinterpret_cast<const char *>(level_data), static_cast<int>(level.byte_length),
+                    static_cast<int>(level.uncompressed_byte_length), &num_inflated_bytes, 1));
+            if(!inflated) { return {}; }
+            level_data = reinterpret_cast<const uint8_t *>(inflated.get());
+            level_size = static_cast<size_t>(num_inflated_bytes);
+        }
+        if(level_size < num_bytes * header.face_count) { return {}; }
+
+        for(uint32_t face = 0; face < header.face_count; ++face)
+        {
+            memcpy(ret[face].levels[lvl].data(), level_data + face * num_bytes, num_bytes);
+        }
+    }
+    return ret;
+}
+
+bool write_dds(const std::filesystem::path &path, const std::vector<compress_result_t> &faces)
+{
+    if(!check_faces(faces))
+    {
+        spdlog::error("write_dds: incompatible faces or levels");
+        return false;
+    }
+    const auto &base = faces.front();
+    auto num_levels = static_cast<uint32_t>(base.levels.size());
+    bool is_cube = faces.size() == 6;
+
+    dds_header_t header = {};
+    header.size = sizeof(dds_header_t);
+    header.flags = DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_LINEARSIZE |
+                   (num_levels > 1 ? DDSD_MIPMAPCOUNT : 0);
+    header.width = base.base_width;
+    header.height = base.base_height;
+    header.pitch_or_linear_size =
+            static_cast<uint32_t>(level_num_bytes(base.mode, base.base_width, base.base_height, 0));
+    header.mip_map_count = num_levels;
+    header.pixel_format.size = sizeof(dds_pixel_format_t);
+    header.pixel_format.flags = DDPF_FOURCC;
+    header.pixel_format.four_cc = four_cc("DX10");
+    header.caps = DDSCAPS_TEXTURE | (num_levels > 1 ? DDSCAPS_MIPMAP | DDSCAPS_COMPLEX : 0) |
+                  (is_cube ? DDSCAPS_COMPLEX : 0);
+    header.caps2 = is_cube ? DDSCAPS2_CUBEMAP | DDSCAPS2_CUBEMAP_ALL_FACES : 0;
+
+    dds_header_dx10_t header_dx10 = {};
+    header_dx10.dxgi_format = find_format([&base](const auto &info) { return info.mode == base.mode; })->dxgi_format;
+    header_dx10.resource_dimension = DDS_DIMENSION_TEXTURE2D;
+    header_dx10.misc_flag = is_cube ? DDS_RESOURCE_MISC_TEXTURECUBE : 0;
+    header_dx10.array_size = 1;
+
+    std::vector<uint8_t> out;
+    append(out, four_cc("DDS "));
+    append(out, header);
+    append(out, header_dx10);
+
+    // all levels of a face are stored consecutively
+    for(const auto &face: faces)
+    {
+        for(uint32_t lvl = 0; lvl < num_levels; ++lvl)
+        {
+            size_t num_bytes = level_num_bytes(base.mode, base.base_width, base.base_height, lvl);
+            auto ptr = reinterpret_cast<const uint8_t *>(face.levels[lvl].data());
+            out.insert(out.end(), ptr, ptr + num_bytes);
+        }
+    }
+    return write_file(path, out);
+}
+
+std::optional<std::vector<compress_result_t>> read_dds(std::span<const uint8_t> data)
+{
+    uint32_t magic = 0;
+    dds_header_t header = {};
+    if(!read_value(data, 0, magic) || magic != four_cc("DDS ") || !read_value(data, sizeof(magic), header) ||
+       header.size != sizeof(dds_header_t) || !(header.pixel_format.flags & DDPF_FOURCC))
+    {
+        return {};
+    }
+    size_t offset = sizeof(magic) + sizeof(dds_header_t);
+    const format_info_t *format_info = nullptr;
+    bool is_cube = false;
+
+    if(header.pixel_format.four_cc == four_cc("DX10"))
+    {
+        dds_header_dx10_t header_dx10 = {};
+        if(!read_value(data, offset, header_dx10) || header_dx10.array_size > 1) { return {}; }
+        offset += sizeof(dds_header_dx10_t);
+        format_info = find_format([&](const auto &info) { return info.dxgi_format == header_dx10.dxgi_format; });
+        is_cube = header_dx10.misc_flag & DDS_RESOURCE_MISC_TEXTURECUBE;
+    }
+    else
+    {
+        // legacy FourCCs, including aliases for BC4/BC5
+        uint32_t fourcc = header.pixel_format.four_cc;
+        if(fourcc == four_cc("BC4U")) { fourcc = four_cc("ATI1"); }
+        else if(fourcc == four_cc("BC5U")) { fourcc = four_cc("ATI2"); }
+        format_info = find_format([fourcc](const auto &info) { return info.legacy_four_cc == fourcc; });
+        is_cube = (header.caps2 & DDSCAPS2_CUBEMAP) && (header.caps2 & DDSCAPS2_CUBEMAP_ALL_FACES);
+    }
+
+    if(!format_info || (header.depth > 1 && !is_cube))
+    {
+        spdlog::warn("read_dds: unsupported format or dimensions");
+        return {};
+    }
+    uint32_t num_levels = (header.flags & DDSD_MIPMAPCOUNT) ? std::max(header.mip_map_count, 1U) : 1;
+    uint32_t num_faces = is_cube ? 6 : 1;
+    auto ret = create_faces(format_info->mode, header.width, header.height, num_faces, num_levels);
+
+    for(auto &face: ret)
+    {
+        for(uint32_t lvl = 0; lvl < num_levels; ++lvl)
+        {
+            size_t num_bytes = level_num_bytes(format_info->mode, header.width, header.height, lvl);
+            if(offset > data.size() || num_bytes > data.size() - offset) { return {}; }
+            memcpy(face.levels[lvl].data(), data.data() + offset, num_bytes);
+            offset += num_bytes;
+        }
+    }
+    return ret;
+}
+
+std::optional<std::vector<compress_result_t>> load_compressed_texture(const std::filesystem::path &path)
+{
+    auto mapped_file = vierkant::MappedFile::create(path);
+    if(!mapped_file) { return {}; }
+    auto bytes = mapped_file->bytes();
+
+    if(bytes.size() >= sizeof(ktx2_identifier) && !memcmp(bytes.data(), ktx2_identifier, sizeof(ktx2_identifier)))
+    {
+        return read_ktx2(bytes);
+    }
+    return read_dds(bytes);
+}
+
+}// namespace vierkant::bcn
@@ -0,0 +1,95 @@
+#include <thread>
+
+#include "test_context.hpp"
+#include <vierkant/AssetStreamer.hpp>
+
+//____________________________________________________________________________//
+
+//! a box, a generated texture and a material referencing it using a non-default sampler
+static vierkant::model::model_assets_t create_test_assets(vierkant::TextureId tex_id, vierkant::SamplerId sampler_id,
+                                                          vierkant::MaterialId mat_id)
+{
+    vierkant::model::model_assets_t assets = {};
+
+    vierkant::Mesh::entry_create_info_t entry_info = {};
+    entry_info.geometry = vierkant::Geometry::Box();
+    assets.geometry_data = std::vector{entry_info};
+    assets.textures[tex_id] = crocore::Image_<uint8_t>::create(16, 16, 4);
+
+    vierkant::texture_sampler_t sampler = {};
+    sampler.address_mode_u = vierkant::texture_sampler_t::AddressMode::CLAMP_TO_EDGE;
+    assets.texture_samplers[sampler_id] = sampler;
+
+    vierkant::material_t material = {};
+    material.id = mat_id;
+    material.texture_data[vierkant::TextureType::Color] = {.texture_id = tex_id, .sampler_id = sampler_id};
+    assets.materials = {material};
+    return assets;
+}
+
+TEST(AssetStreamer, stream_priority)
+{
+    vierkant::Sphere bounds(glm::vec3(0.f, 0.f, -10.f), 1.f);
+    float fovy = glm::radians(45.f);
+
+    // closer and larger objects are more important
+    float priority = vierkant::stream_priority(glm::vec3(0.f), bounds, fovy);
+    EXPECT_GT(priority, 0.f);
+    EXPECT_LT(vierkant::stream_priority(glm::vec3(0.f, 0.f, 10.f), bounds, fovy), priority);
+    EXPECT_GT(vierkant::stream_priority(glm::vec3(0.f), vierkant::Sphere(bounds.center, 2.f), fovy), priority);
+    EXPECT_TRUE(std::isinf(vierkant::stream_priority(bounds.center, bounds, fovy)));
+}
+
+TEST(AssetStreamer, stream)
+{
+    vulkan_test_context_t test_context;
+    crocore::ThreadPoolClassic pool(2);
+
+    for(auto *p: {static_cast<crocore::ThreadPoolClassic *>(nullptr), &pool})
+    {
+        const auto tex_id = vierkant::TextureId::random();
+        const auto sampler_id = vierkant::SamplerId::random();
+        const auto mat_id = vierkant::MaterialId::random();
+
+        vierkant::AssetStreamer::create_info_t create_info = {};
+        create_info.asset_provider = vierkant::AssetProvider::create();
+        create_info.load_params.device = test_context.device;
+        create_info.pool = p;
+
+        vierkant::MeshPtr mesh;
+        create_info.mesh_fn = [&mesh](vierkant::stream_handle_t, const vierkant::model::load_mesh_result_t &result) {
+            mesh = result.mesh;
+        };
+        auto streamer = vierkant::AssetStreamer::create(create_info);
+
+        auto handle = streamer->request(create_test_assets(tex_id, sampler_id, mat_id), 1.f);
+        auto failed = streamer->request("/does/not/exist.obj");
+        EXPECT_NE(streamer->state(handle), vierkant::StreamState::Invalid);
+
+        for(uint32_t i = 0; i < 1000 && !streamer->idle(); ++i)
+        {
+            streamer->update();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        ASSERT_TRUE(streamer->idle());
+        EXPECT_EQ(streamer->state(handle), vierkant::StreamState::Done);
+        EXPECT_EQ(streamer->state(failed), vierkant::StreamState::Failed);
+
+        // mesh, material and both texture-variants were published
+        ASSERT_TRUE(mesh);
+        const auto &provider = create_info.asset_provider;
+        EXPECT_TRUE(provider->mesh_asset(mesh->id));
+        EXPECT_TRUE(provider->material(mat_id));
+        EXPECT_TRUE(provider->texture({tex_id, vierkant::SamplerId::nil()}));
+        EXPECT_TRUE(provider->texture({tex_id, sampler_id}));
+        EXPECT_TRUE(provider->sampler(sampler_id));
+
+        auto stats = streamer->stats();
+        EXPECT_EQ(stats.cpu_bytes, 0);
+        EXPECT_GT(stats.gpu_bytes, 0);
+
+        streamer->release(handle);
+        EXPECT_EQ(streamer->state(handle), vierkant::StreamState::Invalid);
+        EXPECT_EQ(streamer->stats().gpu_bytes, 0);
+    }
+}
@@ -0,0 +1,146 @@
+#include <glm/gtc/random.hpp>
+#include <gtest/gtest.h>
+#include <vierkant/cluster_lod.hpp>
+
+//____________________________________________________________________________//
+
+inline vierkant::cluster_lod_t create_test_cluster_lod(const vierkant::GeometryConstPtr &geom)
+{
+    return vierkant::create_cluster_lod(&geom->positions[0].x, geom->positions.size(), sizeof(glm::vec3),
+                                        geom->indices.data(), geom->indices.size());
+}
+
+TEST(ClusterLod, empty)
+{
+    auto cluster_lod = vierkant::create_cluster_lod(nullptr, 0, sizeof(glm::vec3), nullptr, 0);
+    EXPECT_TRUE(cluster_lod.meshlets.empty());
+    EXPECT_EQ(cluster_lod.num_levels, 0);
+}
+
+TEST(ClusterLod, hierarchy)
+{
+    auto geom = vierkant::Geometry::IcoSphere(1.f, 5);
+    auto cluster_lod = create_test_cluster_lod(geom);
+
+    ASSERT_FALSE(cluster_lod.meshlets.empty());
+    EXPECT_EQ(cluster_lod.meshlets.size(), cluster_lod.meshlet_lods.size());
+    EXPECT_GT(cluster_lod.num_levels, 1);
+
+    size_t num_leaf_triangles = 0;
+    uint32_t num_roots = 0;
+
+    for(uint32_t i = 0; i < cluster_lod.meshlets.size(); ++i)
+    {
+        const auto &meshlet = cluster_lod.meshlets[i];
+        const auto &meshlet_lod = cluster_lod.meshlet_lods[i];
+
+        EXPECT_LE(meshlet.vertex_offset + meshlet.vertex_count, cluster_lod.meshlet_vertices.size());
+        EXPECT_LE(meshlet.triangle_offset + meshlet.triangle_count * 3, cluster_lod.meshlet_triangles.size());
+        EXPECT_LT(meshlet_lod.level, cluster_lod.num_levels);
+
+        if(!meshlet_lod.level)
+        {
+            EXPECT_EQ(meshlet_lod.error, 0.f);
+            num_leaf_triangles += meshlet.triangle_count;
+        }
+        if(meshlet_lod.parent_error == std::numeric_limits<float>::max()) { num_roots++; }
+    }
+    EXPECT_EQ(num_leaf_triangles, geom->indices.size() / 3);
+    EXPECT_GT(num_roots, 0);
+    EXPECT_LT(num_roots, cluster_lod.meshlets.size());
+}
+
+TEST(ClusterLod, error_monotonicity)
+{
+    auto geom = vierkant::Geometry::IcoSphere(1.f, 5);
+    auto cluster_lod = create_test_cluster_lod(geom);
+    ASSERT_FALSE(cluster_lod.meshlet_lods.empty());
+
+    constexpr float eps = 1.e-4f;
+
+    for(const auto &meshlet_lod: cluster_lod.meshlet_lods)
+    {
+        if(meshlet_lod.parent_error == std::numeric_limits<float>::max()) { continue; }
+
+        // parent-errors never decrease
+        EXPECT_GE(meshlet_lod.parent_error, meshlet_lod.error);
+
+        // parent-bounds enclose own bounds
+        float d = glm::length(meshlet_lod.parent_bounds.center - meshlet_lod.bounds.center);
+        EXPECT_LE(d + meshlet_lod.bounds.radius, meshlet_lod.parent_bounds.radius + eps);
+    }
+
+    // projected errors are monotonic for arbitrary view-positions
+    constexpr float proj_scale = 1000.f;
+
+    for(uint32_t i = 0; i < 100; ++i)
+    {
+        glm::vec3 eye = glm::sphericalRand(glm::linearRand(1.5f, 100.f));
+
+        for(const auto &meshlet_lod: cluster_lod.meshlet_lods)
+        {
+            float projected_error = vierkant::cluster_lod_projected_error(meshlet_lod.bounds, meshlet_lod.error, eye,
+                                                                          proj_scale);
+            float projected_parent_error = vierkant::cluster_lod_projected_error(
+                    meshlet_lod.parent_bounds, meshlet_lod.parent_error, eye, proj_scale);
+            EXPECT_GE(projected_parent_error * (1.f + eps), projected_error);
+        }
+    }
+}
+
+TEST(ClusterLod, select)
+{
+    auto geom = vierkant::Geometry::IcoSphere(1.f, 5);
+    auto cluster_lod = create_test_cluster_lod(geom);
+    ASSERT_FALSE(cluster_lod.meshlets.empty());
+
+    constexpr float proj_scale = 1000.f;
+    glm::vec3 eye = {0.f, 0.f, 10.f};
+
+    auto num_selected_triangles = [&cluster_lod, &eye](float threshold) {
+        size_t ret = 0;
+
+        for(uint32_t i = 0; i < cluster_lod.meshlets.size(); ++i)
+        {
+            if(vierkant::cluster_lod_select(cluster_lod.meshlet_lods[i], eye, proj_scale, threshold))
+            {
+                ret += cluster_lod.meshlets[i].triangle_count;
+            }
+        }
+        return ret;
+    };
+
+    // zero tolerance -> full resolution
+    EXPECT_EQ(num_selected_triangles(0.f), geom->indices.size() / 3);
+
+    // increasing tolerance -> fewer triangles
+    size_t last_count = geom->indices.size() / 3;
+
+    for(float threshold: {.1f, 1.f, 10.f, 1.e30f})
+    {
+        size_t count = num_selected_triangles(threshold);
+        EXPECT_GT(count, 0);
+        EXPECT_LE(count, last_count);
+        last_count = count;
+    }
+    EXPECT_LT(last_count, geom->indices.size() / 3);
+}
+
+TEST(ClusterLod, mesh_buffers)
+{
+    vierkant::Mesh::entry_create_info_t entry_create_info = {};
+    entry_create_info.geometry = vierkant::Geometry::IcoSphere(1.f, 4);
+
+    vierkant::mesh_buffer_params_t params = {};
+    params.generate_meshlets = true;
+    params.generate_cluster_lods = true;
+    auto bundle = vierkant::create_mesh_buffers({entry_create_info}, params);
+
+    ASSERT_EQ(bundle.entries.size(), 1);
+    EXPECT_EQ(bundle.meshlets.size(), bundle.meshlet_lods.size());
+
+    const auto &entry = bundle.entries.front();
+    EXPECT_GT(entry.num_cluster_meshlets, 0);
+    EXPECT_EQ(entry.base_cluster_meshlet, entry.lods.front().num_meshlets);
+    EXPECT_EQ(entry.base_cluster_meshlet + entry.num_cluster_meshlets, bundle.meshlets.size());
+}
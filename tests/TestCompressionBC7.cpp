@@ -1,4 +1,7 @@
+#include <numeric>
+
 #include "test_context.hpp"
+#include <spdlog/spdlog.h>
 #include <vierkant/texture_block_compression.hpp>
 
 // 4x4 black/white checkerboard RGBA
@@ -52,7 +55,8 @@ void check(const vierkant::bcn::compress_info_t &compress_info, const vierkant::
 
     for(uint32_t l = 0; l < compress_result.levels.size(); ++l)
     {
-        EXPECT_EQ(compress_result.levels[l].size(), num_blocks(width, height, l));
+        size_t num_bytes = num_blocks(width, height, l) * vierkant::bcn::block_size(compress_result.mode);
+        EXPECT_EQ(compress_result.levels[l].size(), (num_bytes + 15) / 16);
     }
 }
 
@@ -71,6 +75,80 @@ TEST(CompressionBC5, basic)
     check(compress_info, compress_result);
 }
 
+TEST(CompressionBC1_BC3, basic)
+{
+    auto img = crocore::Image_<uint8_t>::create(reinterpret_cast<uint8_t *>(checker_board_4x4), 4, 4, 4);
+    EXPECT_TRUE(img);
+
+    // odd number of 64-bit blocks per row
+    uint32_t width = 20, height = 36;
+    auto img8u = img->resize(width, height);
+
+    for(auto mode: {vierkant::bcn::BC1, vierkant::bcn::BC3})
+    {
+        vierkant::bcn::compress_info_t compress_info = {};
+        compress_info.mode = mode;
+        compress_info.image = img8u;
+        compress_info.generate_mipmaps = true;
+        auto compress_result = vierkant::bcn::compress(compress_info);
+        EXPECT_EQ(compress_result.mode, mode);
+        EXPECT_EQ(compress_result.levels.size(), num_levels(width, height));
+
+        // 45 blocks, 64-bit blocks are padded to a multiple of 128 bits
+        size_t num_bytes = num_blocks(width, height, 0) * vierkant::bcn::block_size(mode);
+        EXPECT_EQ(compress_result.levels[0].size() * 16, mode == vierkant::bcn::BC1 ? num_bytes + 8 : num_bytes);
+    }
+}
+
+TEST(CompressionBC4, single_channel)
+{
+    uint32_t width = 64, height = 32;
+    auto img = crocore::Image_<uint8_t>::create(width, height, 1);
+    auto data = static_cast<uint8_t *>(img->data());
+    for(uint32_t i = 0; i < width * height; ++i) { data[i] = static_cast<uint8_t>(i); }
+
+    vierkant::bcn::compress_info_t compress_info = {};
+    compress_info.mode = vierkant::bcn::BC4;
+    compress_info.image = img;
+    compress_info.generate_mipmaps = true;
+    auto compress_result = vierkant::bcn::compress(compress_info);
+    EXPECT_EQ(compress_result.levels.size(), num_levels(width, height));
+
+    // 4 bpp
+    EXPECT_EQ(compress_result.levels[0].size() * sizeof(vierkant::bcn::block_t), width * height / 2);
+}
+
+TEST(CompressionBC6H, hdr)
+{
+    uint32_t width = 32, height = 16;
+    auto img = crocore::Image_<float>::create(width, height, 3);
+    auto data = static_cast<float *>(img->data());
+    for(uint32_t i = 0; i < width * height * 3; ++i) { data[i] = static_cast<float>(i % 97) * 0.37f; }
+
+    vierkant::bcn::compress_info_t compress_info = {};
+    compress_info.mode = vierkant::bcn::BC6H;
+    compress_info.image = img;
+    auto compress_result = vierkant::bcn::compress(compress_info);
+    ASSERT_EQ(compress_result.levels.size(), 1);
+    ASSERT_EQ(compress_result.levels[0].size(), num_blocks(width, height, 0));
+
+    // single-region mode 11
+    for(const auto &block: compress_result.levels[0]) { EXPECT_EQ(block.value[0] & 0x1F, 0x03); }
+}
+
+TEST(CompressionBCn, mode_mismatch)
+{
+    // float-images require BC6H, 8-bit images any other mode
+    vierkant::bcn::compress_info_t compress_info = {};
+    compress_info.mode = vierkant::bcn::BC7;
+    compress_info.image = crocore::Image_<float>::create(16, 16, 3);
+    EXPECT_TRUE(vierkant::bcn::compress(compress_info).levels.empty());
+
+    compress_info.mode = vierkant::bcn::BC6H;
+    compress_info.image = crocore::Image_<uint8_t>::create(16, 16, 4);
+    EXPECT_TRUE(vierkant::bcn::compress(compress_info).levels.empty());
+}
+
 TEST(CompressionBC7, basic)
 {
     auto img = crocore::Image_<uint8_t>::create(reinterpret_cast<uint8_t *>(checker_board_4x4), 4, 4, 4);
@@ -128,4 +206,332 @@ TEST(CompressionBC7, odd_size)
     compress_info.generate_mipmaps = true;
     auto compress_result = vierkant::bcn::compress(compress_info);
     check(compress_info, compress_result);
-}
\ No newline at end of file
+}
+
+TEST(CompressionBC7, batch)
+{
+    auto img = crocore::Image_<uint8_t>::create(reinterpret_cast<uint8_t *>(checker_board_4x4), 4, 4, 4);
+    EXPECT_TRUE(img);
+
+    std::vector<vierkant::bcn::compress_info_t> compress_infos;
+
+    for(uint32_t i = 0; i < 8; ++i)
+    {
+        vierkant::bcn::compress_info_t compress_info = {};
+        compress_info.image = img->resize(16 + 37 * i, 300 - 29 * i);
+        compress_info.mode = i % 2 ? vierkant::bcn::BC5 : vierkant::bcn::BC7;
+        compress_info.generate_mipmaps = i % 3;
+        compress_infos.push_back(compress_info);
+    }
+
+    crocore::ThreadPoolClassic pool(4);
+    auto delegate_fn = [&pool](const std::function<void()> &fn) { return pool.post(fn); };
+    auto results = vierkant::bcn::compress(compress_infos, delegate_fn, 5);
+    ASSERT_EQ(results.size(), compress_infos.size());
+
+    for(uint32_t i = 0; i < compress_infos.size(); ++i)
+    {
+        EXPECT_EQ(results[i].mode, compress_infos[i].mode);
+        EXPECT_EQ(results[i].base_width, round4(compress_infos[i].image->width()));
+        EXPECT_EQ(results[i].base_height, round4(compress_infos[i].image->height()));
+
+        // identical to separately encoded images
+        auto single_result = vierkant::bcn::compress(compress_infos[i]);
+        ASSERT_EQ(single_result.levels.size(), results[i].levels.size());
+
+        for(uint32_t l = 0; l < single_result.levels.size(); ++l)
+        {
+            const auto &lhs = single_result.levels[l], &rhs = results[i].levels[l];
+            ASSERT_EQ(lhs.size(), rhs.size());
+            EXPECT_EQ(memcmp(lhs.data(), rhs.data(), lhs.size() * sizeof(vierkant::bcn::block_t)), 0);
+        }
+    }
+}
+
+//! mean PSNR over all channels of the base-level
+double mean_psnr(const crocore::ImageConstPtr &img, const vierkant::bcn::compress_result_t &compress_result)
+{
+    auto quality = vierkant::bcn::image_quality(img, compress_result);
+    if(quality.empty() || quality[0].psnr.empty()) { return 0.0; }
+    return std::accumulate(quality[0].psnr.begin(), quality[0].psnr.end(), 0.0) / quality[0].psnr.size();
+}
+
+//! smooth gradients with some noise, resembling natural images more than a checkerboard
+crocore::ImagePtr create_test_image(uint32_t width, uint32_t height)
+{
+    auto img = crocore::Image_<uint8_t>::create(width, height, 4);
+    auto data = static_cast<uint8_t *>(img->data());
+    uint32_t seed = 1;
+
+    for(uint32_t y = 0; y < height; ++y)
+    {
+        for(uint32_t x = 0; x < width; ++x)
+        {
+            seed = seed * 1664525U + 1013904223U;
+            auto *px = data + 4 * (y * width + x);
+            px[0] = static_cast<uint8_t>(x * 255 / width);
+            px[1] = static_cast<uint8_t>(y * 255 / height);
+            px[2] = static_cast<uint8_t>(128 + 64 * std::sin(0.1f * static_cast<float>(x + y)) + (seed >> 28));
+            px[3] = 255;
+        }
+    }
+    return img;
+}
+
+TEST(CompressionBC7, quality)
+{
+    uint32_t width = 256, height = 256;
+    auto img = create_test_image(width, height);
+
+    using vierkant::bcn::Quality;
+    double ultrafast_psnr = 0.0;
+
+    // report throughput and PSNR per quality-level
+    for(auto quality: {Quality::UltraFast, Quality::VeryFast, Quality::Fast, Quality::Basic, Quality::Slow})
+    {
+        vierkant::bcn::compress_info_t compress_info = {};
+        compress_info.image = img;
+        compress_info.quality = quality;
+        auto compress_result = vierkant::bcn::compress(compress_info);
+        ASSERT_EQ(compress_result.levels.size(), 1);
+
+        double psnr = mean_psnr(img, compress_result);
+        double secs = std::max(std::chrono::duration<double>(compress_result.duration).count(), 1.e-3);
+        spdlog::info("BC7 quality {}: {:.1f} Mpx/s - PSNR: {:.2f} dB", static_cast<uint32_t>(quality),
+                     width * height / secs * 1.e-6, psnr);
+
+        if(quality == Quality::UltraFast) { ultrafast_psnr = psnr; }
+        EXPECT_GT(psnr, 30.0);
+        EXPECT_GE(psnr, ultrafast_psnr - 0.01);
+    }
+}
+
+TEST(CompressionBC7, rdo)
+{
+    auto img = create_test_image(128, 128);
+
+    // count blocks sharing their trailing 8 bytes (mostly indices) with their predecessor
+    auto num_repeats = [](const std::vector<vierkant::bcn::block_t> &blocks) {
+        uint32_t ret = 0;
+        for(uint32_t i = 1; i < blocks.size(); ++i) { ret += blocks[i].value[1] == blocks[i - 1].value[1]; }
+        return ret;
+    };
+
+    vierkant::bcn::compress_info_t compress_info = {};
+    compress_info.image = img;
+    auto result = vierkant::bcn::compress(compress_info);
+
+    compress_info.rdo_lambda = 50.f;
+    auto result_rdo = vierkant::bcn::compress(compress_info);
+
+    double psnr = mean_psnr(img, result);
+    double psnr_rdo = mean_psnr(img, result_rdo);
+    spdlog::info("BC7 rdo: PSNR {:.2f} dB -> {:.2f} dB, repeated blocks: {} -> {}", psnr, psnr_rdo,
+                 num_repeats(result.levels[0]), num_repeats(result_rdo.levels[0]));
+
+    // more redundancy for a moderate loss in quality
+    EXPECT_GT(num_repeats(result_rdo.levels[0]), num_repeats(result.levels[0]));
+    EXPECT_LE(psnr_rdo, psnr + 0.01);
+    EXPECT_GT(psnr_rdo, psnr - 6.0);
+}
+
+TEST(CompressionBCn, decompress)
+{
+    uint32_t width = 64, height = 48;
+    auto img = create_test_image(width, height);
+
+    for(auto mode: {vierkant::bcn::BC1, vierkant::bcn::BC3, vierkant::bcn::BC4, vierkant::bcn::BC5,
+                    vierkant::bcn::BC7})
+    {
+        vierkant::bcn::compress_info_t compress_info = {};
+        compress_info.mode = mode;
+        compress_info.image = img;
+        compress_info.generate_mipmaps = true;
+        auto compress_result = vierkant::bcn::compress(compress_info);
+
+        auto images = vierkant::bcn::decompress(compress_result);
+        ASSERT_EQ(images.size(), compress_result.levels.size());
+        EXPECT_EQ(images[0]->width(), width);
+        EXPECT_EQ(images[0]->height(), height);
+        EXPECT_EQ(images.back()->width(), 4);
+
+        uint32_t num_channels = mode == vierkant::bcn::BC4 ? 1 : mode == vierkant::bcn::BC5 ? 2 : 4;
+        EXPECT_EQ(images[0]->num_components(), num_channels);
+
+        // metrics per level and channel
+        auto quality = vierkant::bcn::image_quality(img, compress_result);
+        ASSERT_EQ(quality.size(), images.size());
+
+        for(const auto &q: quality)
+        {
+            ASSERT_EQ(q.psnr.size(), num_channels);
+            ASSERT_EQ(q.ssim.size(), num_channels);
+            ASSERT_EQ(q.max_error.size(), num_channels);
+
+            for(uint32_t c = 0; c < num_channels; ++c)
+            {
+                EXPECT_GT(q.psnr[c], 25.f);
+                EXPECT_GT(q.ssim[c], 0.5f);
+                EXPECT_LE(q.max_error[c], 0.5f);
+            }
+        }
+    }
+}
+
+TEST(CompressionBC6H, decompress)
+{
+    uint32_t width = 32, height = 16;
+    auto img = crocore::Image_<float>::create(width, height, 3);
+    auto data = static_cast<float *>(img->data());
+    for(uint32_t i = 0; i < width * height * 3; ++i) { data[i] = 1.f + static_cast<float>(i % 3) * 0.5f; }
+
+    vierkant::bcn::compress_info_t compress_info = {};
+    compress_info.mode = vierkant::bcn::BC6H;
+    compress_info.image = img;
+    auto compress_result = vierkant::bcn::compress(compress_info);
+
+    auto images = vierkant::bcn::decompress(compress_result);
+    ASSERT_EQ(images.size(), 1);
+    auto decoded = std::dynamic_pointer_cast<crocore::Image_<float>>(images[0]);
+    ASSERT_TRUE(decoded);
+
+    // constant colors are reproduced within half-float precision
+    for(uint32_t c = 0; c < 3; ++c) { EXPECT_NEAR(decoded->at(5, 7)[c], img->at(5, 7)[c], 0.01f); }
+
+    auto quality = vierkant::bcn::image_quality(img, decoded);
+    ASSERT_EQ(quality.psnr.size(), 3);
+    for(float psnr: quality.psnr) { EXPECT_GT(psnr, 40.f); }
+}
+
+TEST(CompressionBCn, image_quality)
+{
+    auto img = create_test_image(32, 32);
+
+    // identical images
+    auto quality = vierkant::bcn::image_quality(img, img);
+    ASSERT_EQ(quality.psnr.size(), 4);
+    for(uint32_t c = 0; c < 4; ++c)
+    {
+        EXPECT_TRUE(std::isinf(quality.psnr[c]));
+        EXPECT_FLOAT_EQ(quality.ssim[c], 1.f);
+        EXPECT_EQ(quality.max_error[c], 0.f);
+    }
+
+    // incompatible images
+    EXPECT_TRUE(vierkant::bcn::image_quality(img, create_test_image(16, 16)).psnr.empty());
+}
+
+TEST(CompressionBCn, get_block)
+{
+    uint32_t width = 16, height = 8;
+
+    for(uint32_t num_components = 1; num_components <= 4; ++num_components)
+    {
+        auto img = crocore::Image_<uint8_t>::create(width, height, num_components);
+        auto data = static_cast<uint8_t *>(img->data());
+        for(uint32_t i = 0; i < width * height * num_components; ++i) { data[i] = static_cast<uint8_t>(i * 7); }
+
+        uint8_t pixels[64];
+        vierkant::bcn::get_block(*img, 3, 1, pixels);
+
+        // replicated single channels, zero for missing channels, 255 for missing alpha
+        for(uint32_t i = 0; i < 16; ++i)
+        {
+            const uint8_t *in = img->at(12 + i % 4, 4 + i / 4);
+            const uint8_t *out = pixels + 4 * i;
+            EXPECT_EQ(out[0], in[0]);
+            EXPECT_EQ(out[1], num_components == 1 ? in[0] : in[1]);
+            EXPECT_EQ(out[2], num_components == 1 ? in[0] : num_components == 2 ? 0 : in[2]);
+            EXPECT_EQ(out[3], num_components == 4 ? in[3] : 255);
+        }
+    }
+}
+
+TEST(CompressionBCn, downsample_2x2)
+{
+    // odd width covers the scalar remainder of SIMD-rows
+    uint32_t width = 46, height = 32;
+    auto img = create_test_image(width, height);
+    auto img8u = std::dynamic_pointer_cast<crocore::Image_<uint8_t>>(img);
+
+    auto downsampled = std::dynamic_pointer_cast<crocore::Image_<uint8_t>>(vierkant::bcn::downsample_2x2(img));
+    ASSERT_TRUE(downsampled);
+    ASSERT_EQ(downsampled->width(), width / 2);
+    ASSERT_EQ(downsampled->height(), height / 2);
+
+    // exact 2x2 averages
+    for(uint32_t y = 0; y < height / 2; ++y)
+    {
+        for(uint32_t x = 0; x < width / 2; ++x)
+        {
+            for(uint32_t c = 0; c < 4; ++c)
+            {
+                uint32_t sum = img8u->at(2 * x, 2 * y)[c] + img8u->at(2 * x + 1, 2 * y)[c] +
+                               img8u->at(2 * x, 2 * y + 1)[c] + img8u->at(2 * x + 1, 2 * y + 1)[c];
+                ASSERT_EQ(downsampled->at(x, y)[c], (sum + 2) / 4);
+            }
+        }
+    }
+
+    // close to the generic resize
+    auto quality = vierkant::bcn::image_quality(img->resize(width / 2, height / 2), downsampled);
+    ASSERT_EQ(quality.psnr.size(), 4);
+    for(float psnr: quality.psnr) { EXPECT_GT(psnr, 30.f); }
+
+    // float-images
+    auto img_f = crocore::Image_<float>::create(4, 4, 1);
+    auto data_f = static_cast<float *>(img_f->data());
+    for(uint32_t i = 0; i < 16; ++i) { data_f[i] = static_cast<float>(i); }
+    auto downsampled_f = std::dynamic_pointer_cast<crocore::Image_<float>>(vierkant::bcn::downsample_2x2(img_f));
+    ASSERT_TRUE(downsampled_f);
+    EXPECT_FLOAT_EQ(*downsampled_f->at(0, 0), (0.f + 1.f + 4.f + 5.f) / 4.f);
+}
+
+TEST(CompressionBCn, downsample_2x2_srgb_normals)
+{
+    // black/white columns average to mid-gray in linear space -> ~188 in sRGB
+    auto img = crocore::Image_<uint8_t>::create(2, 2, 4);
+    auto data = static_cast<uint8_t *>(img->data());
+    uint8_t texels[16] = {0, 0, 0, 255, 255, 255, 255, 255, 0, 0, 0, 255, 255, 255, 255, 255};
+    memcpy(data, texels, sizeof(texels));
+
+    auto box = std::dynamic_pointer_cast<crocore::Image_<uint8_t>>(vierkant::bcn::downsample_2x2(img));
+    auto srgb = std::dynamic_pointer_cast<crocore::Image_<uint8_t>>(
+            vierkant::bcn::downsample_2x2(img, vierkant::bcn::MipFilter::BoxSRGB));
+    ASSERT_TRUE(box && srgb);
+    EXPECT_EQ(box->at(0, 0)[0], 128);
+    EXPECT_NEAR(srgb->at(0, 0)[0], 188, 1);
+    EXPECT_EQ(srgb->at(0, 0)[3], 255);
+
+    // diverging normals (+x, -x) around +z: the box-average is shortened, renormalizing yields +z
+    uint8_t normals[16] = {255, 128, 128, 255, 0, 128, 128, 255, 128, 128, 255, 255, 128, 128, 255, 255};
+    memcpy(data, normals, sizeof(normals));
+    auto normal = std::dynamic_pointer_cast<crocore::Image_<uint8_t>>(
+            vierkant::bcn::downsample_2x2(img, vierkant::bcn::MipFilter::BoxNormalMap));
+    ASSERT_TRUE(normal);
+    glm::vec3 n(normal->at(0, 0)[0], normal->at(0, 0)[1], normal->at(0, 0)[2]);
+    n = n / 127.5f - 1.f;
+    EXPECT_NEAR(glm::length(n), 1.f, 0.02f);
+    EXPECT_GT(n.z, 0.99f);
+}
+
+TEST(CompressionBCn, mips_match_resize)
+{
+    auto img = create_test_image(128, 64);
+
+    vierkant::bcn::compress_info_t compress_info = {};
+    compress_info.image = img;
+    compress_info.generate_mipmaps = true;
+    auto compress_result = vierkant::bcn::compress(compress_info);
+    auto images = vierkant::bcn::decompress(compress_result);
+
+    // box-filtered mip-chain stays close to the chain of generic resizes
+    crocore::ImageConstPtr reference = img;
+
+    for(const auto &level: images)
+    {
+        reference = reference->resize(level->width(), level->height());
+        auto quality = vierkant::bcn::image_quality(reference, level);
+        for(float psnr: quality.psnr) { EXPECT_GT(psnr, 25.f); }
+    }
+}
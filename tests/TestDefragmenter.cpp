@@ -0,0 +1,108 @@
+#include "test_context.hpp"
+#include "vierkant/vierkant.hpp"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief   fill device-local buffers of a category, punch holes and run a defragmentation.
+ *          checks that buffers were relocated and their contents survived.
+ */
+void relocate_buffers(const vierkant::DevicePtr &device, vierkant::MemoryCategory category, bool default_pools)
+{
+    constexpr uint32_t num_buffers = 64;
+    constexpr size_t num_elements = 1U << 16;
+
+    std::vector<vierkant::BufferPtr> buffers;
+
+    for(uint32_t i = 0; i < num_buffers; ++i)
+    {
+        std::vector<uint32_t> data(num_elements, i);
+
+        vierkant::Buffer::create_info_t buffer_info = {};
+        buffer_info.device = device;
+        buffer_info.data = data.data();
+        buffer_info.num_bytes = data.size() * sizeof(uint32_t);
+        buffer_info.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+        buffer_info.mem_usage = VMA_MEMORY_USAGE_GPU_ONLY;
+        buffer_info.memory_category = category;
+        buffers.push_back(vierkant::Buffer::create(buffer_info));
+    }
+
+    // host-visible buffers stay in place
+    auto host_buffer = vierkant::Buffer::create(device, nullptr, num_elements * sizeof(uint32_t),
+                                                VK_BUFFER_USAGE_TRANSFER_DST_BIT, VMA_MEMORY_USAGE_CPU_ONLY);
+    VkBuffer host_handle = host_buffer->handle();
+
+    // punch holes
+    for(uint32_t i = 0; i < num_buffers; i += 2) { buffers[i].reset(); }
+
+    vierkant::Defragmenter::create_info_t create_info = {};
+    create_info.device = device;
+    create_info.default_pools = default_pools;
+    create_info.flags = VMA_DEFRAGMENTATION_FLAG_ALGORITHM_FULL_BIT;
+    create_info.max_allocations_per_pass = 4;
+    auto defragmenter = vierkant::Defragmenter::create(create_info);
+
+    std::vector<vierkant::Defragmenter::relocation_t> relocations;
+    defragmenter->relocation_delegate = [&relocations](const vierkant::Defragmenter::relocation_t &relocation) {
+        EXPECT_NE(relocation.old_handle, relocation.new_handle);
+        EXPECT_EQ(relocation.buffer->handle(), relocation.new_handle);
+        EXPECT_EQ(relocation.buffer->device_address(), relocation.new_device_address);
+        relocations.push_back(relocation);
+    };
+
+    uint32_t num_relocations = defragmenter->update(std::chrono::seconds(10));
+    EXPECT_GT(relocations.size(), 0);
+    EXPECT_EQ(num_relocations, relocations.size());
+    EXPECT_EQ(defragmenter->stats().num_allocations_moved, relocations.size());
+    EXPECT_EQ(host_buffer->handle(), host_handle);
+
+    // contents survived relocation
+    for(uint32_t i = 1; i < num_buffers; i += 2)
+    {
+        buffers[i]->copy_to(host_buffer);
+        auto ptr = static_cast<const uint32_t *>(host_buffer->map());
+        EXPECT_TRUE(std::all_of(ptr, ptr + num_elements, [i](uint32_t v) { return v == i; }));
+        host_buffer->unmap();
+    }
+}
+
+TEST(Defragmenter, relocate_buffers)
+{
+    vulkan_test_context_t test_context;
+    relocate_buffers(test_context.device, vierkant::MemoryCategory::UNDEFINED, true);
+}
+
+TEST(Defragmenter, memory_pools)
+{
+    vulkan_test_context_t test_context;
+
+    // separate device, using a dedicated memory-pool for meshes
+    vierkant::Device::create_info_t device_info = {};
+    device_info.instance = test_context.instance.handle();
+    device_info.physical_device = test_context.instance.physical_devices()[0];
+    device_info.use_validation = test_context.instance.use_validation_layers();
+    device_info.max_num_queues = 2;
+    device_info.memory_pool_block_sizes[vierkant::MemoryCategory::MESH] = 1UL << 23;
+    auto device = vierkant::Device::create(device_info);
+    EXPECT_TRUE(device->memory_pools().empty());
+
+    // pools are created on demand
+    auto buffer = vierkant::Buffer::create({.device = device,
+                                            .num_bytes = 1024,
+                                            .usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                            .mem_usage = VMA_MEMORY_USAGE_GPU_ONLY,
+                                            .memory_category = vierkant::MemoryCategory::MESH});
+    EXPECT_EQ(device->memory_pools().size(), 1);
+
+    // other categories use VMA's default pools
+    auto other_buffer = vierkant::Buffer::create({.device = device,
+                                                  .num_bytes = 1024,
+                                                  .usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                                  .mem_usage = VMA_MEMORY_USAGE_GPU_ONLY,
+                                                  .memory_category = vierkant::MemoryCategory::TEXTURE});
+    EXPECT_EQ(device->memory_pools().size(), 1);
+
+    // only visit the dedicated pool
+    relocate_buffers(device, vierkant::MemoryCategory::MESH, false);
+}
@@ -0,0 +1,95 @@
+#include "test_context.hpp"
+#include "vierkant/vierkant.hpp"
+#include <spdlog/stopwatch.h>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//! descriptors similar to a drawable: storage-buffers and a uniform-buffer
+static vierkant::descriptor_map_t create_descriptors(const std::vector<vierkant::BufferPtr> &buffers)
+{
+    vierkant::descriptor_map_t descriptors;
+    for(uint32_t i = 0; i < buffers.size(); ++i)
+    {
+        auto &desc = descriptors[i];
+        desc.type = i ? VK_DESCRIPTOR_TYPE_STORAGE_BUFFER : VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        desc.stage_flags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+        desc.buffers = {buffers[i]};
+    }
+    return descriptors;
+}
+
+TEST(TestDescriptor, find_or_create_descriptor_set)
+{
+    vulkan_test_context_t test_context;
+    const auto &device = test_context.device;
+
+    std::vector<vierkant::BufferPtr> buffers;
+    for(uint32_t i = 0; i < 4; ++i)
+    {
+        buffers.push_back(vierkant::Buffer::create(
+                device, nullptr, 256, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                VMA_MEMORY_USAGE_CPU_TO_GPU));
+    }
+    auto descriptors = create_descriptors(buffers);
+    auto set_layout = vierkant::create_descriptor_set_layout(device, descriptors);
+    auto pool = vierkant::create_descriptor_pool(
+            device, {{VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 16}, {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 64}}, 16);
+
+    vierkant::descriptor_set_map_t last, current;
+    auto descriptor_set = vierkant::find_or_create_descriptor_set(device, set_layout.get(), descriptors, pool, last,
+                                                                  current, false);
+    ASSERT_TRUE(descriptor_set);
+    EXPECT_EQ(current.size(), 1);
+    EXPECT_EQ(descriptor_set, vierkant::find_or_create_descriptor_set(device, set_layout.get(), descriptors, pool,
+                                                                      last, current, false));
+
+    // other resources -> new descriptor-set
+    auto other_descriptors = descriptors;
+    std::swap(other_descriptors[1].buffers, other_descriptors[2].buffers);
+    EXPECT_NE(descriptor_set, vierkant::find_or_create_descriptor_set(device, set_layout.get(), other_descriptors,
+                                                                      pool, last, current, false));
+    EXPECT_EQ(current.size(), 2);
+
+    // relaxed reuse ignores resources
+    auto relaxed_set = vierkant::find_or_create_descriptor_set(device, set_layout.get(), descriptors, pool, last,
+                                                               current, false, true);
+    EXPECT_EQ(relaxed_set, vierkant::find_or_create_descriptor_set(device, set_layout.get(), other_descriptors, pool,
+                                                                   last, current, false, true));
+    EXPECT_EQ(current.size(), 3);
+    EXPECT_EQ(vierkant::descriptor_hash(descriptors, true), vierkant::descriptor_hash(other_descriptors, true));
+
+    // next frame, descriptor-sets are moved over from last
+    last = std::move(current);
+    current = {};
+    EXPECT_EQ(descriptor_set, vierkant::find_or_create_descriptor_set(device, set_layout.get(), descriptors, pool,
+                                                                      last, current, false));
+    EXPECT_EQ(last.size(), 2);
+    EXPECT_EQ(current.size(), 1);
+
+    // micro-benchmark: lookups of existing descriptor-sets
+    constexpr uint32_t num_iterations = 100000;
+    {
+        spdlog::stopwatch sw;
+        for(uint32_t i = 0; i < num_iterations; ++i)
+        {
+            vierkant::find_or_create_descriptor_set(device, set_layout.get(), descriptors, pool, last, current, false);
+        }
+        spdlog::info("find_or_create_descriptor_set: {:.2f} M lookups/s", num_iterations / sw.elapsed().count() / 1e6);
+    }
+
+    // previous approach: copy + deep hash/compare in an unordered_map keyed by descriptor_map_t
+    {
+        std::unordered_map<vierkant::descriptor_map_t, vierkant::DescriptorSetPtr> map = {{descriptors,
+                                                                                           descriptor_set}};
+        uint32_t num_found = 0;
+        spdlog::stopwatch sw;
+        for(uint32_t i = 0; i < num_iterations; ++i)
+        {
+            auto descriptors_copy = descriptors;
+            num_found += map.contains(descriptors_copy);
+        }
+        EXPECT_EQ(num_found, num_iterations);
+        spdlog::info("copy + std::unordered_map<descriptor_map_t>: {:.2f} M lookups/s",
+                     num_iterations / sw.elapsed().count() / 1e6);
+    }
+}
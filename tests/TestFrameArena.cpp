@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+#include <unordered_map>
+#include <vierkant/FrameArena.hpp>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//! upstream-resource counting allocations
+struct counting_resource_t : public std::pmr::memory_resource
+{
+    size_t num_allocations = 0, num_deallocations = 0;
+
+    void *do_allocate(size_t num_bytes, size_t alignment) override
+    {
+        num_allocations++;
+        return std::pmr::new_delete_resource()->allocate(num_bytes, alignment);
+    }
+
+    void do_deallocate(void *p, size_t num_bytes, size_t alignment) override
+    {
+        num_deallocations++;
+        std::pmr::new_delete_resource()->deallocate(p, num_bytes, alignment);
+    }
+
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+TEST(FrameArena, allocate)
+{
+    counting_resource_t upstream;
+    {
+        vierkant::FrameArena::create_info_t create_info = {};
+        create_info.num_bytes = 1024;
+        create_info.upstream = &upstream;
+        auto arena = vierkant::FrameArena::create(create_info);
+        EXPECT_EQ(upstream.num_allocations, 1);
+        EXPECT_EQ(arena->capacity(), 1024);
+
+        // aligned bump-allocations
+        auto a = static_cast<uint8_t *>(arena->allocate(10, 1));
+        auto b = static_cast<uint8_t *>(arena->allocate(16, 16));
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(b) % 16, 0);
+        EXPECT_GE(b, a + 10);
+        EXPECT_EQ(arena->stats().num_allocations, 2);
+        EXPECT_EQ(arena->stats().num_bytes, static_cast<size_t>(b + 16 - a));
+
+        // deallocation is a no-op, reset reuses memory
+        arena->deallocate(a, 10, 1);
+        arena->reset();
+        EXPECT_EQ(arena->stats().num_allocations, 0);
+        EXPECT_EQ(arena->last_frame_stats().num_allocations, 2);
+        EXPECT_EQ(arena->allocate(10, 1), a);
+
+        // overflow into a new block
+        EXPECT_TRUE(arena->allocate(2000, 8));
+        EXPECT_EQ(upstream.num_allocations, 2);
+        EXPECT_EQ(arena->stats().num_upstream_allocations, 1);
+
+        // blocks are coalesced, following frames fit into a single block
+        arena->reset();
+        EXPECT_EQ(upstream.num_allocations, 3);
+        EXPECT_EQ(upstream.num_deallocations, 2);
+        EXPECT_GE(arena->capacity(), 2010);
+
+        for(uint32_t i = 0; i < 10; ++i)
+        {
+            EXPECT_TRUE(arena->allocate(10, 1));
+            EXPECT_TRUE(arena->allocate(2000, 8));
+            arena->reset();
+        }
+        EXPECT_EQ(upstream.num_allocations, 3);
+        EXPECT_EQ(arena->last_frame_stats().num_upstream_allocations, 0);
+    }
+    EXPECT_EQ(upstream.num_allocations, upstream.num_deallocations);
+}
+
+TEST(FrameArena, pmr_containers)
+{
+    counting_resource_t upstream;
+    vierkant::FrameArena::create_info_t create_info = {};
+    create_info.upstream = &upstream;
+    auto arena = vierkant::FrameArena::create(create_info);
+
+    for(uint32_t frame = 0; frame < 4; ++frame)
+    {
+        {
+            std::pmr::vector<uint32_t> values(arena.get());
+            std::pmr::unordered_map<uint32_t, std::pmr::vector<uint32_t>> map(arena.get());
+
+            for(uint32_t i = 0; i < 1000; ++i)
+            {
+                values.push_back(i);
+                map[i % 16].push_back(i);
+            }
+            EXPECT_EQ(values.size(), 1000);
+            EXPECT_EQ(map.size(), 16);
+            EXPECT_EQ(map[3].size(), 1000 / 16 + 1);
+
+            // nested containers use the arena as well
+            EXPECT_EQ(map[3].get_allocator().resource(), arena.get());
+            EXPECT_GT(arena->stats().num_allocations, 0);
+        }
+        arena->reset();
+    }
+
+    // no upstream-allocations in steady-state
+    EXPECT_EQ(arena->last_frame_stats().num_upstream_allocations, 0);
+}
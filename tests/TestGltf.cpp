@@ -0,0 +1,110 @@
+#include <cstring>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <vierkant/model/gltf.hpp>
+
+//____________________________________________________________________________//
+
+// a single triangle, using a sparse position-accessor and normalized tex-coords
+constexpr char test_gltf_json[] = R"({
+"asset": {"version": "2.0"},
+"scene": 0,
+"scenes": [{"nodes": [0]}],
+"nodes": [{"mesh": 0, "name": "triangle"}],
+"meshes": [{"primitives": [{"attributes": {"POSITION": 1, "TEXCOORD_0": 2}, "indices": 0}]}],
+"buffers": [{"byteLength": 72}],
+"bufferViews": [
+    {"buffer": 0, "byteOffset": 0, "byteLength": 6, "target": 34963},
+    {"buffer": 0, "byteOffset": 8, "byteLength": 36, "target": 34962},
+    {"buffer": 0, "byteOffset": 44, "byteLength": 12, "byteStride": 4, "target": 34962},
+    {"buffer": 0, "byteOffset": 56, "byteLength": 4},
+    {"buffer": 0, "byteOffset": 60, "byteLength": 12}
+],
+"accessors": [
+    {"bufferView": 0, "componentType": 5123, "count": 3, "type": "SCALAR"},
+    {"bufferView": 1, "componentType": 5126, "count": 3, "type": "VEC3", "min": [0, 0, 0], "max": [2, 1, 0],
+     "sparse": {"count": 1, "indices": {"bufferView": 3, "componentType": 5121}, "values": {"bufferView": 4}}},
+    {"bufferView": 2, "componentType": 5121, "normalized": true, "count": 3, "type": "VEC2"}
+]
+})";
+
+inline std::filesystem::path write_test_glb(const std::string &filename)
+{
+    std::vector<uint8_t> bin(72, 0);
+    const uint16_t indices[3] = {0, 1, 2};
+    const float positions[9] = {0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 1.f, 0.f};
+    const uint8_t tex_coords[12] = {0, 0, 0, 0, 255, 0, 0, 0, 0, 255, 0, 0};
+    const uint8_t sparse_indices[1] = {1};
+    const float sparse_values[3] = {2.f, 0.f, 0.f};
+
+    memcpy(bin.data(), indices, sizeof(indices));
+    memcpy(bin.data() + 8, positions, sizeof(positions));
+    memcpy(bin.data() + 44, tex_coords, sizeof(tex_coords));
+    memcpy(bin.data() + 56, sparse_indices, sizeof(sparse_indices));
+    memcpy(bin.data() + 60, sparse_values, sizeof(sparse_values));
+
+    // chunks are padded to 4 bytes
+    std::string json = test_gltf_json;
+    json.resize((json.size() + 3) & ~size_t(3), ' ');
+
+    auto write_u32 = [](std::ofstream &stream, uint32_t value) {
+        stream.write(reinterpret_cast<const char *>(&value), sizeof(value));
+    };
+
+    auto path = std::filesystem::temp_directory_path() / filename;
+    std::ofstream stream(path, std::ios::binary);
+    write_u32(stream, 0x46546C67);
+    write_u32(stream, 2);
+    write_u32(stream, static_cast<uint32_t>(12 + 8 + json.size() + 8 + bin.size()));
+    write_u32(stream, static_cast<uint32_t>(json.size()));
+    write_u32(stream, 0x4E4F534A);
+    stream.write(json.data(), static_cast<std::streamsize>(json.size()));
+    write_u32(stream, static_cast<uint32_t>(bin.size()));
+    write_u32(stream, 0x004E4942);
+    stream.write(reinterpret_cast<const char *>(bin.data()), static_cast<std::streamsize>(bin.size()));
+    return path;
+}
+
+TEST(Gltf, invalid)
+{
+    auto path = std::filesystem::temp_directory_path() / "vierkant_test_invalid.glb";
+    {
+        std::ofstream stream(path, std::ios::binary);
+        stream << "not a glb-file";
+    }
+    EXPECT_FALSE(vierkant::model::gltf(path));
+    std::filesystem::remove(path);
+}
+
+TEST(Gltf, glb)
+{
+    auto path = write_test_glb("vierkant_test_triangle.glb");
+
+    crocore::ThreadPoolClassic pool(2);
+
+    for(auto *p: {static_cast<crocore::ThreadPoolClassic *>(nullptr), &pool})
+    {
+        auto assets = vierkant::model::gltf(path, p);
+        ASSERT_TRUE(assets);
+
+        const auto &entries = std::get<std::vector<vierkant::Mesh::entry_create_info_t>>(assets->geometry_data);
+        ASSERT_EQ(entries.size(), 1);
+        EXPECT_EQ(entries.front().name, "triangle");
+
+        const auto &geom = entries.front().geometry;
+        ASSERT_TRUE(geom);
+        EXPECT_EQ(geom->indices, std::vector<vierkant::index_t>({0, 1, 2}));
+
+        // sparse accessor
+        ASSERT_EQ(geom->positions.size(), 3);
+        EXPECT_EQ(geom->positions[0], glm::vec3(0.f, 0.f, 0.f));
+        EXPECT_EQ(geom->positions[1], glm::vec3(2.f, 0.f, 0.f));
+        EXPECT_EQ(geom->positions[2], glm::vec3(0.f, 1.f, 0.f));
+
+        // normalized, interleaved
+        ASSERT_EQ(geom->tex_coords.size(), 3);
+        EXPECT_EQ(geom->tex_coords[1], glm::vec2(1.f, 0.f));
+        EXPECT_EQ(geom->tex_coords[2], glm::vec2(0.f, 1.f));
+    }
+    std::filesystem::remove(path);
+}
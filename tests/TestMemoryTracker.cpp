@@ -0,0 +1,95 @@
+#include "test_context.hpp"
+#include "vierkant/vierkant.hpp"
+#include <set>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST(MemoryTracker, categories)
+{
+    vulkan_test_context_t test_context;
+    auto &memory_tracker = test_context.device->memory_tracker();
+
+    constexpr size_t num_bytes = 1U << 16;
+    auto mesh_stats = memory_tracker.stats(vierkant::MemoryCategory::MESH);
+    auto staging_stats = memory_tracker.stats(vierkant::MemoryCategory::STAGING);
+    auto render_target_stats = memory_tracker.stats(vierkant::MemoryCategory::RENDER_TARGET);
+    {
+        // category derived from usage-flags
+        auto vertex_buffer = vierkant::Buffer::create(test_context.device, nullptr, num_bytes,
+                                                      VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VMA_MEMORY_USAGE_GPU_ONLY);
+        auto staging_buffer = vierkant::Buffer::create(test_context.device, nullptr, num_bytes,
+                                                       VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY);
+
+        EXPECT_EQ(memory_tracker.stats(vierkant::MemoryCategory::MESH).num_allocations,
+                  mesh_stats.num_allocations + 1);
+        EXPECT_GE(memory_tracker.stats(vierkant::MemoryCategory::MESH).num_bytes, mesh_stats.num_bytes + num_bytes);
+        EXPECT_GE(memory_tracker.stats(vierkant::MemoryCategory::STAGING).num_bytes,
+                  staging_stats.num_bytes + num_bytes);
+
+        // explicit category
+        vierkant::Buffer::create_info_t buffer_info = {};
+        buffer_info.device = test_context.device;
+        buffer_info.num_bytes = num_bytes;
+        buffer_info.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+        buffer_info.mem_usage = VMA_MEMORY_USAGE_GPU_ONLY;
+        buffer_info.memory_category = vierkant::MemoryCategory::MESH;
+        auto storage_buffer = vierkant::Buffer::create(buffer_info);
+        EXPECT_EQ(memory_tracker.stats(vierkant::MemoryCategory::MESH).num_allocations,
+                  mesh_stats.num_allocations + 2);
+
+        // growing a buffer replaces its allocation
+        storage_buffer->set_data(nullptr, 4 * num_bytes);
+        EXPECT_EQ(memory_tracker.stats(vierkant::MemoryCategory::MESH).num_allocations,
+                  mesh_stats.num_allocations + 2);
+        EXPECT_GE(memory_tracker.stats(vierkant::MemoryCategory::MESH).num_bytes,
+                  mesh_stats.num_bytes + 5 * num_bytes);
+
+        vierkant::Image::Format fmt = {};
+        fmt.extent = {256, 256, 1};
+        fmt.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+        auto color_attachment = vierkant::Image::create(test_context.device, fmt);
+        EXPECT_GE(memory_tracker.stats(vierkant::MemoryCategory::RENDER_TARGET).num_bytes,
+                  render_target_stats.num_bytes + 256 * 256 * 4);
+
+        // per-heap accounting
+        VkDeviceSize heap_bytes = 0;
+        auto heap_stats = memory_tracker.heap_stats();
+        EXPECT_FALSE(heap_stats.empty());
+        for(const auto &heap: heap_stats)
+        {
+            heap_bytes += memory_tracker.num_bytes(vierkant::MemoryCategory::MESH, heap.heap_index);
+            EXPECT_EQ(heap.category_bytes[static_cast<uint32_t>(vierkant::MemoryCategory::MESH)],
+                      memory_tracker.num_bytes(vierkant::MemoryCategory::MESH, heap.heap_index));
+            EXPECT_GE(heap.block_bytes, heap.category_bytes[static_cast<uint32_t>(vierkant::MemoryCategory::MESH)]);
+        }
+        EXPECT_EQ(heap_bytes, memory_tracker.stats(vierkant::MemoryCategory::MESH).num_bytes);
+    }
+
+    // all released
+    EXPECT_EQ(memory_tracker.stats(vierkant::MemoryCategory::MESH).num_bytes, mesh_stats.num_bytes);
+    EXPECT_EQ(memory_tracker.stats(vierkant::MemoryCategory::MESH).num_allocations, mesh_stats.num_allocations);
+    EXPECT_EQ(memory_tracker.stats(vierkant::MemoryCategory::STAGING).num_bytes, staging_stats.num_bytes);
+    EXPECT_EQ(memory_tracker.stats(vierkant::MemoryCategory::RENDER_TARGET).num_bytes,
+              render_target_stats.num_bytes);
+}
+
+TEST(MemoryTracker, budget_exceeded)
+{
+    vulkan_test_context_t test_context;
+    auto &memory_tracker = test_context.device->memory_tracker();
+
+    auto buffer = vierkant::Buffer::create(test_context.device, nullptr, 1U << 20, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                           VMA_MEMORY_USAGE_GPU_ONLY);
+
+    std::set<uint32_t> exceeded_heaps;
+    memory_tracker.budget_exceeded_delegate = [&exceeded_heaps](const vierkant::MemoryTracker::heap_stats_t &stats) {
+        EXPECT_GT(stats.budget, 0);
+        exceeded_heaps.insert(stats.heap_index);
+    };
+
+    // any usage exceeds the budget
+    memory_tracker.budget_threshold = 0.f;
+    memory_tracker.update();
+    EXPECT_FALSE(exceeded_heaps.empty());
+    memory_tracker.budget_exceeded_delegate = {};
+}
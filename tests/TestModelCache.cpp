@@ -0,0 +1,394 @@
+#include <fstream>
+#include <gtest/gtest.h>
+#include <vierkant/model/model_cache.hpp>
+#include <vierkant/model/model_loading.hpp>
+#include <vierkant/model/wavefront_obj.hpp>
+#include <vierkant/vertex_splicer.hpp>
+
+//____________________________________________________________________________//
+
+using entries_t = std::vector<vierkant::Mesh::entry_create_info_t>;
+
+inline vierkant::model::model_assets_t create_test_assets()
+{
+    vierkant::model::model_assets_t ret;
+
+    // two entries sharing a geometry
+    auto box = vierkant::Geometry::Box();
+    entries_t entries(2);
+    entries[0].name = "first";
+    entries[0].geometry = box;
+    entries[1].name = "second";
+    entries[1].geometry = box;
+    entries[1].material_index = 1;
+    entries[1].transform.translation = glm::vec3(1.f, 2.f, 3.f);
+    ret.geometry_data = entries;
+
+    auto img = crocore::Image_<uint8_t>::create(4, 4, 4);
+    auto img_data = static_cast<uint8_t *>(img->data());
+    for(uint32_t i = 0; i < img->num_bytes(); ++i) { img_data[i] = static_cast<uint8_t>(i); }
+    auto texture_id = vierkant::TextureId::random();
+    ret.textures[texture_id] = img;
+
+    vierkant::bcn::compress_result_t compressed;
+    compressed.base_width = compressed.base_height = 4;
+    compressed.levels = {{vierkant::bcn::block_t{}}};
+    ret.textures[vierkant::TextureId::random()] = compressed;
+
+    ret.materials.resize(2);
+    ret.materials[0].name = "red";
+    ret.materials[0].base_color = glm::vec4(1.f, 0.f, 0.f, 1.f);
+    ret.materials[1].id = vierkant::MaterialId::random();
+    ret.materials[1].roughness = 0.25f;
+    ret.materials[1].texture_data[vierkant::TextureType::Color] = {texture_id, {}, glm::mat4(2.f)};
+
+    vierkant::lightsource_t light;
+    light.id = vierkant::LightId::random();
+    light.name = "sun";
+    ret.lights.push_back(light);
+    ret.light_instances.push_back({{}, light.id});
+
+    // node-hierarchy and animation
+    auto root = std::make_shared<vierkant::nodes::node_t>();
+    root->name = "root";
+    auto child = std::make_shared<vierkant::nodes::node_t>();
+    child->name = "child";
+    child->index = 1;
+    child->parent = root;
+    root->children.push_back(child);
+    ret.root_node = root;
+
+    vierkant::nodes::node_animation_t animation;
+    animation.name = "wiggle";
+    animation.duration = 2.f;
+    animation.keys[child].positions[1.f] = {glm::vec3(1.f), {}, {}};
+    animation.keys[child].morph_weights[0.5f] = {{0.25, 0.75}, {}, {}};
+    ret.node_animations.push_back(animation);
+    return ret;
+}
+
+TEST(ModelCache, round_trip)
+{
+    auto assets = create_test_assets();
+    auto path = std::filesystem::temp_directory_path() / "vierkant_test_assets.vkmodel";
+    ASSERT_TRUE(vierkant::model::save_model_assets(assets, path, 42));
+
+    // key mismatch
+    EXPECT_FALSE(vierkant::model::load_model_assets(path, 23));
+
+    auto loaded = vierkant::model::load_model_assets(path, 42);
+    ASSERT_TRUE(loaded);
+
+    const auto &entries = std::get<entries_t>(loaded->geometry_data);
+    ASSERT_EQ(entries.size(), 2);
+    EXPECT_EQ(entries[1].name, "second");
+    EXPECT_EQ(entries[1].material_index, 1);
+    EXPECT_EQ(entries[1].transform.translation, glm::vec3(1.f, 2.f, 3.f));
+
+    // shared geometry is preserved
+    ASSERT_TRUE(entries[0].geometry);
+    EXPECT_EQ(entries[0].geometry, entries[1].geometry);
+    EXPECT_EQ(entries[0].geometry->positions, std::get<entries_t>(assets.geometry_data)[0].geometry->positions);
+    EXPECT_EQ(entries[0].geometry->indices, std::get<entries_t>(assets.geometry_data)[0].geometry->indices);
+
+    ASSERT_EQ(loaded->materials.size(), 2);
+    EXPECT_EQ(loaded->materials[0].name, "red");
+    EXPECT_EQ(loaded->materials[0].base_color, assets.materials[0].base_color);
+    EXPECT_EQ(loaded->materials[1].id, assets.materials[1].id);
+    EXPECT_EQ(loaded->materials[1].roughness, 0.25f);
+    const auto &texture_data = loaded->materials[1].texture_data.at(vierkant::TextureType::Color);
+    EXPECT_EQ(texture_data.texture_transform, glm::mat4(2.f));
+
+    ASSERT_EQ(loaded->textures.size(), 2);
+    auto img = std::get<crocore::ImagePtr>(loaded->textures.at(texture_data.texture_id));
+    auto src_img = std::get<crocore::ImagePtr>(assets.textures.at(texture_data.texture_id));
+    ASSERT_TRUE(img);
+    ASSERT_EQ(img->num_bytes(), src_img->num_bytes());
+    EXPECT_EQ(memcmp(img->data(), src_img->data(), img->num_bytes()), 0);
+
+    ASSERT_EQ(loaded->lights.size(), 1);
+    EXPECT_EQ(loaded->lights[0].name, "sun");
+    ASSERT_EQ(loaded->light_instances.size(), 1);
+    EXPECT_EQ(loaded->light_instances[0].light_id, loaded->lights[0].id);
+
+    ASSERT_TRUE(loaded->root_node);
+    ASSERT_EQ(loaded->root_node->children.size(), 1);
+    auto child = loaded->root_node->children.front();
+    EXPECT_EQ(child->name, "child");
+    EXPECT_EQ(child->parent, loaded->root_node);
+
+    ASSERT_EQ(loaded->node_animations.size(), 1);
+    const auto &animation = loaded->node_animations.front();
+    EXPECT_EQ(animation.name, "wiggle");
+    ASSERT_TRUE(animation.keys.contains(child));
+    EXPECT_EQ(animation.keys.at(child).positions.at(1.f).value, glm::vec3(1.f));
+    EXPECT_EQ(animation.keys.at(child).morph_weights.at(0.5f).value, std::vector<double>({0.25, 0.75}));
+
+    // truncated file
+    auto num_bytes = std::filesystem::file_size(path);
+    std::filesystem::resize_file(path, num_bytes / 2);
+    EXPECT_FALSE(vierkant::model::load_model_assets(path));
+    std::filesystem::remove(path);
+}
+
+TEST(ModelCache, load_cached)
+{
+    auto dir = std::filesystem::temp_directory_path() / "vierkant_test_model_cache";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir / "model");
+
+    auto path = dir / "model" / "triangle.obj";
+    {
+        std::ofstream stream(path, std::ios::binary);
+        stream << "o triangle\nv 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3\n";
+    }
+
+    vierkant::model::model_cache_params_t params = {};
+    params.cache_dir = dir / "cache";
+    params.compress_textures = false;
+
+    auto key = vierkant::model::model_cache_key(path, params);
+    EXPECT_NE(key, 0);
+
+    // parameters are part of the key
+    auto other_params = params;
+    other_params.id_seed = "other";
+    EXPECT_NE(key, vierkant::model::model_cache_key(path, other_params));
+
+    auto assets = vierkant::model::load_model_cached(path, params);
+    ASSERT_TRUE(assets);
+    EXPECT_FALSE(std::filesystem::is_empty(params.cache_dir));
+
+    // cache-hit
+    auto cached = vierkant::model::load_model_cached(path, params);
+    ASSERT_TRUE(cached);
+    const auto &entries = std::get<entries_t>(cached->geometry_data);
+    ASSERT_EQ(entries.size(), 1);
+    EXPECT_EQ(entries.front().name, "triangle");
+    EXPECT_EQ(entries.front().geometry->positions, std::get<entries_t>(assets->geometry_data)[0].geometry->positions);
+    EXPECT_EQ(cached->materials.front().id, assets->materials.front().id);
+
+    std::filesystem::remove_all(dir);
+}
+
+TEST(ModelCache, key_external_files)
+{
+    auto dir = std::filesystem::temp_directory_path() / "vierkant_test_model_cache_key";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+
+    auto write_file = [](const std::filesystem::path &path, const std::string &content) {
+        std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+        stream << content;
+    };
+    auto path = dir / "triangle.obj";
+    write_file(path, "mtllib triangle.mtl\nusemtl red\nv 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3\n");
+    write_file(dir / "triangle.mtl", "newmtl red\nKd 1 0 0\nmap_Kd -bm 0.5 red.png\n");
+    write_file(dir / "red.png", "not really a png");
+
+    auto files = vierkant::model::wavefront_obj_external_files(path);
+    ASSERT_EQ(files.size(), 2);
+    EXPECT_EQ(files[0], dir / "triangle.mtl");
+    EXPECT_EQ(files[1], dir / "red.png");
+
+    vierkant::model::model_cache_params_t params = {};
+    auto key = vierkant::model::model_cache_key(path, params);
+
+    // unrelated files do not affect the key
+    write_file(dir / "unrelated.txt", "unrelated");
+    EXPECT_EQ(key, vierkant::model::model_cache_key(path, params));
+
+    // referenced files do
+    write_file(dir / "red.png", "still not a png, but larger");
+    EXPECT_NE(key, vierkant::model::model_cache_key(path, params));
+
+    std::filesystem::remove_all(dir);
+}
+
+TEST(TextureCache, round_trip)
+{
+    auto dir = std::filesystem::temp_directory_path() / "vierkant_test_texture_cache";
+    std::filesystem::remove_all(dir);
+
+    auto img = crocore::Image_<uint8_t>::create(64, 64, 4);
+    auto img_data = static_cast<uint8_t *>(img->data());
+    for(uint32_t i = 0; i < img->num_bytes(); ++i) { img_data[i] = static_cast<uint8_t>(i * 7); }
+
+    vierkant::bcn::compress_info_t compress_info = {};
+    compress_info.image = img;
+    compress_info.mode = vierkant::bcn::BC7;
+    compress_info.generate_mipmaps = true;
+
+    // pixels and settings are part of the key
+    auto key = vierkant::model::texture_cache_key(compress_info);
+    EXPECT_NE(key, 0);
+    auto other_info = compress_info;
+    other_info.quality = vierkant::bcn::Quality::Fast;
+    EXPECT_NE(key, vierkant::model::texture_cache_key(other_info));
+    auto other_img = crocore::Image_<uint8_t>::create(64, 64, 4);
+    memcpy(other_img->data(), img->data(), img->num_bytes());
+    static_cast<uint8_t *>(other_img->data())[17]++;
+    other_info = compress_info;
+    other_info.image = other_img;
+    EXPECT_NE(key, vierkant::model::texture_cache_key(other_info));
+
+    vierkant::model::texture_cache_params_t cache_params = {};
+    cache_params.cache_dir = dir;
+
+    vierkant::model::model_assets_t assets;
+    auto texture_id = vierkant::TextureId::random();
+    assets.textures[texture_id] = img;
+    ASSERT_TRUE(vierkant::model::compress_textures(assets, nullptr, cache_params));
+    EXPECT_FALSE(vierkant::model::load_cached_texture(dir, key + 1));
+
+    // cache-hit returns identical blocks
+    auto cached = vierkant::model::load_cached_texture(dir, key);
+    ASSERT_TRUE(cached);
+    const auto &compressed = std::get<vierkant::bcn::compress_result_t>(assets.textures[texture_id]);
+    EXPECT_EQ(cached->mode, compressed.mode);
+    ASSERT_EQ(cached->levels.size(), compressed.levels.size());
+
+    for(uint32_t l = 0; l < compressed.levels.size(); ++l)
+    {
+        ASSERT_EQ(cached->levels[l].size(), compressed.levels[l].size());
+        EXPECT_EQ(memcmp(cached->levels[l].data(), compressed.levels[l].data(),
+                         compressed.levels[l].size() * sizeof(vierkant::bcn::block_t)),
+                  0);
+    }
+    std::filesystem::remove_all(dir);
+}
+
+TEST(TextureCache, trim)
+{
+    auto dir = std::filesystem::temp_directory_path() / "vierkant_test_texture_cache_trim";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+
+    vierkant::bcn::compress_result_t compressed;
+    compressed.mode = vierkant::bcn::BC7;
+    compressed.base_width = compressed.base_height = 4;
+    compressed.levels = {{vierkant::bcn::block_t{}}};
+
+    // entries with increasing access-times
+    auto now = std::filesystem::file_time_type::clock::now();
+    for(uint64_t key = 1; key <= 4; ++key)
+    {
+        ASSERT_TRUE(vierkant::model::store_cached_texture(dir, key, compressed));
+        std::filesystem::last_write_time(dir / std::format("{:016x}.ktx2", key),
+                                         now - std::chrono::hours(10 - key));
+    }
+    auto entry_size = std::filesystem::file_size(dir / std::format("{:016x}.ktx2", 1));
+
+    // a hit marks entry 1 as most recently used
+    EXPECT_TRUE(vierkant::model::load_cached_texture(dir, 1));
+    vierkant::model::trim_texture_cache(dir, 2 * entry_size);
+
+    EXPECT_TRUE(vierkant::model::load_cached_texture(dir, 1));
+    EXPECT_FALSE(vierkant::model::load_cached_texture(dir, 2));
+    EXPECT_FALSE(vierkant::model::load_cached_texture(dir, 3));
+    EXPECT_TRUE(vierkant::model::load_cached_texture(dir, 4));
+    std::filesystem::remove_all(dir);
+}
+
+TEST(OMMCache, round_trip)
+{
+    auto dir = std::filesystem::temp_directory_path() / "vierkant_test_omm_cache";
+    std::filesystem::remove_all(dir);
+
+    // alpha-masked boxes, sharing a color-texture with a circular cutout
+    vierkant::model::model_assets_t assets;
+    auto img = crocore::Image_<uint8_t>::create(64, 64, 4);
+    for(uint32_t y = 0; y < 64; ++y)
+    {
+        for(uint32_t x = 0; x < 64; ++x)
+        {
+            auto *px = img->at(x, y);
+            px[0] = px[1] = px[2] = 255;
+            px[3] = glm::length(glm::vec2(x, y) - glm::vec2(32.f)) < 20.f ? 255 : 0;
+        }
+    }
+    auto texture_id = vierkant::TextureId::random();
+    assets.textures[texture_id] = img;
+
+    assets.materials.resize(1);
+    assets.materials[0].blend_mode = vierkant::BlendMode::Mask;
+    assets.materials[0].texture_data[vierkant::TextureType::Color] = {texture_id, {}, glm::mat4(1.f)};
+
+    entries_t entries(3);
+    for(auto &entry: entries) { entry.geometry = vierkant::Geometry::Box(); }
+
+    vierkant::mesh_buffer_params_t mesh_buffer_params = {};
+    mesh_buffer_params.pack_vertices = true;
+    auto bundle = vierkant::create_mesh_buffers(entries, mesh_buffer_params);
+
+    vierkant::model::omm_gen_params_t omm_params = {};
+    auto omm_data = vierkant::model::generate_omm_data(assets, bundle, omm_params);
+    ASSERT_EQ(omm_data.size(), entries.size());
+
+    // parallel generation is deterministic
+    crocore::ThreadPoolClassic pool(4);
+    auto omm_data_parallel = vierkant::model::generate_omm_data(assets, bundle, omm_params, &pool);
+    ASSERT_EQ(omm_data_parallel.size(), omm_data.size());
+
+    for(uint32_t i = 0; i < omm_data.size(); ++i)
+    {
+        EXPECT_EQ(omm_data_parallel[i].entry_index, omm_data[i].entry_index);
+        EXPECT_EQ(omm_data_parallel[i].entry.data, omm_data[i].entry.data);
+        EXPECT_EQ(omm_data_parallel[i].entry.indices, omm_data[i].entry.indices);
+    }
+
+    // settings and alpha-texture contents are part of the key
+    auto key = vierkant::model::omm_cache_key(assets, bundle, omm_params);
+    EXPECT_EQ(key, vierkant::model::omm_cache_key(assets, bundle, omm_params));
+    auto other_params = omm_params;
+    other_params.max_level = 2;
+    EXPECT_NE(key, vierkant::model::omm_cache_key(assets, bundle, other_params));
+    img->at(32, 32)[3] = 0;
+    EXPECT_NE(key, vierkant::model::omm_cache_key(assets, bundle, omm_params));
+    img->at(32, 32)[3] = 255;
+
+    // normals do not affect micromaps
+    auto other_bundle = bundle;
+    reinterpret_cast<vierkant::packed_vertex_t *>(other_bundle.vertex_buffer.data())->normal ^= 1;
+    EXPECT_EQ(key, vierkant::model::omm_cache_key(assets, other_bundle, omm_params));
+
+    // cache-miss bakes and stores, cache-hit returns identical data
+    auto cached = vierkant::model::generate_omm_data_cached(assets, bundle, omm_params, dir, &pool);
+    EXPECT_FALSE(std::filesystem::is_empty(dir));
+    auto loaded = vierkant::model::load_omm_data(dir / std::format("{:016x}.vkomm", key), key);
+    ASSERT_TRUE(loaded);
+    ASSERT_EQ(loaded->size(), omm_data.size());
+
+    for(uint32_t i = 0; i < omm_data.size(); ++i)
+    {
+        EXPECT_EQ(cached[i].entry.data, omm_data[i].entry.data);
+        EXPECT_EQ((*loaded)[i].entry_index, omm_data[i].entry_index);
+        EXPECT_EQ((*loaded)[i].color_texture_id, texture_id);
+        EXPECT_EQ((*loaded)[i].entry.data, omm_data[i].entry.data);
+        EXPECT_EQ((*loaded)[i].entry.indices, omm_data[i].entry.indices);
+        EXPECT_EQ((*loaded)[i].entry.triangles.size(), omm_data[i].entry.triangles.size());
+    }
+    EXPECT_FALSE(vierkant::model::load_omm_data(dir / std::format("{:016x}.vkomm", key), key + 1));
+    std::filesystem::remove_all(dir);
+}
+
+TEST(TextureCache, compression_mode)
+{
+    // opaque albedo uses BC1, RGB and RGBA with alpha fully 255
+    auto img = crocore::Image_<uint8_t>::create(64, 64, 4);
+    auto img_data = static_cast<uint8_t *>(img->data());
+    for(uint32_t i = 0; i < img->num_bytes(); ++i) { img_data[i] = i % 4 == 3 ? 255 : static_cast<uint8_t>(i * 7); }
+    EXPECT_EQ(vierkant::model::compression_mode(img, false), vierkant::bcn::BC1);
+    EXPECT_EQ(vierkant::model::compression_mode(crocore::Image_<uint8_t>::create(64, 64, 3), false),
+              vierkant::bcn::BC1);
+
+    // translucent texels require BC7
+    img_data[4 * 100 + 3] = 128;
+    EXPECT_EQ(vierkant::model::compression_mode(img, false), vierkant::bcn::BC7);
+
+    EXPECT_EQ(vierkant::model::compression_mode(img, true), vierkant::bcn::BC5);
+    EXPECT_EQ(vierkant::model::compression_mode(crocore::Image_<uint8_t>::create(64, 64, 1), false),
+              vierkant::bcn::BC4);
+    EXPECT_EQ(vierkant::model::compression_mode(crocore::Image_<float>::create(64, 64, 3), false),
+              vierkant::bcn::BC6H);
+}
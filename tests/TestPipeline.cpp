@@ -1,7 +1,9 @@
 #include "test_context.hpp"
+#include <fstream>
 #include <unordered_map>
 
 #include "vierkant/PipelineCache.hpp"
+#include "vierkant/shaders_slang.hpp"
 #include "vierkant/vierkant.hpp"
 
 TEST(TestPipeline, Format)
@@ -103,4 +105,117 @@ TEST(TestPipeline, PipelineCache)
     // TODO: expected error here, make this obsolete
     // EXPECT_TRUE(test_context.validation_data.num_errors);
     // test_context.validation_data = {};
-}
\ No newline at end of file
+}
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST(TestPipeline, PipelineCachePersistent)
+{
+    vulkan_test_context_t test_context;
+    auto path = std::filesystem::temp_directory_path() / "vierkant_test_pipeline_cache.bin";
+    std::filesystem::remove(path);
+
+    // compute-pipeline matching the object-overlay shader
+    vierkant::descriptor_map_t descriptors;
+    descriptors[0].type = descriptors[1].type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    descriptors[2].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    for(auto &[binding, desc]: descriptors) { desc.stage_flags = VK_SHADER_STAGE_COMPUTE_BIT; }
+    auto set_layout = vierkant::create_descriptor_set_layout(test_context.device, descriptors);
+
+    vierkant::compute_pipeline_info_t fmt = {};
+    fmt.shader_stage = vierkant::create_shader_module(vierkant::slang_shaders::slang::object_overlay_slang);
+    fmt.descriptor_set_layouts = {set_layout.get()};
+
+    {
+        auto cache = vierkant::PipelineCache::create(test_context.device, path);
+        EXPECT_TRUE(cache->handle());
+        EXPECT_EQ(cache->stats().num_loaded_bytes, 0);
+
+        auto pipeline = cache->pipeline(fmt);
+        EXPECT_TRUE(pipeline);
+        EXPECT_TRUE(cache->has(fmt));
+        EXPECT_EQ(pipeline, cache->pipeline(fmt));
+
+        auto stats = cache->stats();
+        EXPECT_EQ(stats.num_misses, 1);
+        EXPECT_EQ(stats.num_hits, 1);
+
+        // merging caches used by other threads/renderers
+        auto other_cache = vierkant::PipelineCache::create(test_context.device);
+        other_cache->pipeline(fmt);
+        cache->merge(other_cache);
+    }
+
+    // saved on destruction
+    ASSERT_TRUE(std::filesystem::exists(path));
+
+    {
+        auto cache = vierkant::PipelineCache::create(test_context.device, path);
+        EXPECT_GT(cache->stats().num_loaded_bytes, 0);
+        EXPECT_TRUE(cache->pipeline(fmt));
+        EXPECT_EQ(cache->stats().num_misses, 1);
+    }
+
+    // corrupted files are rejected
+    {
+        std::fstream stream(path, std::ios::binary | std::ios::in | std::ios::out);
+        stream.seekp(-1, std::ios::end);
+        stream.put('x');
+    }
+    EXPECT_EQ(vierkant::PipelineCache::create(test_context.device, path)->stats().num_loaded_bytes, 0);
+    std::filesystem::remove(path);
+}
+
+TEST(TestPipeline, PipelineManifest)
+{
+    vulkan_test_context_t test_context;
+    auto path = std::filesystem::temp_directory_path() / "vierkant_test_pipeline_manifest.bin";
+
+    vierkant::descriptor_map_t descriptors;
+    descriptors[0].type = descriptors[1].type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    descriptors[2].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    for(auto &[binding, desc]: descriptors) { desc.stage_flags = VK_SHADER_STAGE_COMPUTE_BIT; }
+
+    vierkant::compute_pipeline_info_t fmt = {};
+    fmt.shader_stage = vierkant::create_shader_module(vierkant::slang_shaders::slang::object_overlay_slang);
+    auto recorded_set_layout = vierkant::create_descriptor_set_layout(test_context.device, descriptors);
+    fmt.descriptor_set_layouts = {recorded_set_layout.get()};
+
+    // record pipeline-keys
+    {
+        auto cache = vierkant::PipelineCache::create(test_context.device);
+        EXPECT_TRUE(cache->pipeline(fmt));
+        auto manifest = cache->manifest();
+        ASSERT_EQ(manifest.pipelines.size(), 1);
+        ASSERT_EQ(manifest.shader_codes.size(), 1);
+        ASSERT_EQ(manifest.set_layouts.size(), 1);
+        ASSERT_TRUE(vierkant::save_pipeline_manifest(manifest, path));
+    }
+
+    auto manifest = vierkant::load_pipeline_manifest(path);
+    ASSERT_TRUE(manifest);
+    EXPECT_EQ(manifest->set_layouts.front().bindings.size(), descriptors.size());
+
+    // warm up a new cache
+    crocore::ThreadPoolClassic pool(4);
+    auto cache = vierkant::PipelineCache::create(test_context.device);
+    EXPECT_EQ(cache->precompile(*manifest, &pool), 1);
+    EXPECT_EQ(cache->precompile(*manifest, &pool), 0);
+
+    // equivalent set-layout with a different handle, served without compiling
+    auto set_layout = vierkant::create_descriptor_set_layout(test_context.device, descriptors);
+    fmt.descriptor_set_layouts = {set_layout.get()};
+    EXPECT_TRUE(cache->pipeline(fmt));
+
+    auto stats = cache->stats();
+    EXPECT_EQ(stats.num_precompiled, 1);
+    EXPECT_EQ(stats.num_misses, 0);
+    EXPECT_EQ(stats.num_hits, 1);
+
+    // trailing garbage is rejected
+    {
+        std::ofstream stream(path, std::ios::binary | std::ios::app);
+        stream.put('x');
+    }
+    EXPECT_FALSE(vierkant::load_pipeline_manifest(path));
+    std::filesystem::remove(path);
+}
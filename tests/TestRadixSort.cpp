@@ -0,0 +1,40 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <vierkant/radix_sort.hpp>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+struct sort_item_t
+{
+    uint64_t key = 0;
+    uint32_t index = 0;
+};
+
+TEST(radix_sort, stable)
+{
+    std::mt19937_64 rng(0);
+
+    for(uint64_t key_mask: {0xFFULL, 0xFF00FF0000000000ULL, ~0ULL})
+    {
+        std::vector<sort_item_t> items(4096), tmp(items.size());
+        for(uint32_t i = 0; i < items.size(); ++i) { items[i] = {rng() & key_mask, i}; }
+
+        auto expected = items;
+        std::stable_sort(expected.begin(), expected.end(),
+                         [](const auto &lhs, const auto &rhs) { return lhs.key < rhs.key; });
+
+        vierkant::radix_sort(std::span(items), std::span(tmp), [](const sort_item_t &item) { return item.key; });
+
+        for(uint32_t i = 0; i < items.size(); ++i)
+        {
+            EXPECT_EQ(items[i].key, expected[i].key);
+            EXPECT_EQ(items[i].index, expected[i].index);
+        }
+    }
+
+    // degenerate input
+    std::vector<sort_item_t> items(3, {42, 0}), tmp(3);
+    vierkant::radix_sort(std::span(items), std::span(tmp), [](const sort_item_t &item) { return item.key; });
+    EXPECT_EQ(items.front().key, 42);
+    vierkant::radix_sort(std::span(items).first(0), std::span(tmp), [](const sort_item_t &item) { return item.key; });
+}
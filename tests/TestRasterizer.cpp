@@ -1,6 +1,8 @@
 #include "test_context.hpp"
 #include "vierkant/model/model_loading.hpp"
 #include "vierkant/vierkant.hpp"
+#include <spdlog/stopwatch.h>
+#include <thread>
 
 std::vector<vierkant::drawable_t> create_test_drawables(const vierkant::DevicePtr &device)
 {
@@ -100,4 +102,235 @@ TEST(Rasterizer, direct_API)
     framebuffer.end_rendering({});
 
     cmd_buffer.submit(test_context.device->queue(), true);
-}
\ No newline at end of file
+}
+
+//! render a few frames using bindless indirect-draws, with repeated drawables sharing descriptors
+void render_bindless(const vierkant::DevicePtr &device)
+{
+    const glm::vec2 res(1920, 1080);
+
+    auto command_pool = vierkant::create_command_pool(device, vierkant::Device::Queue::GRAPHICS, 0);
+    vierkant::Rasterizer::create_info_t create_info = {};
+    create_info.num_frames_in_flight = 2;
+    create_info.viewport = {0.f, 0.f, res.x, res.y, 0.f, 1.f};
+    create_info.command_pool = command_pool;
+    create_info.indirect_draw = true;
+    create_info.enable_mesh_shader = true;
+    create_info.use_bindless = true;
+
+    auto rasterizer = vierkant::Rasterizer(device, create_info);
+    EXPECT_TRUE(rasterizer.use_bindless);
+
+    auto drawables = create_test_drawables(device);
+    auto template_drawables = drawables;
+    for(uint32_t i = 0; i < 8; ++i)
+    {
+        drawables.insert(drawables.end(), template_drawables.begin(), template_drawables.end());
+    }
+
+    vierkant::Framebuffer::create_info_t framebuffer_info = {};
+    framebuffer_info.size = {static_cast<uint32_t>(res.x), static_cast<uint32_t>(res.y), 1};
+    vierkant::Framebuffer framebuffer(device, framebuffer_info);
+
+    for(uint32_t frame = 0; frame < 3; ++frame)
+    {
+        rasterizer.stage_drawables(drawables);
+
+        auto cmd_buffer = vierkant::CommandBuffer(device, command_pool.get());
+        cmd_buffer.begin();
+        framebuffer.begin_rendering(cmd_buffer.handle(), {});
+
+        vierkant::Rasterizer::rendering_info_t rendering_info = {};
+        rendering_info.command_buffer = cmd_buffer.handle();
+        rendering_info.color_attachment_formats = framebuffer.color_attachment_formats();
+        rasterizer.render(rendering_info);
+
+        framebuffer.end_rendering({});
+        cmd_buffer.submit(device->queue(), true);
+    }
+}
+
+TEST(Rasterizer, bindless)
+{
+    bool descriptor_buffer_support = false;
+
+    // descriptor-indexing fallback
+    {
+        vulkan_test_context_t test_context;
+        descriptor_buffer_support = vierkant::check_device_extension_support(
+                test_context.device->physical_device(), {VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME});
+        render_bindless(test_context.device);
+    }
+
+    // descriptor-buffers, if supported
+    if(descriptor_buffer_support)
+    {
+        vulkan_test_context_t test_context({VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME});
+        EXPECT_TRUE(vkCmdBindDescriptorBuffersEXT);
+        render_bindless(test_context.device);
+    }
+}
+
+TEST(Rasterizer, batching)
+{
+    vulkan_test_context_t test_context;
+
+    const glm::vec2 res(1920, 1080);
+
+    auto command_pool = vierkant::create_command_pool(test_context.device, vierkant::Device::Queue::GRAPHICS, 0);
+    vierkant::Rasterizer::create_info_t create_info = {};
+    create_info.num_frames_in_flight = 2;
+    create_info.viewport = {0.f, 0.f, res.x, res.y, 0.f, 1.f};
+    create_info.command_pool = command_pool;
+    create_info.indirect_draw = true;
+    auto rasterizer = vierkant::Rasterizer(test_context.device, create_info);
+
+    // interleave drawables from two different meshes
+    auto drawables_a = create_test_drawables(test_context.device);
+    auto drawables_b = create_test_drawables(test_context.device);
+    std::vector<vierkant::drawable_t> drawables;
+    for(uint32_t i = 0; i < 8; ++i)
+    {
+        drawables.insert(drawables.end(), drawables_a.begin(), drawables_a.end());
+        drawables.insert(drawables.end(), drawables_b.begin(), drawables_b.end());
+    }
+
+    vierkant::Framebuffer::create_info_t framebuffer_info = {};
+    framebuffer_info.size = {static_cast<uint32_t>(res.x), static_cast<uint32_t>(res.y), 1};
+    vierkant::Framebuffer framebuffer(test_context.device, framebuffer_info);
+
+    rasterizer.stage_drawables(drawables);
+
+    auto cmd_buffer = vierkant::CommandBuffer(test_context.device, command_pool.get());
+    cmd_buffer.begin();
+    framebuffer.begin_rendering(cmd_buffer.handle(), {});
+
+    vierkant::Rasterizer::rendering_info_t rendering_info = {};
+    rendering_info.command_buffer = cmd_buffer.handle();
+    rendering_info.color_attachment_formats = framebuffer.color_attachment_formats();
+    rasterizer.render(rendering_info);
+
+    framebuffer.end_rendering({});
+    cmd_buffer.submit(test_context.device->queue(), true);
+
+    // sorted by mesh, one indirect draw-call per mesh
+    const auto &batch_stats = rasterizer.batch_stats();
+    EXPECT_EQ(batch_stats.num_drawables, drawables.size());
+    EXPECT_EQ(batch_stats.num_batches, 2);
+    EXPECT_EQ(batch_stats.num_draw_calls, 2);
+    EXPECT_EQ(batch_stats.num_pipeline_binds, 1);
+    EXPECT_LE(batch_stats.num_mesh_binds, 2);
+}
+
+TEST(Rasterizer, concurrent_staging)
+{
+    vulkan_test_context_t test_context;
+
+    const glm::vec2 res(1920, 1080);
+
+    auto command_pool = vierkant::create_command_pool(test_context.device, vierkant::Device::Queue::GRAPHICS, 0);
+    vierkant::Rasterizer::create_info_t create_info = {};
+    create_info.num_frames_in_flight = 1;
+    create_info.viewport = {0.f, 0.f, res.x, res.y, 0.f, 1.f};
+    create_info.command_pool = command_pool;
+    create_info.indirect_draw = true;
+    auto rasterizer = vierkant::Rasterizer(test_context.device, create_info);
+
+    auto template_drawable = create_test_drawables(test_context.device).front();
+
+    constexpr uint32_t num_threads = 8, num_batches = 64, batch_size = 16;
+
+    // producers stage interleaved batches, order-keys establish a reproducible order
+    std::vector<std::thread> threads;
+    for(uint32_t t = 0; t < num_threads; ++t)
+    {
+        threads.emplace_back([&rasterizer, &template_drawable, t] {
+            std::vector<vierkant::drawable_t> drawables(batch_size, template_drawable);
+            for(uint32_t b = num_batches - 1 - t; b < num_batches; b -= num_threads)
+            {
+                for(uint32_t i = 0; i < batch_size; ++i)
+                {
+                    drawables[i].matrices.texture[3][0] = static_cast<float>(b * batch_size + i);
+                }
+                rasterizer.stage_drawables(drawables, b);
+            }
+        });
+    }
+    for(auto &thread: threads) { thread.join(); }
+
+    // delegate receives mesh-draws in staging-order. commands are only recorded, never submitted
+    bool order_checked = false;
+    rasterizer.draw_indirect_delegate = [&order_checked](vierkant::Rasterizer::indirect_draw_bundle_t &bundle) {
+        for(uint32_t i = 0; i < num_batches * batch_size; ++i)
+        {
+            EXPECT_EQ(bundle.mesh_draws_host[i].current_matrices.texture[3][0], static_cast<float>(i));
+        }
+        order_checked = true;
+    };
+
+    vierkant::Framebuffer::create_info_t framebuffer_info = {};
+    framebuffer_info.size = {static_cast<uint32_t>(res.x), static_cast<uint32_t>(res.y), 1};
+    vierkant::Framebuffer framebuffer(test_context.device, framebuffer_info);
+
+    auto cmd_buffer = vierkant::CommandBuffer(test_context.device, command_pool.get());
+    cmd_buffer.begin();
+    framebuffer.begin_rendering(cmd_buffer.handle(), {});
+
+    vierkant::Rasterizer::rendering_info_t rendering_info = {};
+    rendering_info.command_buffer = cmd_buffer.handle();
+    rendering_info.color_attachment_formats = framebuffer.color_attachment_formats();
+    rasterizer.render(rendering_info);
+    framebuffer.end_rendering({});
+    cmd_buffer.end();
+
+    EXPECT_TRUE(order_checked);
+    EXPECT_EQ(rasterizer.batch_stats().num_drawables, num_batches * batch_size);
+}
+
+TEST(Rasterizer, staging_throughput)
+{
+    vulkan_test_context_t test_context;
+
+    vierkant::Rasterizer::create_info_t create_info = {};
+    create_info.viewport = {0.f, 0.f, 1920.f, 1080.f, 0.f, 1.f};
+    create_info.command_pool = vierkant::create_command_pool(test_context.device, vierkant::Device::Queue::GRAPHICS, 0);
+    create_info.indirect_draw = true;
+    auto rasterizer = vierkant::Rasterizer(test_context.device, create_info);
+
+    auto template_drawable = create_test_drawables(test_context.device).front();
+
+    // micro-benchmark: staging-throughput with increasing number of producers
+    constexpr uint32_t num_stagings = 1U << 14;
+    auto run_producers = [&template_drawable](uint32_t num_producers, auto stage_fn) {
+        std::vector<std::thread> producers;
+        spdlog::stopwatch sw;
+        for(uint32_t t = 0; t < num_producers; ++t)
+        {
+            producers.emplace_back([&template_drawable, num_producers, &stage_fn] {
+                for(uint32_t i = 0; i < num_stagings / num_producers; ++i) { stage_fn(template_drawable); }
+            });
+        }
+        for(auto &producer: producers) { producer.join(); }
+        return num_stagings / sw.elapsed().count() / 1e6;
+    };
+
+    for(uint32_t num_producers: {1U, 2U, 4U, std::max(std::thread::hardware_concurrency(), 1U)})
+    {
+        double lock_free_rate = run_producers(num_producers, [&rasterizer](const vierkant::drawable_t &drawable) {
+            rasterizer.stage_drawable(drawable);
+        });
+        rasterizer.reset();
+
+        // previous approach: copy into a shared vector under a mutex
+        std::mutex mutex;
+        std::vector<vierkant::drawable_t> staged_drawables;
+        double mutex_rate = run_producers(num_producers, [&mutex, &staged_drawables](const vierkant::drawable_t &d) {
+            std::lock_guard lock(mutex);
+            staged_drawables.push_back(d);
+        });
+        EXPECT_EQ(staged_drawables.size(), num_stagings / num_producers * num_producers);
+
+        spdlog::info("stage_drawable ({} producers): {:.2f} M/s lock-free, {:.2f} M/s mutex", num_producers,
+                     lock_free_rate, mutex_rate);
+    }
+}
@@ -16,4 +16,23 @@ TEST(TestSpirvReflect, GroupCount)
     EXPECT_TRUE(shader_stage.entry_points.at(VK_SHADER_STAGE_COMPUTE_BIT).front().group_count);
     glm::uvec3 local_sizes = *shader_stage.entry_points.at(VK_SHADER_STAGE_COMPUTE_BIT).front().group_count;
     EXPECT_EQ(local_sizes, glm::uvec3(32, 32, 1));
-}
\ No newline at end of file
+}
+
+TEST(TestSpirvReflect, BuildTimeTables)
+{
+    ASSERT_FALSE(vierkant::slang_shaders::reflections.empty());
+
+    for(const auto &reflection: vierkant::slang_shaders::reflections)
+    {
+        // embedded shader-code uses build-time tables, copies are reflected at runtime
+        auto shader_stage = vierkant::create_shader_module(reflection.code, reflection.num_bytes);
+        size_t num_entry_points = 0;
+        for(const auto &[stage, entry_points]: shader_stage.entry_points) { num_entry_points += entry_points.size(); }
+        EXPECT_EQ(num_entry_points, reflection.entry_points.size());
+
+        std::vector<uint8_t> code_copy(static_cast<const uint8_t *>(reflection.code),
+                                       static_cast<const uint8_t *>(reflection.code) + reflection.num_bytes);
+        auto runtime_shader_stage = vierkant::create_shader_module(code_copy.data(), code_copy.size());
+        EXPECT_EQ(shader_stage.entry_points, runtime_shader_stage.entry_points);
+    }
+}
@@ -0,0 +1,162 @@
+#include "test_context.hpp"
+#include "vierkant/staging_copy.hpp"
+#include "vierkant/vierkant.hpp"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST(StagingRing, allocate)
+{
+    vulkan_test_context_t test_context;
+
+    vierkant::StagingRing::create_info_t create_info = {};
+    create_info.device = test_context.device;
+    create_info.num_bytes = 1024;
+    auto staging_ring = vierkant::StagingRing::create(create_info);
+    ASSERT_TRUE(staging_ring);
+
+    // aligned sub-allocations
+    auto a = staging_ring->allocate(100);
+    ASSERT_TRUE(a);
+    EXPECT_EQ(a.offset, 0);
+    auto b = staging_ring->allocate(100, 64);
+    ASSERT_TRUE(b);
+    EXPECT_EQ(b.offset, 128);
+    EXPECT_EQ(staging_ring->num_bytes_used(), 228);
+
+    // not enough space, nothing is reclaimed before retiring
+    EXPECT_FALSE(staging_ring->allocate(900));
+    EXPECT_FALSE(staging_ring->allocate(2048));
+
+    // submit an empty command-buffer, signaling completion of retired allocations
+    auto semaphore_info = staging_ring->retire();
+    EXPECT_EQ(semaphore_info.semaphore, staging_ring->semaphore().handle());
+
+    auto cmd_buffer = vierkant::CommandBuffer(test_context.device, test_context.device->command_pool_transient());
+    cmd_buffer.begin();
+    cmd_buffer.submit(test_context.device->queue(), true, VK_NULL_HANDLE, {semaphore_info});
+    EXPECT_GE(staging_ring->semaphore().value(), semaphore_info.signal_value);
+
+    // reclaimed, wraps around
+    auto c = staging_ring->allocate(900);
+    ASSERT_TRUE(c);
+    EXPECT_EQ(c.offset, 0);
+
+    // remaining space at the end is too small, start of ring still in use
+    EXPECT_FALSE(staging_ring->allocate(200));
+    EXPECT_TRUE(staging_ring->allocate(100));
+}
+
+TEST(StagingRing, upload)
+{
+    vulkan_test_context_t test_context;
+    const auto &device = test_context.device;
+
+    vierkant::StagingRing::create_info_t create_info = {};
+    create_info.device = device;
+    create_info.num_bytes = 1UL << 20;
+    auto staging_ring = vierkant::StagingRing::create(create_info);
+    ASSERT_TRUE(staging_ring);
+
+    std::vector<uint32_t> data(4096);
+    for(uint32_t i = 0; i < data.size(); ++i) { data[i] = i; }
+    size_t num_bytes = data.size() * sizeof(uint32_t);
+
+    auto gpu_buffer = vierkant::Buffer::create(device, nullptr, num_bytes,
+                                               VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                               VMA_MEMORY_USAGE_GPU_ONLY);
+    auto host_buffer = vierkant::Buffer::create(device, nullptr, num_bytes, VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                                VMA_MEMORY_USAGE_CPU_ONLY);
+
+    vierkant::Image::Format fmt = {};
+    fmt.extent = {32, 32, 1};
+    fmt.usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    auto image = vierkant::Image::create(device, fmt);
+    size_t num_image_bytes = fmt.extent.width * fmt.extent.height * vierkant::num_bytes(fmt.format);
+    auto host_image_buffer = vierkant::Buffer::create(device, nullptr, num_image_bytes,
+                                                      VK_BUFFER_USAGE_TRANSFER_DST_BIT, VMA_MEMORY_USAGE_CPU_ONLY);
+
+    // record uploads into a provided command-buffer
+    auto cmd_buffer = vierkant::CommandBuffer(device, device->command_pool_transient());
+    cmd_buffer.begin();
+    EXPECT_FALSE(staging_ring->upload(cmd_buffer.handle(), data.data(), num_bytes, gpu_buffer, sizeof(uint32_t)));
+    EXPECT_TRUE(staging_ring->upload(cmd_buffer.handle(), data.data(), num_bytes, gpu_buffer));
+    EXPECT_TRUE(staging_ring->upload(cmd_buffer.handle(), data.data(), num_image_bytes, image));
+
+    // read back
+    vierkant::stage_barrier(cmd_buffer.handle(), VK_PIPELINE_STAGE_2_TRANSFER_BIT);
+    gpu_buffer->copy_to(host_buffer, cmd_buffer.handle());
+    image->copy_to(host_image_buffer, cmd_buffer.handle());
+    cmd_buffer.submit(device->queue(), true, VK_NULL_HANDLE, {staging_ring->retire()});
+
+    EXPECT_EQ(memcmp(host_buffer->map(), data.data(), num_bytes), 0);
+    EXPECT_EQ(memcmp(host_image_buffer->map(), data.data(), num_image_bytes), 0);
+
+    // staging_copy using the ring
+    std::vector<uint32_t> data2(data.rbegin(), data.rend());
+    vierkant::staging_copy_info_t copy_info = {};
+    copy_info.data = data2.data();
+    copy_info.num_bytes = num_bytes;
+    copy_info.dst_buffer = gpu_buffer;
+    copy_info.dst_stage = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
+    copy_info.dst_access = VK_ACCESS_2_TRANSFER_READ_BIT;
+
+    cmd_buffer.begin();
+    vierkant::staging_copy_context_t staging_context = {};
+    staging_context.command_buffer = cmd_buffer.handle();
+    staging_context.staging_ring = staging_ring;
+    // ring-copies do not occupy the context's staging-buffer
+    EXPECT_EQ(vierkant::staging_copy(staging_context, {copy_info}), 0);
+    gpu_buffer->copy_to(host_buffer, cmd_buffer.handle());
+    cmd_buffer.submit(device->queue(), true, VK_NULL_HANDLE, {staging_ring->retire()});
+    EXPECT_EQ(memcmp(host_buffer->map(), data2.data(), num_bytes), 0);
+}
+
+TEST(StagingRing, staging_copy_fallback)
+{
+    vulkan_test_context_t test_context;
+    const auto &device = test_context.device;
+
+    vierkant::StagingRing::create_info_t create_info = {};
+    create_info.device = device;
+    create_info.num_bytes = 1024;
+    auto staging_ring = vierkant::StagingRing::create(create_info);
+    ASSERT_TRUE(staging_ring);
+
+    std::vector<uint32_t> data(384);
+    for(uint32_t i = 0; i < data.size(); ++i) { data[i] = i; }
+    size_t num_bytes = data.size() * sizeof(uint32_t);
+    size_t half_num_bytes = num_bytes / 2;
+
+    auto gpu_buffer = vierkant::Buffer::create(device, nullptr, num_bytes,
+                                               VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                               VMA_MEMORY_USAGE_GPU_ONLY);
+    auto host_buffer = vierkant::Buffer::create(device, nullptr, num_bytes, VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                                VMA_MEMORY_USAGE_CPU_ONLY);
+
+    // second half does not fit into the ring anymore
+    std::vector<vierkant::staging_copy_info_t> copy_infos(2);
+    for(uint32_t i = 0; i < copy_infos.size(); ++i)
+    {
+        copy_infos[i].data = reinterpret_cast<const uint8_t *>(data.data()) + i * half_num_bytes;
+        copy_infos[i].num_bytes = half_num_bytes;
+        copy_infos[i].dst_buffer = gpu_buffer;
+        copy_infos[i].dst_offset = i * half_num_bytes;
+        copy_infos[i].dst_stage = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
+        copy_infos[i].dst_access = VK_ACCESS_2_TRANSFER_READ_BIT;
+    }
+
+    auto cmd_buffer = vierkant::CommandBuffer(device, device->command_pool_transient());
+    cmd_buffer.begin();
+    vierkant::staging_copy_context_t staging_context = {};
+    staging_context.command_buffer = cmd_buffer.handle();
+    staging_context.staging_ring = staging_ring;
+    staging_context.staging_buffer = vierkant::Buffer::create(device, nullptr, 1, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                                              VMA_MEMORY_USAGE_CPU_ONLY);
+    EXPECT_EQ(vierkant::staging_copy(staging_context, copy_infos), half_num_bytes);
+    EXPECT_EQ(staging_ring->num_bytes_used(), half_num_bytes);
+    EXPECT_EQ(staging_context.offset, half_num_bytes);
+
+    gpu_buffer->copy_to(host_buffer, cmd_buffer.handle());
+    cmd_buffer.submit(device->queue(), true, VK_NULL_HANDLE, {staging_ring->retire()});
+    EXPECT_EQ(memcmp(host_buffer->map(), data.data(), num_bytes), 0);
+}
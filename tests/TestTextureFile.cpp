@@ -0,0 +1,120 @@
+#include "test_context.hpp"
+#include <vierkant/model/model_loading.hpp>
+#include <vierkant/texture_file.hpp>
+
+//____________________________________________________________________________//
+
+//! compress a generated gradient-image with mips
+static vierkant::bcn::compress_result_t create_compressed(vierkant::bcn::CompressionMode mode, uint32_t seed)
+{
+    uint32_t width = 64, height = 32;
+    auto img = crocore::Image_<uint8_t>::create(width, height, 4);
+    auto data = static_cast<uint8_t *>(img->data());
+    for(uint32_t i = 0; i < width * height * 4; ++i) { data[i] = static_cast<uint8_t>(i * 3 + seed * 17); }
+
+    vierkant::bcn::compress_info_t compress_info = {};
+    compress_info.mode = mode;
+    compress_info.image = img;
+    compress_info.generate_mipmaps = true;
+    return vierkant::bcn::compress(compress_info);
+}
+
+static void check_equal(const std::vector<vierkant::bcn::compress_result_t> &lhs,
+                        const std::vector<vierkant::bcn::compress_result_t> &rhs)
+{
+    ASSERT_EQ(lhs.size(), rhs.size());
+
+    for(uint32_t f = 0; f < lhs.size(); ++f)
+    {
+        EXPECT_EQ(lhs[f].mode, rhs[f].mode);
+        EXPECT_EQ(lhs[f].base_width, rhs[f].base_width);
+        EXPECT_EQ(lhs[f].base_height, rhs[f].base_height);
+        ASSERT_EQ(lhs[f].levels.size(), rhs[f].levels.size());
+
+        for(uint32_t l = 0; l < lhs[f].levels.size(); ++l)
+        {
+            const auto &a = lhs[f].levels[l], &b = rhs[f].levels[l];
+            ASSERT_EQ(a.size(), b.size());
+            EXPECT_EQ(memcmp(a.data(), b.data(), a.size() * sizeof(vierkant::bcn::block_t)), 0);
+        }
+    }
+}
+
+TEST(TextureFile, ktx2)
+{
+    auto path = std::filesystem::temp_directory_path() / "vierkant_test_texture.ktx2";
+
+    for(auto mode: {vierkant::bcn::BC1, vierkant::bcn::BC3, vierkant::bcn::BC4, vierkant::bcn::BC5,
+                    vierkant::bcn::BC7})
+    {
+        std::vector<vierkant::bcn::compress_result_t> faces = {create_compressed(mode, 0)};
+
+        for(auto supercompression: {vierkant::bcn::Supercompression::None, vierkant::bcn::Supercompression::Zlib})
+        {
+            ASSERT_TRUE(vierkant::bcn::write_ktx2(path, faces, supercompression));
+            auto faces_read = vierkant::bcn::load_compressed_texture(path);
+            ASSERT_TRUE(faces_read);
+            check_equal(faces, *faces_read);
+        }
+    }
+    std::filesystem::remove(path);
+}
+
+TEST(TextureFile, dds)
+{
+    auto path = std::filesystem::temp_directory_path() / "vierkant_test_texture.dds";
+
+    for(auto mode: {vierkant::bcn::BC1, vierkant::bcn::BC3, vierkant::bcn::BC4, vierkant::bcn::BC5,
+                    vierkant::bcn::BC7})
+    {
+        std::vector<vierkant::bcn::compress_result_t> faces = {create_compressed(mode, 0)};
+        ASSERT_TRUE(vierkant::bcn::write_dds(path, faces));
+        auto faces_read = vierkant::bcn::load_compressed_texture(path);
+        ASSERT_TRUE(faces_read);
+        check_equal(faces, *faces_read);
+    }
+    std::filesystem::remove(path);
+}
+
+TEST(TextureFile, cube)
+{
+    auto dir = std::filesystem::temp_directory_path();
+    std::vector<vierkant::bcn::compress_result_t> faces;
+    for(uint32_t i = 0; i < 6; ++i) { faces.push_back(create_compressed(vierkant::bcn::BC7, i)); }
+
+    ASSERT_TRUE(vierkant::bcn::write_ktx2(dir / "vierkant_test_cube.ktx2", faces));
+    ASSERT_TRUE(vierkant::bcn::write_dds(dir / "vierkant_test_cube.dds", faces));
+
+    for(const auto &path: {dir / "vierkant_test_cube.ktx2", dir / "vierkant_test_cube.dds"})
+    {
+        auto faces_read = vierkant::bcn::load_compressed_texture(path);
+        ASSERT_TRUE(faces_read);
+        check_equal(faces, *faces_read);
+        std::filesystem::remove(path);
+    }
+
+    // upload as cube-map, without touching the encoder
+    vulkan_test_context_t test_context;
+    auto cube =
+            vierkant::model::create_compressed_texture(test_context.device, faces, {}, test_context.device->queue());
+    ASSERT_TRUE(cube);
+    EXPECT_EQ(cube->num_layers(), 6);
+    EXPECT_EQ(cube->format().view_type, VK_IMAGE_VIEW_TYPE_CUBE);
+}
+
+TEST(TextureFile, invalid)
+{
+    // incompatible faces
+    auto path = std::filesystem::temp_directory_path() / "vierkant_test_invalid.ktx2";
+    std::vector<vierkant::bcn::compress_result_t> faces = {create_compressed(vierkant::bcn::BC7, 0),
+                                                           create_compressed(vierkant::bcn::BC5, 0)};
+    EXPECT_FALSE(vierkant::bcn::write_ktx2(path, faces));
+    EXPECT_FALSE(vierkant::bcn::write_dds(path, faces));
+    EXPECT_FALSE(vierkant::bcn::write_ktx2(path, {}));
+
+    // truncated or garbage data
+    std::vector<uint8_t> garbage(256, 0xAB);
+    EXPECT_FALSE(vierkant::bcn::read_ktx2(garbage));
+    EXPECT_FALSE(vierkant::bcn::read_dds(garbage));
+    EXPECT_FALSE(vierkant::bcn::load_compressed_texture("/does/not/exist.ktx2"));
+}
@@ -0,0 +1,127 @@
+#include "test_context.hpp"
+#include "vierkant/vierkant.hpp"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST(UploadQueue, upload)
+{
+    vulkan_test_context_t test_context;
+    const auto &device = test_context.device;
+
+    auto upload_queue = vierkant::UploadQueue::create({device});
+    ASSERT_TRUE(upload_queue);
+
+    std::vector<uint32_t> data(4096);
+    for(uint32_t i = 0; i < data.size(); ++i) { data[i] = i; }
+    size_t num_bytes = data.size() * sizeof(uint32_t);
+
+    auto gpu_buffer = vierkant::Buffer::create(device, nullptr, num_bytes,
+                                               VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                               VMA_MEMORY_USAGE_GPU_ONLY);
+    auto host_buffer = vierkant::Buffer::create(device, nullptr, num_bytes, VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                                VMA_MEMORY_USAGE_CPU_ONLY);
+
+    // mipmap-chain is generated during acquisition
+    vierkant::Image::Format fmt = {};
+    fmt.extent = {32, 32, 1};
+    fmt.usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    fmt.use_mipmap = true;
+    fmt.initial_layout_transition = false;
+    auto image = vierkant::Image::create(device, fmt);
+    size_t num_image_bytes = fmt.extent.width * fmt.extent.height * vierkant::num_bytes(fmt.format);
+    auto host_image_buffer = vierkant::Buffer::create(device, nullptr, num_image_bytes,
+                                                      VK_BUFFER_USAGE_TRANSFER_DST_BIT, VMA_MEMORY_USAGE_CPU_ONLY);
+
+    // exceeds the image's base-level or the buffer, destinations are not resized
+    EXPECT_FALSE(upload_queue->upload(image, data.data(), num_bytes));
+    EXPECT_FALSE(upload_queue->upload(gpu_buffer, data.data(), num_bytes, sizeof(uint32_t)));
+
+    // uploads are batched, nothing submitted yet
+    auto buffer_handle = upload_queue->upload(gpu_buffer, data.data(), num_bytes);
+    auto image_handle = upload_queue->upload(image, data.data(), num_image_bytes);
+    EXPECT_TRUE(buffer_handle);
+    EXPECT_EQ(buffer_handle.value, image_handle.value);
+    EXPECT_FALSE(upload_queue->complete(buffer_handle));
+
+    auto handle = upload_queue->flush();
+    EXPECT_EQ(handle.value, buffer_handle.value);
+
+    // acquire and read back on the graphics-queue
+    auto cmd_buffer = vierkant::CommandBuffer(device, device->command_pool_transient());
+    cmd_buffer.begin();
+    auto wait_info = upload_queue->acquire(cmd_buffer.handle());
+    EXPECT_EQ(wait_info.semaphore, upload_queue->semaphore().handle());
+    EXPECT_EQ(wait_info.wait_value, handle.value);
+    EXPECT_EQ(image->image_layout(), VK_IMAGE_LAYOUT_READ_ONLY_OPTIMAL);
+
+    // nothing left to acquire
+    EXPECT_FALSE(upload_queue->acquire(cmd_buffer.handle()).semaphore);
+
+    gpu_buffer->copy_to(host_buffer, cmd_buffer.handle());
+    image->copy_to(host_image_buffer, cmd_buffer.handle());
+    cmd_buffer.submit(device->queue(), true, VK_NULL_HANDLE, {wait_info});
+    EXPECT_TRUE(upload_queue->complete(handle));
+
+    EXPECT_EQ(memcmp(host_buffer->map(), data.data(), num_bytes), 0);
+    EXPECT_EQ(memcmp(host_image_buffer->map(), data.data(), num_image_bytes), 0);
+}
+
+TEST(UploadQueue, exhaustion)
+{
+    vulkan_test_context_t test_context;
+    const auto &device = test_context.device;
+
+    vierkant::UploadQueue::create_info_t create_info = {};
+    create_info.device = device;
+    create_info.staging_num_bytes = 1024;
+    auto upload_queue = vierkant::UploadQueue::create(create_info);
+    ASSERT_TRUE(upload_queue);
+
+    constexpr uint32_t num_buffers = 8;
+    std::vector<uint32_t> data(256);
+    size_t num_bytes = data.size() * sizeof(uint32_t);
+
+    // each upload occupies the entire ring, batches are submitted and awaited on the calling thread
+    std::vector<vierkant::BufferPtr> gpu_buffers;
+    for(uint32_t i = 0; i < num_buffers; ++i)
+    {
+        std::fill(data.begin(), data.end(), i);
+        gpu_buffers.push_back(vierkant::Buffer::create(
+                device, nullptr, num_bytes, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                VMA_MEMORY_USAGE_GPU_ONLY));
+        EXPECT_TRUE(upload_queue->upload(gpu_buffers.back(), data.data(), num_bytes));
+    }
+
+    // exceeds the ring, uses a dedicated staging-buffer
+    std::vector<uint32_t> large_data(4096, 0xC0FFEE);
+    auto large_buffer = vierkant::Buffer::create(
+            device, nullptr, large_data.size() * sizeof(uint32_t),
+            VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_GPU_ONLY);
+    auto handle = upload_queue->upload(large_buffer, large_data.data(), large_data.size() * sizeof(uint32_t));
+    upload_queue->wait(handle);
+    EXPECT_TRUE(upload_queue->complete(handle));
+
+    auto cmd_buffer = vierkant::CommandBuffer(device, device->command_pool_transient());
+    cmd_buffer.begin();
+    auto wait_info = upload_queue->acquire(cmd_buffer.handle());
+    EXPECT_EQ(wait_info.wait_value, handle.value);
+
+    std::vector<vierkant::BufferPtr> host_buffers;
+    for(const auto &gpu_buffer: gpu_buffers)
+    {
+        host_buffers.push_back(vierkant::Buffer::create(device, nullptr, num_bytes, VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                                        VMA_MEMORY_USAGE_CPU_ONLY));
+        gpu_buffer->copy_to(host_buffers.back(), cmd_buffer.handle());
+    }
+    auto large_host_buffer = vierkant::Buffer::create(device, nullptr, large_data.size() * sizeof(uint32_t),
+                                                      VK_BUFFER_USAGE_TRANSFER_DST_BIT, VMA_MEMORY_USAGE_CPU_ONLY);
+    large_buffer->copy_to(large_host_buffer, cmd_buffer.handle());
+    cmd_buffer.submit(device->queue(), true, VK_NULL_HANDLE, {wait_info});
+
+    for(uint32_t i = 0; i < num_buffers; ++i)
+    {
+        std::fill(data.begin(), data.end(), i);
+        EXPECT_EQ(memcmp(host_buffers[i]->map(), data.data(), num_bytes), 0);
+    }
+    EXPECT_EQ(memcmp(large_host_buffer->map(), large_data.data(), large_data.size() * sizeof(uint32_t)), 0);
+}
@@ -0,0 +1,149 @@
+#include <fstream>
+#include <gtest/gtest.h>
+#include <vierkant/model/wavefront_obj.hpp>
+
+//____________________________________________________________________________//
+
+inline std::filesystem::path write_test_file(const std::string &filename, const std::string &content)
+{
+    auto path = std::filesystem::temp_directory_path() / filename;
+    std::ofstream stream(path, std::ios::binary);
+    stream << content;
+    return path;
+}
+
+inline const std::vector<vierkant::Mesh::entry_create_info_t> &
+get_entries(const vierkant::model::model_assets_t &assets)
+{
+    return std::get<std::vector<vierkant::Mesh::entry_create_info_t>>(assets.geometry_data);
+}
+
+TEST(WavefrontObj, invalid)
+{
+    EXPECT_FALSE(vierkant::model::wavefront_obj("/does/not/exist.obj"));
+}
+
+TEST(WavefrontObj, quad)
+{
+    // a quad with positions/tex_coords/normals, using negative (relative) indices
+    auto path = write_test_file("vierkant_test_quad.obj", "# test-quad\n"
+                                                          "o quad\n"
+                                                          "v -1.0 -1.0 0.0\n"
+                                                          "v 1.0 -1.0 0.0\n"
+                                                          "v 1.0 1.0 0.0\n"
+                                                          "v -1.0 1.0 0.0\n"
+                                                          "vt 0 0\n"
+                                                          "vt 1 0\n"
+                                                          "vt 1 1\n"
+                                                          "vt 0 1\n"
+                                                          "vn 0 0 1\n"
+                                                          "f -4/-4/-1 -3/-3/-1 -2/-2/-1 -1/-1/-1\n");
+    auto assets = vierkant::model::wavefront_obj(path);
+    ASSERT_TRUE(assets);
+
+    const auto &entries = get_entries(*assets);
+    ASSERT_EQ(entries.size(), 1);
+    EXPECT_EQ(entries.front().name, "quad");
+    EXPECT_EQ(assets->materials.size(), 1);
+
+    // two triangles, four shared vertices
+    const auto &geom = entries.front().geometry;
+    EXPECT_EQ(geom->indices.size(), 6);
+    EXPECT_EQ(geom->positions.size(), 4);
+    EXPECT_EQ(geom->normals.size(), 4);
+    EXPECT_EQ(geom->tex_coords.size(), 4);
+    EXPECT_EQ(geom->positions[2], glm::vec3(1.f, 1.f, 0.f));
+    EXPECT_EQ(geom->tex_coords[2], glm::vec2(1.f, 1.f));
+    EXPECT_EQ(geom->normals[0], glm::vec3(0.f, 0.f, 1.f));
+    std::filesystem::remove(path);
+}
+
+TEST(WavefrontObj, groups_materials)
+{
+    auto mtl_path = write_test_file("vierkant_test_groups.mtl", "newmtl red\n"
+                                                                "Kd 1 0 0\n"
+                                                                "d 0.5\n"
+                                                                "newmtl green\n"
+                                                                "Kd 0 1 0\n"
+                                                                "Ke 0 2 0\n");
+    auto path = write_test_file("vierkant_test_groups.obj", "mtllib vierkant_test_groups.mtl\n"
+                                                            "v 0 0 0\n"
+                                                            "v 1 0 0\n"
+                                                            "v 1 1 0\n"
+                                                            "v 0 1 0\n"
+                                                            "g first\n"
+                                                            "usemtl green\n"
+                                                            "f 1 2 3\n"
+                                                            "g second\n"
+                                                            "usemtl red\n"
+                                                            "f 1 3 4\n"
+                                                            "f 1 2 4\n");
+    auto assets = vierkant::model::wavefront_obj(path);
+    ASSERT_TRUE(assets);
+    ASSERT_EQ(assets->materials.size(), 2);
+    EXPECT_EQ(assets->materials[0].name, "red");
+    EXPECT_EQ(assets->materials[0].base_color, glm::vec4(1.f, 0.f, 0.f, 0.5f));
+    EXPECT_EQ(assets->materials[1].emission, glm::vec3(0.f, 2.f, 0.f));
+
+    const auto &entries = get_entries(*assets);
+    ASSERT_EQ(entries.size(), 2);
+    EXPECT_EQ(entries[0].name, "first");
+    EXPECT_EQ(entries[0].material_index, 1);
+    EXPECT_EQ(entries[0].geometry->indices.size(), 3);
+    EXPECT_EQ(entries[1].name, "second");
+    EXPECT_EQ(entries[1].material_index, 0);
+    EXPECT_EQ(entries[1].geometry->indices.size(), 6);
+
+    // no normals -> flat normals, no shared vertices
+    EXPECT_EQ(entries[1].geometry->positions.size(), 6);
+    EXPECT_EQ(entries[1].geometry->normals.size(), 6);
+    std::filesystem::remove(path);
+    std::filesystem::remove(mtl_path);
+}
+
+TEST(WavefrontObj, parallel)
+{
+    // a grid, large enough to be split into multiple chunks
+    constexpr uint32_t grid_size = 300;
+    std::stringstream ss;
+    ss << "o grid\n";
+
+    for(uint32_t y = 0; y <= grid_size; ++y)
+    {
+        for(uint32_t x = 0; x <= grid_size; ++x)
+        {
+            ss << "v " << static_cast<float>(x) * 0.125f << " " << static_cast<float>(y) * 0.125f << " -1.5e-1\n";
+            ss << "vn 0 0 1\n";
+        }
+    }
+    for(uint32_t y = 0; y < grid_size; ++y)
+    {
+        for(uint32_t x = 0; x < grid_size; ++x)
+        {
+            uint32_t i = y * (grid_size + 1) + x + 1;
+            ss << "f " << i << "//" << i << " " << i + 1 << "//" << i + 1 << " " << i + grid_size + 2 << "//"
+               << i + grid_size + 2 << " " << i + grid_size + 1 << "//" << i + grid_size + 1 << "\n";
+        }
+    }
+    auto path = write_test_file("vierkant_test_grid.obj", ss.str());
+
+    auto assets = vierkant::model::wavefront_obj(path);
+    ASSERT_TRUE(assets);
+
+    crocore::ThreadPoolClassic pool(4);
+    auto assets_parallel = vierkant::model::wavefront_obj(path, &pool);
+    ASSERT_TRUE(assets_parallel);
+
+    const auto &geom = get_entries(*assets).front().geometry;
+    const auto &geom_parallel = get_entries(*assets_parallel).front().geometry;
+
+    EXPECT_EQ(geom->indices.size(), 6 * grid_size * grid_size);
+    EXPECT_EQ(geom->positions.size(), (grid_size + 1) * (grid_size + 1));
+    EXPECT_EQ(geom->positions.back(), glm::vec3(grid_size * 0.125f, grid_size * 0.125f, -0.15f));
+
+    // identical results
+    EXPECT_EQ(geom->indices, geom_parallel->indices);
+    EXPECT_EQ(geom->positions, geom_parallel->positions);
+    EXPECT_EQ(geom->normals, geom_parallel->normals);
+    std::filesystem::remove(path);
+}
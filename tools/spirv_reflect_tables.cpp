@@ -0,0 +1,78 @@
+//
+// build-time shader-reflection, emits constexpr tables consumed via vierkant::shader_reflection_t
+//
+// usage: spirv_reflect_tables <spirv-file> <symbol-name>
+//
+
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "spirv_reflect.h"
+
+int main(int argc, char *argv[])
+{
+    if(argc != 3)
+    {
+        std::cerr << "usage: spirv_reflect_tables <spirv-file> <symbol-name>\n";
+        return 1;
+    }
+    std::string symbol = argv[2];
+
+    std::ifstream stream(argv[1], std::ios::binary);
+    std::vector<char> code{std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>()};
+
+    SpvReflectShaderModule spv_shader_module;
+    if(code.empty() ||
+       spvReflectCreateShaderModule(code.size(), code.data(), &spv_shader_module) != SPV_REFLECT_RESULT_SUCCESS ||
+       !spv_shader_module.entry_point_count)
+    {
+        std::cerr << "spirv_reflect_tables: could not reflect " << argv[1] << "\n";
+        return 1;
+    }
+
+    std::string bindings_tables, entry_points;
+
+    for(uint32_t i = 0; i < spv_shader_module.entry_point_count; ++i)
+    {
+        const auto &spv_entry_point = spv_shader_module.entry_points[i];
+
+        // ordered, unique bindings
+        std::set<uint32_t> bindings;
+        for(uint32_t j = 0; j < spv_entry_point.descriptor_set_count; ++j)
+        {
+            const auto &spv_descriptor_set = spv_entry_point.descriptor_sets[j];
+            for(uint32_t k = 0; k < spv_descriptor_set.binding_count; ++k)
+            {
+                bindings.insert(spv_descriptor_set.bindings[k]->binding);
+            }
+        }
+
+        // zero-sized arrays are ill-formed, use an empty span instead
+        std::string bindings_symbol = "{}";
+
+        if(!bindings.empty())
+        {
+            bindings_symbol = std::format("{}_bindings_{}", symbol, i);
+            bindings_tables += std::format("constexpr uint32_t {}[] = {{", bindings_symbol);
+            for(auto it = bindings.begin(); it != bindings.end(); ++it)
+            {
+                bindings_tables += std::format("{}{}u", it == bindings.begin() ? "" : ", ", *it);
+            }
+            bindings_tables += "};\n";
+        }
+        entry_points += std::format("        {{\"{}\", 0x{:x}u, {{{}u, {}u, {}u}}, {}}},\n", spv_entry_point.name,
+                                    static_cast<uint32_t>(spv_entry_point.shader_stage), spv_entry_point.local_size.x,
+                                    spv_entry_point.local_size.y, spv_entry_point.local_size.z, bindings_symbol);
+    }
+    spvReflectDestroyShaderModule(&spv_shader_module);
+
+    std::cout << bindings_tables
+              << std::format("constexpr vierkant::shader_reflection_t::entry_point_t {}_entry_points[] = {{\n{}}};\n",
+                             symbol, entry_points);
+    return 0;
+}